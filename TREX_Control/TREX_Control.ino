@@ -29,6 +29,9 @@
 // =============================================================
 #include <Arduino.h>
 #include <TrexProtocol.h>
+#include "TrexProtocolExt.h"
+#include "ClockSync.h"
+#include "StateHeartbeat.h"
 #include <TrexTransport.h>
 #include <TrexVersion.h>
 #include <Preferences.h>
@@ -73,11 +76,11 @@
 
 // Radio identity for this station
 static uint8_t WIFI_CHANNEL = 6;   // must match server (loaded from NVS)
-constexpr uint8_t STATION_ID   = 7;   // unique id for CONTROL station
+constexpr uint8_t STATION_ID   = TREX_CONTROL_ID;   // unique id for CONTROL station
 
 // Station IDs for targeting
-constexpr uint8_t SERVER_STATION_ID   = 0; // T-Rex server
-constexpr uint8_t DROPOFF_STATION_ID  = 6; // your Drop-off station id
+constexpr uint8_t SERVER_STATION_ID   = TREX_SERVER_ID; // T-Rex server
+constexpr uint8_t DROPOFF_STATION_ID  = TREX_DROPOFF_ID; // your Drop-off station id
 // Loot stations are typically 1..5
 
 // --- Radio config (persisted in NVS) ------------------------------------
@@ -142,6 +145,8 @@ struct GameStatusSnapshot {
   uint32_t teamScore            = 0;
   uint32_t msLeftGame           = 0;
   uint32_t msLeftRound          = 0;
+  bool     hasStageEnd          = false;   // WORLD_FRAME v2: stageEndServerMs valid
+  uint32_t stageEndServerMs     = 0;       // stage timer runs out (server time)
   uint8_t  roundIndex           = 0;
   uint8_t  phase                = 0;   // Phase enum: 1=PLAYING, 2=END
   uint8_t  lightState           = 0;   // LightState: 0=GREEN,1=RED,2=YELLOW
@@ -457,7 +462,13 @@ static void pmsTick() {
   const char* lightStr = pmsLightStr(light);
 
   // PMS should show the current stage timer, not the overall game timer.
+  // Counted down on the server's clock when we have it, so tleft_ms keeps
+  // moving smoothly between frames and doesn't carry their radio delay.
   uint32_t tleft = statusValid ? gStatus.msLeftRound : 0;
+  if (statusValid && gStatus.hasStageEnd && clockSynced()) {
+    const int32_t left = (int32_t)(gStatus.stageEndServerMs - serverNow());
+    tleft = (left > 0) ? (uint32_t)left : 0;
+  }
 
   // Initialize baseline without emitting spurious events.
   if (!gPmsBaselineValid) {
@@ -595,6 +606,49 @@ void sendHello() {
   Transport::sendToServer(buf, sizeof(buf));
 }
 
+// TIME_SYNC_REQ whenever ClockSync asks for a sample
+void tickClockSync() {
+  TimeSyncReqPayload req;
+  if (!clockSyncDue(millis(), req)) return;
+
+  uint8_t buf[sizeof(MsgHeader) + sizeof(TimeSyncReqPayload)];
+  auto* h = (MsgHeader*)buf;
+  h->version      = TREX_PROTO_VERSION;
+  h->type         = (uint8_t)MsgTypeExt::TIME_SYNC_REQ;
+  h->srcStationId = STATION_ID;
+  h->flags        = 0;
+  h->payloadLen   = sizeof(TimeSyncReqPayload);
+  h->seq          = gSeq++;
+  memcpy(buf + sizeof(MsgHeader), &req, sizeof(req));
+
+  Transport::sendToServer(buf, sizeof(buf));
+}
+
+// STATE_HEARTBEAT: what we show (phase, light, round, lives, score), hashed
+void tickStateHeartbeat() {
+  StationDigest d;
+  memset(&d, 0, sizeof(d));
+  d.phase      = gStatus.phase;
+  d.light      = gStatus.lightState;
+  d.roundIndex = gStatus.roundIndex;
+  d.lives      = gStatus.livesRemaining;
+  d.teamScore  = gStatus.teamScore;
+  StateHeartbeatPayload hb;
+  if (!stateHbDue(millis(), d, hb)) return;
+
+  uint8_t buf[sizeof(MsgHeader) + sizeof(StateHeartbeatPayload)];
+  auto* h = (MsgHeader*)buf;
+  h->version      = TREX_PROTO_VERSION;
+  h->type         = (uint8_t)MsgTypeExt::STATE_HEARTBEAT;
+  h->srcStationId = STATION_ID;
+  h->flags        = 0;
+  h->payloadLen   = sizeof(StateHeartbeatPayload);
+  h->seq          = gSeq++;
+  memcpy(buf + sizeof(MsgHeader), &hb, sizeof(hb));
+
+  Transport::sendToServer(buf, sizeof(buf));
+}
+
 // Always broadcast CONTROL_CMD; targets are encoded in payload
 void sendControl(ControlOp op, uint8_t targetType, uint8_t targetId) {
   uint8_t buf[sizeof(MsgHeader) + sizeof(ControlCmdPayload)];
@@ -655,6 +709,35 @@ void sendRadioCfgRequest(uint8_t wifiChannel, int8_t txFramed = -1, int8_t rxLeg
 
 // --- Network RX: update snapshot + emit events -------------------------
 
+// Shared by GAME_STATUS and WORLD_FRAME.
+static void noteGameStatus(uint32_t teamScore, uint32_t msLeftGame, uint32_t msLeftRound,
+                           uint8_t roundIndex, uint8_t phase, uint8_t lightState) {
+  const bool    hadStatus = gStatus.hasStatus;
+  const uint8_t prevLight = gStatus.lightState;
+  const uint8_t prevPhase = gStatus.phase;
+
+  gStatus.hasStatus    = true;
+  gStatus.teamScore    = teamScore;
+  gStatus.msLeftGame   = msLeftGame;
+  gStatus.msLeftRound  = msLeftRound;
+  gStatus.roundIndex   = roundIndex;
+  gStatus.phase        = phase;
+  gStatus.lightState   = lightState;
+  if (phase == 1) gStatus.lastGameOverReason = 255;
+  gStatus.lastUpdateMs = millis();
+  gServerInMaint       = false;   // fresh status => server back from maint
+
+  // Queue an immediate PMS EVENT when the light changes (minimizes latency for RED/YELLOW).
+  // Flushed from loop() (not directly from the ESPNOW RX callback).
+  if (hadStatus &&
+      prevPhase == 1 &&
+      phase == 1 &&
+      prevLight != lightState) {
+    gPmsLightEventPending = true;
+    gPmsPendingLightState = lightState;
+  }
+}
+
 void onRx(const uint8_t* data, uint16_t len) {
   if (len < sizeof(MsgHeader)) return;
   auto* h = (const MsgHeader*)data;
@@ -662,6 +745,51 @@ void onRx(const uint8_t* data, uint16_t len) {
 
   const uint8_t* payload = data + sizeof(MsgHeader);
 
+  // Extension ids sit outside MsgType; give them their own switch so the
+  // MsgType one below only ever sees its own enumerators.
+  switch ((MsgTypeExt)h->type) {
+    // Coalesced per-tick snapshot (supersedes GAME_STATUS; also carries lives).
+    case MsgTypeExt::WORLD_FRAME: {
+      if (h->payloadLen < WORLD_FRAME_V1_LEN) break;
+      auto* p = (const WorldFramePayload*)payload;
+      if (p->frameVersion < 1) break;
+      noteGameStatus(p->teamScore, p->msLeftGame, p->msLeftStage,
+                     p->roundIndex, p->phase, p->lightState);
+      gStatus.livesRemaining = p->livesRemaining;
+      gStatus.livesMax       = p->livesMax;
+      gStatus.hasStageEnd    = (p->frameVersion >= 2 && h->payloadLen >= sizeof(WorldFramePayload));
+      if (gStatus.hasStageEnd) gStatus.stageEndServerMs = p->serverNowMs + p->msLeftStage;
+      break;
+    }
+
+    // Our heartbeat disagreed with the server, or we said HELLO mid-game:
+    // its full picture for us
+    case MsgTypeExt::STATION_RESYNC: {
+      if (h->payloadLen != sizeof(StationResyncPayload)) break;
+      auto* p = (const StationResyncPayload*)payload;
+      if (p->targetId != STATION_ID) break;
+      noteGameStatus(p->teamScore, p->msLeftGame, p->msLeftStage,
+                     p->roundIndex, p->phase, p->lightState);
+      gStatus.livesRemaining   = p->livesRemaining;
+      gStatus.livesMax         = p->livesMax;
+      gStatus.hasStageEnd      = true;
+      gStatus.stageEndServerMs = p->serverNowMs + p->msLeftStage;
+      stateHbResynced();
+      break;
+    }
+
+    case MsgTypeExt::TIME_SYNC_RESP: {
+      if (h->payloadLen != sizeof(TimeSyncRespPayload)) break;
+      auto* p = (const TimeSyncRespPayload*)payload;
+      if (p->targetId != STATION_ID) break;
+      clockSyncOnResp(*p);
+      break;
+    }
+
+    default:
+      break;
+  }
+
   switch ((MsgType)h->type) {
     case MsgType::RADIO_CFG: {
       if (h->payloadLen != sizeof(RadioCfgPayload)) break;
@@ -679,31 +807,9 @@ void onRx(const uint8_t* data, uint16_t len) {
     case MsgType::GAME_STATUS: {
       if (h->payloadLen != sizeof(GameStatusPayload)) break;
       auto* p = (const GameStatusPayload*)payload;
-
-      const bool    hadStatus = gStatus.hasStatus;
-      const uint8_t prevLight = gStatus.lightState;
-      const uint8_t prevPhase = gStatus.phase;
-
-      gStatus.hasStatus    = true;
-      gStatus.teamScore    = p->teamScore;
-      gStatus.msLeftGame   = p->msLeftGame;
-      gStatus.msLeftRound  = p->msLeftRound;
-      gStatus.roundIndex   = p->roundIndex;
-      gStatus.phase        = p->phase;
-      gStatus.lightState   = p->lightState;
-      if (p->phase == 1) gStatus.lastGameOverReason = 255;
-      gStatus.lastUpdateMs = millis();
-      gServerInMaint       = false;   // fresh status => server back from maint
-
-      // Queue an immediate PMS EVENT when the light changes (minimizes latency for RED/YELLOW).
-      // Flushed from loop() (not directly from the ESPNOW RX callback).
-      if (hadStatus &&
-          prevPhase == 1 &&
-          p->phase == 1 &&
-          prevLight != p->lightState) {
-        gPmsLightEventPending = true;
-        gPmsPendingLightState = p->lightState;
-      }
+      noteGameStatus(p->teamScore, p->msLeftGame, p->msLeftRound,
+                     p->roundIndex, p->phase, p->lightState);
+      gStatus.hasStageEnd = false;
       break;
     }
 
@@ -862,7 +968,7 @@ void handleMaintCommand(const String& cmd) {
   DBG_PRINTLN("  MAINT DROPOFF");
   DBG_PRINTLN("  MAINT LOOT             (all loot stations)");
   DBG_PRINTLN("  MAINT LOOT ALL");
-  DBG_PRINTLN("  MAINT LOOT <N>         (loot station N, 1..5)");
+  DBG_PRINTLN("  MAINT LOOT <N>         (loot station N, 1..16)");
   DBG_PRINTLN("  MAINT ALL              (server + drop-off + all loot)");
 }
 
@@ -871,7 +977,7 @@ void handleLootCommand(const String& cmd) {
   // Options:
   //   LOOT           -> LOOT ALL
   //   LOOT ALL
-  //   LOOT N         (1..5)
+  //   LOOT N         (1..TREX_MAX_LOOT_STATIONS)
 
   if (cmd.length() == 4) {
     // bare LOOT -> all loot
@@ -950,7 +1056,7 @@ void printHelp() {
   DBG_PRINTLN("  MAINT DROPOFF     - Drop-off station only");
   DBG_PRINTLN("  MAINT LOOT        - All loot stations");
   DBG_PRINTLN("  MAINT LOOT ALL    - Same as above");
-  DBG_PRINTLN("  MAINT LOOT <N>    - Single loot station (N = 1..255; typical 1..5)");
+  DBG_PRINTLN("  MAINT LOOT <N>    - Single loot station (N = 1..255; typical 1..16)");
   DBG_PRINTLN("  MAINT ALL         - Server + Drop-off + all loot stations");
   DBG_PRINTLN();
 
@@ -963,6 +1069,8 @@ void printHelp() {
   DBG_PRINTLN("Status / debug:");
   DBG_PRINTLN("  STATUS            - Print one status line immediately");
   DBG_PRINTLN("                       (phase, round, score, msGame, msRound, light, lives)");
+  DBG_PRINTLN("  CLOCK             - Server clock estimate (offset, drift, last error, rtt)");
+  DBG_PRINTLN("  HB                - State heartbeats sent / resyncs received");
   DBG_PRINTLN("  HELP              - Show this help");
   DBG_PRINTLN();
 
@@ -1090,6 +1198,14 @@ void handleCommand(const String& raw) {
                     (unsigned)gStatus.livesRemaining,
                     (unsigned)gStatus.livesMax);
     }
+  } else if (cmd == "CLOCK") {
+#if PMS_DEBUG_SERIAL
+    clockSyncPrint(Serial);
+#endif
+  } else if (cmd == "HB") {
+#if PMS_DEBUG_SERIAL
+    stateHbPrint(Serial);
+#endif
   } else if (cmd == "HELP") {
     printHelp();
   } else {
@@ -1152,6 +1268,8 @@ void loop() {
   }
 
   Transport::loop();
+  tickClockSync();
+  tickStateHeartbeat();
 
   static String line;
   while (Serial.available()) {
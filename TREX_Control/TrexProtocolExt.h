@@ -0,0 +1,263 @@
+#pragma once
+// Message types + payloads layered on top of the TrexProtocol library.
+//
+// The core MsgType enum and payloads live in the shared TrexProtocol library.
+// Everything here uses ids from 0x40 up so it can never collide with it.
+// Each sketch carries an identical copy of this file (Arduino sketches can't
+// include headers from a sibling folder) — keep them in sync.
+#include <stddef.h>
+#include <stdint.h>
+#include <TrexProtocol.h>
+
+// ---- Station ids ----------------------------------------------------------
+// An id names one device on the air (MsgHeader.srcStationId, hold/blame ids);
+// what the device *is* comes from its role (StationType in CONTROL_CMD), not
+// from where its id falls. Loot stations take 1..TREX_MAX_LOOT_STATIONS (how
+// many a room actually has is server config); the single Drop-off and
+// Control have fixed ids above that block, so adding Loots never renumbers
+// them. Station bitmasks (bonus, minigame) stay uint32_t, bit = Loot id.
+constexpr uint8_t TREX_SERVER_ID         = 0;
+constexpr uint8_t TREX_MAX_LOOT_STATIONS = 16;
+constexpr uint8_t TREX_DROPOFF_ID        = 0x20;
+constexpr uint8_t TREX_CONTROL_ID        = 0x21;
+static_assert(TREX_MAX_LOOT_STATIONS < 32, "Loot ids are bits of a uint32_t mask");
+static_assert(TREX_DROPOFF_ID > TREX_MAX_LOOT_STATIONS && TREX_CONTROL_ID > TREX_MAX_LOOT_STATIONS,
+              "fixed roles must sit above the Loot id block");
+
+static inline bool trexIsLootId(uint8_t id) { return id >= 1 && id <= TREX_MAX_LOOT_STATIONS; }
+
+enum class MsgTypeExt : uint8_t {
+  WORLD_FRAME     = 0x40,   // server -> all, once per tick
+  LOOT_TICK_BATCH = 0x41,   // server -> all, once per accrual pass
+  STATION_INVENTORY = 0x42, // server -> all, on change (rate-limited) + periodic refresh
+  LIGHT_SCHEDULE  = 0x43,   // server -> all, on every light flip / cadence change
+  TIME_SYNC_REQ   = 0x44,   // station -> server, every CLOCK_SYNC_PERIOD_MS
+  TIME_SYNC_RESP  = 0x45,   // server -> that station (broadcast if its MAC is unknown)
+  STATE_HEARTBEAT = 0x46,   // station -> server, on state change + every STATE_HB_PERIOD_MS
+  STATION_RESYNC  = 0x47,   // server -> one station whose heartbeat disagrees, or that just said HELLO
+};
+
+// ---- WORLD_FRAME ----------------------------------------------------------
+// One coalesced per-tick snapshot. Replaces the per-tick STATE_TICK +
+// GAME_STATUS and the ROUND_STATUS / BONUS_UPDATE keep-alives. The event-driven
+// messages (GAME_START/GAME_OVER, LIVES_UPDATE with a reason, bonus spawns…)
+// still go out on their own when they happen.
+//
+// Versioning: fields are only ever appended. Receivers accept any frame with
+// frameVersion >= 1 and payloadLen >= WORLD_FRAME_V1_LEN, and read a later
+// version's fields only when frameVersion and payloadLen both cover them.
+//   v2: serverNowMs, schedEpoch (LIGHT_SCHEDULE)
+constexpr uint8_t WORLD_FRAME_VERSION = 2;
+
+constexpr uint8_t WF_FLAG_MG_ACTIVE    = 0x01;  // minigame running
+constexpr uint8_t WF_FLAG_INTERMISSION = 0x02;  // R2.5 / R3.5 bonus window
+
+#pragma pack(push, 1)
+struct WorldFramePayload {
+  uint8_t  frameVersion;     // WORLD_FRAME_VERSION
+  uint8_t  phase;            // 1=PLAYING, 2=END
+  uint8_t  lightState;       // LightState
+  uint8_t  roundIndex;
+  uint8_t  livesRemaining;
+  uint8_t  livesMax;
+  uint8_t  flags;            // WF_FLAG_*
+  uint8_t  _pad;
+  uint32_t msLeftStage;      // round / intermission / minigame timer (0 when not PLAYING)
+  uint32_t msLeftGame;       // overall game timer (0 when not PLAYING)
+  uint32_t teamScore;
+  uint32_t roundStartScore;
+  uint32_t roundGoalAbs;
+  uint32_t bonusMask;        // bit i => station i is bonus-active
+  // v2
+  uint32_t serverNowMs;      // server millis() at pack time: msLeft* count from here
+  uint16_t schedEpoch;       // LIGHT_SCHEDULE epoch in force
+  uint16_t _pad2;
+};
+#pragma pack(pop)
+
+constexpr uint16_t WORLD_FRAME_V1_LEN = offsetof(WorldFramePayload, serverNowMs);
+
+// ---- LOOT_TICK_BATCH ------------------------------------------------------
+// Every hold that ticked in one accrual pass, plus the current inventory of
+// every station. Variable length:
+//
+//   LootTickBatchPayload
+//   uint16_t      inventory[stationCount]   // stations 1..stationCount
+//   LootTickEntry entries[entryCount]
+//
+// A Loot takes inventory[STATION_ID-1] and the entry matching its holdId
+// (if any). payloadLen must equal the size implied by the two counts.
+#pragma pack(push, 1)
+struct LootTickBatchPayload {
+  uint8_t stationCount;
+  uint8_t entryCount;
+};
+
+struct LootTickEntry {
+  uint32_t holdId;
+  uint8_t  carried;
+};
+#pragma pack(pop)
+
+// ---- STATION_INVENTORY ----------------------------------------------------
+// Inventory + capacity of every station in one frame; replaces the
+// one-station-per-frame STATION_UPDATE. Variable length:
+//
+//   StationInventoryPayload
+//   StationInvEntry stations[stationCount]  // stations 1..stationCount
+#pragma pack(push, 1)
+struct StationInventoryPayload {
+  uint8_t stationCount;
+  uint8_t _pad;
+};
+
+struct StationInvEntry {
+  uint16_t inventory;
+  uint16_t capacity;
+};
+#pragma pack(pop)
+
+// ---- LIGHT_SCHEDULE -------------------------------------------------------
+// The light segments the server has already drawn (current one first), so a
+// station flips on its own at the same server time instead of whenever a
+// frame happens to land. Variable length:
+//
+//   LightSchedulePayload
+//   LightScheduleEntry entries[count]   // ascending atMs; [0] = light now
+//
+// Times are server millis(); stations compare them with their serverNow()
+// (TIME_SYNC below) and ignore schedules until that is synced. A schedule
+// replaces whatever the
+// station had. The epoch only changes when the server breaks its own plan
+// (life loss, manual flip, round change): a WORLD_FRAME carrying some other
+// schedEpoch means this station missed that correction and must drop its
+// schedule until the next one. count == 0 just clears it.
+constexpr uint8_t LIGHT_SCHEDULE_MAX = 8;
+
+#pragma pack(push, 1)
+struct LightSchedulePayload {
+  uint16_t epoch;
+  uint8_t  count;
+  uint8_t  _pad;
+};
+
+struct LightScheduleEntry {
+  uint32_t atMs;             // server millis() the light takes effect
+  uint8_t  light;            // LightState
+};
+#pragma pack(pop)
+
+// ---- TIME_SYNC_REQ / TIME_SYNC_RESP ---------------------------------------
+// NTP-style exchange that gives every station the server's clock
+// (serverNow(), ClockSync.h). Stamps are esp_timer_get_time() microseconds,
+// each on its own device's clock:
+//
+//   station t1 --REQ--> server t2 ... t3 --RESP--> station t4
+//   offset = ((t2 - t1) + (t3 - t4)) / 2     rtt = (t4 - t1) - (t3 - t2)
+//
+// The request also carries how well the station's estimate held up on the
+// previous exchange, so the server can show every station's clock side by
+// side (`clock`).
+#pragma pack(push, 1)
+struct TimeSyncReqPayload {
+  uint64_t t1Us;
+  int32_t  errUs;            // last sample minus what the estimate predicted
+  uint32_t rttUs;            // last accepted round trip
+  int16_t  driftPpm10;       // station clock vs server, 0.1 ppm
+  uint8_t  synced;
+  uint8_t  _pad;
+};
+
+struct TimeSyncRespPayload {
+  uint8_t  targetId;         // station the answer is for
+  uint8_t  _pad[3];
+  uint64_t t1Us;             // echoed from the request
+  uint64_t t2Us;             // server: request received
+  uint64_t t3Us;             // server: response sent
+};
+#pragma pack(pop)
+
+// ---- STATE_HEARTBEAT / STATION_RESYNC -------------------------------------
+// Anti-entropy: each station hashes what it currently believes and sends the
+// hash shortly after it changes (STATE_HB_JITTER_MS spreads a room-wide flip)
+// and every STATE_HB_PERIOD_MS otherwise. The server hashes what that station
+// *should* believe; a station that hasn't reported the current truth
+// STATE_HB_CONFIRM_MS after it changed gets a STATION_RESYNC unicast. Event
+// messages therefore go out once instead of in blind bursts. A HELLO while
+// PLAYING (a station that rebooted mid-game) gets one straight away, repeated
+// until the station's heartbeat matches; so does a STATE_HB_BOOT heartbeat
+// that doesn't match, in case the HELLO was lost.
+//
+// The digest is per role, fields a role doesn't track stay 0:
+//   Loot     phase, light, round, bonusMask = own bit only, inventory, capacity
+//   Drop-off phase, light, round, bonusMask, teamScore
+//   Control  phase, light, round, lives, teamScore
+// Stations report phase as PLAYING while they consider the game running; the
+// server only compares (and resyncs) while it is PLAYING.
+constexpr uint32_t STATE_HB_PERIOD_MS  = 2000;
+constexpr uint32_t STATE_HB_JITTER_MS  = 40;
+constexpr uint32_t STATE_HB_CONFIRM_MS = 300;
+
+#pragma pack(push, 1)
+struct StationDigest {
+  uint8_t  phase;
+  uint8_t  light;
+  uint8_t  roundIndex;
+  uint8_t  lives;
+  uint32_t bonusMask;
+  uint32_t teamScore;
+  uint16_t inventory;
+  uint16_t capacity;
+};
+
+constexpr uint8_t STATE_HB_PERIODIC = 0;   // nothing changed, still here
+constexpr uint8_t STATE_HB_CHANGED  = 1;
+constexpr uint8_t STATE_HB_RESYNCED = 2;   // just applied a STATION_RESYNC
+constexpr uint8_t STATE_HB_BOOT     = 3;   // first since boot (mid-game: treated like a HELLO)
+
+struct StateHeartbeatPayload {
+  uint32_t stateHash;        // trexDigestHash() of this station's StationDigest
+  uint8_t  reason;           // STATE_HB_*
+  uint8_t  _pad[3];
+};
+
+// Everything a station needs to be correct again (WORLD_FRAME plus its own
+// inventory and minigame), addressed to one station. Also the answer to a
+// HELLO mid-game, so a station that rebooted is back within a round trip.
+struct StationResyncPayload {
+  uint8_t  targetId;
+  uint8_t  phase;
+  uint8_t  lightState;
+  uint8_t  roundIndex;
+  uint8_t  livesRemaining;
+  uint8_t  livesMax;
+  uint8_t  flags;            // WF_FLAG_*
+  uint8_t  _pad;
+  uint16_t inventory;        // Loots: targetId's
+  uint16_t capacity;
+  uint16_t schedEpoch;
+  uint16_t _pad2;
+  uint32_t bonusMask;
+  uint32_t teamScore;
+  uint32_t roundStartScore;
+  uint32_t roundGoalAbs;
+  uint32_t serverNowMs;
+  uint32_t msLeftStage;
+  uint32_t msLeftGame;
+  // Minigame still open to targetId (running, not tried yet); mgMsLeft 0 = none.
+  // Same fields as MG_START, but the timer is what is left of it.
+  uint32_t mgSeed;
+  uint16_t mgMsLeft;
+  uint8_t  mgSpeedMinMs, mgSpeedMaxMs;
+  uint8_t  mgSegMin, mgSegMax;
+  uint8_t  _pad3[2];
+};
+#pragma pack(pop)
+
+// FNV-1a over the packed digest; identical on every sketch
+static inline uint32_t trexDigestHash(const StationDigest& d) {
+  const uint8_t* b = (const uint8_t*)&d;
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < sizeof(d); ++i) { h ^= b[i]; h *= 16777619u; }
+  return h;
+}
@@ -0,0 +1,159 @@
+#include "ClockSync.h"
+#include <atomic>
+#include <esp_timer.h>
+
+// ---- Published estimate ----
+// Written from loop() only; serverNow() may run in the RX callback, so the
+// three fields go out under a sequence count (odd = being written) and
+// readers retry until they get a stable copy.
+struct Estimate {
+  int64_t offUs;      // server - local at refUs
+  int64_t refUs;      // local esp_timer time the offset belongs to
+  int32_t driftPpb;   // server clock rate vs ours - 1, parts per billion
+};
+static Estimate              sEst = { 0, 0, 0 };
+static std::atomic<uint32_t> sEstSeq{0};
+
+static void publish(const Estimate& e) {
+  sEstSeq.fetch_add(1, std::memory_order_acq_rel);
+  sEst = e;
+  sEstSeq.fetch_add(1, std::memory_order_acq_rel);
+}
+
+static Estimate snapshot() {
+  Estimate e;
+  uint32_t s0, s1;
+  do {
+    s0 = sEstSeq.load(std::memory_order_acquire);
+    e  = sEst;
+    s1 = sEstSeq.load(std::memory_order_acquire);
+  } while ((s0 & 1) || s0 != s1);
+  return e;
+}
+
+static int64_t predictOffUs(const Estimate& e, int64_t localUs) {
+  return e.offUs + (int64_t)e.driftPpb * (localUs - e.refUs) / 1000000000LL;
+}
+
+// ---- Filter state (loop only) ----
+static uint8_t  sSamples    = 0;            // accepted since the last reset (saturates)
+static int32_t  sLastErrUs  = 0;
+static uint32_t sLastRttUs  = 0;
+static uint32_t sRttFloorUs = UINT32_MAX;   // best recent round trip, relaxes upwards
+static uint64_t sPendingT1  = 0;            // t1 of the request we still expect an answer to
+static uint32_t sLastReqMs  = 0;
+static bool     sEverSent   = false;
+
+static uint32_t sSent = 0, sAccepted = 0, sRejected = 0, sStale = 0, sResets = 0;
+
+constexpr uint32_t RTT_SLACK_US       = 1000;   // accept rtt <= 2 * floor + this
+constexpr int64_t  DRIFT_MIN_SPAN_US  = (int64_t)CLOCK_SYNC_PERIOD_MS * 500;   // shorter gaps are all jitter
+
+// ---- Pending response (RX callback -> loop) ----
+static TimeSyncRespPayload sResp;
+static int64_t             sRespT4 = 0;
+static std::atomic<bool>   sRespReady{false};
+
+void clockSyncOnResp(const TimeSyncRespPayload& p) {
+  const int64_t t4 = esp_timer_get_time();
+  if (sRespReady.load(std::memory_order_acquire)) return;   // loop hasn't taken the last one yet
+  sResp   = p;
+  sRespT4 = t4;
+  sRespReady.store(true, std::memory_order_release);
+}
+
+static void restart(int64_t offUs, int64_t midUs) {
+  publish(Estimate{ offUs, midUs, 0 });
+  sSamples   = 1;
+  sLastErrUs = 0;
+}
+
+static void takeSample(const TimeSyncRespPayload& p, int64_t t4) {
+  if (!sPendingT1 || p.t1Us != sPendingT1) { sStale++; return; }   // duplicate or answer to an older request
+  sPendingT1 = 0;
+
+  const int64_t t1  = (int64_t)p.t1Us;
+  const int64_t rtt = (t4 - t1) - (int64_t)(p.t3Us - p.t2Us);
+  if (rtt < 0 || rtt > (int64_t)UINT32_MAX) { sRejected++; return; }
+
+  if (sRttFloorUs != UINT32_MAX) sRttFloorUs += sRttFloorUs / 16;
+  if ((uint32_t)rtt < sRttFloorUs) sRttFloorUs = (uint32_t)rtt;
+  if ((uint32_t)rtt > 2 * sRttFloorUs + RTT_SLACK_US) { sRejected++; return; }
+
+  const int64_t offUs = ((int64_t)(p.t2Us - p.t1Us) + ((int64_t)p.t3Us - t4)) / 2;
+  const int64_t midUs = t1 + (t4 - t1) / 2;
+  sLastRttUs = (uint32_t)rtt;
+  sAccepted++;
+
+  if (!sSamples) { restart(offUs, midUs); return; }
+
+  const Estimate e    = snapshot();
+  const int64_t  pred = predictOffUs(e, midUs);
+  const int64_t  err  = offUs - pred;
+  if (err > CLOCK_SYNC_RESET_US || err < -CLOCK_SYNC_RESET_US) {
+    sResets++;
+    sRttFloorUs = (uint32_t)rtt;
+    restart(offUs, midUs);
+    return;
+  }
+  sLastErrUs = (int32_t)err;
+
+  int64_t drift = e.driftPpb;
+  const int64_t span = midUs - e.refUs;
+  if (span >= DRIFT_MIN_SPAN_US) {
+    drift += err * 1000000000LL / span / 4;
+    if (drift >  CLOCK_SYNC_DRIFT_MAX_PPB) drift =  CLOCK_SYNC_DRIFT_MAX_PPB;
+    if (drift < -CLOCK_SYNC_DRIFT_MAX_PPB) drift = -CLOCK_SYNC_DRIFT_MAX_PPB;
+  }
+  publish(Estimate{ pred + err / 2, midUs, (int32_t)drift });
+  if (sSamples < 255) sSamples++;
+}
+
+bool clockSynced() {
+  return sSamples >= CLOCK_SYNC_MIN_SAMPLES;
+}
+
+uint32_t serverNow() {
+  const int64_t  local = esp_timer_get_time();
+  const Estimate e     = snapshot();
+  return (uint32_t)((local + predictOffUs(e, local)) / 1000);
+}
+
+bool clockSyncDue(uint32_t nowMs, TimeSyncReqPayload& out) {
+  if (sRespReady.load(std::memory_order_acquire)) {
+    const TimeSyncRespPayload p  = sResp;
+    const int64_t             t4 = sRespT4;
+    sRespReady.store(false, std::memory_order_release);
+    takeSample(p, t4);
+  }
+
+  // A lost request or answer is retried after CLOCK_SYNC_FAST_MS, not a whole
+  // period later, so a few losses in a row don't leave the estimate coasting
+  const bool waiting = sPendingT1 != 0;
+  const uint32_t period = (clockSynced() && !waiting) ? CLOCK_SYNC_PERIOD_MS : CLOCK_SYNC_FAST_MS;
+  if (sEverSent && nowMs - sLastReqMs < period) return false;
+  sEverSent  = true;
+  sLastReqMs = nowMs;
+
+  const Estimate e = snapshot();
+  out.t1Us       = (uint64_t)esp_timer_get_time();
+  out.errUs      = sLastErrUs;
+  out.rttUs      = sLastRttUs;
+  out.driftPpm10 = (int16_t)(e.driftPpb / 100);
+  out.synced     = clockSynced() ? 1 : 0;
+  out._pad       = 0;
+  sPendingT1 = out.t1Us;
+  sSent++;
+  return true;
+}
+
+void clockSyncPrint(Print& out) {
+  const Estimate e = snapshot();
+  out.printf("clock %s offset=%ldms drift=%.1fppm err=%ldus rtt=%luus floor=%luus\n",
+             clockSynced() ? "synced" : "UNSYNCED", (long)(e.offUs / 1000), e.driftPpb / 1000.0f,
+             (long)sLastErrUs, (unsigned long)sLastRttUs,
+             (unsigned long)(sRttFloorUs == UINT32_MAX ? 0 : sRttFloorUs));
+  out.printf("clock sent=%lu accepted=%lu rejected=%lu stale=%lu resets=%lu serverNow=%lu\n",
+             (unsigned long)sSent, (unsigned long)sAccepted, (unsigned long)sRejected,
+             (unsigned long)sStale, (unsigned long)sResets, (unsigned long)serverNow());
+}
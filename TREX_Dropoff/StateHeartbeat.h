@@ -0,0 +1,17 @@
+#pragma once
+// STATE_HEARTBEAT pacing (see TrexProtocolExt.h).
+//
+// The sketch builds its StationDigest every loop() pass and hands it here;
+// a heartbeat is due on the first pass after boot, a few ms (random, up to
+// STATE_HB_JITTER_MS) after the hash changes, right after a STATION_RESYNC
+// was applied, and every STATE_HB_PERIOD_MS regardless.
+#include <Arduino.h>
+#include "TrexProtocolExt.h"
+
+// true when `out` should go out as STATE_HEARTBEAT now
+bool stateHbDue(uint32_t nowMs, const StationDigest& d, StateHeartbeatPayload& out);
+// A STATION_RESYNC was applied (RX callback or loop): confirm it right away
+void stateHbResynced();
+
+// heartbeats sent by reason, last hash (`hb`)
+void stateHbPrint(Print& out);
@@ -34,6 +34,9 @@
 #endif
 
 #include <TrexProtocol.h>
+#include "TrexProtocolExt.h"
+#include "ClockSync.h"
+#include "StateHeartbeat.h"
 #include <TrexTransport.h>
 #include <Preferences.h>
 #include "TrexMaintenance.h"
@@ -44,7 +47,7 @@
 #define HOSTNAME    "Drop-off"    // unique per device
 
 /* ── IDs & radio ───────────────────────────────────────────── */
-constexpr uint8_t  STATION_ID    = 6;    // drop-off station id
+constexpr uint8_t  STATION_ID    = TREX_DROPOFF_ID;    // drop-off station id (fixed role id)
 static uint8_t     WIFI_CHANNEL  = 6;    // must match T-Rex (loaded from NVS)
 
 static bool TX_FRAMED        = false;  // false = legacy packets (no wire header)
@@ -546,6 +549,16 @@ void tickFinalBlink() {
     clearAllVisualsOff();
     return;
   }
+  // Phase off the server clock when we have it, so the blink lines up with
+  // the other stations no matter who heard GAME_OVER first
+  if (clockSynced()) {
+    const bool on = ((serverNow() / FINAL_BLINK_PERIOD_MS) & 1) == 0;
+    if (on == finalBlinkOn) return;
+    finalBlinkLastMs = now;
+    finalBlinkOn = on;
+    drawFinalBarsFrame(finalScoreSnapshot, roundTargetCount(), finalBlinkOn, finalBlinkSuccess);
+    return;
+  }
   if ((now - finalBlinkLastMs) >= FINAL_BLINK_PERIOD_MS) {
     finalBlinkLastMs = now;
     finalBlinkOn = !finalBlinkOn;
@@ -572,8 +585,54 @@ void sendDropRequest(const TrexUid& uid, uint8_t readerIndex) {
   p->uid = uid; p->readerIndex = readerIndex;
   Transport::sendToServer(buf, sizeof(buf));
 }
+void sendTimeSyncReqIfDue() {
+  TimeSyncReqPayload req;
+  if (!clockSyncDue(millis(), req)) return;
+  uint8_t buf[sizeof(MsgHeader)+sizeof(TimeSyncReqPayload)];
+  packHeader((uint8_t)MsgTypeExt::TIME_SYNC_REQ, sizeof(TimeSyncReqPayload), buf);
+  memcpy(buf + sizeof(MsgHeader), &req, sizeof(req));
+  Transport::sendToServer(buf, sizeof(buf));
+}
+
+void sendStateHeartbeatIfDue() {
+  StationDigest d;
+  memset(&d, 0, sizeof(d));
+  d.phase      = gameActive ? 1 : 2;   // PLAYING / END
+  d.light      = (uint8_t)g_lightState;
+  d.roundIndex = roundIndex;
+  d.bonusMask  = bonusActiveMask;
+  d.teamScore  = teamScore;
+  StateHeartbeatPayload hb;
+  if (!stateHbDue(millis(), d, hb)) return;
+  uint8_t buf[sizeof(MsgHeader)+sizeof(StateHeartbeatPayload)];
+  packHeader((uint8_t)MsgTypeExt::STATE_HEARTBEAT, sizeof(StateHeartbeatPayload), buf);
+  memcpy(buf + sizeof(MsgHeader), &hb, sizeof(hb));
+  Transport::sendToServer(buf, sizeof(buf));
+}
 
 /* ── RX handler ──────────────────────────────────────────── */
+static void startGame() {
+  gameActive = true;
+  wasPaused = false;
+  teamScore = 0;
+  roundStartScore = 0;
+  bonusActiveMask = 0;
+  bonusVisualStartScore = 0;
+  stopFinalBlink();
+  scanLocked = false;
+  scanAwaitingResult = false;
+  stopAudioExclusive();
+
+  for (int i=0;i<4;i++) {
+    ringHoldActive[i] = false;
+    ringPendingShow[i] = false;
+    tagPresent[i] = false;
+    absentMs[i]   = 0;
+    fillRing(i, RED);
+  }
+  reqHead = reqTail = 0;
+}
+
 void onRx(const uint8_t* data, uint16_t len) {
   if (len < sizeof(MsgHeader)) return;
   auto* h = (const MsgHeader*)data;
@@ -597,13 +656,101 @@ void onRx(const uint8_t* data, uint16_t len) {
     return;
   }
 
+  // Extension ids sit outside MsgType; give them their own switch so the
+  // MsgType one below only ever sees its own enumerators.
+  switch ((MsgTypeExt)h->type) {
+    case MsgTypeExt::TIME_SYNC_RESP: {
+      if (h->payloadLen != sizeof(TimeSyncRespPayload)) break;
+      auto* p = (const TimeSyncRespPayload*)(data + sizeof(MsgHeader));
+      if (p->targetId != STATION_ID) break;
+      clockSyncOnResp(*p);
+      break;
+    }
+
+    // Coalesced per-tick snapshot: covers a missed ROUND_STATUS / BONUS_UPDATE /
+    // SCORE_UPDATE. Only repaint when something actually moved.
+    case MsgTypeExt::WORLD_FRAME: {
+      if (h->payloadLen < WORLD_FRAME_V1_LEN) break;
+      auto* p = (const WorldFramePayload*)(data + sizeof(MsgHeader));
+      if (p->frameVersion < 1) break;
+
+      if      (p->lightState == (uint8_t)LightState::GREEN)  g_lightState = LightState::GREEN;
+      else if (p->lightState == (uint8_t)LightState::YELLOW) g_lightState = LightState::YELLOW;
+      else                                                   g_lightState = LightState::RED;
+
+      if (!gameActive) break;  // GAME_START / GAME_OVER own those transitions
+
+      bool changed = false;
+      if (p->roundIndex != roundIndex || p->roundStartScore != roundStartScore ||
+          p->roundGoalAbs != roundGoalAbs) {
+        roundIndex      = p->roundIndex;
+        roundStartScore = p->roundStartScore;
+        roundGoalAbs    = p->roundGoalAbs;
+        changed = true;
+      }
+      if (p->bonusMask != bonusActiveMask) {
+        if (p->bonusMask != 0 && bonusActiveMask == 0) {
+          bonusVisualStartScore = (teamScore < roundGoalAbs) ? teamScore : roundGoalAbs;
+        }
+        bonusActiveMask = p->bonusMask;
+        changed = true;
+      }
+      // Leave the score alone while a drop is in flight so DROP_RESULT still
+      // sees the increase and plays the cash-in feedback.
+      if (!scanAwaitingResult && p->teamScore != teamScore) {
+        teamScore = p->teamScore;
+        changed = true;
+      }
+
+      if (changed) {
+        if (!audioExclusive) drawTeamGaugesRound(teamScore, roundTargetCount());
+        else { pendingTeamScore = teamScore; gaugeDirty = true; }
+      }
+      break;
+    }
+
+    // Our heartbeat disagreed with the server for too long, or we said HELLO
+    // mid-game (rebooted): take its word for everything (only sent while a
+    // game is running)
+    case MsgTypeExt::STATION_RESYNC: {
+      if (h->payloadLen != sizeof(StationResyncPayload)) break;
+      auto* p = (const StationResyncPayload*)(data + sizeof(MsgHeader));
+      if (p->targetId != STATION_ID || p->phase != 1) break;
+      Serial.printf("[SYNC] STATION_RESYNC light=%u round=%u score=%lu bonus=0x%08lX%s\n",
+                    p->lightState, p->roundIndex, (unsigned long)p->teamScore,
+                    (unsigned long)p->bonusMask, gameActive ? "" : " (missed GAME_START)");
+      if (!gameActive) startGame();
+
+      if      (p->lightState == (uint8_t)LightState::GREEN)  g_lightState = LightState::GREEN;
+      else if (p->lightState == (uint8_t)LightState::YELLOW) g_lightState = LightState::YELLOW;
+      else                                                   g_lightState = LightState::RED;
+
+      roundIndex      = p->roundIndex;
+      roundStartScore = p->roundStartScore;
+      roundGoalAbs    = p->roundGoalAbs;
+      if (p->bonusMask != 0 && bonusActiveMask == 0) {
+        bonusVisualStartScore = (teamScore < roundGoalAbs) ? teamScore : roundGoalAbs;
+      }
+      bonusActiveMask = p->bonusMask;
+      if (!scanAwaitingResult) teamScore = p->teamScore;   // as WORLD_FRAME
+
+      if (!audioExclusive) drawTeamGaugesRound(teamScore, roundTargetCount());
+      else { pendingTeamScore = teamScore; gaugeDirty = true; }
+      stateHbResynced();
+      break;
+    }
+
+    default:
+      break;
+  }
+
   switch ((MsgType)h->type) {
     case MsgType::CONTROL_CMD: {
       if (h->payloadLen != sizeof(ControlCmdPayload)) break;
       auto* p = (const ControlCmdPayload*)(data + sizeof(MsgHeader));
 
       const uint8_t myType = (uint8_t)StationType::DROP;
-      const uint8_t myId   = STATION_ID;  // 6 for your Drop-off
+      const uint8_t myId   = STATION_ID;  // TREX_DROPOFF_ID
 
       bool typeMatch = (p->targetType == myType || p->targetType == 255);
       bool idMatch   = (p->targetId   == myId   || p->targetId   == 255);
@@ -747,27 +894,8 @@ void onRx(const uint8_t* data, uint16_t len) {
     }
 
     case MsgType::GAME_START: {
-      gameActive = true;
-      wasPaused = false;
-      teamScore = 0;
-      roundStartScore = 0;
-      bonusActiveMask = 0;
-      bonusVisualStartScore = 0;
       Serial.println("[DROP] GAME_START");
-      stopFinalBlink();
-      scanLocked = false;
-      scanAwaitingResult = false;
-      stopAudioExclusive();
-
-      for (int i=0;i<4;i++) {
-        ringHoldActive[i] = false;
-        ringPendingShow[i] = false;
-        tagPresent[i] = false;
-        absentMs[i]   = 0;
-        fillRing(i, RED);
-      }
-      reqHead = reqTail = 0;
-
+      startGame();
       drawTeamGaugesRound(teamScore, roundTargetCount());
       break;
     }
@@ -839,6 +967,7 @@ void setup() {
     Serial.println("[DROP] Transport init FAILED");
     while (1) delay(1000);
   }
+  sendHello();   // mid-game the server answers with a STATION_RESYNC
   Serial.printf("Trex proto ver: %d\n", TREX_PROTO_VERSION);
 }
 
@@ -882,6 +1011,8 @@ void loop() {
   }
 
   Transport::loop();
+  sendTimeSyncReqIfDue();
+  sendStateHeartbeatIfDue();
 
   if (audioExclusive) {
     if (playing && decoder) {
@@ -0,0 +1,38 @@
+#pragma once
+// Server clock for stations (TIME_SYNC_REQ / TIME_SYNC_RESP, see
+// TrexProtocolExt.h).
+//
+// Every CLOCK_SYNC_PERIOD_MS (faster until the first few samples are in, and
+// again while the last request is unanswered) the sketch sends a request;
+// each answer gives one offset sample. Samples whose
+// round trip is well above the best recent one waited in some queue and are
+// dropped. The rest steer an offset + drift estimate: the new sample is
+// compared with what the estimate predicted for that instant (that
+// difference is the reported error), the offset moves halfway towards it and
+// the drift takes a quarter of the implied rate (only across a second or
+// more; over shorter gaps the error is all jitter). A sample more than
+// CLOCK_SYNC_RESET_US away from the prediction means the server rebooted (or
+// we did not hear it for a long time): start over.
+//
+// serverNow() is safe from the RX callback as well as loop().
+#include <Arduino.h>
+#include "TrexProtocolExt.h"
+
+constexpr uint32_t CLOCK_SYNC_PERIOD_MS   = 2000;
+constexpr uint32_t CLOCK_SYNC_FAST_MS     = 250;    // until CLOCK_SYNC_MIN_SAMPLES / retrying a lost one
+constexpr uint8_t  CLOCK_SYNC_MIN_SAMPLES = 4;      // accepted samples before clockSynced()
+constexpr int32_t  CLOCK_SYNC_RESET_US    = 50000;
+constexpr int32_t  CLOCK_SYNC_DRIFT_MAX_PPB = 200000;   // crystals are ~±20 ppm; anything past this is noise
+
+// Server millis() now, on our clock. Before the first sample: our millis().
+uint32_t serverNow();
+bool     clockSynced();
+
+// loop(): true when a request is due; `out` is then ready to send as
+// TIME_SYNC_REQ. Also folds in the last response (so call it every pass).
+bool clockSyncDue(uint32_t nowMs, TimeSyncReqPayload& out);
+// TIME_SYNC_RESP addressed to us (RX callback or loop)
+void clockSyncOnResp(const TimeSyncRespPayload& p);
+
+// offset, drift, last error + rtt, samples accepted / rejected / resets (`clock`)
+void clockSyncPrint(Print& out);
@@ -0,0 +1,17 @@
+// Loot event ids for EventLog (no include guard: this is an X-macro list).
+//
+// EVT(id, NAME, "text format")
+//   - ids are what goes on the wire: never renumber or reuse one.
+//   - args are rendered in order a, b, c, d, all as unsigned long (%lu).
+//   - tools/evlog_decode.py parses this file, keep one EVT per line.
+
+EVT(1, PROTO_MISMATCH,  "[WARN] Proto mismatch on RX: got=%lu exp=%lu (type=%lu)")
+EVT(2, RADIO_CFG_RX,    "[RADIO] RADIO_CFG received: chan=%lu txFramed=%lu rxLegacy=%lu")
+EVT(3, MAINT_REQUEST,   "[LOOT %lu] CONTROL_CMD ENTER_MAINT received")
+EVT(4, GAME_START,      "[LOOT] GAME_START")
+EVT(5, GAME_OVER,       "[LOOT] GAME_OVER reason=%lu blame=%lu me=%lu")
+EVT(6, OTA_GAME_ACTIVE, "[OTA] Ignored (game active)")
+EVT(7, OTA_BUSY,        "[OTA] Already in progress")
+EVT(8, OTA_NO_URL,      "[OTA] No URL")
+EVT(9, SCHED_EPOCH_DROP, "[SCHED] schedule epoch %lu superseded by %lu, frames own the light")
+EVT(10, RESYNC_RX,      "[SYNC] STATION_RESYNC: light %lu->%lu round=%lu inv=%lu")
@@ -5,6 +5,12 @@
 
 static Preferences idstore;
 
+// Auto-provisioned ids are spread over this many Loots; set it to the room's
+// station count, or provision ids explicitly (`ident <id> <name>`).
+#ifndef LOOT_AUTO_ID_COUNT
+#define LOOT_AUTO_ID_COUNT 5
+#endif
+
 uint8_t STATION_ID = 0;          // loaded from NVS
 char    HOSTNAME[32] = "Loot-0"; // loaded from NVS
 
@@ -26,9 +32,9 @@ void saveIdentity(uint8_t id, const char* host) {
 void ensureIdentity() {
   loadIdentity();
   if (STATION_ID == 0 || HOSTNAME[0] == '\0' || !strncmp(HOSTNAME, "Loot-0", 6)) {
-    // Derive a stable default from EFUSE MAC: map to 1..5
+    // Derive a stable default from EFUSE MAC: map to 1..LOOT_AUTO_ID_COUNT
     uint8_t derived = (uint8_t)(ESP.getEfuseMac() & 0xFF);
-    uint8_t id = (derived % 5) + 1;
+    uint8_t id = (derived % LOOT_AUTO_ID_COUNT) + 1;
     char host[32];
     snprintf(host, sizeof(host), "Loot-%u", id);
     saveIdentity(id, host);
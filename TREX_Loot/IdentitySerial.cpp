@@ -1,5 +1,11 @@
 #include "IdentitySerial.h"
 #include "Identity.h"
+#include "EventLog.h"
+#include "Profiler.h"
+#include "LightSchedule.h"
+#include "ClockSync.h"
+#include "StateHeartbeat.h"
+#include "TrexProtocolExt.h"   // TREX_MAX_LOOT_STATIONS
 #include <Arduino.h>
 #include <string.h>
 #include <stdlib.h>
@@ -18,12 +24,12 @@ void processIdentitySerial() {
 
       } else if (!strncmp(buf, "id ", 3)) {
         int id = atoi(buf+3);
-        if (id >= 1 && id <= 5) {
+        if (id >= 1 && id <= TREX_MAX_LOOT_STATIONS) {
           saveIdentity((uint8_t)id, HOSTNAME);
           Serial.printf("[ID] Saved id=%d (host=%s). Rebooting…\n", id, HOSTNAME);
           delay(200); ESP.restart();
         } else {
-          Serial.println("[ID] Usage: id <1..5>");
+          Serial.printf("[ID] Usage: id <1..%u>\n", (unsigned)TREX_MAX_LOOT_STATIONS);
         }
 
       } else if (!strncmp(buf, "host ", 5)) {
@@ -38,16 +44,41 @@ void processIdentitySerial() {
 
       } else if (!strncmp(buf, "ident ", 6)) {
         int id = 0; char name[32] = {0};
-        if (sscanf(buf+6, "%d %31s", &id, name) == 2 && id>=1 && id<=5) {
+        if (sscanf(buf+6, "%d %31s", &id, name) == 2 && id>=1 && id<=TREX_MAX_LOOT_STATIONS) {
           saveIdentity((uint8_t)id, name);
           Serial.printf("[ID] Saved id=%d host=%s. Rebooting…\n", id, name);
           delay(200); ESP.restart();
         } else {
-          Serial.println("[ID] Usage: ident <1..5> <name>");
+          Serial.printf("[ID] Usage: ident <1..%u> <name>\n", (unsigned)TREX_MAX_LOOT_STATIONS);
         }
 
+      } else if (strcmp(buf, "evlog") == 0) {
+        evlogDump(Serial);
+
+      } else if (!strncmp(buf, "evlog ", 6)) {
+        const char* m = buf+6;
+        if      (!strcmp(m, "off"))  evlogSetDrain(EvDrain::OFF);
+        else if (!strcmp(m, "text")) evlogSetDrain(EvDrain::TEXT);
+        else if (!strcmp(m, "bin"))  evlogSetDrain(EvDrain::BIN);
+        else { Serial.println("[EVLOG] Usage: evlog [off|text|bin]"); len = 0; continue; }
+        Serial.printf("[EVLOG] drain=%s\n", m);
+
+      } else if (strcmp(buf, "prof") == 0) {
+        profPrint(Serial);
+
+      } else if (strcmp(buf, "prof reset") == 0) {
+        profReset();
+        Serial.println("[PROF] reset");
+
+      } else if (strcmp(buf, "sched") == 0) {
+        schedPrintStats(Serial);
+      } else if (strcmp(buf, "clock") == 0) {
+        clockSyncPrint(Serial);
+      } else if (strcmp(buf, "hb") == 0) {
+        stateHbPrint(Serial);
+
       } else if (len) {
-        Serial.println("[ID] cmds: whoami | id <1..5> | host <name> | ident <1..5> <name>");
+        Serial.println("[ID] cmds: whoami | id <1..5> | host <name> | ident <1..5> <name> | evlog [off|text|bin] | prof [reset] | sched | clock | hb");
       }
 
       len = 0;
@@ -0,0 +1,105 @@
+#include "LightSchedule.h"
+#include <string.h>
+#include "TrexProtocolExt.h"
+#include "EventLog.h"
+#include "ClockSync.h"
+
+// ---- Schedule ----
+static LightScheduleEntry sEnt[LIGHT_SCHEDULE_MAX];
+static bool     sAhead[LIGHT_SCHEDULE_MAX];   // heard of before it came due (counts toward `late`)
+static uint8_t  sCount   = 0;
+static uint16_t sEpoch   = 0;
+static bool     sApplied = false;   // sAppliedAt is the entry g_lightState came from
+static uint32_t sAppliedAt = 0;
+
+static uint32_t sRx = 0, sUnsynced = 0, sFlips = 0, sLateSum = 0, sLateMax = 0, sOverruled = 0, sEpochDrops = 0;
+
+void schedRx(const uint8_t* payload, uint16_t len) {
+  // Without the server's clock the times mean nothing; frames keep the light
+  if (!clockSynced()) { sUnsynced++; return; }
+
+  LightSchedulePayload p;
+  memcpy(&p, payload, sizeof(p));
+
+  uint8_t n = p.count;
+  if (n > LIGHT_SCHEDULE_MAX) n = LIGHT_SCHEDULE_MAX;
+  if (len < sizeof(p) + n * sizeof(LightScheduleEntry)) return;
+
+  // The schedule sent after a flip starts with that flip; it was already
+  // ahead of us if the previous schedule had it
+  LightScheduleEntry ent[LIGHT_SCHEDULE_MAX];
+  bool ahead[LIGHT_SCHEDULE_MAX];
+  memcpy(ent, payload + sizeof(p), n * sizeof(LightScheduleEntry));
+  const uint32_t now = serverNow();
+  for (uint8_t i = 0; i < n; ++i) {
+    ahead[i] = (int32_t)(ent[i].atMs - now) > 0;
+    for (uint8_t j = 0; j < sCount && !ahead[i]; ++j) {
+      ahead[i] = sAhead[j] && sEnt[j].atMs == ent[i].atMs && sEnt[j].light == ent[i].light;
+    }
+  }
+  memcpy(sEnt, ent, n * sizeof(LightScheduleEntry));
+  memcpy(sAhead, ahead, n * sizeof(bool));
+  sCount = n;
+  sEpoch = p.epoch;
+  sRx++;
+}
+
+void schedNoteEpoch(uint16_t epoch) {
+  if (!sCount || epoch == sEpoch) return;
+  evlog(EV_SCHED_EPOCH_DROP, sEpoch, epoch);
+  sCount = 0;
+  sEpochDrops++;
+}
+
+void schedClear() {
+  sCount   = 0;
+  sApplied = false;
+}
+
+// Last entry already in effect at server time `now`, -1 if none
+static int8_t currentEntry(uint32_t now) {
+  int8_t cur = -1;
+  for (uint8_t i = 0; i < sCount; ++i) {
+    if ((int32_t)(now - sEnt[i].atMs) < 0) break;
+    cur = (int8_t)i;
+  }
+  return cur;
+}
+
+bool schedOverrides(uint8_t frameLight) {
+  if (!sCount || !clockSynced()) return false;
+  const uint32_t now = serverNow();
+  const int8_t cur = currentEntry(now);
+  if (cur < 0 || cur == sCount - 1) return false;   // nothing in effect yet / no flip left ahead
+  if (frameLight != sEnt[cur].light) sOverruled++;
+  return true;
+}
+
+bool schedPoll(uint8_t& light) {
+  if (!sCount || !clockSynced()) return false;
+  const uint32_t now = serverNow();
+  const int8_t cur = currentEntry(now);
+  if (cur < 0) return false;
+  const LightScheduleEntry& e = sEnt[cur];
+  if (sApplied && sAppliedAt == e.atMs) return false;
+
+  sApplied   = true;
+  sAppliedAt = e.atMs;
+  light      = e.light;
+  if (sAhead[cur]) {                  // a flip we knew was coming (not one just announced)
+    const uint32_t late = now - e.atMs;
+    sLateSum += late;
+    if (late > sLateMax) sLateMax = late;
+    sFlips++;
+  }
+  return true;
+}
+
+void schedPrintStats(Print& out) {
+  out.printf("sched clock=%s rx=%lu ignoredUnsynced=%lu epoch=%u entries=%u\n",
+             clockSynced() ? "synced" : "UNSYNCED", (unsigned long)sRx,
+             (unsigned long)sUnsynced, (unsigned)sEpoch, (unsigned)sCount);
+  out.printf("sched flips=%lu late avg=%lums max=%lums overruled=%lu epochDrops=%lu\n",
+             (unsigned long)sFlips, (unsigned long)(sFlips ? sLateSum / sFlips : 0),
+             (unsigned long)sLateMax, (unsigned long)sOverruled, (unsigned long)sEpochDrops);
+}
@@ -0,0 +1,28 @@
+#pragma once
+// LIGHT_SCHEDULE follower.
+//
+// The server sends the light segments it has already drawn, stamped in its
+// own millis(). schedPoll() flips us at the planned server time, so every
+// Loot changes colour together instead of whenever a frame happens to land;
+// while a schedule still has a flip ahead it owns g_lightState and the light
+// in WORLD_FRAME / STATE_TICK is ignored.
+//
+// Server time is ClockSync's serverNow(); until that is synced schedules are
+// ignored and frames keep the light as before.
+#include <Arduino.h>
+
+// LIGHT_SCHEDULE payload (length already checked by the caller)
+void schedRx(const uint8_t* payload, uint16_t len);
+// WORLD_FRAME v2 schedEpoch: a different epoch means we missed a correction
+void schedNoteEpoch(uint16_t epoch);
+void schedClear();                          // GAME_OVER (a new game starts with a fresh epoch)
+
+// A frame says the light is `frameLight`: true if the schedule owns the
+// light right now and the frame should be ignored (disagreements are counted)
+bool schedOverrides(uint8_t frameLight);
+// True (and the LightState in `light`) when a scheduled flip is due that
+// hasn't been applied yet; call every loop() pass.
+bool schedPoll(uint8_t& light);
+
+// clock state, flips applied and how late, frames overruled, epoch drops (`sched`)
+void schedPrintStats(Print& out);
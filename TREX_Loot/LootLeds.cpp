@@ -1,6 +1,7 @@
 #include "LootLeds.h"
 #include <Arduino.h>
 #include <pgmspace.h>
+#include "ClockSync.h"
 
 // Fallbacks in case some macros are only in the sketch.
 // These do NOT override your existing definitions.
@@ -68,12 +69,18 @@ static constexpr uint16_t EMPTY_BLINK_PERIOD_MS  = 500;
 static constexpr uint16_t RAINBOW_STEP     = 768; // ~fast smooth
 static constexpr uint16_t RAINBOW_FRAME_MS = 33;  // ~30 FPS
 
+// Bonus warning blink (last 3s of intermission)
+static constexpr uint32_t BONUS_WARN_MS         = 3000;  // blink when msLeft <= this
+static constexpr uint32_t BONUS_BLINK_PERIOD_MS = 220;   // ~4.5 Hz
+
 // ===== LED state (definitions) =====
 bool     fullBlinkActive = false;
 bool     fullBlinkOn     = false;
 uint32_t fullBlinkLastMs = 0;
 uint32_t blinkHoldId     = 0;
 
+uint32_t bonusEndsAtServerMs = 0;
+
 bool     yellowBlinkActive = false;
 bool     yellowBlinkOn     = false;
 uint32_t yellowBlinkLastMs = 0;
@@ -316,6 +323,18 @@ void tickBonusRainbow() {
   uint32_t now = millis();
   if ((int32_t)(now - nextGaugeDrawAtMs) < 0) return;  // reuse your 20ms throttle
 
+  // Intermission about to end: blink, phased on the server clock so every
+  // station is dark at the same moment
+  if (bonusEndsAtServerMs && clockSynced()) {
+    const int32_t left = (int32_t)(bonusEndsAtServerMs - serverNow());
+    if (left > 0 && (uint32_t)left <= BONUS_WARN_MS &&
+        ((uint32_t)left % BONUS_BLINK_PERIOD_MS) < BONUS_BLINK_PERIOD_MS / 2) {
+      fillGauge(OFF);
+      nextGaugeDrawAtMs = now + RAINBOW_FRAME_MS;
+      return;
+    }
+  }
+
   g_rainbowPhase += RAINBOW_STEP;                      // scroll the hues
   drawGaugeInventoryRainbowAnimated(inv, cap, g_rainbowPhase);
 
@@ -28,6 +28,10 @@ extern bool       gaugeCacheValid;
 
 extern uint32_t nextGaugeDrawAtMs;
 
+// Server time the bonus intermission ends (from WORLD_FRAME), 0 = none;
+// tickBonusRainbow() blinks through its last seconds
+extern uint32_t bonusEndsAtServerMs;
+
 // ---- LED API (names preserved) ----
 uint32_t gaugeColor();
 
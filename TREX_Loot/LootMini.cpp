@@ -5,6 +5,7 @@
 #include "LootNet.h"    // sendMgResult(...)
 #include "Audio.h"      // startLootAudio(true), stopAudio()
 #include "Identity.h"   // STATION_ID
+#include "ClockSync.h" // serverNow()
 #include <TrexProtocol.h>
 
 // --- externs provided elsewhere (unchanged) ---
@@ -144,6 +145,12 @@ void mgStop() {
   }
 }
 
+void mgSyncDeadline(uint32_t serverEndMs) {
+  if (st != MgState::Running || !clockSynced()) return;
+  const int32_t left = (int32_t)(serverEndMs - serverNow());
+  endAtMs = millis() + (left > 0 ? (uint32_t)left : 0);
+}
+
 void mgCancel() {
   // Same as stop, but used when MG is preempted (e.g., GAME_START/OVER/OTA)
   st = MgState::Idle;
@@ -15,6 +15,10 @@ struct MgParams {
 
 void mgStart(const MgParams& p); // called by RX on MG_START
 void mgStop();                   // called by RX on MG_STOP (or GAME_OVER/START)
+// WORLD_FRAME: the server's minigame deadline, in server time. Moves our
+// timer onto it (MG_START only tells us the length, counted from whenever
+// it arrived).
+void mgSyncDeadline(uint32_t serverEndMs);
 
 // Loop to run while mgActive; safe to call every loop() tick
 void mgLoop();
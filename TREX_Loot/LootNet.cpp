@@ -1,8 +1,13 @@
 #include "LootNet.h"
 #include <Arduino.h>
 #include <TrexTransport.h>
+#include <WiFi.h>            // STA MAC for HELLO
 #include <TrexVersion.h>     // TREX_FW_MAJOR / TREX_FW_MINOR
 #include "Identity.h"        // STATION_ID
+#include "TrexProtocolExt.h"
+#include "ClockSync.h"
+#include "StateHeartbeat.h"
+#include "LootRx.h"          // fillStateDigest
 
 #include <esp_random.h>      // esp_random for holdId
 
@@ -35,7 +40,7 @@ void sendHello() {
   p->fwMajor     = TREX_FW_MAJOR;
   p->fwMinor     = TREX_FW_MINOR;
   p->wifiChannel = WIFI_CHANNEL;
-  memset(p->mac, 0, 6);
+  WiFi.macAddress(p->mac);     // server unicasts our ACK/TICK/HOLD_END to this
   Transport::sendToServer(buf, sizeof(buf));
 }
 
@@ -72,3 +77,23 @@ void sendMgResult(const TrexUid& uid, uint8_t success) {
     Transport::sendToServer(buf, sizeof(buf));
   }
 }
+
+void tickClockSync() {
+  TimeSyncReqPayload req;
+  if (!clockSyncDue(millis(), req)) return;
+  uint8_t buf[sizeof(MsgHeader)+sizeof(TimeSyncReqPayload)];
+  packHeader((uint8_t)MsgTypeExt::TIME_SYNC_REQ, sizeof(TimeSyncReqPayload), buf);
+  memcpy(buf + sizeof(MsgHeader), &req, sizeof(req));
+  Transport::sendToServer(buf, sizeof(buf));
+}
+
+void tickStateHeartbeat() {
+  StationDigest d;
+  fillStateDigest(d);
+  StateHeartbeatPayload hb;
+  if (!stateHbDue(millis(), d, hb)) return;
+  uint8_t buf[sizeof(MsgHeader)+sizeof(StateHeartbeatPayload)];
+  packHeader((uint8_t)MsgTypeExt::STATE_HEARTBEAT, sizeof(StateHeartbeatPayload), buf);
+  memcpy(buf + sizeof(MsgHeader), &hb, sizeof(hb));
+  Transport::sendToServer(buf, sizeof(buf));
+}
@@ -8,3 +8,8 @@ void sendHello();
 void sendHoldStart(const TrexUid& uid);
 void sendHoldStop();
 void sendMgResult(const TrexUid& uid, uint8_t success);
+
+// TIME_SYNC_REQ when ClockSync wants a sample; call every loop() pass
+void tickClockSync();
+// STATE_HEARTBEAT when StateHeartbeat says so; call every loop() pass
+void tickStateHeartbeat();
@@ -1,12 +1,17 @@
 #include "LootRx.h"
 #include <Arduino.h>
 #include <TrexProtocol.h>
+#include "TrexProtocolExt.h"
 
 #include "Audio.h"
 #include "LootLeds.h"
 #include "LootNet.h"
 #include "LootMini.h"
 #include "Identity.h"
+#include "EventLog.h"
+#include "LightSchedule.h"
+#include "ClockSync.h"
+#include "StateHeartbeat.h"
 
 #ifndef PIN_MOSFET
 #define PIN_MOSFET 17
@@ -68,15 +73,269 @@ extern bool maintRequested;
 extern volatile bool   gRadioCfgPending;
 extern RadioCfgPayload gRadioCfgMsg;
 
+// -------- shared state appliers (legacy messages + WORLD_FRAME) --------
+static void applyLightState(uint8_t state) {
+  if      (state == (uint8_t)LightState::GREEN)  g_lightState = LightState::GREEN;
+  else if (state == (uint8_t)LightState::YELLOW) g_lightState = LightState::YELLOW;
+  else                                           g_lightState = LightState::RED;
+
+  if (g_lightState == LightState::YELLOW) yellowBlinkActive = true;
+  else                                    stopYellowBlink();
+
+  if (!gameActive) {
+    if (g_lightState == LightState::RED && !holdActive && !otaInProgress) fillRing(Adafruit_NeoPixel::Color(255,0,0));
+    return;
+  }
+
+  if (mgSwallowRepaints()) return;
+  if (stationInited && canPaintGaugeNow()) drawGaugeAuto(inv, cap);
+}
+
+// Scheduled flips (LIGHT_SCHEDULE) land here on their own time
+void tickLightSchedule() {
+  if (!gameActive || mgActive) return;
+  uint8_t light;
+  if (schedPoll(light)) applyLightState(light);
+}
+
+static uint8_t sRoundIndex = 0;   // last one the server told us (heartbeat digest)
+
+static void applyRoundIndex(uint8_t roundIndex) {
+  sRoundIndex = roundIndex;
+  // Safety: if MG_STOP was dropped but the server has already advanced into
+  // Round 5, leave the minigame anyway so normal gauge rendering resumes.
+  if (mgActive && roundIndex >= 5) {
+    mgStop();
+  }
+}
+
+static void applyBonusMask(uint32_t mask) {
+  bool wasBonus = s_isBonusNow;
+  s_isBonusNow  = ((mask >> STATION_ID) & 0x1u) != 0;
+
+  if (mgActive) return; // swallow chime/paint during minigame
+
+  if (!wasBonus && s_isBonusNow) {
+    playBonusSpawnChime();
+    stopYellowBlink();
+    stopEmptyBlink();
+  }
+
+  if (gameActive && stationInited && !otaInProgress) {
+    gaugeCacheValid = false;
+    drawGaugeAuto(inv, cap);
+  }
+}
+
+// STATION_UPDATE / our slot of STATION_INVENTORY
+static void applyStationInventory(uint16_t newInv, uint16_t newCap) {
+  inv = newInv;
+  cap = newCap;
+  stationInited = true;
+
+  if (!gameActive) return;
+  if (mgSwallowRepaints()) return;
+
+  if (!holdActive && !otaInProgress && canPaintGaugeNow()) {
+    drawGaugeAuto(inv, cap);
+  }
+}
+
+// Our hold ticked (LOOT_TICK or our entry in a LOOT_TICK_BATCH)
+static void applyLootTick(uint32_t tickHoldId, uint8_t tickCarried, uint16_t tickInv) {
+  carried = (tickCarried > maxCarry) ? maxCarry : tickCarried;
+  inv     = tickInv;
+  stationInited = true;
+
+  if (tagPresent && inv == 0) startEmptyBlink();
+  else                        stopEmptyBlink();
+
+  if (carried >= maxCarry) {
+    if (!fullAnnounced || blinkHoldId != tickHoldId) {
+      startFullBlinkImmediate();
+      fullAnnounced = true;
+      blinkHoldId   = tickHoldId;
+      scheduleAudioStop(AUDIO_STOP_STAGGER_MS);
+    }
+  } else {
+    if (fullBlinkActive) stopFullBlink();
+    fullAnnounced = false;
+    drawRingCarried(carried, maxCarry);
+  }
+
+  uint32_t now = millis();
+  if ((int32_t)(now - nextGaugeDrawAtMs) >= 0 && canPaintGaugeNow()) {
+    drawGaugeAuto(inv, cap);
+    nextGaugeDrawAtMs = now + 20;
+  }
+}
+
+void fillStateDigest(StationDigest& d) {
+  memset(&d, 0, sizeof(d));
+  d.phase      = gameActive ? 1 : 2;   // PLAYING / END
+  d.light      = (uint8_t)g_lightState;
+  d.roundIndex = sRoundIndex;
+  d.bonusMask  = s_isBonusNow ? (1u << STATION_ID) : 0;
+  d.inventory  = inv;
+  d.capacity   = cap;
+}
+
 void onRx(const uint8_t* data, uint16_t len) {
   if (len < sizeof(MsgHeader)) return;
   auto* h = (const MsgHeader*)data;
   if (h->version != TREX_PROTO_VERSION) {
-    Serial.printf("[WARN] Proto mismatch on RX: got=%u exp=%u (type=%u)\n",
-                  h->version, (unsigned)TREX_PROTO_VERSION, h->type);
+    evlog(EV_PROTO_MISMATCH, h->version, TREX_PROTO_VERSION, h->type);
     return;
   }
 
+  // Extension ids sit outside MsgType; give them their own switch so the
+  // MsgType one below only ever sees its own enumerators.
+  switch ((MsgTypeExt)h->type) {
+    // Coalesced per-tick snapshot from the server. Bonus is only re-applied
+    // when it disagrees with what we have (i.e. we missed the BONUS_UPDATE),
+    // so the spawn chime/repaint don't fire every tick.
+    case MsgTypeExt::WORLD_FRAME: {
+      if (h->payloadLen < WORLD_FRAME_V1_LEN) break;
+      const auto* p = (const WorldFramePayload*)(data + sizeof(MsgHeader));
+      if (p->frameVersion < 1) break;
+      if (p->frameVersion >= 2 && h->payloadLen >= sizeof(WorldFramePayload)) {
+        schedNoteEpoch(p->schedEpoch);
+        // Stage deadline in server time (msLeft counts from serverNowMs)
+        const uint32_t stageEnd = p->serverNowMs + p->msLeftStage;
+        bonusEndsAtServerMs = (p->flags & WF_FLAG_INTERMISSION) ? stageEnd : 0;
+        if (p->flags & WF_FLAG_MG_ACTIVE) mgSyncDeadline(stageEnd);
+      }
+
+      applyRoundIndex(p->roundIndex);
+      const bool bonusHere = ((p->bonusMask >> STATION_ID) & 0x1u) != 0;
+      if (bonusHere != s_isBonusNow) applyBonusMask(p->bonusMask);
+      if (!schedOverrides(p->lightState)) applyLightState(p->lightState);
+      break;
+    }
+
+    // Upcoming flips; tickLightSchedule() applies them at their server time
+    case MsgTypeExt::LIGHT_SCHEDULE: {
+      if (h->payloadLen < sizeof(LightSchedulePayload)) break;
+      if (len < sizeof(MsgHeader) + h->payloadLen) break;
+      schedRx(data + sizeof(MsgHeader), h->payloadLen);
+      tickLightSchedule();
+      break;
+    }
+
+    // Our heartbeat disagreed with the server for too long, or we said HELLO
+    // mid-game (rebooted): take its word for everything (only sent while a
+    // game is running)
+    case MsgTypeExt::STATION_RESYNC: {
+      if (h->payloadLen != sizeof(StationResyncPayload)) break;
+      const auto* p = (const StationResyncPayload*)(data + sizeof(MsgHeader));
+      if (p->targetId != STATION_ID || p->phase != 1) break;
+
+      if (!gameActive) {              // missed GAME_START: same as if we'd heard it
+        mgCancel();
+        gameActive       = true;
+        wasPaused        = false;
+        fullBlinkActive  = false;
+        fullAnnounced    = false;
+        stationInited    = false;
+        gaugeCacheValid  = false;
+        digitalWrite(PIN_MOSFET, HIGH);
+        stopFullBlink();
+        stopEmptyBlink();
+        fillRing(Adafruit_NeoPixel::Color(255,0,0));
+      }
+      evlog(EV_RESYNC_RX, (uint8_t)g_lightState, p->lightState, p->roundIndex, p->inventory);
+
+      // A minigame we haven't had our go at (rebooted, or missed MG_START):
+      // same seed, so the same segment and speed, for the time that is left
+      if (p->mgMsLeft && !mgActive) {
+        MgParams mp;
+        mp.seed       = p->mgSeed;
+        mp.timerMs    = p->mgMsLeft;
+        mp.speedMinMs = p->mgSpeedMinMs;
+        mp.speedMaxMs = p->mgSpeedMaxMs;
+        mp.segMin     = p->mgSegMin;
+        mp.segMax     = p->mgSegMax;
+        mgStart(mp);
+      }
+
+      schedNoteEpoch(p->schedEpoch);
+      const uint32_t stageEnd = p->serverNowMs + p->msLeftStage;
+      bonusEndsAtServerMs = (p->flags & WF_FLAG_INTERMISSION) ? stageEnd : 0;
+      if (p->flags & WF_FLAG_MG_ACTIVE) mgSyncDeadline(stageEnd);
+
+      applyRoundIndex(p->roundIndex);
+      const bool bonusHere = ((p->bonusMask >> STATION_ID) & 0x1u) != 0;
+      if (bonusHere != s_isBonusNow) applyBonusMask(p->bonusMask);
+      applyStationInventory(p->inventory, p->capacity);
+      if ((uint8_t)g_lightState != p->lightState) {
+        schedClear();                 // whatever put us there was wrong
+        applyLightState(p->lightState);
+      }
+      stateHbResynced();
+      break;
+    }
+
+    case MsgTypeExt::TIME_SYNC_RESP: {
+      if (h->payloadLen != sizeof(TimeSyncRespPayload)) break;
+      const auto* p = (const TimeSyncRespPayload*)(data + sizeof(MsgHeader));
+      if (p->targetId != STATION_ID) break;   // someone else's (broadcast fallback)
+      clockSyncOnResp(*p);
+      break;
+    }
+
+    case MsgTypeExt::LOOT_TICK_BATCH: {
+      if (mgActive) break;
+      if (h->payloadLen < sizeof(LootTickBatchPayload)) break;
+      const uint8_t* p = data + sizeof(MsgHeader);
+      const auto* b = (const LootTickBatchPayload*)p;
+      if (h->payloadLen != sizeof(LootTickBatchPayload) + b->stationCount * sizeof(uint16_t)
+                                                        + b->entryCount * sizeof(LootTickEntry)) break;
+      if (len < sizeof(MsgHeader) + h->payloadLen) break;
+      if (STATION_ID < 1 || STATION_ID > b->stationCount) break;
+
+      uint16_t myInv;
+      memcpy(&myInv, p + sizeof(LootTickBatchPayload) + (STATION_ID - 1) * sizeof(uint16_t), sizeof(myInv));
+
+      const uint8_t* e = p + sizeof(LootTickBatchPayload) + b->stationCount * sizeof(uint16_t);
+      if (holdActive) {
+        for (uint8_t i = 0; i < b->entryCount; ++i, e += sizeof(LootTickEntry)) {
+          LootTickEntry ent;
+          memcpy(&ent, e, sizeof(ent));
+          if (ent.holdId != holdId) continue;
+          applyLootTick(ent.holdId, ent.carried, myInv);
+          return;
+        }
+      }
+
+      // Not our tick: same as a STATION_UPDATE for our inventory
+      inv = myInv;
+      stationInited = true;
+      if (!gameActive || mgSwallowRepaints()) break;
+      if (!holdActive && !otaInProgress && canPaintGaugeNow()) drawGaugeAuto(inv, cap);
+      break;
+    }
+
+    case MsgTypeExt::STATION_INVENTORY: {
+      if (h->payloadLen < sizeof(StationInventoryPayload)) break;
+      const auto* p = (const StationInventoryPayload*)(data + sizeof(MsgHeader));
+      if (h->payloadLen != sizeof(StationInventoryPayload) + p->stationCount * sizeof(StationInvEntry)) break;
+      if (len < sizeof(MsgHeader) + h->payloadLen) break;
+      if (STATION_ID < 1 || STATION_ID > p->stationCount) break;
+
+      StationInvEntry e;
+      memcpy(&e, data + sizeof(MsgHeader) + sizeof(StationInventoryPayload)
+                      + (STATION_ID - 1) * sizeof(StationInvEntry), sizeof(e));
+      // While holding, LOOT_TICK(_BATCH) owns inv; a periodic refresh that
+      // crosses a tick in flight must not rewind the gauge.
+      if (holdActive && stationInited) { cap = e.capacity; break; }
+      applyStationInventory(e.inventory, e.capacity);
+      break;
+    }
+
+    default:
+      break;
+  }
+
   switch ((MsgType)h->type) {
     case MsgType::RADIO_CFG: {
       if (h->payloadLen != sizeof(RadioCfgPayload)) break;
@@ -84,10 +343,7 @@ void onRx(const uint8_t* data, uint16_t len) {
       const auto* p = (const RadioCfgPayload*)(data + sizeof(MsgHeader));
       gRadioCfgMsg = *p;
       gRadioCfgPending = true;
-      Serial.printf("[RADIO] RADIO_CFG received: chan=%u txFramed=%u rxLegacy=%u\n",
-                    (unsigned)p->wifiChannel,
-                    (unsigned)p->txFramed,
-                    (unsigned)p->rxLegacy);
+      evlog(EV_RADIO_CFG_RX, p->wifiChannel, p->txFramed, p->rxLegacy);
       break;
     }
 
@@ -107,7 +363,7 @@ void onRx(const uint8_t* data, uint16_t len) {
 
       if ((ControlOp)p->op == ControlOp::ENTER_MAINT) {
         maintRequested = true;
-        Serial.printf("[LOOT %u] CONTROL_CMD ENTER_MAINT received\n", (unsigned)myId);
+        evlog(EV_MAINT_REQUEST, myId);
       }
       break;
     }
@@ -116,33 +372,14 @@ void onRx(const uint8_t* data, uint16_t len) {
       if (h->payloadLen < 1) break;
       const StateTickPayload* p =
           (const StateTickPayload*)(data + sizeof(MsgHeader));
-
-      if      (p->state == (uint8_t)LightState::GREEN)  g_lightState = LightState::GREEN;
-      else if (p->state == (uint8_t)LightState::YELLOW) g_lightState = LightState::YELLOW;
-      else                                              g_lightState = LightState::RED;
-
-      if (g_lightState == LightState::YELLOW) yellowBlinkActive = true;
-      else                                    stopYellowBlink();
-
-      if (!gameActive) {
-        if (g_lightState == LightState::RED && !holdActive && !otaInProgress) fillRing(Adafruit_NeoPixel::Color(255,0,0));
-        break;
-      }
-
-      if (mgSwallowRepaints()) break;
-      if (stationInited && canPaintGaugeNow()) drawGaugeAuto(inv, cap);
+      if (!schedOverrides(p->state)) applyLightState(p->state);
       break;
     }
 
     case MsgType::ROUND_STATUS: {
       if (h->payloadLen != sizeof(RoundStatusPayload)) break;
       const auto* p = (const RoundStatusPayload*)(data + sizeof(MsgHeader));
-
-      // Safety: if MG_STOP was dropped but the server has already advanced into
-      // Round 5, leave the minigame anyway so normal gauge rendering resumes.
-      if (mgActive && p->roundIndex >= 5) {
-        mgStop();
-      }
+      applyRoundIndex(p->roundIndex);
       break;
     }
 
@@ -217,32 +454,7 @@ void onRx(const uint8_t* data, uint16_t len) {
       if (h->payloadLen != sizeof(LootTickPayload)) break;
       const auto* p = (const LootTickPayload*)(data + sizeof(MsgHeader));
       if (!holdActive || p->holdId != holdId) break;
-
-      carried = (p->carried > maxCarry) ? maxCarry : p->carried;
-      inv     = p->inventory;
-      stationInited = true;
-
-      if (tagPresent && inv == 0) startEmptyBlink();
-      else                        stopEmptyBlink();
-
-      if (carried >= maxCarry) {
-        if (!fullAnnounced || blinkHoldId != p->holdId) {
-          startFullBlinkImmediate();
-          fullAnnounced = true;
-          blinkHoldId   = p->holdId;
-          scheduleAudioStop(AUDIO_STOP_STAGGER_MS);
-        }
-      } else {
-        if (fullBlinkActive) stopFullBlink();
-        fullAnnounced = false;
-        drawRingCarried(carried, maxCarry);
-      }
-
-      uint32_t now = millis();
-      if ((int32_t)(now - nextGaugeDrawAtMs) >= 0 && canPaintGaugeNow()) {
-        drawGaugeAuto(inv, cap);
-        nextGaugeDrawAtMs = now + 20;
-      }
+      applyLootTick(p->holdId, p->carried, p->inventory);
       break;
     }
 
@@ -283,17 +495,7 @@ void onRx(const uint8_t* data, uint16_t len) {
       const auto* p = (const StationUpdatePayload*)(data + sizeof(MsgHeader));
       if (h->payloadLen != sizeof(StationUpdatePayload)) break;
       if (p->stationId != STATION_ID) break;
-
-      inv = p->inventory;
-      cap = p->capacity;
-      stationInited = true;
-
-      if (!gameActive) break;
-      if (mgSwallowRepaints()) break;
-
-      if (!holdActive && !otaInProgress && canPaintGaugeNow()) {
-        drawGaugeAuto(inv, cap);
-      }
+      applyStationInventory(p->inventory, p->capacity);
       break;
     }
 
@@ -311,7 +513,7 @@ void onRx(const uint8_t* data, uint16_t len) {
       stopFullBlink();
       stopEmptyBlink();
       fillRing(Adafruit_NeoPixel::Color(255,0,0));
-      Serial.println("[LOOT] GAME_START");
+      evlog(EV_GAME_START);
       break;
     }
 
@@ -334,6 +536,8 @@ void onRx(const uint8_t* data, uint16_t len) {
       const bool redViolation = (reason == GAMEOVER_REASON_RED_VIOLATION);
 
       s_isBonusNow = false;
+      bonusEndsAtServerMs = 0;
+      schedClear();
       g_lightState = success ? LightState::GREEN : LightState::RED;
       stopYellowBlink();
       stopEmptyBlink();
@@ -355,23 +559,22 @@ void onRx(const uint8_t* data, uint16_t len) {
         else         gameOverBlinkAndOff();
       }
 
-      Serial.printf("[LOOT] GAME_OVER reason=%u blame=%u me=%u\n",
-                    reason, blameSid, STATION_ID);
+      evlog(EV_GAME_OVER, reason, blameSid, STATION_ID);
       break;
     }
 
     case MsgType::CONFIG_UPDATE: {
       mgCancel();                     // OTA takes priority; cancel MG
       if (h->payloadLen != sizeof(ConfigUpdatePayload)) break;
-      if (gameActive) { Serial.println("[OTA] Ignored (game active)"); break; }
+      if (gameActive) { evlog(EV_OTA_GAME_ACTIVE); break; }
       const auto* p = (const ConfigUpdatePayload*)(data + sizeof(MsgHeader));
 
       bool typeMatch = (p->stationType == 0) || (p->stationType == (uint8_t)StationType::LOOT);
       bool idMatch   = (p->targetId == 0)    || (p->targetId == STATION_ID);
       if (!typeMatch || !idMatch) break;
 
-      if (otaInProgress) { Serial.println("[OTA] Already in progress"); break; }
-      if (p->otaUrl[0] == 0) { Serial.println("[OTA] No URL"); break; }
+      if (otaInProgress) { evlog(EV_OTA_BUSY); break; }
+      if (p->otaUrl[0] == 0) { evlog(EV_OTA_NO_URL); break; }
 
       strncpy(otaUrl, p->otaUrl, sizeof(otaUrl)-1); otaUrl[sizeof(otaUrl)-1]=0;
       otaCampaignId  = p->campaignId;
@@ -389,6 +592,14 @@ void onRx(const uint8_t* data, uint16_t len) {
       if (h->payloadLen != sizeof(MgStartPayload)) break;
       const auto* p = (const MgStartPayload*)(data + sizeof(MsgHeader));
 
+      // The server repeats MG_START with one seq; only the first copy starts it.
+      static uint16_t lastMgStartSeq = 0;
+      static uint32_t lastMgStartAt  = 0;
+      const uint32_t nowMs = millis();
+      if (mgActive && h->seq == lastMgStartSeq && (uint32_t)(nowMs - lastMgStartAt) < 1000) break;
+      lastMgStartSeq = h->seq;
+      lastMgStartAt  = nowMs;
+
       MgParams mp;
       mp.seed       = p->seed;
       mp.timerMs    = p->timerMs;
@@ -412,22 +623,7 @@ void onRx(const uint8_t* data, uint16_t len) {
                     | ((uint32_t)pl[1] << 8)
                     | ((uint32_t)pl[2] << 16)
                     | ((uint32_t)pl[3] << 24);
-
-      bool wasBonus = s_isBonusNow;
-      s_isBonusNow  = ((mask >> STATION_ID) & 0x1u) != 0;
-
-      if (mgActive) break; // swallow chime/paint during minigame
-
-      if (!wasBonus && s_isBonusNow) {
-        playBonusSpawnChime();
-        stopYellowBlink();
-        stopEmptyBlink();
-      }
-
-      if (gameActive && stationInited && !otaInProgress) {
-        gaugeCacheValid = false;
-        drawGaugeAuto(inv, cap);
-      }
+      applyBonusMask(mask);
       break;
     }
 
@@ -3,3 +3,10 @@
 
 // RX entry point used by Transport::init(cfg, onRx)
 void onRx(const uint8_t* data, uint16_t len);
+
+// Apply a LIGHT_SCHEDULE flip that has come due; every loop() pass
+void tickLightSchedule();
+
+// What this Loot currently believes, for STATE_HEARTBEAT (layout: TrexProtocolExt.h)
+struct StationDigest;
+void fillStateDigest(StationDigest& d);
@@ -0,0 +1,11 @@
+// Loot loop() sections for Profiler (no include guard: X-macro list).
+//
+// PROF(NAME, "label") -> PS_NAME. Order is print order only.
+
+PROF(LOOP,     "loop")       // whole pass, after the maintenance/OTA gates
+PROF(SERIAL,   "serial")     // processIdentitySerial
+PROF(NET,      "net")        // Transport::loop
+PROF(RFID,     "rfid")       // PICC_WakeupA presence probe (+ UID read on arrival)
+PROF(AUDIO,    "audio")      // handleAudio + idle stop
+PROF(LEDS,     "leds")       // blink / rainbow ticks
+PROF(MINIGAME, "minigame")   // mgLoop
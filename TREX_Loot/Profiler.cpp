@@ -0,0 +1,69 @@
+#include "Profiler.h"
+#include <string.h>
+
+static const char* const kLabels[PS_COUNT] = {
+#define PROF(name, label) label,
+#include "ProfSections.h"
+#undef PROF
+};
+
+#if TREX_PROF
+struct ProfStat {
+  uint32_t count;
+  uint64_t sum;
+  uint32_t min;
+  uint32_t max;
+  uint32_t hist[PROF_BUCKETS];
+};
+
+static ProfStat sStat[PS_COUNT];
+static uint32_t sSinceMs = 0;
+
+void profAdd(ProfId id, uint32_t cycles) {
+  ProfStat& s = sStat[id];
+  if (!s.count || cycles < s.min) s.min = cycles;
+  if (cycles > s.max) s.max = cycles;
+  s.count++;
+  s.sum += cycles;
+  s.hist[cycles ? 31 - __builtin_clz(cycles) : 0]++;
+}
+
+void profReset() {
+  memset(sStat, 0, sizeof(sStat));
+  sSinceMs = millis();
+}
+
+// Upper edge (cycles) of the bucket holding the 99th-percentile sample
+static uint32_t p99Cycles(const ProfStat& s) {
+  const uint32_t want = s.count - s.count / 100;   // samples at or below p99
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < PROF_BUCKETS; ++b) {
+    seen += s.hist[b];
+    if (seen >= want) {
+      const uint32_t edge = (b >= 31) ? 0xFFFFFFFFu : ((2u << b) - 1);
+      return (edge < s.max) ? edge : s.max;
+    }
+  }
+  return s.max;
+}
+
+void profPrint(Print& out) {
+  const float mhz = (float)ESP.getCpuFreqMHz();
+  out.printf("prof: %lus window, %u MHz, us\n",
+             (unsigned long)((millis() - sSinceMs) / 1000), (unsigned)mhz);
+  out.printf("%-12s %8s %8s %8s %8s %8s\n", "section", "count", "min", "avg", "p99<=", "max");
+  for (uint8_t i = 0; i < PS_COUNT; ++i) {
+    const ProfStat& s = sStat[i];
+    if (!s.count) continue;
+    out.printf("%-12s %8lu %8.1f %8.1f %8.1f %8.1f\n", kLabels[i], (unsigned long)s.count,
+               s.min / mhz, (float)((double)s.sum / s.count) / mhz,
+               p99Cycles(s) / mhz, s.max / mhz);
+  }
+}
+#else
+void profPrint(Print& out) {
+  out.printf("prof: disabled (built with TREX_PROF=0), %u sections\n", (unsigned)PS_COUNT);
+  (void)kLabels;
+}
+void profReset() {}
+#endif
@@ -0,0 +1,58 @@
+#include "StateHeartbeat.h"
+#include <string.h>
+#include <esp_random.h>
+
+static bool     sEverSent      = false;
+static uint32_t sSentHash      = 0;
+static uint32_t sSentAtMs      = 0;
+static bool     sChangePending = false;
+static uint32_t sChangeDueMs   = 0;
+static volatile bool sResynced = false;
+
+static uint32_t sSent[4] = { 0, 0, 0, 0 };   // by STATE_HB_*
+
+void stateHbResynced() {
+  sResynced = true;
+}
+
+bool stateHbDue(uint32_t nowMs, const StationDigest& d, StateHeartbeatPayload& out) {
+  const uint32_t h = trexDigestHash(d);
+
+  uint8_t reason;
+  if (!sEverSent) {
+    sResynced = false;
+    reason = STATE_HB_BOOT;
+  } else if (sResynced) {
+    sResynced = false;
+    reason = STATE_HB_RESYNCED;
+  } else if (nowMs - sSentAtMs >= STATE_HB_PERIOD_MS) {
+    reason = STATE_HB_PERIODIC;
+  } else if (h != sSentHash) {
+    if (!sChangePending) {
+      sChangePending = true;
+      sChangeDueMs   = nowMs + esp_random() % (STATE_HB_JITTER_MS + 1);
+    }
+    if ((int32_t)(nowMs - sChangeDueMs) < 0) return false;
+    reason = STATE_HB_CHANGED;
+  } else {
+    sChangePending = false;   // changed and changed back before it went out
+    return false;
+  }
+
+  sChangePending = false;
+  sEverSent = true;
+  sSentHash = h;
+  sSentAtMs = nowMs;
+  sSent[reason]++;
+
+  out.stateHash = h;
+  out.reason    = reason;
+  memset(out._pad, 0, sizeof(out._pad));
+  return true;
+}
+
+void stateHbPrint(Print& out) {
+  out.printf("hb hash=%08lx sent periodic=%lu changed=%lu resynced=%lu\n",
+             (unsigned long)sSentHash, (unsigned long)sSent[STATE_HB_PERIODIC],
+             (unsigned long)sSent[STATE_HB_CHANGED], (unsigned long)sSent[STATE_HB_RESYNCED]);
+}
@@ -2,7 +2,7 @@
 #include <ArduinoJson.h>
 
 struct StationCfg {
-  uint8_t stationId   = 0;       // 1..5 for Loot stations
+  uint8_t stationId   = 0;       // 1..TREX_MAX_LOOT_STATIONS for Loot stations
   uint8_t wifiChannel = 6;       // must match T-Rex / ESP-NOW
   char    hostname[32] = "Loot-0";
 };
@@ -52,6 +52,8 @@
 #include "LootRx.h"
 #include "LootLeds.h"
 #include "LootMini.h"
+#include "EventLog.h"
+#include "Profiler.h"
 
 /* ---------- Wi-Fi (Maintenance / OTA HTTP) ---------- */
 const char* WIFI_SSID  = "AndrewiPhone";
@@ -154,9 +156,8 @@ constexpr uint32_t ABSENCE_MS = 150;   // debounce removal
 bool          tagPresent      = false;
 uint32_t      absentStartMs   = 0;
 
-// ── Bonus warning blink (last 3s of intermission) ──────────────────────────
-constexpr uint32_t BONUS_WARN_MS         = 3000;  // blink when msLeft <= this
-constexpr uint32_t BONUS_BLINK_PERIOD_MS = 220;   // ~4.5 Hz
+/* ── HELLO (server learns our MAC for unicast) ───────── */
+constexpr uint32_t HELLO_PERIOD_MS = 15000;
 
 /* ── Game/h
  state (server-auth) ───────────────────── */
@@ -273,6 +274,7 @@ void setup() {
   }
 
   transportReady = true;
+  sendHello();
 
   Serial.printf("Trex proto ver: %d\n", TREX_PROTO_VERSION);
   drawGaugeInventory(inv, cap);
@@ -281,7 +283,11 @@ void setup() {
 /* ── loop ────────────────────────────────────────────── */
 void loop() {
   // identity serial (non-blocking)
-  processIdentitySerial();
+  {
+    PROF_SCOPE(PS_SERIAL);
+    processIdentitySerial();
+  }
+  evlogPump(Serial);
 
   if (gRadioCfgPending) {
     gRadioCfgPending = false;
@@ -331,14 +337,23 @@ void loop() {
   // While OTA runs, keep spinner and skip the rest of the logic
   if (otaInProgress) { otaTickSpinner(); return; }
 
+  PROF_SCOPE(PS_LOOP);
+
   // While the minigame is active, it owns the gauge and input
   if (mgActive) {
-    mgLoop();
+    {
+      PROF_SCOPE(PS_MINIGAME);
+      mgLoop();
+    }
 
+    PROF_BEGIN(PS_AUDIO);
     if (playing) handleAudio();
     tickScheduledAudio();
+    PROF_END(PS_AUDIO);
 
+    PROF_BEGIN(PS_NET);
     Transport::loop();
+    PROF_END(PS_NET);
     if (transportReady && otaSuccessReportPending && millis() >= otaSuccessSendAt) {
       sendOtaStatus(OtaPhase::SUCCESS, 0, 0, 0);
       otaClearFile();
@@ -348,7 +363,10 @@ void loop() {
   }
 
   // Now normal networking
+  PROF_BEGIN(PS_NET);
   Transport::loop();
+  PROF_END(PS_NET);
+  tickLightSchedule();
 
   // Deferred SUCCESS (after ESPNOW is re-initialized)
   if (transportReady && otaSuccessReportPending && millis() >= otaSuccessSendAt) {
@@ -357,6 +375,18 @@ void loop() {
     otaSuccessReportPending = false;
   }
 
+  // Re-announce now and then so a rebooted server re-learns our MAC
+  static uint32_t lastHelloMs = 0;
+  if (transportReady && millis() - lastHelloMs >= HELLO_PERIOD_MS) {
+    lastHelloMs = millis();
+    sendHello();
+  }
+
+  // Server clock (ClockSync): fast until synced, then every couple of seconds
+  if (transportReady) tickClockSync();
+  // What we believe, hashed, so the server can resync us if we missed something
+  if (transportReady) tickStateHeartbeat();
+
   // ---- PAUSED / GAME OVER: only listen for messages ----
   if (!gameActive && !otaInProgress) {
     if (!wasPaused) {
@@ -377,11 +407,15 @@ void loop() {
   // ---- NORMAL ACTIVE LOOP ----
   const uint32_t now = millis();
 
+  PROF_BEGIN(PS_RFID);
   const bool present = isAnyCardPresent(rfid);
+  const bool gotUid  = (present && !tagPresent) && readUid(rfid, currentUid);
+  PROF_END(PS_RFID);
+  tickLightSchedule();   // the probe is the long part of a pass; don't sit on a due flip
 
   // ARRIVAL
   if (present && !tagPresent) {
-    if (readUid(rfid, currentUid)) {
+    if (gotUid) {
       tagPresent    = true;
       absentStartMs = 0;
       carried       = 0;
@@ -414,17 +448,21 @@ void loop() {
   }
 
   // Audio keep-alive
+  PROF_BEGIN(PS_AUDIO);
   if (playing) handleAudio();
 
   // In normal (looping) mode, stop audio if no active hold
   if (!g_audioOneShot && !holdActive && playing) {
     stopAudio();
   }
+  PROF_END(PS_AUDIO);
 
+  PROF_BEGIN(PS_LEDS);
   tickFullBlink();
   tickYellowBlink();
   tickEmptyBlink();
   tickBonusRainbow();
   tickIdleRfidBlink();
+  PROF_END(PS_LEDS);
   tickScheduledAudio();
 }
@@ -13,4 +13,4 @@ void tickBonusDirector(Game& g, uint32_t now);
 
 // Apply "instant-drain" at LOOT_HOLD_START if station is bonus.
 // Returns true if the hold ended immediately (FULL or EMPTY).
-bool applyBonusOnHoldStart(Game& g, uint8_t playerIdx, uint8_t stationId, uint32_t holdId);
+bool applyBonusOnHoldStart(Game& g, uint16_t playerIdx, uint8_t stationId, uint32_t holdId);
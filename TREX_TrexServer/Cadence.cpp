@@ -1,79 +1,266 @@
-#include <esp_random.h>
 #include "Cadence.h"
 #include "Media.h"
 #include "Net.h"
 #include "GameAudio.h"
 #include "Bonus.h"
+#include "EventLog.h"
+#include "Timers.h"
+#include "RoundTable.h"
+#include "Profiler.h"
 
-static inline uint32_t pickDur(uint32_t base, uint32_t mn, uint32_t mx) {
+static inline uint32_t pickDur(Game& g, uint32_t base, uint32_t mn, uint32_t mx) {
   if (mn && mx && mx >= mn) {
-    uint32_t span = mx - mn + 1;
-    return mn + (esp_random() % span);
+    return rngRange(g.rng, mn, mx);
   }
   return base;
 }
 
-void enterGreen(Game& g) {
-  g.light = LightState::GREEN;
-  g.nextSwitch = millis() + pickDur(g.greenMs, g.greenMsMin, g.greenMsMax);
-  g.lastFlipMs = millis();
-  spritePlay(CLIP_NOT_LOOKING);
-  Serial.println("[TREX] -> GREEN");
-  if (gameAudioCurrentTrack() != TRK_TREX_WIN) {
-    gameAudioStop();
+// ---- Pre-drawn cadence ----
+// Every segment (light + duration, incl. the R4 bounce draw) is drawn
+// CADENCE_PLAN_LEN flips ahead and the lot goes out as LIGHT_SCHEDULE, so the
+// stations flip on their own at the planned server time. A cadence flip just
+// takes the plan's head and draws one more at the tail; any other flip (round
+// start, life loss, manual) or a rule change under a running plan redraws it
+// from now under a new epoch, and that correction is the only thing stations
+// have to catch.
+struct Segment {
+  LightState light;
+  uint32_t   at;     // planned start (millis)
+  uint32_t   dur;
+};
+static Segment  sCur{};                     // the segment g.light is in
+static Segment  sPlan[CADENCE_PLAN_LEN];    // what follows it; sPlan[0].at == g.nextSwitch
+static uint8_t  sPlanN = 0;
+static uint16_t sEpoch = 0;
+static_assert(1 + CADENCE_PLAN_LEN <= LIGHT_SCHEDULE_MAX, "current + plan must fit one LIGHT_SCHEDULE");
+
+// What follows `s` held for `dur` under this round's rules
+static LightState successor(const Game& g, LightState s, uint32_t dur) {
+  if (g.noRedThisRound) {
+    return (g.allowYellowThisRound && s == LightState::GREEN) ? LightState::YELLOW : LightState::GREEN;
   }
-  // Immediate state broadcast
-  uint32_t now = millis();
-  uint32_t msLeft = (g.nextSwitch > now) ? (g.nextSwitch - now) : 0;
-  uint32_t toRoundEnd = (g.roundEndAt > now) ? (g.roundEndAt - now) : 0xFFFFFFFFUL;
-  uint32_t toGameEnd  = (g.gameEndAt  > now) ? (g.gameEndAt  - now) : 0xFFFFFFFFUL;
-  if (toRoundEnd < msLeft) msLeft = toRoundEnd;
-  if (toGameEnd  < msLeft) msLeft = toGameEnd;
-  sendStateTick(g, msLeft);
-  bcastGameStatus(g);
+  if (s == LightState::GREEN) return LightState::YELLOW;
+  if (s == LightState::YELLOW) {
+    if (roundDesc(g.roundIndex).yellowBouncePct) {
+      const uint32_t yBase = g.yellowMs ? g.yellowMs : 3000;
+      return (dur < yBase) ? LightState::GREEN : LightState::RED;   // a short YELLOW is a bounce
+    }
+    return LightState::RED;
+  }
+  return LightState::GREEN;
 }
 
-void enterYellow(Game& g) {
-  g.light      = LightState::YELLOW;
-  uint32_t now = millis();
+static uint32_t drawDur(Game& g, LightState s) {
+  if (s == LightState::GREEN) return pickDur(g, g.greenMs, g.greenMsMin, g.greenMsMax);
+  if (s == LightState::RED)   return pickDur(g, g.redMs, g.redMsMin, g.redMsMax);
+
+  const uint8_t bouncePct = roundDesc(g.roundIndex).yellowBouncePct;
+  if (!bouncePct) return pickDur(g, g.yellowMs, g.yellowMsMin, g.yellowMsMax);
+
+  const bool bounce = (rngBelow(g.rng, 100) < bouncePct); // fake-out: YELLOW falls back to GREEN
+  const uint32_t yBase = g.yellowMs ? g.yellowMs : 3000; // RED path = exactly this
+  if (!bounce) return yBase;                             // non-bounce path: fixed yBase ⇒ will go to RED
+  // Use your 1500–3000 window but clamp max to (yBase - 1) to avoid overlap
+  uint32_t yMin = g.yellowMsMin ? g.yellowMsMin : 1500;
+  uint32_t yMax = g.yellowMsMax ? g.yellowMsMax : 3000;
+  if (yMax >= yBase) yMax = (yBase > 0 ? yBase - 1 : 0); // ⇒ 1500..2999
+  if (yMin > yMax)   yMin = yMax;                        // safety clamp
+  return pickDur(g, /*base*/0, yMin, yMax);
+}
+
+static void topUpPlan(Game& g) {
+  while (sPlanN < CADENCE_PLAN_LEN) {
+    const Segment& last = sPlanN ? sPlan[sPlanN - 1] : sCur;
+    Segment n;
+    n.light = successor(g, last.light, last.dur);
+    n.at    = last.at + last.dur;
+    n.dur   = drawDur(g, n.light);
+    sPlan[sPlanN++] = n;
+  }
+}
+
+static bool sViaCadence = false;            // tickCadence is flipping
+
+// Start the segment for g.light: the plan's head on a cadence flip, a fresh
+// draw (and epoch) otherwise. Returns true when the plan was redrawn.
+static bool beginSegment(Game& g) {
+  const uint32_t now = millis();
+  const bool fromPlan = sViaCadence && sPlanN && sPlan[0].light == g.light;
+  if (fromPlan) {
+    sCur = sPlan[0];
+    for (uint8_t i = 1; i < sPlanN; ++i) sPlan[i - 1] = sPlan[i];
+    sPlanN--;
+  } else {
+    sPlanN = 0;
+    sEpoch++;
+    sCur = Segment{ g.light, now, drawDur(g, g.light) };
+  }
+  topUpPlan(g);
+
   g.lastFlipMs = now;
+  g.nextSwitch = sCur.at + sCur.dur;
+  timerArm(TMR_CADENCE, g.nextSwitch);
+  return !fromPlan;
+}
+
+// Current segment + plan to the stations. A correction has to reach all of
+// them; a cadence flip only extends a schedule they already hold.
+static void publishPlan(Game& g, bool corrected) {
+  LightScheduleEntry e[1 + CADENCE_PLAN_LEN];
+  e[0] = LightScheduleEntry{ sCur.at, (uint8_t)sCur.light };
+  for (uint8_t i = 0; i < sPlanN; ++i) e[1 + i] = LightScheduleEntry{ sPlan[i].at, (uint8_t)sPlan[i].light };
+  if (corrected) bcastLightSchedule(g, sEpoch, e, 1 + sPlanN, /*copies=*/3, /*gapMs=*/12);
+  else           bcastLightSchedule(g, sEpoch, e, 1 + sPlanN);
+}
+
+// What tickCadence will flip to when g.nextSwitch comes up
+static LightState nextLight(const Game& g) {
+  if (sPlanN) return sPlan[0].light;
+  return successor(g, g.light, g.nextSwitch - g.lastFlipMs);   // restored snapshot: nothing drawn yet
+}
+
+uint16_t cadenceEpoch() { return sEpoch; }
+
+// ---- Light media cues ----
+// A flip's sprite clip and DY track are lined up on the moment the station
+// rings change, i.e. flip + LEDS lag (Media.h). An output slower than the
+// rings goes out that much *before* a cadence flip, whose time and colour
+// are known as soon as the previous flip arms it; a quicker one is held
+// back after the flip. Flips nothing scheduled (round start, life loss,
+// manual) can't be anticipated, so their slow outputs just go out now.
+enum : uint8_t { OUT_SPRITE = 0, OUT_AUDIO = 1, OUT_N = 2 };
+static const MediaOut kOut[OUT_N] = { MediaOut::SPRITE, MediaOut::AUDIO };
+
+static LightState sCueLight[OUT_N];            // what each armed TMR_CUE_* plays
+static LightState sPreLight   = LightState::GREEN;
+static bool       sPreValid   = false;         // early outputs cued for sPreLight at g.nextSwitch
+static uint32_t   sRedSeenMs  = 0;             // last RED: flip -> the room sees it
+
+static bool hasMedia(LightState s, uint8_t out) {
+  return !(s == LightState::YELLOW && out == OUT_SPRITE);   // YELLOW keeps the GREEN clip
+}
+
+static void playLightMedia(LightState s, uint8_t out, uint32_t at = 0) {
+  if (out == OUT_SPRITE) {
+    spritePlay(s == LightState::RED ? CLIP_LOOKING : CLIP_NOT_LOOKING, at);
+    return;
+  }
+  switch (s) {
+    case LightState::GREEN:
+      if (gameAudioCurrentTrack() != TRK_TREX_WIN) gameAudioStop(at);
+      break;
+    case LightState::YELLOW: gameAudioPlayOnce(TRK_TICKS_LOOP, at);         break;
+    case LightState::RED:    gameAudioPlayOnce(TRK_PLAYERS_STAY_STILL, at); break;
+    default: break;
+  }
+}
 
-  if (g.roundIndex == 4) {
-    const bool bounce = ((esp_random() % 100) < 50); // ~25% fake-out
-    const uint32_t yBase = g.yellowMs ? g.yellowMs : 3000; // RED path = exactly this
-    if (bounce) {
-      // Use your 1500–3000 window but clamp max to (yBase - 1) to avoid overlap
-      uint32_t yMin = g.yellowMsMin ? g.yellowMsMin : 1500;
-      uint32_t yMax = g.yellowMsMax ? g.yellowMsMax : 3000;
-      if (yMax >= yBase) yMax = (yBase > 0 ? yBase - 1 : 0); // ⇒ 1500..2999
-      if (yMin > yMax)   yMin = yMax;                        // safety clamp
-      g.nextSwitch = now + pickDur(/*base*/0, yMin, yMax);
+void cadenceCancelCues() {
+  for (uint8_t o = 0; o < OUT_N; ++o) timerCancel(TMR_CUE_SPRITE + o);
+  sPreValid = false;
+}
+
+// Media for the light just entered; returns flip -> seen (ms)
+static uint32_t lightMedia(Game& g, LightState s) {
+  const uint32_t now = g.lastFlipMs;
+  const uint16_t led = mediaLagMs(MediaOut::LEDS);
+  const bool cued = sViaCadence && sPreValid && sPreLight == s;
+  if (!cued) cadenceCancelCues();   // early outputs were lined up for some other flip
+  sPreValid = false;
+
+  uint32_t seen = led;
+  for (uint8_t o = 0; o < OUT_N; ++o) {
+    if (!hasMedia(s, o)) continue;
+    const uint16_t lag = mediaLagMs(kOut[o]);
+    if (lag > led) {
+      if (cued) continue;                        // went out ahead of this flip
+      playLightMedia(s, o);
+      if (lag > seen) seen = lag;
     } else {
-      // Non-bounce path: fixed yBase (e.g., 3000 ms) ⇒ will go to RED
-      g.nextSwitch = now + yBase;
+      playLightMedia(s, o, (lag < led) ? now + (led - lag) : 0);
     }
-  } else {
-    g.nextSwitch = now + pickDur(g.yellowMs, g.yellowMsMin, g.yellowMsMax);
   }
+  return seen;
+}
+
+// Arm the early outputs for the flip at g.nextSwitch
+static void cueNextFlip(Game& g) {
+  const LightState next = nextLight(g);
+  const uint16_t led = mediaLagMs(MediaOut::LEDS);
+  for (uint8_t o = 0; o < OUT_N; ++o) {
+    const uint16_t lag = mediaLagMs(kOut[o]);
+    if (lag <= led || !hasMedia(next, o)) continue;
+    sCueLight[o] = next;
+    timerArm(TMR_CUE_SPRITE + o, g.nextSwitch - (lag - led));   // already due: fires next pass
+  }
+  sPreLight = next;
+  sPreValid = true;
+}
+
+void tickLightCues(Game& g) {
+  // Only while the cadence runs: an intermission/minigame/game end means
+  // the flip these were for isn't coming
+  const bool live = (g.phase == Phase::PLAYING) && !g.mgActive &&
+                    !g.bonusIntermission && !g.bonusIntermission2;
+  for (uint8_t o = 0; o < OUT_N; ++o) {
+    if (timerTake(TMR_CUE_SPRITE + o) && live) playLightMedia(sCueLight[o], o);
+  }
+}
 
-  Serial.println("[TREX] -> YELLOW");
-  gameAudioPlayOnce(TRK_TICKS_LOOP);
+void cadenceRearmPir(Game& g) {
+  g.pirArmAt = g.lastFlipMs + sRedSeenMs + g.pirArmDelayMs;
+}
 
-  uint32_t msLeft = (g.nextSwitch > now) ? (g.nextSwitch - now) : 0;
-  uint32_t toRoundEnd = (g.roundEndAt > now) ? (g.roundEndAt - now) : 0xFFFFFFFFUL;
-  uint32_t toGameEnd  = (g.gameEndAt  > now) ? (g.gameEndAt  - now) : 0xFFFFFFFFUL;
-  if (toRoundEnd < msLeft) msLeft = toRoundEnd;
-  if (toGameEnd  < msLeft) msLeft = toGameEnd;
-  sendStateTick(g, msLeft);
-  bcastGameStatus(g);
+void cadenceReplan(Game& g) {
+  if (!sPlanN) sCur = Segment{ g.light, g.lastFlipMs, g.nextSwitch - g.lastFlipMs };
+  sPlanN = 0;
+  sEpoch++;
+  topUpPlan(g);
+  cadenceCancelCues();
+  cueNextFlip(g);
+  publishPlan(g, /*corrected=*/true);
+}
+
+void cadencePrintPlan(Print& out) {
+  static const char* const kName[] = { "G", "R", "Y" };
+  const uint32_t now = millis();
+  out.printf("cadence epoch=%u now:%s", (unsigned)sEpoch, kName[(uint8_t)sCur.light % 3]);
+  for (uint8_t i = 0; i < sPlanN; ++i) {
+    out.printf(" +%ld:%s", (long)(int32_t)(sPlan[i].at - now), kName[(uint8_t)sPlan[i].light % 3]);
+  }
+  out.print("\n");
+}
+
+void enterGreen(Game& g) {
+  PROF_BEGIN(PS_FLIP);
+  g.light = LightState::GREEN;
+  const bool corrected = beginSegment(g);
+  evlog(EV_LIGHT_GREEN);
+  lightMedia(g, LightState::GREEN);
+  cueNextFlip(g);
+  // Immediate state broadcast
+  PROF_END(PS_FLIP);
+  bcastWorldFrame(g);
+  publishPlan(g, corrected);
+}
+
+void enterYellow(Game& g) {
+  PROF_BEGIN(PS_FLIP);
+  g.light = LightState::YELLOW;
+  const bool corrected = beginSegment(g);   // bounce or not was drawn with the segment
+  evlog(EV_LIGHT_YELLOW);
+  lightMedia(g, LightState::YELLOW);
+  cueNextFlip(g);
+  PROF_END(PS_FLIP);
+  bcastWorldFrame(g);
+  publishPlan(g, corrected);
 }
 
 void enterRed(Game& g) {
-  g.light  = LightState::RED;
-  g.nextSwitch  = millis() + pickDur(g.redMs, g.redMsMin, g.redMsMax);
-  g.lastFlipMs  = millis();
+  PROF_BEGIN(PS_FLIP);
+  g.light = LightState::RED;
+  const bool corrected = beginSegment(g);
   g.redGraceUntil = g.lastFlipMs + g.redHoldGraceMs;
-  g.pirArmAt      = g.lastFlipMs + g.pirArmDelayMs;
 
   // New RED period begins: allow at most one motion-input life loss this RED.
   // Reset the input edge tracker so a fresh LOW seen after the arm window counts
@@ -87,17 +274,13 @@ void enterRed(Game& g) {
     }
   }
 
-  spritePlay(CLIP_LOOKING);
-  Serial.println("[TREX] -> RED");
-  gameAudioPlayOnce(TRK_PLAYERS_STAY_STILL);
-  uint32_t now = millis();
-  uint32_t msLeft = (g.nextSwitch > now) ? (g.nextSwitch - now) : 0;
-  uint32_t toRoundEnd = (g.roundEndAt > now) ? (g.roundEndAt - now) : 0xFFFFFFFFUL;
-  uint32_t toGameEnd  = (g.gameEndAt  > now) ? (g.gameEndAt  - now) : 0xFFFFFFFFUL;
-  if (toRoundEnd < msLeft) msLeft = toRoundEnd;
-  if (toGameEnd  < msLeft) msLeft = toGameEnd;
-  sendStateTick(g, msLeft);
-  bcastGameStatus(g);
+  evlog(EV_LIGHT_RED);
+  sRedSeenMs = lightMedia(g, LightState::RED);
+  cadenceRearmPir(g);   // the arm delay runs from when the room sees RED
+  cueNextFlip(g);
+  PROF_END(PS_FLIP);
+  bcastWorldFrame(g);
+  publishPlan(g, corrected);
 }
 
 void tickCadence(Game& g, uint32_t now) {
@@ -106,29 +289,14 @@ void tickCadence(Game& g, uint32_t now) {
   // bonus scheduler/expiry
   tickBonusDirector(g, now);
 
-  if (now < g.nextSwitch) return;
+  if (!timerTake(TMR_CADENCE)) return;   // g.nextSwitch reached
 
-  if (g.noRedThisRound) {
-    if (g.allowYellowThisRound) {
-      (g.light == LightState::GREEN) ? enterYellow(g) : enterGreen(g);
-    } else {
-      enterGreen(g);
-    }
-    return;
+  sViaCadence = true;
+  switch (nextLight(g)) {
+    case LightState::GREEN:  enterGreen(g);  break;
+    case LightState::YELLOW: enterYellow(g); break;
+    case LightState::RED:    enterRed(g);    break;
+    default:                 enterGreen(g);  break;
   }
-
-  if (g.light == LightState::GREEN) { enterYellow(g); return; }
-
-  if (g.light == LightState::YELLOW) {
-    if (g.roundIndex == 4) {
-      const uint32_t yBase = g.yellowMs ? g.yellowMs : 3000;
-      const uint32_t dur   = g.nextSwitch - g.lastFlipMs;
-      (dur < yBase) ? enterGreen(g) : enterRed(g);
-    } else {
-      enterRed(g);
-    }
-    return;
-  }
-
-  enterGreen(g);
+  sViaCadence = false;
 }
@@ -6,3 +6,14 @@ void enterGreen(Game& g);
 void enterYellow(Game& g);
 void enterRed(Game& g);
 void tickCadence(Game& g, uint32_t now);
+
+// Segments drawn ahead and sent as LIGHT_SCHEDULE (see Cadence.cpp)
+void     cadenceReplan(Game& g);   // cadence rules changed without a flip: redraw, new epoch
+uint16_t cadenceEpoch();           // WORLD_FRAME.schedEpoch
+void     cadencePrintPlan(Print& out);
+
+// Light media lined up across outputs by their measured lag (see Cadence.cpp)
+void tickLightCues(Game& g);     // every loop() pass, right after timersRun
+void cadenceCancelCues();        // drop media cued for the next flip (lag retuned)
+// pirArmAt = RED flip + time for the room to see it + pirArmDelayMs
+void cadenceRearmPir(Game& g);
@@ -0,0 +1,14 @@
+// Server event ids for EventLog (no include guard: this is an X-macro list).
+//
+// EVT(id, NAME, "text format")
+//   - ids are what goes on the wire: never renumber or reuse one.
+//   - args are rendered in order a, b, c, d, all as unsigned long (%lu).
+//   - tools/evlog_decode.py parses this file, keep one EVT per line.
+
+EVT(1, LIGHT_GREEN,  "[TREX] -> GREEN")
+EVT(2, LIGHT_YELLOW, "[TREX] -> YELLOW")
+EVT(3, LIGHT_RED,    "[TREX] -> RED")
+EVT(4, SPRITE_PLAY,  "[TREX] Sprite -> play clip %lu")
+EVT(5, BONUS_VACUUM, "[BONUS VACUUM] sid=%lu took=%lu carry %lu->%lu")
+EVT(6, LIFE_LOST,    "[TREX] LIFE LOST reason=%lu blameSid=%lu lives=%lu/%lu")
+EVT(7, HELLO,        "[TREX] HELLO from station %lu")
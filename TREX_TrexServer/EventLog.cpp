@@ -0,0 +1,111 @@
+#include "EventLog.h"
+#include <freertos/FreeRTOS.h>
+
+static_assert((EVLOG_CAPACITY & (EVLOG_CAPACITY - 1)) == 0, "EVLOG_CAPACITY must be a power of two");
+static_assert(sizeof(EvRec) == 16, "EvRec is a 16-byte wire record");
+
+static EvRec    sRing[EVLOG_CAPACITY];
+static uint32_t sHead    = 0;   // records ever written
+static uint32_t sTail    = 0;   // next record to drain
+static uint32_t sDropped = 0;
+static EvDrain  sMode    = EvDrain::TEXT;
+static portMUX_TYPE sMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Max records handed to the port per evlogPump() call, so a backlog can't
+// turn into one long loop() pass.
+static const uint8_t PUMP_MAX_RECORDS = 8;
+
+static const char* evFormat(uint8_t id) {
+  switch (id) {
+#define EVT(id, name, fmt) case id: return fmt;
+#include "EventIds.h"
+#undef EVT
+    default: return nullptr;
+  }
+}
+
+void evlog(EvId id, uint8_t a, uint16_t b, uint32_t c, uint32_t d) {
+  EvRec r;
+  r.t  = millis();
+  r.id = (uint8_t)id;
+  r.a  = a;
+  r.b  = b;
+  r.c  = c;
+  r.d  = d;
+
+  portENTER_CRITICAL(&sMux);
+  sRing[sHead & (EVLOG_CAPACITY - 1)] = r;
+  sHead++;
+  if (sHead - sTail > EVLOG_CAPACITY) {
+    sTail = sHead - EVLOG_CAPACITY;   // oldest undrained record was overwritten
+    sDropped++;
+  }
+  portEXIT_CRITICAL(&sMux);
+}
+
+static bool popRec(EvRec& out) {
+  bool ok = false;
+  portENTER_CRITICAL(&sMux);
+  if (sTail != sHead) {
+    out = sRing[sTail & (EVLOG_CAPACITY - 1)];
+    sTail++;
+    ok = true;
+  }
+  portEXIT_CRITICAL(&sMux);
+  return ok;
+}
+
+static void renderText(Print& out, const EvRec& r) {
+  const char* fmt = evFormat(r.id);
+  if (!fmt) {
+    out.printf("[EVLOG] unknown id=%u\n", (unsigned)r.id);
+    return;
+  }
+  out.printf(fmt, (unsigned long)r.a, (unsigned long)r.b,
+                  (unsigned long)r.c, (unsigned long)r.d);
+  out.print('\n');
+}
+
+void evlogPump(Print& out) {
+  if (sMode == EvDrain::OFF) return;
+
+  // Only hand over what the port can buffer right now; a text line is well
+  // under 96 bytes, a binary frame is 18.
+  const int need = (sMode == EvDrain::BIN) ? (int)(2 + sizeof(EvRec)) : 96;
+
+  EvRec r;
+  for (uint8_t n = 0; n < PUMP_MAX_RECORDS; ++n) {
+    if (out.availableForWrite() < need) break;
+    if (!popRec(r)) break;
+
+    if (sMode == EvDrain::BIN) {
+      const uint8_t sync[2] = { EVLOG_SYNC0, EVLOG_SYNC1 };
+      out.write(sync, sizeof(sync));
+      out.write((const uint8_t*)&r, sizeof(r));
+    } else {
+      renderText(out, r);
+    }
+  }
+}
+
+void evlogSetDrain(EvDrain mode) { sMode = mode; }
+EvDrain evlogDrainMode()         { return sMode; }
+uint32_t evlogDropped()          { return sDropped; }
+
+void evlogDump(Print& out) {
+  portENTER_CRITICAL(&sMux);
+  const uint32_t head  = sHead;
+  portEXIT_CRITICAL(&sMux);
+  uint32_t i = (head > EVLOG_CAPACITY) ? (head - EVLOG_CAPACITY) : 0;
+
+  out.printf("evlog: %lu records, %lu dropped\n",
+             (unsigned long)(head - i), (unsigned long)sDropped);
+  for (; i < head; ++i) {
+    EvRec r;
+    portENTER_CRITICAL(&sMux);
+    r = sRing[i & (EVLOG_CAPACITY - 1)];
+    portEXIT_CRITICAL(&sMux);
+    out.printf("%8lu ", (unsigned long)r.t);
+    renderText(out, r);
+  }
+}
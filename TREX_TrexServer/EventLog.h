@@ -0,0 +1,52 @@
+#pragma once
+// Compact binary event log.
+//
+// Hot paths call evlog(EV_xxx, ...) instead of Serial.printf: that's a 16-byte
+// copy into a RAM ring, no formatting, no UART. evlogPump() drains the ring
+// from loop() only as fast as the port can take without blocking, either as
+// the usual text lines or as binary frames for tools/evlog_decode.py.
+//
+// The events themselves (id, name, text format) live in EventIds.h, which is
+// per sketch. EventLog.h/.cpp are identical copies in each sketch that uses it.
+#include <Arduino.h>
+
+enum EvId : uint8_t {
+#define EVT(id, name, fmt) EV_##name = id,
+#include "EventIds.h"
+#undef EVT
+};
+
+#ifndef EVLOG_CAPACITY
+#define EVLOG_CAPACITY 256          // records (16 bytes each); power of two
+#endif
+
+#pragma pack(push, 1)
+struct EvRec {
+  uint32_t t;     // millis()
+  uint8_t  id;    // EvId
+  uint8_t  a;     // args, rendered in order a, b, c, d
+  uint16_t b;
+  uint32_t c;
+  uint32_t d;
+};
+#pragma pack(pop)
+
+// Binary drain framing: EVLOG_SYNC0, EVLOG_SYNC1, then one EvRec (little-endian)
+constexpr uint8_t EVLOG_SYNC0 = 0xA5;
+constexpr uint8_t EVLOG_SYNC1 = 0x5A;
+
+enum class EvDrain : uint8_t { OFF = 0, TEXT = 1, BIN = 2 };
+
+// Record an event (safe from loop() and from the radio RX callback).
+void evlog(EvId id, uint8_t a = 0, uint16_t b = 0, uint32_t c = 0, uint32_t d = 0);
+
+// Background drain; call once per loop() pass. Never blocks on `out`.
+void     evlogPump(Print& out);
+void     evlogSetDrain(EvDrain mode);
+EvDrain  evlogDrainMode();
+
+// Render everything still in the ring as text (telnet / serial dump).
+void     evlogDump(Print& out);
+
+// Records overwritten before the drain got to them.
+uint32_t evlogDropped();
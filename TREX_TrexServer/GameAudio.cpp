@@ -1,10 +1,11 @@
 #include "GameAudio.h"
+#include "Media.h"
 #include <HardwareSerial.h>
 #include <DYPlayerArduino.h>
 
 static HardwareSerial AudioSerial(2);      // UART2 on ESP32-S3
 static DY::Player     audioModule(&AudioSerial);
-static uint16_t       g_currentTrack = 0;
+static uint16_t       g_currentTrack = 0;  // as posted; the module follows via the media task
 
 void gameAudioInit(uint8_t rxPin, uint8_t txPin, uint32_t baud, uint8_t volume) {
   AudioSerial.begin(baud, SERIAL_8N1, rxPin, txPin);
@@ -14,16 +15,20 @@ void gameAudioInit(uint8_t rxPin, uint8_t txPin, uint32_t baud, uint8_t volume)
   g_currentTrack = 0;
 }
 
-void gameAudioPlayOnce(uint16_t track) {
-  audioModule.playSpecified(track);
+void gameAudioPlayOnce(uint16_t track, uint32_t at) {
+  mediaPost(MediaOp::AUDIO_PLAY, track, at);
   g_currentTrack = track;
 }
 
-void gameAudioStop() {
-  audioModule.stop();
+void gameAudioStop(uint32_t at) {
+  if (g_currentTrack == 0) return;         // already stopped (every GREEN flip asks)
+  mediaPost(MediaOp::AUDIO_STOP, 0, at);
   g_currentTrack = 0;
 }
 
 uint16_t gameAudioCurrentTrack() {   // ← accessor
   return g_currentTrack;
 }
+
+void gameAudioDevPlay(uint16_t track) { audioModule.playSpecified(track); }
+void gameAudioDevStop()               { audioModule.stop(); }
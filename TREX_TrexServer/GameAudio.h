@@ -9,8 +9,13 @@ constexpr uint16_t TRK_TREX_LOSE          = 4;  // 00004
 constexpr uint16_t TRK_TREX_WIN           = 5;  // 00005
 constexpr uint16_t TRK_GAME_MUSIC         = 6;  // 00006 (unused)
 
-// Init + controls
+// Init + controls. Play/stop are queued to the media task (Media.h), or
+// held until `at` when given; the current track is what was last asked for.
 void gameAudioInit(uint8_t rxPin = 9, uint8_t txPin = 8, uint32_t baud = 9600, uint8_t volume = 25);
-void gameAudioPlayOnce(uint16_t track);
-void gameAudioStop();
+void gameAudioPlayOnce(uint16_t track, uint32_t at = 0);
+void gameAudioStop(uint32_t at = 0);
 uint16_t gameAudioCurrentTrack();
+
+// Media task side: drive the DY module directly
+void gameAudioDevPlay(uint16_t track);
+void gameAudioDevStop();
@@ -3,25 +3,42 @@
 #include <TrexProtocol.h> 
 
 #include "ModeClassic.h"
-
-static inline bool uidEq(const TrexUid& a, const TrexUid& b) {
-  if (a.len != b.len) return false;
-  for (uint8_t i=0;i<a.len;i++) if (a.bytes[i]!=b.bytes[i]) return false;
-  return true;
-}
+#include "Timers.h"
+#include "Journal.h"
+#include <esp_random.h>
 
 #include <TrexProtocol.h>  // for TrexUid helpers if used
 #include "GameModel.h"
 
+static uint32_t sNextSeed = 0;
+
+void setNextGameSeed(uint32_t seed) { sNextSeed = seed; }
+
 void resetGame(Game& g) {
+  // One seed per game: every gameplay draw comes from g.rng after this
+  g.rngSeedValue = sNextSeed ? sNextSeed : esp_random();
+  sNextSeed = 0;
+  rngSeed(g.rng, g.rngSeedValue);
+  Serial.printf("[TREX] Game seed=%lu\n", (unsigned long)g.rngSeedValue);
+  journalGameStart(g.rngSeedValue, g.stationCount);
+
+  resetGameState(g);
+}
+
+void resetGameState(Game& g) {
   g.phase = Phase::PLAYING;       // ensure we're in play mode
   g.teamScore = 0;
 
   // Reset sequence / drip broadcast scheduler
   g.seq = 1;
   g.pending = PendingStart{};
+  g.stationDirty = 0;
   g.lastTickSentMs = 0;
 
+  // Drop every deadline from the previous game; the first WORLD_FRAME is due now
+  timersReset();
+  timerArm(TMR_WORLD_FRAME, millis());
+
   // Lives reset
   g.livesMax             = 5;
   g.livesRemaining       = g.livesMax;
@@ -57,7 +74,7 @@ void resetGame(Game& g) {
   g.mgAllTriedAt    = 0;
   g.mgTriedMask     = 0;
   g.mgSuccessMask   = 0;
-  g.mgExpectedStations = MAX_STATIONS;
+  g.mgExpectedStations = g.stationCount;
   g.mgCfg           = Game::MgConfig{};
 
   g.r5Active        = false;
@@ -84,9 +101,10 @@ void resetGame(Game& g) {
   g.bonusNextSpawnAt = 0;
   g.bonusSpawnsThisRound = 0;
 
-  // Clear station state; Round 1 will set inventory=20 later
+  // Clear station state; Round 1 will set inventory=20 later.
+  // Ids past stationCount stay at capacity 0 so nothing can loot them.
   for (uint8_t sid = 1; sid <= MAX_STATIONS; ++sid) {
-    g.stationCapacity[sid]  = 56;  // keep your physical gauge size
+    g.stationCapacity[sid]  = (sid <= g.stationCount) ? 56 : 0;  // keep your physical gauge size
     g.stationInventory[sid] = 0;   // start empty; filled in startRound()
   }
 
@@ -94,37 +112,143 @@ void resetGame(Game& g) {
   g.redMsMin   = g.redMsMax   = 0;
   g.yellowMsMin= g.yellowMsMax= 0;
 
-  // (Optional) clear any per-player holds/carry if you track them here
-  for (int i=0;i<MAX_PLAYERS;i++) {
-    g.players[i] = PlayerRec{}; // zero/clear
-  }
+  // Forget every wristband from the previous game
+  playersClear(g.players);
 
   // Clear any holds explicitly (safety)
-  for (int i=0;i<MAX_HOLDS;i++) {
-    g.holds[i] = HoldRec{};
-  }
+  clearHolds(g);
 }
 
 int findPlayer(const Game& g, const TrexUid& u) {
-  for (int i=0;i<MAX_PLAYERS;i++) if (g.players[i].used && uidEq(g.players[i].uid,u)) return i;
-  return -1;
+  return playersFind(g.players, u);
 }
 int ensurePlayer(Game& g, const TrexUid& u) {
   int idx = findPlayer(g,u);
+  const uint32_t now = millis();
+  if (idx>=0) { g.players[idx].lastSeenMs = now; return idx; }
+
+  idx = playersInsert(g.players, u, now);
   if (idx>=0) return idx;
-  for (int i=0;i<MAX_PLAYERS;i++) if (!g.players[i].used) {
-    g.players[i].used=true; g.players[i].uid=u; g.players[i].carried=0; g.players[i].banked=0;
-    return i;
+
+#if PLAYER_EVICT_LRU
+  // Full: recycle the coldest record that has nothing to lose (no carried
+  // loot, no hold pointing at it). Only runs when full, so O(N) is fine.
+  static bool held[MAX_PLAYERS];
+  memset(held, 0, sizeof(held));
+  for (uint8_t sid=1; sid<=MAX_STATIONS; sid++)
+    for (uint8_t hi=g.holds.byStation[sid]; hi!=HOLD_NONE; hi=g.holds[hi].next) held[g.holds[hi].playerIdx] = true;
+
+  uint16_t victim = PLAYER_NONE;
+  for (uint16_t i=0;i<MAX_PLAYERS;i++) {
+    const PlayerRec& r = g.players[i];
+    if (!r.used || r.carried || held[i]) continue;
+    if (victim == PLAYER_NONE || (int32_t)(r.lastSeenMs - g.players[victim].lastSeenMs) < 0) victim = i;
   }
+  if (victim != PLAYER_NONE) {
+    playersRemove(g.players, victim);
+    playersNoteFull(/*evicted=*/true);
+    return playersInsert(g.players, u, now);
+  }
+#endif
+  playersNoteFull(/*evicted=*/false);
   return -1;
 }
+// --- Hold pool ---
+static const uint32_t HOLD_MASK = HOLD_INDEX_SLOTS - 1;
+
+static inline uint32_t holdSlotOf(uint32_t hid) {
+  return (hid * 2654435761u >> 16) & HOLD_MASK;
+}
+
+static void holdTableInit(HoldTable& t) {
+  for (uint8_t i=0;i<MAX_HOLDS;i++) t.recs[i] = HoldRec{};
+  for (uint8_t sid=0;sid<=MAX_STATIONS;sid++) t.byStation[sid] = HOLD_NONE;
+  for (uint32_t s=0;s<HOLD_INDEX_SLOTS;s++) t.idIndex[s] = HOLD_NONE;
+  t.freeTop = 0;
+  for (uint8_t i=MAX_HOLDS; i-- > 0; ) t.freeList[t.freeTop++] = i;
+  t.count = 0;
+}
+
+HoldTable::HoldTable() { holdTableInit(*this); }
+
+void clearHolds(Game& g) {
+  for (uint8_t i=0;i<MAX_HOLDS;i++) if (g.holds[i].active) timerCancel(TMR_HOLD_0 + i);
+  holdTableInit(g.holds);
+}
+
 int findHoldById(const Game& g, uint32_t hid) {
-  for (int i=0;i<MAX_HOLDS;i++) if (g.holds[i].active && g.holds[i].holdId==hid) return i;
+  const HoldTable& t = g.holds;
+  for (uint32_t s = holdSlotOf(hid); t.idIndex[s] != HOLD_NONE; s = (s + 1) & HOLD_MASK) {
+    if (t.recs[t.idIndex[s]].holdId == hid) return t.idIndex[s];
+  }
   return -1;
 }
-int allocHold(Game& g) {
-  for (int i=0;i<MAX_HOLDS;i++) if (!g.holds[i].active) return i;
-  return -1;
+
+int allocHold(Game& g, uint32_t holdId, uint8_t stationId, uint16_t playerIdx) {
+  HoldTable& t = g.holds;
+  if (!t.freeTop || stationId > MAX_STATIONS) return -1;
+  const uint8_t hi = t.freeList[--t.freeTop];
+
+  HoldRec& h = t.recs[hi];
+  h = HoldRec{};
+  h.active    = true;
+  h.holdId    = holdId;
+  h.stationId = stationId;
+  h.playerIdx = playerIdx;
+
+  h.next = t.byStation[stationId];
+  if (h.next != HOLD_NONE) t.recs[h.next].prev = hi;
+  t.byStation[stationId] = hi;
+
+  uint32_t s = holdSlotOf(holdId);
+  while (t.idIndex[s] != HOLD_NONE) s = (s + 1) & HOLD_MASK;
+  t.idIndex[s] = hi;
+
+  t.count++;
+  return hi;
+}
+
+void releaseHold(Game& g, uint8_t hi) {
+  HoldTable& t = g.holds;
+  if (hi >= MAX_HOLDS || !t.recs[hi].active) return;
+  HoldRec& h = t.recs[hi];
+
+  if (h.prev != HOLD_NONE) t.recs[h.prev].next = h.next;
+  else                     t.byStation[h.stationId] = h.next;
+  if (h.next != HOLD_NONE) t.recs[h.next].prev = h.prev;
+
+  // Backward-shift deletion, same as the player index (no tombstones)
+  uint32_t s = holdSlotOf(h.holdId);
+  while (t.idIndex[s] != hi) s = (s + 1) & HOLD_MASK;
+  t.idIndex[s] = HOLD_NONE;
+  for (uint32_t j = (s + 1) & HOLD_MASK; t.idIndex[j] != HOLD_NONE; j = (j + 1) & HOLD_MASK) {
+    const uint32_t home = holdSlotOf(t.recs[t.idIndex[j]].holdId);
+    if (((j - home) & HOLD_MASK) >= ((j - s) & HOLD_MASK)) {
+      t.idIndex[s] = t.idIndex[j];
+      t.idIndex[j] = HOLD_NONE;
+      s = j;
+    }
+  }
+
+  timerCancel(TMR_HOLD_0 + hi);
+  h.active = false;
+  h.next = h.prev = HOLD_NONE;
+  t.freeList[t.freeTop++] = hi;
+  t.count--;
+}
+
+void markStationDirty(Game& g, uint8_t sid) {
+  if (isLiveStation(g, sid)) g.stationDirty |= (1u << sid);
+}
+
+void markAllStationsDirty(Game& g) {
+  g.stationDirty |= allStationsMask(g);
+}
+
+void setStationCount(Game& g, uint8_t n) {
+  if (n < 1) n = 1;
+  if (n > MAX_STATIONS) n = MAX_STATIONS;
+  g.stationCount = n;
 }
 
 void startNewGame(Game& g) {
@@ -2,27 +2,53 @@
 #include <Arduino.h>
 #include <TrexProtocol.h>
 #include "ServerMini.h"
+#include "ServerConfig.h"
+#include "TrexProtocolExt.h"
+#include "Rng.h"
+#include "PlayerTable.h"
 
-constexpr uint8_t MAX_PLAYERS = 24;
-constexpr uint8_t MAX_HOLDS   = 8;
-constexpr uint8_t MAX_STATIONS= 5;
+#ifndef TREX_MAX_HOLDS
+#define TREX_MAX_HOLDS 32
+#endif
+
+constexpr uint8_t MAX_HOLDS   = TREX_MAX_HOLDS;
+constexpr uint8_t MAX_STATIONS= TREX_MAX_LOOT_STATIONS;   // capacity; Game::stationCount is how many are live
+constexpr uint8_t HOLD_NONE   = 0xFF;
+static_assert(MAX_HOLDS > 0 && MAX_HOLDS <= 64, "hold slots are 8-bit; timers reserve one id per slot");
 
 // Phases
 enum class Phase : uint8_t { PLAYING=1, END=2 };
 
-struct PlayerRec {
-  TrexUid  uid{};
-  bool     used=false;
-  uint8_t  carried=0;
-  uint32_t banked=0;
-};
-
 struct HoldRec {
   bool     active=false;
   uint32_t holdId=0;
   uint8_t  stationId=0;
-  uint8_t  playerIdx=255;
+  uint16_t playerIdx=PLAYER_NONE;
   uint32_t nextTickAt=0;
+  uint8_t  next=HOLD_NONE, prev=HOLD_NONE;   // per-station list links
+};
+
+// Hold pool: slots come off a free list, every active hold is linked into
+// its station's list (byStation[sid] = head), and idIndex[] maps holdId to
+// slot (open addressing, linear probing). So "hold by id", "any hold on
+// station X" and "every active hold" never scan idle slots.
+static constexpr uint32_t holdIndexSlots(uint32_t want, uint32_t p = 16) {
+  return (p >= want) ? p : holdIndexSlots(want, p * 2);
+}
+constexpr uint32_t HOLD_INDEX_SLOTS = holdIndexSlots(2u * MAX_HOLDS);
+
+struct HoldTable {
+  HoldRec  recs[MAX_HOLDS];
+  uint8_t  byStation[MAX_STATIONS + 1];
+  uint8_t  idIndex[HOLD_INDEX_SLOTS];    // slot or HOLD_NONE
+  uint8_t  freeList[MAX_HOLDS];
+  uint8_t  freeTop = 0;
+  uint8_t  count   = 0;
+
+  HoldTable();   // starts empty
+
+  HoldRec&       operator[](uint8_t i)       { return recs[i]; }
+  const HoldRec& operator[](uint8_t i) const { return recs[i]; }
 };
 
 struct PirRec {
@@ -34,8 +60,6 @@ struct PirRec {
 
 struct PendingStart {
   bool    needGameStart = false;
-  uint8_t nextStation   = 0;  // 1..5 (0 = idle)
-  uint8_t stationPasses = 0;  // how many full 1..5 sync passes remain
   bool    needScore     = false;
 };
 
@@ -47,6 +71,9 @@ struct Game {
   uint16_t    seq        = 1;
   uint32_t    teamScore  = 0;
 
+  // Loot stations in play (ids 1..stationCount); NVS "stations", see setup()
+  uint8_t     stationCount = DEFAULT_STATION_COUNT;
+
   // Lives system ("5 lives")
   uint8_t   livesMax             = 5;    // configured max lives
   uint8_t   livesRemaining       = 5;    // decremented on failures
@@ -94,7 +121,7 @@ struct Game {
   uint32_t bonus2NextHopAt      = 0;       // next hop time (millis)
   
   // R3.5 random hop order (shuffle without repeats)
-  uint8_t  bonus2Order[MAX_STATIONS];  // 1..MAX_STATIONS
+  uint8_t  bonus2Order[MAX_STATIONS];  // 1..stationCount
   uint8_t  bonus2Idx = 0;              // next index into bonus2Order
 
   // --- Bonus runtime state (cleared at round start) ---
@@ -117,13 +144,13 @@ struct Game {
   uint32_t mgAllTriedAt     = 0;     // first time all stations have tried (for +3s end)
   uint32_t mgTriedMask      = 0;     // bit i => station i has used its attempt
   uint32_t mgSuccessMask    = 0;     // bit i => station i reported success
-  uint8_t  mgExpectedStations = MAX_STATIONS; // set to 5 if you only have 5 Loots
+  uint8_t  mgExpectedStations = DEFAULT_STATION_COUNT; // = stationCount at minigame start
   MgConfig mgCfg{};
 
   // ---- Round 5: Hot-station hop mechanic ----
   bool     r5Active          = false;
-  uint8_t  r5HotSid          = 0;       // current “hot” station (1..5)
-  uint8_t  r5Order[5]        = {1,2,3,4,5}; // current shuffle order
+  uint8_t  r5HotSid          = 0;       // current “hot” station (1..stationCount)
+  uint8_t  r5Order[MAX_STATIONS] = {};  // current shuffle order (first stationCount used)
   uint8_t  r5Idx             = 0;       // index into r5Order
   uint32_t r5DwellEndAt      = 0;       // hop when now >= this
   uint32_t r5NextDepleteAt   = 0;       // throttle deplete steps
@@ -148,7 +175,9 @@ struct Game {
   bool      noRedThisRound  = true;     // Round 1 = true
 
   bool     pirEnforce      = true;
-  uint32_t pirArmDelayMs   = 900;   // camera motion input arming delay after RED; raised to better ignore video/light-change lag
+  uint32_t pirArmDelayMs   = 900;   // camera motion input arming delay, counted from when the room sees RED
+                                    // (flip + media lag, see Media.h); with the lags measured this can come
+                                    // back down toward reaction time
   uint32_t pirArmAt        = 0;
 
   // RED looting policy:
@@ -161,19 +190,50 @@ struct Game {
   uint32_t lastTickSentMs = 0;
 
   // Tables
-  PlayerRec players[MAX_PLAYERS];
-  HoldRec   holds[MAX_HOLDS];
+  PlayerTable players;   // g.players[i] indexes records; see PlayerTable.h
+  HoldTable holds;      // g.holds[i] indexes slots; see HoldTable above
   PirRec    pir[4];
-  uint16_t  stationCapacity[7]  = {0, 56,56,56,56,56, 0}; // index 0,6 unused
-  uint16_t  stationInventory[7] = {0, 56,56,56,56,56, 0};
+  uint16_t  stationCapacity[MAX_STATIONS + 1]  = {};   // index 0 unused; filled by resetGame
+  uint16_t  stationInventory[MAX_STATIONS + 1] = {};
+
+  // Gameplay randomness (see Rng.h); rngSeedValue is what this game was seeded with
+  Rng       rng;
+  uint32_t  rngSeedValue = 0;
+
+  // Station inventory sync: bit sid set => inventory/capacity changed since
+  // the last STATION_INVENTORY frame (flushed by netStationSync)
+  uint32_t  stationDirty = 0;
 };
 
 // Helpers
 void resetGame(Game& g);
+// resetGame() without the new seed and journal game (snapshotRestore()
+// overlays the saved game, seed and RNG state included)
+void resetGameState(Game& g);
 int  findPlayer(const Game& g, const TrexUid& u);
 int  ensurePlayer(Game& g, const TrexUid& u);
 int  findHoldById(const Game& g, uint32_t hid);
-int  allocHold(Game& g);
+// Take a slot for a new active hold (linked + indexed); -1 when full
+int  allocHold(Game& g, uint32_t holdId, uint8_t stationId, uint16_t playerIdx);
+// End hold `hi`: unlink, unindex, cancel its tick timer, return the slot
+void releaseHold(Game& g, uint8_t hi);
+void clearHolds(Game& g);   // drop every hold without notifying anyone
+static inline bool anyHoldOnStation(const Game& g, uint8_t sid) {
+  return sid <= MAX_STATIONS && g.holds.byStation[sid] != HOLD_NONE;
+}
+void markStationDirty(Game& g, uint8_t sid);
+void markAllStationsDirty(Game& g);
+// Bit sid set for every live Loot (1..stationCount)
+static inline uint32_t allStationsMask(const Game& g) {
+  return ((1UL << (g.stationCount + 1)) - 1) & ~1UL;
+}
+static inline bool isLiveStation(const Game& g, uint8_t sid) {
+  return sid >= 1 && sid <= g.stationCount;
+}
+// Clamp to 1..MAX_STATIONS; takes effect at the next resetGame()
+void setStationCount(Game& g, uint8_t n);
+// Pin the seed of the next resetGame() (0 = fresh hardware-random seed)
+void setNextGameSeed(uint32_t seed);
 
 // Lifecycle
 void startNewGame(Game& g);
\ No newline at end of file
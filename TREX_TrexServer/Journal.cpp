@@ -0,0 +1,186 @@
+#include "Journal.h"
+#include <LittleFS.h>
+#include <TrexProtocol.h>
+#include "TrexProtocolExt.h"
+
+// Wait this long after GAME_OVER before touching flash, so the GAME_OVER /
+// WORLD_FRAME repeats (netTxPump) aren't delayed by a blocking write.
+static const uint32_t FLUSH_DELAY_MS = 500;
+
+static uint8_t  sBuf[JOURNAL_BYTES];
+static uint32_t sUsed     = 0;
+static uint32_t sDropped  = 0;
+static uint32_t sSeed     = 0;
+static bool     sFsOk     = false;
+static bool     sFlushDue = false;
+static bool     sUnsaved  = false;   // records since the last flush
+static uint32_t sFlushAt  = 0;
+static uint32_t sLastFlushBytes = 0;
+static uint32_t sLastFlushMs    = 0;
+
+// TX hash of the open window
+static bool     sTxOn      = false;   // game start -> game end
+static uint32_t sTxStartMs = 0;
+static uint16_t sTxWindow  = 0;
+static uint16_t sTxFrames  = 0;
+static uint32_t sTxHash    = 0;
+
+static void append(JrKind kind, const uint8_t* a, uint16_t aLen,
+                   const uint8_t* b = nullptr, uint16_t bLen = 0) {
+  const uint16_t len = aLen + bLen;
+  if (len > 255 || sUsed + 6 + len > JOURNAL_BYTES) { sDropped++; return; }
+
+  const uint32_t t = millis();
+  memcpy(sBuf + sUsed, &t, 4);
+  sBuf[sUsed + 4] = (uint8_t)kind;
+  sBuf[sUsed + 5] = (uint8_t)len;
+  if (aLen) memcpy(sBuf + sUsed + 6, a, aLen);
+  if (bLen) memcpy(sBuf + sUsed + 6 + aLen, b, bLen);
+  sUsed += 6 + len;
+  sUnsaved = true;
+}
+
+void journalBegin() {
+  sFsOk = LittleFS.begin() || LittleFS.begin(/*formatOnFail=*/true);
+  if (!sFsOk) Serial.println("[JRNL] LittleFS mount failed; journal stays in RAM");
+}
+
+static const uint32_t FNV_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+static void closeTxWindow() {
+  if (!sTxFrames) return;
+  uint8_t d[8];
+  memcpy(d,     &sTxWindow, 2);
+  memcpy(d + 2, &sTxFrames, 2);
+  memcpy(d + 4, &sTxHash,   4);
+  append(JR_TX, d, sizeof(d));
+  sTxFrames = 0;
+  sTxHash   = FNV_BASIS;
+}
+
+static void flush() {
+  closeTxWindow();
+  sUnsaved = false;
+  if (!sFsOk) return;
+
+  const uint32_t t0 = millis();
+  if (LittleFS.exists(JOURNAL_PREV_PATH)) LittleFS.remove(JOURNAL_PREV_PATH);
+  if (LittleFS.exists(JOURNAL_PATH))      LittleFS.rename(JOURNAL_PATH, JOURNAL_PREV_PATH);
+
+  File f = LittleFS.open(JOURNAL_PATH, "w");
+  if (!f) { Serial.println("[JRNL] open for write failed"); return; }
+
+  JournalFileHeader hdr{};
+  memcpy(hdr.magic, "TRJ1", 4);
+  hdr.version      = 2;
+  hdr.protoVersion = TREX_PROTO_VERSION;
+  hdr.seed         = sSeed;
+  hdr.bytes        = sUsed;
+  hdr.dropped      = sDropped;
+  f.write((const uint8_t*)&hdr, sizeof(hdr));
+  f.write(sBuf, sUsed);
+  f.close();
+
+  sLastFlushBytes = sizeof(hdr) + sUsed;
+  sLastFlushMs    = millis() - t0;
+  Serial.printf("[JRNL] %lu bytes -> %s in %lums (dropped=%lu)\n",
+                (unsigned long)sLastFlushBytes, JOURNAL_PATH,
+                (unsigned long)sLastFlushMs, (unsigned long)sDropped);
+}
+
+void journalGameStart(uint32_t seed, uint8_t stations) {
+  // A game restarted before it ended (operator/Control restart) still gets
+  // its journal saved; that's exactly the case we want to look at later.
+  if (sUnsaved && sUsed) flush();
+
+  sUsed     = 0;
+  sDropped  = 0;
+  sSeed     = seed;
+  sFlushDue = false;
+  append(JR_GAME_START, (const uint8_t*)&seed, sizeof(seed), &stations, 1);
+  sUnsaved = false;
+
+  sTxOn      = true;
+  sTxStartMs = millis();
+  sTxWindow  = 0;
+  sTxFrames  = 0;
+  sTxHash    = FNV_BASIS;
+}
+
+void journalRx(const uint8_t* data, uint16_t len) {
+  append(JR_RX, data, len);
+}
+
+void journalTx(const uint8_t* data, uint16_t len) {
+  if (!sTxOn || len < sizeof(MsgHeader)) return;
+  const uint8_t type = ((const MsgHeader*)data)->type;
+  if (type == (uint8_t)MsgTypeExt::TIME_SYNC_RESP ||
+      type == (uint8_t)MsgTypeExt::STATION_RESYNC) return;
+
+  const uint16_t window = (uint16_t)((millis() - sTxStartMs) / JOURNAL_TX_WINDOW_MS);
+  if (window != sTxWindow) {
+    closeTxWindow();
+    sTxWindow = window;
+  }
+  const uint16_t seqOfs = offsetof(MsgHeader, seq);
+  for (uint16_t i = 0; i < len; ++i) {
+    const uint8_t b = (i == seqOfs || i == seqOfs + 1) ? 0 : data[i];
+    sTxHash = (sTxHash ^ b) * FNV_PRIME;
+  }
+  sTxFrames++;
+}
+
+void journalPir(uint8_t input, bool triggered) {
+  const uint8_t d[2] = { input, (uint8_t)(triggered ? 1 : 0) };
+  append(JR_PIR, d, sizeof(d));
+}
+
+void journalCmd(char source, const String& line) {
+  const uint8_t src = (uint8_t)source;
+  const uint16_t n = (line.length() > 200) ? 200 : (uint16_t)line.length();
+  append(JR_CMD, &src, 1, (const uint8_t*)line.c_str(), n);
+}
+
+void journalGameEnd(uint8_t reason, uint8_t blameSid) {
+  if (!sTxOn) return;   // no game open (resumed from a snapshot)
+  closeTxWindow();
+  sTxOn = false;
+  const uint8_t d[2] = { reason, blameSid };
+  append(JR_GAME_END, d, sizeof(d));
+  sFlushDue = true;
+  sFlushAt  = millis() + FLUSH_DELAY_MS;
+}
+
+void journalPump(uint32_t now) {
+  if (!sFlushDue || (int32_t)(now - sFlushAt) < 0) return;
+  sFlushDue = false;
+  flush();
+}
+
+const uint8_t* journalRecords(uint32_t& bytes) {
+  bytes = sUsed;
+  return sBuf;
+}
+
+void journalDump(Print& out) {
+  if (!sFsOk) { out.print("journal: no filesystem\n"); return; }
+  File f = LittleFS.open(JOURNAL_PATH, "r");
+  if (!f) { out.print("journal: nothing flushed yet\n"); return; }
+
+  uint8_t chunk[32];
+  int n;
+  while ((n = f.read(chunk, sizeof(chunk))) > 0) {
+    out.print("J ");
+    for (int i = 0; i < n; ++i) out.printf("%02x", chunk[i]);
+    out.print('\n');
+  }
+  f.close();
+}
+
+void journalPrintStats(Print& out) {
+  out.printf("journal used=%lu/%u dropped=%lu seed=%lu lastFlush=%luB/%lums%s\n",
+             (unsigned long)sUsed, (unsigned)JOURNAL_BYTES, (unsigned long)sDropped,
+             (unsigned long)sSeed, (unsigned long)sLastFlushBytes,
+             (unsigned long)sLastFlushMs, sFsOk ? "" : " (no fs)");
+}
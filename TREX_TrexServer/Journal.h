@@ -0,0 +1,70 @@
+#pragma once
+// Per-game input journal.
+//
+// Everything that can change the game from outside is appended here with its
+// millis() stamp: every inbound frame that passed handleRx validation, PIR /
+// camera input edges, and operator commands (serial + telnet). Together with
+// the game seed (first record) that is enough to re-drive the game logic.
+// What the server sent back is kept as one FNV-1a hash per JOURNAL_TX_WINDOW_MS
+// of game time, so a replay (host/tools/trex_replay) can tell in which second
+// it stopped matching the recorded game.
+//
+// Records go into a fixed RAM buffer during the game; at game end the buffer
+// is written to LittleFS (JOURNAL_PATH, previous game kept as
+// JOURNAL_PREV_PATH) from loop(), once the end-of-game bursts are out.
+// tools/journal_decode.py turns a journal into a readable timeline.
+//
+// File layout (little-endian):
+//   JournalFileHeader
+//   records: uint32 t, uint8 kind, uint8 len, uint8 data[len]
+#include <Arduino.h>
+
+#ifndef JOURNAL_BYTES
+#define JOURNAL_BYTES (48 * 1024)
+#endif
+
+#ifndef JOURNAL_TX_WINDOW_MS
+#define JOURNAL_TX_WINDOW_MS 1000
+#endif
+
+#define JOURNAL_PATH      "/journal.bin"
+#define JOURNAL_PREV_PATH "/journal.prev.bin"
+
+enum JrKind : uint8_t {
+  JR_GAME_START = 1,   // data: uint32 seed, uint8 stationCount
+  JR_RX         = 2,   // data: raw frame (MsgHeader + payload)
+  JR_PIR        = 3,   // data: uint8 input index, uint8 level (1 = triggered)
+  JR_CMD        = 4,   // data: uint8 source ('S' serial, 'T' telnet) + text
+  JR_GAME_END   = 5,   // data: uint8 reason, uint8 blameSid
+  JR_TX         = 6,   // data: uint16 window, uint16 frames, uint32 hash
+};                     //   window = (millis() - game start) / JOURNAL_TX_WINDOW_MS
+
+#pragma pack(push, 1)
+struct JournalFileHeader {
+  char     magic[4];      // "TRJ1"
+  uint16_t version;       // 2 (1: no stationCount in JR_GAME_START)
+  uint16_t protoVersion;  // TREX_PROTO_VERSION of the recorded frames
+  uint32_t seed;
+  uint32_t bytes;         // record bytes that follow
+  uint32_t dropped;       // records that didn't fit in JOURNAL_BYTES
+};
+#pragma pack(pop)
+
+void journalBegin();                                  // setup(): mount LittleFS
+void journalGameStart(uint32_t seed, uint8_t stations); // clears the buffer
+void journalRx(const uint8_t* data, uint16_t len);
+// Every frame the server sends, until GAME_END. Seq is left out of the hash,
+// and so are TIME_SYNC_RESP and STATION_RESYNC: they answer inputs the journal
+// doesn't keep (clock sync requests, heartbeats).
+void journalTx(const uint8_t* data, uint16_t len);
+void journalPir(uint8_t input, bool triggered);
+void journalCmd(char source, const String& line);
+void journalGameEnd(uint8_t reason, uint8_t blameSid); // schedules the flush
+void journalPump(uint32_t now);                        // loop(): does the flush
+// The current game's records in RAM (the replay compares against these)
+const uint8_t* journalRecords(uint32_t& bytes);
+
+// Hex dump of the last flushed journal (maintenance `journal`), one
+// "J <hex>" line per 32 bytes; journal_decode.py --hex reads it back.
+void journalDump(Print& out);
+void journalPrintStats(Print& out);
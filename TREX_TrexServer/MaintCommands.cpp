@@ -3,6 +3,12 @@
 #include "Media.h"
 #include "Net.h"
 #include "Cadence.h"
+#include "EventLog.h"
+#include "Timers.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "RoundTable.h"
+#include "Profiler.h"
 #include <WiFi.h>
 
 static Game* GP = nullptr;
@@ -19,10 +25,10 @@ static bool parseInt(const String& s, int32_t& out) {
 }
 
 static void printStatus(WiFiClient& out, Game& g) {
-  out.printf("phase=%s light=%s score=%u \n",
+  out.printf("phase=%s light=%s score=%u seed=%lu\n",
              (g.phase==Phase::PLAYING?"PLAYING":"END"),
              (g.light==LightState::GREEN?"GREEN":"RED"),
-             (unsigned)g.teamScore);
+             (unsigned)g.teamScore, (unsigned long)g.rngSeedValue);
   out.printf("G=%u R=%u loot=%u maxCarry=%u tickHz=%u pir=%u pirArm=%u\n",
              (unsigned)g.greenMs, (unsigned)g.redMs, (unsigned)g.lootRateMs,
              (unsigned)g.maxCarry, (unsigned)g.tickHz,
@@ -31,15 +37,25 @@ static void printStatus(WiFiClient& out, Game& g) {
              (unsigned)g.edgeGraceMs,
              (unsigned)g.redHoldGraceMs,
              g.redLootPenaltyAfterGrace ? "strict" : "drop");
+  cadencePrintPlan(out);
 
   // holds summary
-  int active=0; for (auto &h : g.holds) if (h.active) active++;
-  out.printf("holdsActive=%d\n", active);
+  out.printf("holdsActive=%u/%u\n", (unsigned)g.holds.count, (unsigned)MAX_HOLDS);
 
   // station table
-  for (uint8_t sid=1; sid<=5; ++sid) {
+  out.printf("stations=%u/%u\n", (unsigned)g.stationCount, (unsigned)MAX_STATIONS);
+  for (uint8_t sid=1; sid<=g.stationCount; ++sid) {
     out.printf("station %u: inv=%u/%u\n", sid, (unsigned)g.stationInventory[sid], (unsigned)g.stationCapacity[sid]);
   }
+
+  netPrintStats(out);
+  netPrintClockSync(out);
+  netPrintConvergence(out);
+  playersPrintStats(out, g.players);
+  timersPrintStats(out);
+  journalPrintStats(out);
+  snapshotPrintStats(out);
+  mediaPrintStats(out);
 }
 
 static bool handleCmd(const String& raw, WiFiClient& out) {
@@ -47,6 +63,7 @@ static bool handleCmd(const String& raw, WiFiClient& out) {
   Game& g = *GP;
 
   String cmd = raw; // already lowercased by TrexMaintenance
+  journalCmd('T', raw);
   // split into tokens
   auto nextTok = [&](int& i)->String{
     while (i < (int)cmd.length() && cmd[i]==' ') i++;
@@ -73,12 +90,50 @@ static bool handleCmd(const String& raw, WiFiClient& out) {
     else if (key=="pir_arm_ms") g.pirArmDelayMs = u;
     else if (key=="red_loot_penalty") g.redLootPenaltyAfterGrace = (u != 0);
     else if (key=="tick_hz")  { g.tickHz = (uint8_t)max<uint32_t>(1,u); }
+    else if (key=="sprite_lag_ms") { mediaSetLagMs(MediaOut::SPRITE, (uint16_t)min<uint32_t>(u, MEDIA_LAG_MAX_MS)); cadenceCancelCues(); }
+    else if (key=="audio_lag_ms")  { mediaSetLagMs(MediaOut::AUDIO,  (uint16_t)min<uint32_t>(u, MEDIA_LAG_MAX_MS)); cadenceCancelCues(); }
+    else if (key=="led_lag_ms")    { mediaSetLagMs(MediaOut::LEDS,   (uint16_t)min<uint32_t>(u, MEDIA_LAG_MAX_MS)); cadenceCancelCues(); }
     else { out.print("unknown key\n"); return true; }
 
     out.print("ok\n");
     return true;
   }
 
+  if (t=="rxlog") {
+    String v = nextTok(i);
+    if (v=="on")  netSetRxVerbose(true);
+    else if (v=="off") netSetRxVerbose(false);
+    else { out.printf("rxlog is %s (usage: rxlog on|off)\n", netRxVerbose() ? "on" : "off"); return true; }
+    out.print("ok\n");
+    return true;
+  }
+
+  if (t=="evlog") {
+    String v = nextTok(i);
+    if (v=="")          { evlogDump(out); return true; }
+    if (v=="off")       evlogSetDrain(EvDrain::OFF);
+    else if (v=="text") evlogSetDrain(EvDrain::TEXT);
+    else if (v=="bin")  evlogSetDrain(EvDrain::BIN);
+    else { out.print("usage: evlog [off|text|bin]\n"); return true; }
+    out.print("ok\n");
+    return true;
+  }
+
+  if (t=="journal") { journalDump(out); return true; }
+  if (t=="playerbench") { playersBench(out); return true; }
+  if (t=="stationload") { netPrintStationLoad(g, out); return true; }
+  if (t=="rounds") { roundTablePrint(out); return true; }
+  if (t=="clock") { netPrintClockSync(out); return true; }
+  if (t=="sync") { netPrintConvergence(out); return true; }
+
+  if (t=="prof") {
+    String v = nextTok(i);
+    if (v=="")           { profPrint(out); return true; }
+    if (v=="reset")      { profReset(); out.print("ok\n"); return true; }
+    out.print("usage: prof [reset]\n");
+    return true;
+  }
+
   if (t=="pir") {
     String v = nextTok(i);
     if (v=="on")  g.pirEnforce = true;
@@ -92,30 +147,30 @@ static bool handleCmd(const String& raw, WiFiClient& out) {
     if (t=="fill") {
       String sid = nextTok(i);
       if (sid=="all") {
-        for (uint8_t s=1;s<=5;s++) g.stationInventory[s]=g.stationCapacity[s];
+        for (uint8_t s=1;s<=g.stationCount;s++) g.stationInventory[s]=g.stationCapacity[s];
         out.print("ok\n"); return true;
       }
-      uint32_t s=0; if(!parseUint(sid,s) || s<1 || s>5){out.print("bad sid\n"); return true;}
+      uint32_t s=0; if(!parseUint(sid,s) || s<1 || s>g.stationCount){out.print("bad sid\n"); return true;}
       g.stationInventory[s]=g.stationCapacity[s];
       out.print("ok\n"); return true;
     }
     if (t=="drain") {
       String sidS = nextTok(i), nS = nextTok(i);
-      uint32_t s=0,n=0; if(!parseUint(sidS,s) || s<1 || s>5 || !parseUint(nS,n)){out.print("usage: drain <sid> <n>\n"); return true;}
+      uint32_t s=0,n=0; if(!parseUint(sidS,s) || s<1 || s>g.stationCount || !parseUint(nS,n)){out.print("usage: drain <sid> <n>\n"); return true;}
       uint16_t cur = g.stationInventory[s];
       g.stationInventory[s] = (cur > n) ? (cur - n) : 0;
       out.print("ok\n"); return true;
     }
     if (t=="cap") {
       String sidS = nextTok(i), capS = nextTok(i);
-      uint32_t s=0,c=0; if(!parseUint(sidS,s) || s<1 || s>5 || !parseUint(capS,c)){out.print("usage: cap <sid> <cap>\n"); return true;}
+      uint32_t s=0,c=0; if(!parseUint(sidS,s) || s<1 || s>g.stationCount || !parseUint(capS,c)){out.print("usage: cap <sid> <cap>\n"); return true;}
       g.stationCapacity[s]=(uint16_t)c;
       if (g.stationInventory[s] > g.stationCapacity[s]) g.stationInventory[s]=g.stationCapacity[s];
       out.print("ok\n"); return true;
     }
     if (t=="inv") {
       String sidS = nextTok(i), invS = nextTok(i);
-      uint32_t s=0,v=0; if(!parseUint(sidS,s) || s<1 || s>5 || !parseUint(invS,v)){out.print("usage: inv <sid> <inv>\n"); return true;}
+      uint32_t s=0,v=0; if(!parseUint(sidS,s) || s<1 || s>g.stationCount || !parseUint(invS,v)){out.print("usage: inv <sid> <inv>\n"); return true;}
       g.stationInventory[s]=(uint16_t)min<uint32_t>(v, g.stationCapacity[s]);
       out.print("ok\n"); return true;
     }
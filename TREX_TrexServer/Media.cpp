@@ -1,12 +1,174 @@
 #include "Media.h"
 #include <Arduino.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "EventLog.h"
+#include "GameAudio.h"
+
+struct MediaCmd {
+  MediaOp  op;
+  uint16_t arg;
+  uint32_t postedUs;
+};
+
+// sPosted/sDropped only move on loop(); the rest are bumped by the media
+// task (sCoalesced by both) and read by mediaPrintStats on loop()
+static uint32_t sPosted    = 0;
+static uint32_t sDropped   = 0;
+static std::atomic<uint32_t> sCoalesced{0};
+static std::atomic<uint32_t> sDepthMax{0};
+static std::atomic<uint32_t> sLatMaxUs{0};   // post -> UART write, task side
+static std::atomic<uint32_t> sLatSumUs{0};
+static std::atomic<uint32_t> sWrites{0};
+
+// One deferred command per device (mediaPost with `at`); anything posted
+// for that device later replaces it
+struct Deferred {
+  bool     armed;
+  MediaOp  op;
+  uint16_t arg;
+  uint32_t at;
+};
+static Deferred sDeferred[2];   // [0] Sprite, [1] DY audio
+
+static inline uint8_t deviceOf(MediaOp op) { return (op == MediaOp::SPRITE) ? 0 : 1; }
+
+static uint16_t sLagMs[(uint8_t)MediaOut::COUNT] = {};
+static const char* const kLagKeys[(uint8_t)MediaOut::COUNT] = { "lagSpr", "lagAud", "lagLed" };
+
+static void execute(const MediaCmd& c) {
+  switch (c.op) {
+    case MediaOp::SPRITE:     Serial1.write((uint8_t)c.arg); break;   // Sprite expects single-byte clip numbers
+    case MediaOp::AUDIO_PLAY: gameAudioDevPlay(c.arg);        break;
+    case MediaOp::AUDIO_STOP: gameAudioDevStop();             break;
+  }
+  const uint32_t lat = micros() - c.postedUs;
+  if (lat > sLatMaxUs.load(std::memory_order_relaxed)) sLatMaxUs.store(lat, std::memory_order_relaxed);
+  sLatSumUs.fetch_add(lat, std::memory_order_relaxed);
+  sWrites.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if MEDIA_TASK
+static QueueHandle_t sQueue = nullptr;
+
+static void mediaTask(void*) {
+  for (;;) {
+    MediaCmd c;
+    if (xQueueReceive(sQueue, &c, portMAX_DELAY) != pdTRUE) continue;
+
+    // Whatever else is already queued belongs to the same burst; only the
+    // last command per device matters.
+    bool     haveSprite = false, haveAudio = false;
+    MediaCmd sprite{}, audio{};
+    uint32_t n = 0;
+    do {
+      n++;
+      if (c.op == MediaOp::SPRITE) { if (haveSprite) sCoalesced++; sprite = c; haveSprite = true; }
+      else                         { if (haveAudio)  sCoalesced++; audio  = c; haveAudio  = true; }
+    } while (xQueueReceive(sQueue, &c, 0) == pdTRUE);
+    if (n > sDepthMax.load(std::memory_order_relaxed)) sDepthMax.store(n, std::memory_order_relaxed);
+
+    if (haveSprite) execute(sprite);
+    if (haveAudio)  execute(audio);
+  }
+}
+#endif
 
 void mediaInit() {
   Serial1.begin(SPRITE_BAUD, SERIAL_8N1, SPRITE_RX, SPRITE_TX);
   delay(20);
+
+  Preferences p;
+  p.begin("trex", true);
+  for (uint8_t o = 0; o < (uint8_t)MediaOut::COUNT; ++o) {
+    const uint16_t v = p.getUShort(kLagKeys[o], 0);
+    sLagMs[o] = (v > MEDIA_LAG_MAX_MS) ? MEDIA_LAG_MAX_MS : v;
+  }
+  p.end();
+
+#if MEDIA_TASK
+  sQueue = xQueueCreate(MEDIA_QUEUE_LEN, sizeof(MediaCmd));
+  const BaseType_t core = xPortGetCoreID() ? 0 : 1;   // the core loop() isn't on
+  if (!sQueue || xTaskCreatePinnedToCore(mediaTask, "media", MEDIA_TASK_STACK, nullptr,
+                                         MEDIA_TASK_PRIO, nullptr, core) != pdPASS) {
+    Serial.println("[MEDIA] task create FAILED, media runs inline");
+    sQueue = nullptr;
+  }
+#endif
 }
 
-void spritePlay(uint8_t clip) {
+static void send(MediaOp op, uint16_t arg) {
+  const MediaCmd c{ op, arg, micros() };
+  sPosted++;
+#if MEDIA_TASK
+  if (sQueue) {
+    if (xQueueSend(sQueue, &c, 0) != pdTRUE) sDropped++;
+    return;
+  }
+#endif
+  execute(c);
+}
+
+void mediaPost(MediaOp op, uint16_t arg, uint32_t at) {
+  Deferred& d = sDeferred[deviceOf(op)];
+  if (at && (int32_t)(at - millis()) > 0) {
+    if (d.armed) sCoalesced++;
+    d = Deferred{ true, op, arg, at };
+    return;
+  }
+  d.armed = false;
+  send(op, arg);
+}
+
+void mediaPump(uint32_t now) {
+  for (Deferred& d : sDeferred) {
+    if (!d.armed || (int32_t)(now - d.at) < 0) continue;
+    d.armed = false;
+    send(d.op, d.arg);
+  }
+}
+
+uint16_t mediaLagMs(MediaOut o) {
+  return ((uint8_t)o < (uint8_t)MediaOut::COUNT) ? sLagMs[(uint8_t)o] : 0;
+}
+
+void mediaSetLagMs(MediaOut o, uint16_t ms) {
+  if ((uint8_t)o >= (uint8_t)MediaOut::COUNT) return;
+  if (ms > MEDIA_LAG_MAX_MS) ms = MEDIA_LAG_MAX_MS;
+  sLagMs[(uint8_t)o] = ms;
+
+  Preferences p;
+  p.begin("trex", false);
+  p.putUShort(kLagKeys[(uint8_t)o], ms);
+  p.end();
+}
+
+void spritePlay(uint8_t clip, uint32_t at) {
   Serial.printf("[TREX] Sprite -> play clip %u\n", clip);
-  Serial1.write(clip);  // Sprite expects single-byte clip numbers
+  evlog(EV_SPRITE_PLAY, clip);
+  mediaPost(MediaOp::SPRITE, clip, at);
+}
+
+void mediaPrintStats(Print& out) {
+  // Each counter is read once; the average may straddle a write, which is fine for a stat line
+  const uint32_t coalesced = sCoalesced.load(std::memory_order_relaxed);
+  const uint32_t depthMax  = sDepthMax.load(std::memory_order_relaxed);
+  const uint32_t writes    = sWrites.load(std::memory_order_relaxed);
+  const uint32_t latSum    = sLatSumUs.load(std::memory_order_relaxed);
+  const uint32_t latMax    = sLatMaxUs.load(std::memory_order_relaxed);
+  out.printf("media %s posted=%lu coalesced=%lu dropped=%lu burstMax=%lu writes=%lu lat avg=%luus max=%luus\n",
+#if MEDIA_TASK
+             "task",
+#else
+             "inline",
+#endif
+             (unsigned long)sPosted, (unsigned long)coalesced, (unsigned long)sDropped,
+             (unsigned long)depthMax, (unsigned long)writes,
+             (unsigned long)(writes ? latSum / writes : 0), (unsigned long)latMax);
+  out.printf("media lag sprite=%ums audio=%ums leds=%ums\n",
+             (unsigned)sLagMs[(uint8_t)MediaOut::SPRITE], (unsigned)sLagMs[(uint8_t)MediaOut::AUDIO],
+             (unsigned)sLagMs[(uint8_t)MediaOut::LEDS]);
 }
@@ -1,4 +1,18 @@
 #pragma once
+// Show media: the Sprite video player (Serial1) and, via GameAudio, the DY
+// audio module (UART2).
+//
+// Callers never touch the UARTs. spritePlay() / gameAudioPlayOnce() /
+// gameAudioStop() post a command to a queue serviced by a media task pinned
+// to the core loop() is not on, so a light flip or GAME_OVER broadcast never
+// waits behind a UART write. The task drains whatever is queued as one batch
+// and only the last command per device survives it (a STOP immediately
+// followed by a PLAY is just the PLAY).
+//
+// Commands can also be held until a given millis() (`at`); mediaPump()
+// releases them from loop(). A device keeps at most one held command and
+// anything posted for it afterwards supersedes that.
+#include <Arduino.h>
 #include "ServerConfig.h"
 
 constexpr uint8_t CLIP_NOT_LOOKING = 0;  // GREEN loop
@@ -7,5 +21,34 @@ constexpr uint8_t CLIP_GAME_OVER   = 2;  // fail / manual stop one-shot
 constexpr uint8_t CLIP_LUNCHBREAK  = 3;  // lunchbreak bonus
 constexpr uint8_t CLIP_SUCCESS     = 4;  // success one-shot (adjust if your Sprite asset index differs)
 
-void mediaInit();
-void spritePlay(uint8_t clip);
+enum class MediaOp : uint8_t {
+  SPRITE     = 0,   // arg = clip
+  AUDIO_PLAY = 1,   // arg = DY track
+  AUDIO_STOP = 2,
+};
+
+void mediaInit();     // Serial1, saved lags, the media task; call before gameAudioInit()
+void spritePlay(uint8_t clip, uint32_t at = 0);
+
+// Queue a command for the media task (GameAudio posts through this too);
+// `at` != 0 holds it until then.
+void mediaPost(MediaOp op, uint16_t arg = 0, uint32_t at = 0);
+void mediaPump(uint32_t now);   // once per loop() pass
+
+// Output latency: command issued -> the room sees/hears it (ms), measured
+// per installation and tuned over telnet (`set sprite_lag_ms` etc.).
+// Persisted in NVS ("trex": lagSpr / lagAud / lagLed). Light flips use
+// these to line their outputs up (see Cadence.cpp).
+enum class MediaOut : uint8_t {
+  SPRITE = 0,   // clip byte -> video visibly changes
+  AUDIO  = 1,   // DY command -> track audible
+  LEDS   = 2,   // WORLD_FRAME -> station rings change (radio + render)
+  COUNT
+};
+constexpr uint16_t MEDIA_LAG_MAX_MS = 2000;
+
+uint16_t mediaLagMs(MediaOut o);
+void     mediaSetLagMs(MediaOut o, uint16_t ms);   // clamps to MEDIA_LAG_MAX_MS, saves
+
+// posted / coalesced / dropped, queue high-water, post->UART latency, lags
+void mediaPrintStats(Print& out);
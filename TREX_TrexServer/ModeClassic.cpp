@@ -6,34 +6,29 @@
 #include "Media.h"
 #include "esp_system.h"
 #include "ServerMini.h"
-#include <esp_random.h>
+#include "Timers.h"
+#include "RoundTable.h"
 #include <TrexProtocol.h>
 
 namespace {
-constexpr uint32_t GAME_TOTAL_MS          = 360000UL;  // 6:00 overall success timer
-constexpr uint32_t ROUND1_MS              = 70000UL;
-constexpr uint32_t ROUND2_MS              = 75000UL;
-constexpr uint32_t ROUND3_MS              = 75000UL;
-constexpr uint32_t ROUND4_MS              = 60000UL;
-constexpr uint32_t ROUND5_MS              = 60000UL;
+constexpr uint32_t GAME_TOTAL_MS          = 360000UL;  // 6:00 overall success timer (rounds: RoundTable.cpp)
 constexpr uint16_t BONUS_INTERMISSION_MS  = 12000;
 constexpr uint16_t BONUS_INTERMISSION2_MS = 12000;
 constexpr uint16_t BONUS2_HOP_MS          = 3000;
 constexpr uint16_t MINIGAME_MS            = 30000;
-constexpr uint8_t  ROUND_SYNC_PASSES      = 3;
-constexpr uint8_t  BONUS_SYNC_PASSES      = 2;
 }
 
-// --- Random split of TOTAL across 5 stations, each <= 56 ---
+// --- Random split of TOTAL across the live stations, each <= 56 ---
 static void splitInventoryRandom(Game& g, uint16_t total /*=100*/) {
   uint16_t remain = total;
-  for (uint8_t sid = 1; sid <= 5; ++sid) {
-    const uint8_t left = (uint8_t)(5 - sid + 1);
+  const uint8_t n = g.stationCount;
+  for (uint8_t sid = 1; sid <= n; ++sid) {
+    const uint8_t left = (uint8_t)(n - sid + 1);
     const uint16_t maxPer = 56;
     const uint16_t minX = (remain > (left - 1)*maxPer) ? (uint16_t)(remain - (left - 1)*maxPer) : 0;
     const uint16_t maxX = (remain < maxPer) ? remain : maxPer;
-    uint16_t x = (sid < 5)
-      ? (uint16_t)(minX + (esp_random() % (uint32_t)(maxX - minX + 1)))
+    uint16_t x = (sid < n)
+      ? (uint16_t)rngRange(g.rng, minX, maxX)
       : remain; // last takes the rest
     g.stationCapacity[sid]  = maxPer;
     g.stationInventory[sid] = x;
@@ -41,23 +36,21 @@ static void splitInventoryRandom(Game& g, uint16_t total /*=100*/) {
   }
 }
 
-#include "esp_system.h"  // for esp_random()
-
 static void fillAndShuffleOrder(Game& g, uint8_t avoidFirst /*0 = no guard*/) {
-  // Fill 1..MAX_STATIONS
-  for (uint8_t i = 0; i < MAX_STATIONS; ++i) g.bonus2Order[i] = i + 1;
+  const uint8_t n = g.stationCount;
+  // Fill 1..stationCount
+  for (uint8_t i = 0; i < n; ++i) g.bonus2Order[i] = i + 1;
 
   // Fisher–Yates shuffle
-  for (int i = MAX_STATIONS - 1; i > 0; --i) {
-    uint32_t r = esp_random();
-    int j = (int)(r % (uint32_t)(i + 1));
+  for (int i = n - 1; i > 0; --i) {
+    int j = (int)rngBelow(g.rng, (uint32_t)(i + 1));
     uint8_t tmp = g.bonus2Order[i];
     g.bonus2Order[i] = g.bonus2Order[j];
     g.bonus2Order[j] = tmp;
   }
 
   // Ensure we don't immediately repeat the previous SID across cycles
-  if (avoidFirst >= 1 && avoidFirst <= MAX_STATIONS && MAX_STATIONS > 1) {
+  if (avoidFirst >= 1 && avoidFirst <= n && n > 1) {
     if (g.bonus2Order[0] == avoidFirst) {
       // swap first two
       uint8_t t = g.bonus2Order[0];
@@ -68,34 +61,70 @@ static void fillAndShuffleOrder(Game& g, uint8_t avoidFirst /*0 = no guard*/) {
   g.bonus2Idx = 0;
 }
 
+// Per-round knobs, cadence policy and cadence windows from the descriptor
+void applyRoundRules(Game& g, const RoundDesc& d) {
+  g.maxCarry    = d.maxCarry;
+  g.lootPerTick = d.lootPerTick;
+  g.lootRateMs  = d.lootRateMs;
+  g.noRedThisRound       = !d.red;
+  g.allowYellowThisRound = d.yellow;
+
+  g.greenMsMin  = d.greenMin;   g.greenMsMax  = d.greenMax;
+  g.redMsMin    = d.redMin;     g.redMsMax    = d.redMax;
+  g.yellowMsMin = d.yellowMin;  g.yellowMsMax = d.yellowMax;
+  // RED must outlast the camera arming delay or motion can never count
+  if (d.redFloorPirArm && g.redMsMin) {
+    if (g.redMsMin < g.pirArmDelayMs) g.redMsMin = g.pirArmDelayMs;
+    if (g.redMsMax < g.redMsMin)      g.redMsMax = g.redMsMin;
+  }
+}
+
+// Spread `total` over the live stations the way the round asks for
+static void fillInventory(Game& g, const RoundDesc& d, uint16_t total) {
+  switch (d.split) {
+    case SplitMode::EVEN: {
+      uint16_t base = total / g.stationCount, rem = total % g.stationCount;
+      for (uint8_t sid = 1; sid <= g.stationCount; ++sid) {
+        uint16_t x = base + (rem ? 1 : 0); if (rem) rem--;
+        if (x > 56) x = 56;
+        g.stationCapacity[sid]  = 56;
+        g.stationInventory[sid] = x;
+      }
+      break;
+    }
+    case SplitMode::RANDOM:
+      splitInventoryRandom(g, total);
+      break;
+    case SplitMode::HOT:
+      // Ensure sane capacities for the hop engine; r5Start() picks the hot one
+      for (uint8_t sid = 1; sid <= g.stationCount; ++sid) {
+        if (g.stationCapacity[sid] == 0) g.stationCapacity[sid] = 56;
+        g.stationInventory[sid] = 0;
+      }
+      break;
+  }
+}
+
 // End any active holds and zero ALL players' carried before a new round
 static void endAndClearHoldsAndCarried(Game& g) {
   // End any live holds (clients will clean up visuals/audio on HOLD_END)
-  for (uint8_t i = 0; i < MAX_HOLDS; ++i) {
-    if (g.holds[i].active) {
-      sendHoldEnd(g, g.holds[i].holdId, /*EMPTY*/1);
-      g.holds[i].active = false;
-    }
-  }
+  endAllHolds(g, /*EMPTY*/1);
   // Zero every player's carried so nothing rolls into the next round
-  for (uint8_t pi = 0; pi < MAX_PLAYERS; ++pi) {
+  for (uint16_t pi = 0; pi < MAX_PLAYERS; ++pi) {
     g.players[pi].carried = 0;
   }
 }
 
 // -------- R5 internals (file-local) --------
-static inline uint32_t rr() { return esp_random(); }
-
-static void r5Shuffle(uint8_t a[5]) {
-  for (int i=4;i>0;--i) {
-    int j = rr() % (i+1);
+static void r5Shuffle(Game& g, uint8_t* a, uint8_t n) {
+  for (int i=n-1;i>0;--i) {
+    int j = (int)rngBelow(g.rng, i+1);
     uint8_t t=a[i]; a[i]=a[j]; a[j]=t;
   }
 }
 
 static bool r5AnyHoldOnSid(const Game& g, uint8_t sid) {
-  for (const auto &h : g.holds) if (h.active && h.stationId == sid) return true;
-  return false;
+  return anyHoldOnStation(g, sid);
 }
 
 static void r5SetHot(Game &g, uint8_t sid, uint32_t now) {
@@ -103,11 +132,11 @@ static void r5SetHot(Game &g, uint8_t sid, uint32_t now) {
   enterGreen(g);
 
   // One-hot inventory: hot=100%, others=0
-  for (uint8_t s=1; s<=5; ++s) {
+  for (uint8_t s=1; s<=g.stationCount; ++s) {
     uint16_t inv = (s==sid) ? g.stationCapacity[s] : 0;
     if (g.stationInventory[s] != inv) {
       g.stationInventory[s] = inv;
-      bcastStation(g, s);
+      markStationDirty(g, s);
     }
   }
 
@@ -115,9 +144,11 @@ static void r5SetHot(Game &g, uint8_t sid, uint32_t now) {
 
   // Random dwell within window
   uint16_t span = (g.r5DwellMaxMs > g.r5DwellMinMs) ? (g.r5DwellMaxMs - g.r5DwellMinMs) : 0;
-  uint16_t dwell = g.r5DwellMinMs + (span ? (rr() % (span+1)) : 0);
+  uint16_t dwell = g.r5DwellMinMs + (span ? rngBelow(g.rng, span+1) : 0);
   g.r5DwellEndAt    = now + dwell;
   g.r5NextDepleteAt = now + g.r5DepleteStepMs;
+  timerArm(TMR_R5_DWELL,   g.r5DwellEndAt);
+  timerArm(TMR_R5_DEPLETE, g.r5NextDepleteAt);
 }
 
 static void r5Start(Game &g, uint32_t now) {
@@ -125,8 +156,8 @@ static void r5Start(Game &g, uint32_t now) {
   g.r5Active = true;
 
   // Start with a shuffle-bag cycle
-  g.r5Order[0]=1; g.r5Order[1]=2; g.r5Order[2]=3; g.r5Order[3]=4; g.r5Order[4]=5;
-  r5Shuffle(g.r5Order);
+  for (uint8_t i=0; i<g.stationCount; ++i) g.r5Order[i] = i + 1;
+  r5Shuffle(g, g.r5Order, g.stationCount);
   g.r5Idx = 0;
 
   // Lock cadence policy (future-friendly knobs)
@@ -137,14 +168,14 @@ static void r5Start(Game &g, uint32_t now) {
 }
 
 static void r5HopNext(Game &g, uint32_t now) {
-  if (++g.r5Idx >= 5) { r5Shuffle(g.r5Order); g.r5Idx = 0; }
+  if (++g.r5Idx >= g.stationCount) { r5Shuffle(g, g.r5Order, g.stationCount); g.r5Idx = 0; }
   r5SetHot(g, g.r5Order[g.r5Idx], now);
 }
 
-// Call only when roundIndex==5 & PLAYING
+// Call only while the hop engine runs (r5Active) & PLAYING
 static void r5Tick(Game &g, uint32_t now) {
   // Dwell expiry → hop
-  if ((int32_t)(now - g.r5DwellEndAt) >= 0) {
+  if (timerTake(TMR_R5_DWELL)) {
     r5HopNext(g, now);
   }
 
@@ -152,16 +183,18 @@ static void r5Tick(Game &g, uint32_t now) {
   const uint8_t sid = g.r5HotSid;
   if (!sid) return;
 
-  if (!r5AnyHoldOnSid(g, sid) &&
-      g.stationInventory[sid] > 0 &&
-      (int32_t)(now - g.r5NextDepleteAt) >= 0) {
+  // The deplete fire stays pending while the station is held / empty.
+  if (timerFired(TMR_R5_DEPLETE) &&
+      !r5AnyHoldOnSid(g, sid) &&
+      g.stationInventory[sid] > 0) {
 
     uint16_t inv = g.stationInventory[sid];
     uint16_t dec = g.r5DepletePerStep;
     if (dec > inv) dec = inv;
     g.stationInventory[sid] = (uint16_t)(inv - dec);
-    bcastStation(g, sid);
+    markStationDirty(g, sid);
     g.r5NextDepleteAt = now + g.r5DepleteStepMs;
+    timerArm(TMR_R5_DEPLETE, g.r5NextDepleteAt);
   }
 }
 
@@ -175,188 +208,44 @@ static void startRound(Game& g, uint8_t idx) {
   g.r5HotSid        = 0;
   g.r5DwellEndAt    = 0;
   g.r5NextDepleteAt = 0;
+  timerCancel(TMR_R5_DWELL);
+  timerCancel(TMR_R5_DEPLETE);
 
   gameAudioStop();
   if (idx > 1) gameAudioPlayOnce(TRK_TREX_WIN);
 
-  if (idx == 1) {
-    // ---------- ROUND 1 ----------
-    g.maxCarry = 20;
-    g.noRedThisRound       = true;
-    g.allowYellowThisRound = false;
+  const RoundDesc& d = roundDesc(idx);
+  applyRoundRules(g, d);
 
+  if (idx == 1) {
     // Only set the overall game timer when starting a *new* game.
     // (Avoids surprise timer resets if Round 1 is re-entered via FORCE/NEXT paths.)
     if (g.gameStartAt == 0) g.gameStartAt = now;
     if (g.gameEndAt == 0)   g.gameEndAt   = now + GAME_TOTAL_MS;
-    g.roundEndAt  = now + ROUND1_MS;
-
-    sendStateTick(g, (g.roundEndAt > now) ? (g.roundEndAt - now) : 0);
-
     g.roundStartScore = 0;
-    g.roundGoal       = 40;
-    g.lootPerTick     = 4;
-    g.lootRateMs      = 1000;
-
-    endAndClearHoldsAndCarried(g);
-
-    // EVEN split of THIS ROUND'S total (goal - start)
-    const uint16_t roundTotal = (uint16_t)(g.roundGoal - g.roundStartScore); // =40
-    uint16_t base = roundTotal / 5, rem = roundTotal % 5;
-    for (uint8_t sid = 1; sid <= 5; ++sid) {
-      uint16_t x = base + (rem ? 1 : 0); if (rem) rem--;
-      if (x > 56) x = 56;
-      g.stationCapacity[sid]  = 56;
-      g.stationInventory[sid] = x;
-    }
-
     g.pending.needGameStart = true;
-    g.pending.nextStation   = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore     = true;
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-    return;
-  }
-
-  if (idx == 2) {
-    // ---------- ROUND 2 ----------
-    g.maxCarry = 20;
-    g.noRedThisRound       = false;
-    g.allowYellowThisRound = true;
-    g.lootRateMs  = 1000;
-    g.lootPerTick = 4;
-
+  } else {
     g.roundStartScore = g.teamScore;
-    g.roundGoal       = g.roundStartScore + 40;
-    g.roundEndAt      = now + ROUND2_MS;
-
-    endAndClearHoldsAndCarried(g);
-
-    // EVEN split of THIS ROUND'S total
-    const uint16_t roundTotal = (uint16_t)(g.roundGoal - g.roundStartScore);
-    uint16_t base = roundTotal / 5, rem = roundTotal % 5;
-    for (uint8_t sid = 1; sid <= 5; ++sid) {
-      uint16_t x = base + (rem ? 1 : 0); if (rem) rem--;
-      if (x > 56) x = 56;
-      g.stationCapacity[sid]  = 56;
-      g.stationInventory[sid] = x;
-    }
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-    return;
   }
+  g.roundGoal  = g.roundStartScore + d.goalDelta;
+  g.roundEndAt = now + d.durationMs;
 
-  if (idx == 3) {
-    // ---------- ROUND 3 ----------
-    g.maxCarry = 10;
-    g.noRedThisRound       = false;
-    g.allowYellowThisRound = true;
-    g.lootRateMs  = 1000;
-    g.lootPerTick = 4;
+  bcastWorldFrame(g);
 
-    g.roundStartScore = g.teamScore;
-    g.roundGoal       = g.roundStartScore + 40;
-    g.roundEndAt      = now + ROUND3_MS;
-
-    endAndClearHoldsAndCarried(g);
-
-    // RANDOM split of THIS ROUND'S total
-    const uint16_t roundTotal = (uint16_t)(g.roundGoal - g.roundStartScore);
-    splitInventoryRandom(g, roundTotal);
-
-    // Your R3 cadence feel
-    g.greenMsMin = 14000;  g.greenMsMax = 18000;
-    g.redMsMin   = 6500;   g.redMsMax   = 8000;
-    g.yellowMsMin= g.yellowMs; g.yellowMsMax = g.yellowMs;
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-    return;
-  }
-
-  if (idx == 4) {
-    // ---------- ROUND 4 ----------
-    g.maxCarry = 10;
-    g.noRedThisRound       = false;
-    g.allowYellowThisRound = true;
-    g.lootRateMs  = 1000;
-    g.lootPerTick = 4;
-
-    g.roundStartScore = g.teamScore;
-    g.roundGoal       = g.roundStartScore + 40;
-    g.roundEndAt      = now + ROUND4_MS;
-
-    endAndClearHoldsAndCarried(g);
-
-    // RANDOM split of THIS ROUND'S total
-    {
-      const uint16_t roundTotal = (uint16_t)(g.roundGoal - g.roundStartScore);
-      splitInventoryRandom(g, roundTotal);
-    }
-
-    const uint32_t redMin  = (g.pirArmDelayMs > 6000) ? g.pirArmDelayMs : 6000;
-    g.redMsMin   = redMin;                 g.redMsMax   = (7000 > redMin) ? 7000 : redMin;
-    g.greenMsMin = 10000;                  g.greenMsMax = 14000;
-    g.yellowMsMin= 3000;                   g.yellowMsMax = 3000;
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-    return;
-  }
-
- if (idx == 5) {
-    // ---------- ROUND 5 ----------
-    // Keep GREEN; no bonus in this round (for now).
-    g.noRedThisRound       = true;
-    g.allowYellowThisRound = false;
-
-    // Same carry/loot cadence as Round 4
-    g.maxCarry    = 10;
-    g.lootRateMs  = 1000;
-    g.lootPerTick = 4;
-
-    // Same goal & timing model as Round 4
-    g.roundStartScore = g.teamScore;
-    g.roundGoal       = g.roundStartScore + 40;
-    g.roundEndAt      = now + ROUND5_MS;
-
-    // Broadcast timers like other rounds
-    sendStateTick(g, (g.roundEndAt > now) ? (g.roundEndAt - now) : 0);
+  endAndClearHoldsAndCarried(g);
 
-    // Clear any rolls from previous round
-    endAndClearHoldsAndCarried(g);
+  // Inventory for THIS ROUND'S total (goal - start)
+  fillInventory(g, d, d.goalDelta);
 
-    // Enter GREEN and tell clients
-    enterGreen(g);
-    bcastRoundStatus(g);
+  markAllStationsDirty(g);
+  g.pending.needScore = true;
 
-    // *** Start the R5 hop engine ***
-    r5Start(g, now);
+  bonusResetForRound(g, now);
+  enterGreen(g);
+  bcastRoundStatus(g);
 
-    g.pending.nextStation   = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore     = true;
-    return;
-  }
+  // *** Start the R5 hop engine ***
+  if (d.split == SplitMode::HOT) r5Start(g, now);
 }
 
 // Retry the current round after a GOAL_NOT_MET failure (consumes a life elsewhere).
@@ -396,11 +285,14 @@ static void retryCurrentRoundAfterGoalFail(Game& g) {
   g.r5HotSid        = 0;
   g.r5DwellEndAt    = 0;
   g.r5NextDepleteAt = 0;
+  timerCancel(TMR_R5_DWELL);
+  timerCancel(TMR_R5_DEPLETE);
 
   // Reset the round timer (keep overall gameStartAt/gameEndAt untouched).
+  const RoundDesc& d = roundDesc(idx);
   g.roundStartAt = now;
-  g.roundEndAt   = now + ((idx == 1) ? ROUND1_MS : (idx == 2) ? ROUND2_MS : (idx == 3) ? ROUND3_MS : (idx == 4) ? ROUND4_MS : ROUND5_MS);
-  sendStateTick(g, (g.roundEndAt > now) ? (g.roundEndAt - now) : 0);
+  g.roundEndAt   = now + d.durationMs;
+  bcastWorldFrame(g);
 
   // Remaining points needed to hit the existing absolute goal.
   const uint16_t remaining = (g.roundGoal > g.teamScore)
@@ -408,138 +300,21 @@ static void retryCurrentRoundAfterGoalFail(Game& g) {
     : 0;
 
   // Round-specific knobs + inventory refill style.
-  if (idx == 1) {
-    g.maxCarry = 20;
-    g.noRedThisRound       = true;
-    g.allowYellowThisRound = false;
-    g.lootPerTick          = 4;
-    g.lootRateMs           = 1000;
-
-    // EVEN split of remaining
-    uint16_t base = remaining / 5, rem = remaining % 5;
-    for (uint8_t sid = 1; sid <= 5; ++sid) {
-      uint16_t x = base + (rem ? 1 : 0); if (rem) rem--;
-      if (x > 56) x = 56;
-      g.stationCapacity[sid]  = 56;
-      g.stationInventory[sid] = x;
-    }
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-    return;
-  }
-
-  if (idx == 2) {
-    g.maxCarry = 20;
-    g.noRedThisRound       = false;
-    g.allowYellowThisRound = true;
-    g.lootRateMs           = 1000;
-    g.lootPerTick          = 4;
-
-    // EVEN split of remaining
-    uint16_t base = remaining / 5, rem = remaining % 5;
-    for (uint8_t sid = 1; sid <= 5; ++sid) {
-      uint16_t x = base + (rem ? 1 : 0); if (rem) rem--;
-      if (x > 56) x = 56;
-      g.stationCapacity[sid]  = 56;
-      g.stationInventory[sid] = x;
-    }
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-    return;
-  }
-
-  if (idx == 3) {
-    g.maxCarry = 10;
-    g.noRedThisRound       = false;
-    g.allowYellowThisRound = true;
-    g.lootRateMs           = 1000;
-    g.lootPerTick          = 4;
-
-    // RANDOM split of remaining
-    splitInventoryRandom(g, remaining);
-
-    // Restore the intended Round 3 cadence feel
-    g.greenMsMin = 14000;  g.greenMsMax = 18000;
-    g.redMsMin   = 6500;   g.redMsMax   = 8000;
-    g.yellowMsMin= g.yellowMs; g.yellowMsMax = g.yellowMs;
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-    return;
-  }
-
-  if (idx == 4) {
-    g.maxCarry = 10;
-    g.noRedThisRound       = false;
-    g.allowYellowThisRound = true;
-    g.lootRateMs           = 1000;
-    g.lootPerTick          = 4;
-
-    // RANDOM split of remaining
-    splitInventoryRandom(g, remaining);
-
-    // Restore Round 4 cadence windowing
-    const uint32_t redMin  = (g.pirArmDelayMs > 6000) ? g.pirArmDelayMs : 6000;
-    g.redMsMin   = redMin;                 g.redMsMax   = (7000 > redMin) ? 7000 : redMin;
-    g.greenMsMin = 10000;                  g.greenMsMax = 14000;
-    g.yellowMsMin= 3000;                   g.yellowMsMax = 3000;
-
-    bonusResetForRound(g, now);
-    enterGreen(g);
-    bcastRoundStatus(g);
-
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-    return;
-  }
-
-  // idx >= 5: Round 5 retry
-  {
-    g.noRedThisRound       = true;
-    g.allowYellowThisRound = false;
-
-    g.maxCarry   = 10;
-    g.lootRateMs = 1000;
-    g.lootPerTick= 4;
+  applyRoundRules(g, d);
+  fillInventory(g, d, remaining);
 
-    // Ensure sane capacities for the hop engine
-    for (uint8_t sid = 1; sid <= 5; ++sid) {
-      if (g.stationCapacity[sid] == 0) g.stationCapacity[sid] = 56;
-      g.stationInventory[sid] = 0;
-    }
-
-    enterGreen(g);
-    bcastRoundStatus(g);
+  bonusResetForRound(g, now);
+  enterGreen(g);
+  bcastRoundStatus(g);
 
-    // Restart the R5 hop engine
-    r5Start(g, now);
+  // Restart the R5 hop engine
+  if (d.split == SplitMode::HOT) r5Start(g, now);
 
-    g.pending.nextStation = 1;
-    g.pending.stationPasses = ROUND_SYNC_PASSES;
-    g.pending.needScore   = true;
-  }
+  markAllStationsDirty(g);
+  g.pending.needScore   = true;
 }
 
-static const uint8_t ST_FIRST = 1;
-static const uint8_t ST_LAST  = MAX_STATIONS;
+static const uint8_t ST_FIRST = 1;   // last is g.stationCount
 
 void startBonusIntermission(Game& g, uint16_t durationMs /*=BONUS_INTERMISSION_MS*/) {
   // End any holds and clear carried so nothing rolls into intermission
@@ -553,8 +328,7 @@ void startBonusIntermission(Game& g, uint16_t durationMs /*=BONUS_INTERMISSION_M
   g.bonusInterEnd     = g.bonusInterStart + durationMs;
   g.bonusWarnTickStarted = false;   // arm the last-3s tick
   
-  uint32_t now = millis();
-  sendStateTick(g, (g.bonusInterEnd > now) ? (g.bonusInterEnd - now) : 0);
+  bcastWorldFrame(g);
 
   // Lock cadence to GREEN (no yellow/red during intermission)
   g.noRedThisRound       = true;
@@ -566,14 +340,13 @@ void startBonusIntermission(Game& g, uint16_t durationMs /*=BONUS_INTERMISSION_M
 
   // Fill every station to capacity, broadcast, and mark bonus ON for all
   g.bonusActiveMask = 0;
-  for (uint8_t sid = ST_FIRST; sid <= ST_LAST; ++sid) {
+  for (uint8_t sid = ST_FIRST; sid <= g.stationCount; ++sid) {
     g.stationInventory[sid] = g.stationCapacity[sid];
-    bcastStation(g, sid);
+    markStationDirty(g, sid);
     g.bonusActiveMask |= (1u << sid);
     g.bonusEndsAt[sid] = g.bonusInterEnd;
   }
-  g.pending.nextStation   = 1;
-  g.pending.stationPasses = BONUS_SYNC_PASSES;
+  markAllStationsDirty(g);
   bcastBonusUpdate(g);  // clients: rainbow + spawn chime
 }
 
@@ -582,10 +355,10 @@ void tickBonusIntermission(Game& g, uint32_t now) {
 
   // Finish condition
   if ((int32_t)(now - g.bonusInterEnd) >= 0) {
-    for (uint8_t sid = ST_FIRST; sid <= ST_LAST; ++sid) {
+    for (uint8_t sid = ST_FIRST; sid <= g.stationCount; ++sid) {
       if (g.stationInventory[sid] != 0) {
         g.stationInventory[sid] = 0;
-        bcastStation(g, sid);
+        markStationDirty(g, sid);
       }
       g.bonusEndsAt[sid] = 0;
     }
@@ -603,7 +376,7 @@ void tickBonusIntermission(Game& g, uint32_t now) {
       g.bonusWarnTickStarted = false;
     }
     
-    startRound(g, /*idx=*/3);
+    startRound(g, /*idx=*/g.roundIndex + 1);
     return;
   }
 
@@ -618,19 +391,20 @@ void tickBonusIntermission(Game& g, uint32_t now) {
     g.bonusWarnTickStarted = true;
   }
 
-  for (uint8_t sid = ST_FIRST; sid <= ST_LAST; ++sid) {
+  for (uint8_t sid = ST_FIRST; sid <= g.stationCount; ++sid) {
     const uint16_t cap    = g.stationCapacity[sid];
     const uint16_t target = (uint16_t)((uint64_t)cap * timeLeft / T);
     if (g.stationInventory[sid] > target) {
       g.stationInventory[sid] = target;
-      bcastStation(g, sid);
+      markStationDirty(g, sid);
     }
   }
 }
 
-static uint8_t nextSidSeq(uint8_t cur) {
+static uint8_t nextSidSeq(Game& g, uint8_t cur) {
   uint8_t n;
-  do { n = (uint8_t)((esp_random() % ST_LAST) + ST_FIRST); } while (n == cur);
+  if (g.stationCount <= 1) return ST_FIRST;
+  do { n = (uint8_t)rngRange(g.rng, ST_FIRST, g.stationCount); } while (n == cur);
   return n;
 }
 
@@ -652,10 +426,10 @@ void startBonusIntermission2(Game& g, uint16_t durationMs /*=BONUS_INTERMISSION2
   spritePlay(CLIP_LUNCHBREAK);
 
   // All stations to 0, set TTLs, broadcast
-  for (uint8_t sid = 1; sid <= MAX_STATIONS; ++sid) {
+  for (uint8_t sid = 1; sid <= g.stationCount; ++sid) {
     g.stationInventory[sid] = 0;
     g.bonusEndsAt[sid]      = g.bonus2End;
-    bcastStation(g, sid);
+    markStationDirty(g, sid);
   }
 
   // Build first random order (no avoid on the very first cycle)
@@ -664,17 +438,15 @@ void startBonusIntermission2(Game& g, uint16_t durationMs /*=BONUS_INTERMISSION2
   // Activate the first station in the permutation
   g.bonus2Sid = g.bonus2Order[g.bonus2Idx++];
   g.stationInventory[g.bonus2Sid] = g.stationCapacity[g.bonus2Sid];
-  bcastStation(g, g.bonus2Sid);
+  markStationDirty(g, g.bonus2Sid);
 
   g.bonusActiveMask = (1u << g.bonus2Sid);
-  g.pending.nextStation   = 1;
-  g.pending.stationPasses = BONUS_SYNC_PASSES;
+  markAllStationsDirty(g);
   bcastBonusUpdate(g);
 
   g.bonus2NextHopAt = g.bonus2Start + g.bonus2HopMs;
 
-  uint32_t now = millis();
-  sendStateTick(g, (g.bonus2End > now) ? (g.bonus2End - now) : 0);
+  bcastWorldFrame(g);
 }
 
 void tickBonusIntermission2(Game& g, uint32_t now) {
@@ -682,8 +454,8 @@ void tickBonusIntermission2(Game& g, uint32_t now) {
 
   // Finish
   if ((int32_t)(now - g.bonus2End) >= 0) {
-    for (uint8_t sid = 1; sid <= MAX_STATIONS; ++sid) {
-      if (g.stationInventory[sid] != 0) { g.stationInventory[sid] = 0; bcastStation(g, sid); }
+    for (uint8_t sid = 1; sid <= g.stationCount; ++sid) {
+      if (g.stationInventory[sid] != 0) { g.stationInventory[sid] = 0; markStationDirty(g, sid); }
       g.bonusEndsAt[sid] = 0;
     }
     g.bonusActiveMask = 0; bcastBonusUpdate(g);
@@ -692,7 +464,7 @@ void tickBonusIntermission2(Game& g, uint32_t now) {
     g.bonusIntermission2 = false;
     g.noRedThisRound       = false;
     g.allowYellowThisRound = true;
-    startRound(g, /*idx=*/4);
+    startRound(g, /*idx=*/g.roundIndex + 1);
     return;
   }
 
@@ -708,14 +480,14 @@ void tickBonusIntermission2(Game& g, uint32_t now) {
     const uint16_t target = (el >= hopMs) ? 0 : (uint16_t)((uint64_t)cap * (hopMs - el) / hopMs);
     if (g.stationInventory[g.bonus2Sid] > target) {
       g.stationInventory[g.bonus2Sid] = target;
-      bcastStation(g, g.bonus2Sid);
+      markStationDirty(g, g.bonus2Sid);
     }
   }
 
   // Force non-active stations to 0 (and keep them there)
-  for (uint8_t sid = 1; sid <= MAX_STATIONS; ++sid) {
+  for (uint8_t sid = 1; sid <= g.stationCount; ++sid) {
     if (sid == g.bonus2Sid) continue;
-    if (g.stationInventory[sid] != 0) { g.stationInventory[sid] = 0; bcastStation(g, sid); }
+    if (g.stationInventory[sid] != 0) { g.stationInventory[sid] = 0; markStationDirty(g, sid); }
   }
 
   // Hop?
@@ -723,18 +495,18 @@ void tickBonusIntermission2(Game& g, uint32_t now) {
     // Zero current active (if not already)
     if (g.stationInventory[g.bonus2Sid] != 0) {
       g.stationInventory[g.bonus2Sid] = 0;
-      bcastStation(g, g.bonus2Sid);
+      markStationDirty(g, g.bonus2Sid);
     }
 
     // If we exhausted the permutation, reshuffle; avoid current SID repeating
-    if (g.bonus2Idx >= MAX_STATIONS) {
+    if (g.bonus2Idx >= g.stationCount) {
       fillAndShuffleOrder(g, /*avoidFirst=*/g.bonus2Sid);
     }
     g.bonus2Sid = g.bonus2Order[g.bonus2Idx++];
 
     // New active to full capacity
     g.stationInventory[g.bonus2Sid] = g.stationCapacity[g.bonus2Sid];
-    bcastStation(g, g.bonus2Sid);
+    markStationDirty(g, g.bonus2Sid);
 
     // Update mask & notify for chime at the new station
     g.bonusActiveMask = (1u << g.bonus2Sid);
@@ -754,7 +526,7 @@ void tickBonusIntermission2(Game& g, uint32_t now) {
 
 void modeClassicForceRound(Game& g, uint8_t idx, bool playWin) {
   if (idx < 1) idx = 1;
-  if (idx > 5) idx = 5;
+  if (idx > ROUND_COUNT) idx = ROUND_COUNT;
 
   // Make sure we’re in active play
   g.phase = Phase::PLAYING;
@@ -795,9 +567,30 @@ static inline void endR35Now(Game& g) {
   g.allowYellowThisRound = true;
 }
 
+// Minigame between rounds (R4 -> R5); modeClassic's caller ends it and
+// forces the next round.
+static void startMinigame(Game& g, uint32_t now) {
+  g.mgActive     = true;
+  g.mgCfg.seed   = rngNext(g.rng);
+  g.mgCfg.timerMs= MINIGAME_MS;
+  g.mgCfg.speedMinMs = 20;  g.mgCfg.speedMaxMs = 80;
+  g.mgCfg.segMin = 6;       g.mgCfg.segMax = 16;
+  g.mgStartedAt  = now;
+  g.mgDeadline   = now + g.mgCfg.timerMs;
+  g.mgAllTriedAt = 0;
+  g.mgTriedMask  = 0;
+  g.mgSuccessMask= 0;
+  g.mgExpectedStations = g.stationCount;
+  bcastMgStart(g, g.mgCfg);
+  g.noRedThisRound = true; g.allowYellowThisRound = false;
+  cadenceReplan(g);   // the drawn YELLOW/RED segments no longer apply
+}
+
 void modeClassicNextRound(Game& g, bool playWin) {
+  const AfterRound after = roundDesc(g.roundIndex).after;
+
   // Finish R2 -> R2.5 path
-  if (g.roundIndex == 2 && !g.bonusIntermission) {
+  if (after == AfterRound::BONUS_ALL && !g.bonusIntermission) {
     startBonusIntermission(g, /*durationMs=*/BONUS_INTERMISSION_MS);
     return;
   }
@@ -811,12 +604,12 @@ void modeClassicNextRound(Game& g, bool playWin) {
     bcastBonusUpdate(g);
     g.noRedThisRound       = false;
     g.allowYellowThisRound = true;
-    startRound(g, /*idx=*/3);
+    startRound(g, /*idx=*/g.roundIndex + 1);
     return;
   }
 
   // Finish R3 -> R3.5 path
-  if (g.roundIndex == 3 && !g.bonusIntermission2) {
+  if (after == AfterRound::BONUS_HOP && !g.bonusIntermission2) {
     startBonusIntermission2(g, /*durationMs=*/BONUS_INTERMISSION2_MS, /*hopMs=*/BONUS2_HOP_MS);
     return;
   }
@@ -831,7 +624,7 @@ void modeClassicNextRound(Game& g, bool playWin) {
     bcastBonusUpdate(g);
     g.noRedThisRound       = false;
     g.allowYellowThisRound = true;
-    startRound(g, /*idx=*/4);
+    startRound(g, /*idx=*/g.roundIndex + 1);
     return;
   }
 
@@ -839,30 +632,18 @@ void modeClassicNextRound(Game& g, bool playWin) {
   if (g.mgActive) {
     g.mgActive = false;
     bcastMgStop(g);
-    modeClassicForceRound(g, 5, /*playWin=*/false);  // startRound(5) will arm R5 engine
+    modeClassicForceRound(g, g.roundIndex + 1, /*playWin=*/false);  // startRound(5) will arm R5 engine
     return;
   }
 
   // From R4, pressing "next" starts the minigame (if not already running).
-  if (g.roundIndex == 4) {
-    g.mgActive     = true;
-    g.mgCfg.seed   = esp_random();
-    g.mgCfg.timerMs= MINIGAME_MS;
-    g.mgCfg.speedMinMs = 20;  g.mgCfg.speedMaxMs = 80;
-    g.mgCfg.segMin = 6;       g.mgCfg.segMax = 16;
-    g.mgStartedAt  = millis();
-    g.mgDeadline   = g.mgStartedAt + g.mgCfg.timerMs;
-    g.mgAllTriedAt = 0;
-    g.mgTriedMask  = 0;
-    g.mgSuccessMask= 0;
-    g.mgExpectedStations = MAX_STATIONS;    // set 5 if only 5 Loots
-    bcastMgStart(g, g.mgCfg);
-    g.noRedThisRound = true; g.allowYellowThisRound = false;
+  if (after == AfterRound::MINIGAME) {
+    startMinigame(g, millis());
     return;
   }
 
-  // Otherwise: advance one round (cap at 5). startRound(5) will start the R5 hop engine.
-  uint8_t next = (g.roundIndex >= 5) ? 5 : (g.roundIndex + 1);
+  // Otherwise: advance one round (cap at the last). startRound(5) will start the R5 hop engine.
+  uint8_t next = (g.roundIndex >= ROUND_COUNT) ? ROUND_COUNT : (g.roundIndex + 1);
 
   // Make sure we’re in active play and optionally play win sting
   g.phase = Phase::PLAYING;
@@ -882,19 +663,42 @@ void modeClassicNextRound(Game& g, bool playWin) {
   startRound(g, next);
 }
 
-static void continueRound5UntilGameEnd(Game& g, uint32_t now) {
+static void continueRoundUntilGameEnd(Game& g, uint32_t now) {
   // TREX now uses the 6-minute overall timer as the primary success condition.
   // In Round 5, hitting the local segment goal should keep the room running until
   // that overall timer expires instead of ending early.
+  const RoundDesc& d = roundDesc(g.roundIndex);
   g.roundStartScore = g.teamScore;
-  g.roundGoal       = g.roundStartScore + 40;
-  g.roundEndAt      = now + ROUND5_MS;
+  g.roundGoal       = g.roundStartScore + d.goalDelta;
+  g.roundEndAt      = now + d.durationMs;
   if (g.gameEndAt > 0 && g.roundEndAt > g.gameEndAt) {
     g.roundEndAt = g.gameEndAt;
   }
-  sendStateTick(g, (g.roundEndAt > now) ? (g.roundEndAt - now) : 0);
+  bcastWorldFrame(g);
   bcastRoundStatus(g);
-  bcastGameStatus(g);
+}
+
+// Round goal met: one step along the round's `after`
+static void finishRound(Game& g, uint32_t now) {
+  switch (roundDesc(g.roundIndex).after) {
+    case AfterRound::NEXT:
+      startRound(g, g.roundIndex + 1);
+      return;
+    case AfterRound::BONUS_ALL:
+      startBonusIntermission(g, /*durationMs=*/BONUS_INTERMISSION_MS);
+      return;
+    case AfterRound::BONUS_HOP:
+      startBonusIntermission2(g, /*durationMs=*/BONUS_INTERMISSION2_MS, /*hopMs=*/BONUS2_HOP_MS);
+      return;
+    case AfterRound::MINIGAME:
+      startMinigame(g, now);
+      bcastWorldFrame(g);   // stage timer should reflect the minigame countdown
+      return;
+    case AfterRound::LOOP:
+      // Rolls in segments until the overall 6-minute timer ends
+      continueRoundUntilGameEnd(g, now);
+      return;
+  }
 }
 
 
@@ -917,39 +721,14 @@ void modeClassicMaybeAdvance(Game& g) {
   // Do nothing while intermissions are running; their tickers advance them
   if (g.bonusIntermission || g.bonusIntermission2) return;
 
+  // Before modeClassicInit() there is no round to advance
+  if (g.roundIndex == 0) return;
+
   // ===== Goal met path =====
   if (g.teamScore >= g.roundGoal) {
     gameAudioStop();
-
-    if      (g.roundIndex == 1) { startRound(g, 2); return; }
-    else if (g.roundIndex == 2) { startBonusIntermission(g, /*durationMs=*/BONUS_INTERMISSION_MS); return; }
-    else if (g.roundIndex == 3) { startBonusIntermission2(g, /*durationMs=*/BONUS_INTERMISSION2_MS, /*hopMs=*/BONUS2_HOP_MS); return; }
-    else if (g.roundIndex == 4) {
-      // === START MINIGAME (between R4->R5) ===
-      g.mgActive     = true;
-      g.mgCfg.seed   = esp_random();
-      g.mgCfg.timerMs= MINIGAME_MS;
-      g.mgCfg.speedMinMs = 20;  g.mgCfg.speedMaxMs = 80;
-      g.mgCfg.segMin = 6;       g.mgCfg.segMax = 16;
-      g.mgStartedAt  = now;
-      g.mgDeadline   = now + g.mgCfg.timerMs;
-      g.mgAllTriedAt = 0;
-      g.mgTriedMask  = 0;
-      g.mgSuccessMask= 0;
-      g.mgExpectedStations = MAX_STATIONS;    // set 5 if only 5 Loots
-      bcastMgStart(g, g.mgCfg);
-      g.noRedThisRound = true; g.allowYellowThisRound = false;
-
-      // Stage timer should reflect the minigame countdown.
-      sendStateTick(g, (g.mgDeadline > now) ? (g.mgDeadline - now) : 0);
-      bcastGameStatus(g);
-      return;
-    }
-    else if (g.roundIndex == 5) {
-      // Round 5 now loops in 60s segments until the overall 6-minute timer ends.
-      continueRound5UntilGameEnd(g, now);
-      return;
-    }
+    finishRound(g, now);
+    return;
   }
 
   // *** Guard: if no round end time is set yet, do not treat it as a timeout ***
@@ -984,63 +763,13 @@ void modeClassicMaybeAdvance(Game& g) {
     }
 
     gameAudioStop();
-
-    if      (g.roundIndex == 1) { startRound(g, 2); return; }
-    else if (g.roundIndex == 2) { startBonusIntermission(g, /*durationMs=*/BONUS_INTERMISSION_MS); return; }
-    else if (g.roundIndex == 3) { startBonusIntermission2(g, /*durationMs=*/BONUS_INTERMISSION2_MS, /*hopMs=*/BONUS2_HOP_MS); return; }
-    else if (g.roundIndex == 4) {
-      // Timeout at R4 also enters the minigame
-      g.mgActive     = true;
-      g.mgCfg.seed   = esp_random();
-      g.mgCfg.timerMs= MINIGAME_MS;
-      g.mgCfg.speedMinMs = 20;  g.mgCfg.speedMaxMs = 80;
-      g.mgCfg.segMin = 6;       g.mgCfg.segMax = 16;
-      g.mgStartedAt  = now;
-      g.mgDeadline   = now + g.mgCfg.timerMs;
-      g.mgAllTriedAt = 0;
-      g.mgTriedMask  = 0;
-      g.mgSuccessMask= 0;
-      g.mgExpectedStations = MAX_STATIONS;
-      bcastMgStart(g, g.mgCfg);
-      g.noRedThisRound = true; g.allowYellowThisRound = false;
-
-      // Stage timer should reflect the minigame countdown.
-      sendStateTick(g, (g.mgDeadline > now) ? (g.mgDeadline - now) : 0);
-      bcastGameStatus(g);
-      return;
-    }
-    else if (g.roundIndex == 5) {
-      // R5 timeout -> if the local segment goal was met, keep rolling until the
-      // overall game timer expires. Otherwise it is still a life-loss retry.
-      if (g.teamScore >= g.roundGoal) {
-        continueRound5UntilGameEnd(g, now);
-      } else {
-        // Round 5 goal failure also costs a life; retry R5 until lives run out.
-        bool skipLife = false;
-        if (g.lifeLossLockoutUntil) {
-          const uint32_t lastLossAt = (g.lifeLossLockoutUntil >= g.lifeLossCooldownMs)
-            ? (g.lifeLossLockoutUntil - g.lifeLossCooldownMs)
-            : 0;
-          if (lastLossAt && (uint32_t)(now - lastLossAt) < GOAL_TIMEOUT_DOUBLELOSS_GUARD_MS) {
-            skipLife = true;
-          }
-        }
-        if (!skipLife) {
-          const LifeLossResult r = applyLifeLoss(g, /*GOAL_NOT_MET*/4, GAMEOVER_BLAME_ALL, /*obeyLockout=*/false);
-          if (r == LifeLossResult::GAME_OVER) return;
-        } else {
-          Serial.println("[TREX] Timeout immediately after life loss (R5): restarting without extra life.");
-        }
-        retryCurrentRoundAfterGoalFail(g);
-      }
-      return;
-    }
+    finishRound(g, now);
   }
 }
 
 void modeClassicOnPlayingTick(Game& g, uint32_t now) {
   // Other per-frame mechanics while PLAYING (e.g., Round 5 hop/deplete)
-  if (g.roundIndex == 5 && g.r5Active) {
+  if (g.r5Active) {
     r5Tick(g, now);
   }
 }
@@ -1,9 +1,12 @@
 #pragma once
 #include "GameModel.h"
+#include "RoundTable.h"
 
 // Configure warmup + level table (fixed intervals that speed up)
 void modeClassicInit(Game& g);
 void modeClassicMaybeAdvance(Game& g);
+// Per-round knobs (carry, loot rate), cadence policy and windows from `d`
+void applyRoundRules(Game& g, const RoundDesc& d);
 // Add near other declarations
 void modeClassicForceRound(Game& g, uint8_t idx, bool playWin = true);
 void modeClassicNextRound(Game& g, bool playWin = true);
@@ -1,6 +1,10 @@
 #include <TrexTransport.h>
 #include <esp_random.h>
+#include <atomic>
+#include <esp_now.h>
+#include <esp_timer.h>
 #include <TrexProtocol.h>
+#include "TrexProtocolExt.h"
 #include "Net.h"
 #include "Media.h"
 #include "OtaCampaign.h"
@@ -8,9 +12,14 @@
 #include "Cadence.h"
 #include "Bonus.h"
 #include "ServerMini.h"
+#include "EventLog.h"
+#include "Timers.h"
+#include "Journal.h"
+#include "RoundTable.h"
 
 // From main server sketch
 extern void startNewGame(Game& g);
+extern Game g;
 
 // --- Maintenance / control request flags (CONTROL -> server) ---
 static bool sEnterMaintRequested   = false;
@@ -76,9 +85,287 @@ bool netConsumeRadioCfgRequest(RadioCfgPayload& out) {
   return true;
 }
 
+/* ── RX queue (transport callback → loop) ─────────────────── */
+// The transport callback only copies the frame into a single-producer /
+// single-consumer ring; netDrainRx() dispatches from loop(), so handleRx()
+// never races loop() over holds[] / players[] / score.
+constexpr uint8_t  RXQ_SLOTS   = 16;    // power of two
+constexpr uint16_t RXQ_MAX_LEN = 250;   // ESP-NOW max payload
+
+struct RxSlot {
+  uint16_t len;
+  uint32_t atUs;                        // enqueue time, for RX->handle latency
+  uint8_t  data[RXQ_MAX_LEN];
+};
+static RxSlot               sRxq[RXQ_SLOTS];
+static std::atomic<uint8_t> sRxHead{0};  // written by the callback only
+static std::atomic<uint8_t> sRxTail{0};  // written by loop() only
+
+static uint32_t sRxOverflow  = 0;       // dropped: ring full
+static uint32_t sRxOversize  = 0;       // dropped: frame > slot
+static uint8_t  sRxHighWater = 0;
+static uint32_t sRxLatMaxUs  = 0;
+static uint32_t sRxLatSumUs  = 0;
+static uint32_t sRxLatCount  = 0;
+static uint32_t sRxAtUs      = 0;       // enqueue micros() of the frame being handled
+
+// Per-type RX accounting (see `status`)
+struct RxCounters {
+  uint32_t rx;          // arrived (any source / length)
+  uint32_t dropped;     // wrong source station
+  uint32_t malformed;   // wrong payload length / truncated
+};
+static RxCounters sRxCount[256];
+static uint32_t   sRxBadVersion = 0;
+static bool       sRxVerbose    = false;   // per-packet "[NET] RX" log
+
+void netSetRxVerbose(bool on) { sRxVerbose = on; }
+bool netRxVerbose()           { return sRxVerbose; }
+
+// --- TX accounting (see `status`) ---
+// Frames are bucketed by the stage the room was in when they went out; the
+// stage is re-evaluated (and its wall time accrued) on every WORLD_FRAME.
+static uint32_t sTxFrames[NET_STAGE_COUNT] = {0};
+static uint32_t sTxBytes [NET_STAGE_COUNT] = {0};
+static uint32_t sStageMs [NET_STAGE_COUNT] = {0};
+static uint8_t  sTxStage       = NET_STAGE_IDLE;
+static uint32_t sTxStageSince  = 0;
+
+// --- Airtime vs concurrent holds (see `status`) ---
+// While accrual runs, every frame we send is also binned by how many holds
+// were active at the time, along with the wall time spent at that count.
+// Estimated airtime assumes the ESP-NOW default 1 Mbps rate: long preamble
+// plus the 802.11 action frame / vendor IE overhead around our payload.
+constexpr uint32_t AIR_PREAMBLE_US   = 192;
+constexpr uint32_t AIR_OVERHEAD_BYTES = 39;
+constexpr uint32_t AIR_GAP_MS        = 250;   // longer gaps aren't accrual time
+
+static uint32_t sAirMs    [MAX_HOLDS + 1] = {0};
+static uint32_t sAirFrames[MAX_HOLDS + 1] = {0};
+static uint32_t sAirUs    [MAX_HOLDS + 1] = {0};
+static uint8_t  sAirBin    = 0xFF;             // 0xFF = not in accrual
+static uint32_t sAirLastMs = 0;
+
+void netNoteAccrualPass(uint8_t activeHolds, uint32_t now) {
+  if (activeHolds > MAX_HOLDS) activeHolds = MAX_HOLDS;
+  if (sAirBin != 0xFF && (now - sAirLastMs) < AIR_GAP_MS) sAirMs[sAirBin] += now - sAirLastMs;
+  sAirBin    = activeHolds;
+  sAirLastMs = now;
+}
+
+static void txAccount(const uint8_t* data, uint16_t len) {
+  journalTx(data, len);
+  sTxFrames[sTxStage]++;
+  sTxBytes [sTxStage] += len;
+  if (sAirBin != 0xFF && (millis() - sAirLastMs) < AIR_GAP_MS) {
+    sAirFrames[sAirBin]++;
+    sAirUs[sAirBin] += AIR_PREAMBLE_US + (AIR_OVERHEAD_BYTES + len) * 8;
+  }
+}
+
+static bool txBroadcast(const uint8_t* data, uint16_t len) {
+  txAccount(data, len);
+  return Transport::broadcast(data, len);
+}
+
+static uint8_t stageOf(const Game& g) {
+  if (g.phase != Phase::PLAYING)                   return NET_STAGE_IDLE;
+  if (g.mgActive)                                  return NET_STAGE_MG;
+  if (g.bonusIntermission || g.bonusIntermission2) return NET_STAGE_BONUS;
+  if (g.roundIndex >= 1 && g.roundIndex <= ROUND_COUNT) return g.roundIndex;
+  return NET_STAGE_IDLE;
+}
+
+static void accrueStage(const Game& g, uint32_t now) {
+  sStageMs[sTxStage] += now - sTxStageSince;
+  sTxStageSince = now;
+  sTxStage      = stageOf(g);
+}
+
+// --- Unicast to the station that owns a hold ---
+// Per-hold messages (ACK / TICK / HOLD_END) go straight to the originating
+// Loot once we know its MAC from HELLO: ESP-NOW unicast gets MAC-layer ACKs
+// and retries, and the other stations don't have to parse and discard it.
+// Broadcast stays the fallback (unknown MAC, framed wire mode, send error).
+// Only Loots own holds, so only Loot ids get a slot.
+constexpr uint8_t NET_PEER_SLOTS = MAX_STATIONS + 1;   // indexed by Loot id
+
+static bool     sUnicastEnabled = false;
+static bool     sPeerKnown[NET_PEER_SLOTS] = {false};
+static uint8_t  sPeerMac[NET_PEER_SLOTS][6];
+static uint32_t sTxUnicast      = 0;
+static uint32_t sTxUnicastFail  = 0;
+static uint32_t sTxUnicastFallback = 0;
+
+void netSetUnicastEnabled(bool on) { sUnicastEnabled = on; }
+
+static void learnPeer(uint8_t sid, const uint8_t mac[6]) {
+  if (!trexIsLootId(sid) || sid >= NET_PEER_SLOTS) return;
+
+  bool allZero = true;
+  for (uint8_t i = 0; i < 6; ++i) if (mac[i]) { allZero = false; break; }
+  if (allZero) return;   // older firmware leaves HelloPayload.mac zeroed
+
+  if (sPeerKnown[sid] && memcmp(sPeerMac[sid], mac, 6) == 0) return;
+
+  if (!esp_now_is_peer_exist(mac)) {
+    esp_now_peer_info_t peer{};
+    memcpy(peer.peer_addr, mac, 6);
+    peer.channel = 0;                // current channel
+    peer.ifidx   = WIFI_IF_STA;
+    peer.encrypt = false;
+    if (esp_now_add_peer(&peer) != ESP_OK) {
+      Serial.printf("[NET] add peer for station %u failed\n", (unsigned)sid);
+      return;
+    }
+  }
+  memcpy(sPeerMac[sid], mac, 6);
+  sPeerKnown[sid] = true;
+  Serial.printf("[NET] station %u -> %02X:%02X:%02X:%02X:%02X:%02X (unicast)\n", (unsigned)sid,
+                mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+static bool txToStation(uint8_t sid, const uint8_t* data, uint16_t len) {
+  if (sUnicastEnabled && sid < NET_PEER_SLOTS && sPeerKnown[sid]) {
+    if (esp_now_send(sPeerMac[sid], data, len) == ESP_OK) {
+      txAccount(data, len);
+      sTxUnicast++;
+      return true;
+    }
+    sTxUnicastFail++;
+  } else {
+    sTxUnicastFallback++;
+  }
+  return txBroadcast(data, len);
+}
+
+// --- Non-blocking retransmit queue ---
+// Burst copies of one pre-packed frame (same seq, so clients can de-dupe) are
+// spaced out by netTxPump() from loop() instead of delay()-ing in place.
+constexpr uint8_t  TXQ_SLOTS   = 8;
+constexpr uint16_t TXQ_MAX_LEN = 64;
+
+struct TxRepeat {
+  bool     active = false;
+  uint8_t  left   = 0;     // copies still to send
+  uint16_t gapMs  = 0;
+  uint16_t len    = 0;
+  uint32_t nextAt = 0;
+  uint8_t  buf[TXQ_MAX_LEN];
+};
+static TxRepeat sTxq[TXQ_SLOTS];
+static uint32_t sTxqOverflow = 0;
+
+// Send the first copy now, then the remaining copies gapMs apart.
+static void txRepeat(const uint8_t* buf, uint16_t len, uint8_t copies, uint16_t gapMs) {
+  if (copies == 0) return;
+  txBroadcast(buf, len);
+  if (copies == 1) return;
+
+  TxRepeat* slot = nullptr;
+  if (len <= TXQ_MAX_LEN) {
+    for (auto& q : sTxq) if (!q.active) { slot = &q; break; }
+  }
+  if (!slot) {
+    // Queue full (or oversize frame): fall back to back-to-back copies rather
+    // than stalling the loop.
+    sTxqOverflow++;
+    for (uint8_t n = 1; n < copies; ++n) txBroadcast(buf, len);
+    return;
+  }
+
+  memcpy(slot->buf, buf, len);
+  slot->len    = len;
+  slot->left   = copies - 1;
+  slot->gapMs  = gapMs;
+  slot->nextAt = millis() + gapMs;
+  slot->active = true;
+}
+
+void netTxPump(uint32_t now) {
+  for (auto& q : sTxq) {
+    if (!q.active || (int32_t)(now - q.nextAt) < 0) continue;
+    txBroadcast(q.buf, q.len);
+    if (--q.left == 0) q.active = false;
+    else               q.nextAt = now + q.gapMs;
+  }
+}
+
+// --- Loop health ---
+static uint32_t sLoopLastUs   = 0;
+static uint32_t sLoopMaxGapUs = 0;
+
+void netNoteLoopPass(uint32_t nowUs) {
+  if (sLoopLastUs) {
+    const uint32_t gap = nowUs - sLoopLastUs;
+    if (gap > sLoopMaxGapUs) sLoopMaxGapUs = gap;
+  }
+  sLoopLastUs = nowUs;
+}
+
+void netLoopPaused() {
+  sLoopLastUs = 0;   // don't count maintenance time as a stall
+}
+
+void netPrintStats(Print& out) {
+  static const char* const kNames[NET_STAGE_COUNT] = {
+    "idle", "R1", "R2", "R3", "R4", "R5", "bonus", "mg"
+  };
+  // Include the still-open stage up to now without disturbing the bookkeeping.
+  const uint32_t now = millis();
+  out.println("TX frames by stage:");
+  for (uint8_t i = 0; i < NET_STAGE_COUNT; ++i) {
+    uint32_t ms = sStageMs[i] + ((i == sTxStage) ? (now - sTxStageSince) : 0);
+    if (!sTxFrames[i] && !ms) continue;
+    const float secs = ms / 1000.0f;
+    out.printf("  %-5s frames=%lu bytes=%lu time=%.1fs rate=%.1f/s\n",
+               kNames[i], (unsigned long)sTxFrames[i], (unsigned long)sTxBytes[i],
+               secs, secs > 0 ? sTxFrames[i] / secs : 0.0f);
+  }
+
+  uint8_t pending = 0;
+  for (auto& q : sTxq) if (q.active) pending++;
+  out.printf("txq pending=%u overflow=%lu\n", (unsigned)pending, (unsigned long)sTxqOverflow);
+
+  out.printf("unicast %s: sent=%lu failed=%lu broadcastFallback=%lu peers=",
+             sUnicastEnabled ? "on" : "off", (unsigned long)sTxUnicast,
+             (unsigned long)sTxUnicastFail, (unsigned long)sTxUnicastFallback);
+  for (uint8_t sid = 1; sid < NET_PEER_SLOTS; ++sid) if (sPeerKnown[sid]) out.printf("%u ", (unsigned)sid);
+  out.print('\n');
+
+  out.println("accrual airtime by active holds:");
+  for (uint8_t n = 0; n <= MAX_HOLDS; ++n) {
+    if (!sAirMs[n]) continue;
+    const float secs = sAirMs[n] / 1000.0f;
+    out.printf("  holds=%u time=%.1fs frames/s=%.1f airtime=%.1fms/s\n", (unsigned)n, secs,
+               sAirFrames[n] / secs, (sAirUs[n] / 1000.0f) / secs);
+  }
+
+  out.printf("rxq depth=%u highWater=%u/%u overflow=%lu oversize=%lu\n",
+             (unsigned)(uint8_t)(sRxHead.load() - sRxTail.load()),
+             (unsigned)sRxHighWater, (unsigned)RXQ_SLOTS,
+             (unsigned long)sRxOverflow, (unsigned long)sRxOversize);
+  out.printf("rx latency avg=%luus max=%luus (n=%lu)\n",
+             (unsigned long)(sRxLatCount ? sRxLatSumUs / sRxLatCount : 0),
+             (unsigned long)sRxLatMaxUs, (unsigned long)sRxLatCount);
+  sRxLatMaxUs = sRxLatSumUs = sRxLatCount = 0;
+
+  out.printf("rx by type (badVersion=%lu):\n", (unsigned long)sRxBadVersion);
+  for (uint16_t t = 0; t < 256; ++t) {
+    const RxCounters& c = sRxCount[t];
+    if (!c.rx) continue;
+    out.printf("  type %3u rx=%lu drop=%lu bad=%lu\n", (unsigned)t,
+               (unsigned long)c.rx, (unsigned long)c.dropped, (unsigned long)c.malformed);
+  }
+
+  // Max gap between loop() passes since the last readout.
+  out.printf("loop maxGap=%luus\n", (unsigned long)sLoopMaxGapUs);
+  sLoopMaxGapUs = 0;
+}
+
 // Generic raw broadcast used by OTA
 void netBroadcastRaw(const uint8_t* data, uint16_t len) {
-  Transport::broadcast(data, len);
+  txBroadcast(data, len);
 }
 
 static void packHeader(Game& g, uint8_t type, uint16_t payLen, uint8_t* buf, uint16_t seqOverride=0) {
@@ -91,19 +378,69 @@ static void packHeader(Game& g, uint8_t type, uint16_t payLen, uint8_t* buf, uin
   h->seq = seqOverride ? seqOverride : g.seq++;
 }
 
-void sendStateTick(const Game& g, uint32_t msLeft) {
-  uint8_t buf[sizeof(MsgHeader)+sizeof(StateTickPayload)];
-  auto* p=(StateTickPayload*)(buf+sizeof(MsgHeader));
-  packHeader(const_cast<Game&>(g), (uint8_t)MsgType::STATE_TICK, sizeof(StateTickPayload), buf);
-  p->state = (uint8_t)g.light;
-  p->msLeft = msLeft;
-  Transport::broadcast(buf,sizeof(buf));
+// "Stage" timer: round / intermission / minigame, whichever is running.
+static uint32_t stageMsLeft(const Game& g, uint32_t now) {
+  if      (g.mgActive)           return (g.mgDeadline    > now) ? (g.mgDeadline    - now) : 0;
+  else if (g.bonusIntermission)  return (g.bonusInterEnd > now) ? (g.bonusInterEnd - now) : 0;
+  else if (g.bonusIntermission2) return (g.bonus2End     > now) ? (g.bonus2End     - now) : 0;
+  else                           return (g.roundEndAt    > now) ? (g.roundEndAt    - now) : 0;
+}
+
+uint32_t worldFramePeriodMs(const Game& g) {
+  return max<uint32_t>(10, 1000 / g.tickHz);
+}
+
+void bcastWorldFrame(Game& g, uint8_t copies /*=1*/, uint16_t gapMs /*=0*/) {
+  const uint32_t now = millis();
+  accrueStage(g, now);
+
+  uint8_t buf[sizeof(MsgHeader) + sizeof(WorldFramePayload)];
+  packHeader(g, (uint8_t)MsgTypeExt::WORLD_FRAME, sizeof(WorldFramePayload), buf);
+  auto* p = (WorldFramePayload*)(buf + sizeof(MsgHeader));
+
+  const bool playing = (g.phase == Phase::PLAYING);
+
+  p->frameVersion    = WORLD_FRAME_VERSION;
+  p->phase           = (uint8_t)g.phase;
+  p->lightState      = (uint8_t)g.light;
+  p->roundIndex      = g.roundIndex;
+  p->livesRemaining  = g.livesRemaining;
+  p->livesMax        = g.livesMax;
+  p->flags           = (g.mgActive ? WF_FLAG_MG_ACTIVE : 0) |
+                       ((g.bonusIntermission || g.bonusIntermission2) ? WF_FLAG_INTERMISSION : 0);
+  p->_pad            = 0;
+  p->msLeftStage     = playing ? stageMsLeft(g, now) : 0;
+  p->msLeftGame      = (playing && g.gameEndAt > now) ? (g.gameEndAt - now) : 0;
+  p->teamScore       = g.teamScore;
+  p->roundStartScore = g.roundStartScore;
+  p->roundGoalAbs    = g.roundGoal;
+  p->bonusMask       = g.bonusActiveMask;
+  p->serverNowMs     = serverNow();
+  p->schedEpoch      = cadenceEpoch();
+  p->_pad2           = 0;
+
+  txRepeat(buf, sizeof(buf), copies, gapMs);
+}
+
+void bcastLightSchedule(Game& g, uint16_t epoch, const LightScheduleEntry* e, uint8_t n,
+                        uint8_t copies /*=1*/, uint16_t gapMs /*=0*/) {
+  if (n > LIGHT_SCHEDULE_MAX) n = LIGHT_SCHEDULE_MAX;
+  const uint16_t payLen = sizeof(LightSchedulePayload) + n * sizeof(LightScheduleEntry);
+  uint8_t buf[sizeof(MsgHeader) + sizeof(LightSchedulePayload) + LIGHT_SCHEDULE_MAX * sizeof(LightScheduleEntry)];
+  packHeader(g, (uint8_t)MsgTypeExt::LIGHT_SCHEDULE, payLen, buf);
+  auto* p = (LightSchedulePayload*)(buf + sizeof(MsgHeader));
+  p->epoch       = epoch;
+  p->count       = n;
+  p->_pad        = 0;
+  memcpy(buf + sizeof(MsgHeader) + sizeof(LightSchedulePayload), e, n * sizeof(LightScheduleEntry));
+
+  txRepeat(buf, sizeof(MsgHeader) + payLen, copies, gapMs);
 }
 
 void bcastGameStart(Game& g) {
   uint8_t buf[sizeof(MsgHeader)];
   packHeader(g, (uint8_t)MsgType::GAME_START, 0, buf);
-  bool ok = Transport::broadcast(buf, sizeof(buf));
+  bool ok = txBroadcast(buf, sizeof(buf));
   Serial.printf("[TREX] GAME_START broadcast %s\n", ok ? "OK" : "FAILED");
 }
 
@@ -132,21 +469,20 @@ void bcastGameOver(Game& g, uint8_t reason, uint8_t blameSid /*=GAMEOVER_BLAME_A
   auto *p = (GameOverPayload*)(buf + sizeof(MsgHeader));
   p->reason   = reason;
   p->blameSid = blameSid;
+  journalGameEnd(reason, blameSid);
 
   // A one-shot transition packet can occasionally get missed during a busy RED
   // violation moment. Send a short spaced burst so Loot/Drop/Control all make
   // the end-state transition instead of sitting in the last RED frame.
-  for (uint8_t n = 0; n < 4; ++n) {
-    Transport::broadcast(buf, sizeof(buf));
-    sendStateTick(g, 0); // freeze timers alongside each end-state pass
-    if (n + 1 < 4) delay(12);
-  }
+  txRepeat(buf, sizeof(buf), 4, 12);
+  bcastWorldFrame(g, 4, 12); // freeze timers alongside each end-state pass
 
   // keep scheduler from immediately sending more ticks
   g.lastTickSentMs = millis();
+  timerArm(TMR_WORLD_FRAME, g.lastTickSentMs + worldFramePeriodMs(g));
 
   // Clean up holds and play the appropriate ending media.
-  for (auto &h : g.holds) h.active = false;
+  clearHolds(g);
   if (success) {
     gameAudioPlayOnce(TRK_TREX_WIN);
     spritePlay(CLIP_SUCCESS);
@@ -159,25 +495,59 @@ void bcastGameOver(Game& g, uint8_t reason, uint8_t blameSid /*=GAMEOVER_BLAME_A
 }
 
 void bcastScore(Game& g) {
-  // Short burst: score rollbacks on round timeout and drop completions are both
-  // important UI sync points for DROP/CONTROL, and a single ESP-NOW packet can
-  // occasionally get lost during busy transitions.
+  // Once: DROP/CONTROL hash the score into their heartbeat, so one that
+  // missed this is resynced (netConvergeTick) instead of every station
+  // hearing it three times.
   uint8_t buf[sizeof(MsgHeader)+sizeof(ScoreUpdatePayload)];
   packHeader(g, (uint8_t)MsgType::SCORE_UPDATE, sizeof(ScoreUpdatePayload), buf);
   ((ScoreUpdatePayload*)(buf+sizeof(MsgHeader)))->teamScore = g.teamScore;
-  for (uint8_t n = 0; n < 3; ++n) {
-    Transport::broadcast(buf,sizeof(buf));
+  txBroadcast(buf,sizeof(buf));
+}
+
+// --- Station inventory sync ---
+// Changes only mark g.stationDirty; this sends at most one all-stations frame
+// per STATION_FLUSH_MS. A Loot that missed a frame is caught by its
+// heartbeat (netConvergeTick); the full vector still goes out every
+// STATION_REFRESH_MS while PLAYING as a backstop.
+constexpr uint32_t STATION_FLUSH_MS   = 50;
+constexpr uint32_t STATION_REFRESH_MS = 5000;
+
+constexpr uint16_t STATION_INV_FRAME_MAX =
+  sizeof(MsgHeader) + sizeof(StationInventoryPayload) + MAX_STATIONS * sizeof(StationInvEntry);
+
+// Stations 1..n into buf; returns the frame length
+static uint16_t packStationInventory(Game& g, uint8_t n, uint8_t* buf, uint16_t seqOverride = 0) {
+  const uint16_t payLen = sizeof(StationInventoryPayload) + n * sizeof(StationInvEntry);
+  packHeader(g, (uint8_t)MsgTypeExt::STATION_INVENTORY, payLen, buf, seqOverride);
+  auto* p = (StationInventoryPayload*)(buf + sizeof(MsgHeader));
+  p->stationCount = n;
+  p->_pad = 0;
+  auto* e = (StationInvEntry*)(buf + sizeof(MsgHeader) + sizeof(StationInventoryPayload));
+  for (uint8_t sid = 1; sid <= n; ++sid) {
+    e[sid - 1].inventory = g.stationInventory[sid];
+    e[sid - 1].capacity  = g.stationCapacity[sid];
   }
+  return sizeof(MsgHeader) + payLen;
 }
 
-void bcastStation(Game& g, uint8_t stationId) {
-  uint8_t buf[sizeof(MsgHeader)+sizeof(StationUpdatePayload)];
-  packHeader(g, (uint8_t)MsgType::STATION_UPDATE, sizeof(StationUpdatePayload), buf);
-  auto* p=(StationUpdatePayload*)(buf+sizeof(MsgHeader));
-  p->stationId = stationId;
-  p->inventory = g.stationInventory[stationId];
-  p->capacity  = g.stationCapacity[stationId];
-  Transport::broadcast(buf,sizeof(buf));
+static void bcastStationInventory(Game& g) {
+  uint8_t buf[STATION_INV_FRAME_MAX];
+  txBroadcast(buf, packStationInventory(g, g.stationCount, buf));
+}
+
+void netStationSync(Game& g, uint32_t now) {
+  static uint32_t lastSent = 0;
+  // Keep GAME_START ahead of the first inventory frame: a Loot clears its
+  // station state when GAME_START arrives.
+  if (g.pending.needGameStart) return;
+
+  const uint32_t since = now - lastSent;
+  if ((g.stationDirty && since >= STATION_FLUSH_MS) ||
+      (g.phase == Phase::PLAYING && since >= STATION_REFRESH_MS)) {
+    bcastStationInventory(g);
+    g.stationDirty = 0;
+    lastSent = now;
+  }
 }
 
 void bcastRoundStatus(Game& g) {
@@ -189,85 +559,43 @@ void bcastRoundStatus(Game& g) {
   p->_pad           = 0;
   p->roundStartScore= g.roundStartScore;
   p->roundGoalAbs   = g.roundGoal;
-  const uint32_t now = millis();
-  // "msLeftRound" is treated as a stage timer: round / intermission / minigame.
-  if      (g.mgActive)          p->msLeftRound = (g.mgDeadline   > now) ? (g.mgDeadline   - now) : 0;
-  else if (g.bonusIntermission) p->msLeftRound = (g.bonusInterEnd> now) ? (g.bonusInterEnd- now) : 0;
-  else if (g.bonusIntermission2)p->msLeftRound = (g.bonus2End    > now) ? (g.bonus2End    - now) : 0;
-  else                          p->msLeftRound = (g.roundEndAt   > now) ? (g.roundEndAt   - now) : 0;
-  Transport::broadcast(buf, sizeof(buf));
+  p->msLeftRound    = stageMsLeft(g, millis());
+  txBroadcast(buf, sizeof(buf));
 }
 
 void bcastBonusUpdate(Game& g) {
-  // Short burst: a missed BONUS_UPDATE is what makes a station stay plain green
-  // until some later interaction re-syncs it.
-  for (uint8_t n = 0; n < 3; ++n) {
-    uint8_t buf[sizeof(MsgHeader) + sizeof(BonusUpdatePayload)];
-    packHeader(g, (uint8_t)MsgType::BONUS_UPDATE, sizeof(BonusUpdatePayload), buf);
-    auto* p = (BonusUpdatePayload*)(buf + sizeof(MsgHeader));
-    p->mask = g.bonusActiveMask;
-    Transport::broadcast(buf, sizeof(buf));
-  }
+  // Once: the bonus bit is in every station's heartbeat digest, so a station
+  // that stays plain green gets a STATION_RESYNC within STATE_HB_CONFIRM_MS.
+  uint8_t buf[sizeof(MsgHeader) + sizeof(BonusUpdatePayload)];
+  packHeader(g, (uint8_t)MsgType::BONUS_UPDATE, sizeof(BonusUpdatePayload), buf);
+  auto* p = (BonusUpdatePayload*)(buf + sizeof(MsgHeader));
+  p->mask = g.bonusActiveMask;
+  txBroadcast(buf, sizeof(buf));
 }
 
-// --- Game status broadcast for Control station ---
 void bcastRadioCfg(Game& g, const RadioCfgPayload& cfgp) {
   uint8_t buf[sizeof(MsgHeader) + sizeof(RadioCfgPayload)];
   packHeader(g, (uint8_t)MsgType::RADIO_CFG, sizeof(RadioCfgPayload), buf);
   auto* p = (RadioCfgPayload*)(buf + sizeof(MsgHeader));
   *p = cfgp;
-  Transport::broadcast(buf, sizeof(buf));
+  txBroadcast(buf, sizeof(buf));
 }
 
-void bcastGameStatus(const Game& g) {
-  uint8_t buf[sizeof(MsgHeader) + sizeof(GameStatusPayload)];
-  Game& ng = const_cast<Game&>(g);
-  packHeader(ng, (uint8_t)MsgType::GAME_STATUS, sizeof(GameStatusPayload), buf);
-  auto* p = (GameStatusPayload*)(buf + sizeof(MsgHeader));
-
-  const uint32_t now = millis();
-
-  uint32_t msLeftGame = 0;
-  if (g.gameEndAt > 0 && g.gameEndAt > now) {
-    msLeftGame = g.gameEndAt - now;
-  }
-
-  uint32_t msLeftRound = 0;
-  if (g.phase == Phase::PLAYING) {
-    // "msLeftRound" is treated as a stage timer: round / intermission / minigame.
-    if      (g.mgActive)          msLeftRound = (g.mgDeadline   > now) ? (g.mgDeadline   - now) : 0;
-    else if (g.bonusIntermission)  msLeftRound = (g.bonusInterEnd  > now) ? (g.bonusInterEnd  - now) : 0;
-    else if (g.bonusIntermission2) msLeftRound = (g.bonus2End      > now) ? (g.bonus2End      - now) : 0;
-    else                           msLeftRound = (g.roundEndAt     > now) ? (g.roundEndAt     - now) : 0;
-  }
-
-  p->teamScore    = g.teamScore;
-  p->msLeftGame   = msLeftGame;
-  p->msLeftRound  = msLeftRound;
-  p->roundIndex   = g.roundIndex;
-  p->phase        = (uint8_t)g.phase;
-  p->lightState   = (uint8_t)g.light;
-  p->_pad         = 0;
-
-  Transport::broadcast(buf, sizeof(buf));
-}
 
 
 // --- Lives system ------------------------------------------------------
 
 void bcastLivesUpdate(Game& g, uint8_t reason /*=0*/, uint8_t blameSid /*=GAMEOVER_BLAME_ALL*/) {
-  // Broadcast in a short burst to reduce ESP-NOW drop issues.
-  // (Receivers treat these as idempotent updates; duplicates are OK.)
-  for (uint8_t n = 0; n < 3; ++n) {
-    uint8_t buf[sizeof(MsgHeader) + sizeof(LivesUpdatePayload)];
-    packHeader(g, (uint8_t)MsgType::LIVES_UPDATE, sizeof(LivesUpdatePayload), buf);
-    auto* p = (LivesUpdatePayload*)(buf + sizeof(MsgHeader));
-    p->livesRemaining = g.livesRemaining;
-    p->livesMax       = g.livesMax;
-    p->reason         = reason;
-    p->blameSid       = blameSid;
-    Transport::broadcast(buf, sizeof(buf));
-  }
+  // Once: CONTROL hashes lives into its heartbeat and is resynced if it
+  // missed this (receivers treat these as idempotent updates anyway).
+  uint8_t buf[sizeof(MsgHeader) + sizeof(LivesUpdatePayload)];
+  packHeader(g, (uint8_t)MsgType::LIVES_UPDATE, sizeof(LivesUpdatePayload), buf);
+  auto* p = (LivesUpdatePayload*)(buf + sizeof(MsgHeader));
+  p->livesRemaining = g.livesRemaining;
+  p->livesMax       = g.livesMax;
+  p->reason         = reason;
+  p->blameSid       = blameSid;
+  txBroadcast(buf, sizeof(buf));
 }
 
 LifeLossResult applyLifeLoss(Game& g, uint8_t reason, uint8_t blameSid /*=GAMEOVER_BLAME_ALL*/, bool obeyLockout /*=true*/) {
@@ -294,9 +622,7 @@ LifeLossResult applyLifeLoss(Game& g, uint8_t reason, uint8_t blameSid /*=GAMEOV
   g.lastLifeLossBlameSid = blameSid;
   g.lifeLossLockoutUntil = now + g.lifeLossCooldownMs;
 
-  Serial.printf("[TREX] LIFE LOST reason=%u blameSid=%u lives=%u/%u\n",
-                (unsigned)reason, (unsigned)blameSid,
-                (unsigned)g.livesRemaining, (unsigned)g.livesMax);
+  evlog(EV_LIFE_LOST, reason, blameSid, g.livesRemaining, g.livesMax);
 
   bcastLivesUpdate(g, reason, blameSid);
 
@@ -311,29 +637,24 @@ LifeLossResult applyLifeLoss(Game& g, uint8_t reason, uint8_t blameSid /*=GAMEOV
 void bcastMgStart(Game& g, const Game::MgConfig& c) {
   // Use a short spaced burst here instead of only back-to-back copies. If a
   // single instant is busy, the Loot stations can miss the whole transition and
-  // never show the R4->R5 minigame.
-  for (uint8_t n = 0; n < 5; ++n) {
-    uint8_t buf[sizeof(MsgHeader) + sizeof(MgStartPayload)];
-    packHeader(g, (uint8_t)MsgType::MG_START, sizeof(MgStartPayload), buf);
-    auto* p = (MgStartPayload*)(buf + sizeof(MsgHeader));
-    p->seed       = c.seed;
-    p->timerMs    = c.timerMs;
-    p->speedMinMs = c.speedMinMs;
-    p->speedMaxMs = c.speedMaxMs;
-    p->segMin     = c.segMin;
-    p->segMax     = c.segMax;
-    Transport::broadcast(buf, sizeof buf);
-    if (n + 1 < 5) delay(10);
-  }
+  // never show the R4->R5 minigame. All copies share one seq so a Loot only
+  // (re)starts the minigame once.
+  uint8_t buf[sizeof(MsgHeader) + sizeof(MgStartPayload)];
+  packHeader(g, (uint8_t)MsgType::MG_START, sizeof(MgStartPayload), buf);
+  auto* p = (MgStartPayload*)(buf + sizeof(MsgHeader));
+  p->seed       = c.seed;
+  p->timerMs    = c.timerMs;
+  p->speedMinMs = c.speedMinMs;
+  p->speedMaxMs = c.speedMaxMs;
+  p->segMin     = c.segMin;
+  p->segMax     = c.segMax;
+  txRepeat(buf, sizeof buf, 5, 10);
 }
 
 void bcastMgStop(Game& g) {
-  for (uint8_t n = 0; n < 4; ++n) {
-    uint8_t buf[sizeof(MsgHeader)];
-    packHeader(g, (uint8_t)MsgType::MG_STOP, 0, buf);
-    Transport::broadcast(buf, sizeof buf);
-    if (n + 1 < 4) delay(8);
-  }
+  uint8_t buf[sizeof(MsgHeader)];
+  packHeader(g, (uint8_t)MsgType::MG_STOP, 0, buf);
+  txRepeat(buf, sizeof buf, 4, 8);
 }
 
 void sendDropResult(Game& g, uint16_t dropped, uint8_t readerIndex /*=DROP_READER_UNKNOWN*/) {
@@ -349,385 +670,838 @@ void sendDropResult(Game& g, uint16_t dropped, uint8_t readerIndex /*=DROP_READE
   p->readerIndex = readerIndex;
 
   for (uint8_t n = 0; n < 3; ++n) {
-    Transport::broadcast(buf, sizeof(buf));
+    txBroadcast(buf, sizeof(buf));
   }
 }
 
-void sendHoldEnd(Game& g, uint32_t holdId, uint8_t reason) {
+void sendHoldEnd(Game& g, uint8_t stationId, uint32_t holdId, uint8_t reason) {
   uint8_t buf[sizeof(MsgHeader)+sizeof(HoldEndPayload)];
   packHeader(g, (uint8_t)MsgType::HOLD_END, sizeof(HoldEndPayload), buf);
   auto* e=(HoldEndPayload*)(buf+sizeof(MsgHeader));
   e->holdId=holdId; e->reason=reason;
-  Transport::broadcast(buf,sizeof(buf));
+  txToStation(stationId, buf,sizeof(buf));
+}
+
+uint8_t endHoldsOnStation(Game& g, uint8_t sid, uint8_t reason) {
+  if (sid > MAX_STATIONS) return 0;
+  uint8_t n = 0;
+  for (uint8_t hi = g.holds.byStation[sid], nx; hi != HOLD_NONE; hi = nx) {
+    nx = g.holds[hi].next;
+    const uint32_t holdId = g.holds[hi].holdId;
+    releaseHold(g, hi);
+    sendHoldEnd(g, sid, holdId, reason);
+    n++;
+  }
+  return n;
 }
 
-void sendLootTick(Game& g, uint32_t holdId, uint8_t carried, uint16_t stationInv) {
+uint8_t endAllHolds(Game& g, uint8_t reason) {
+  uint8_t firstSid = 0;
+  for (uint8_t sid = 1; sid <= g.stationCount && g.holds.count; ++sid) {
+    if (endHoldsOnStation(g, sid, reason) && !firstSid) firstSid = sid;
+  }
+  return firstSid;
+}
+
+void sendLootTick(Game& g, uint8_t stationId, uint32_t holdId, uint8_t carried, uint16_t stationInv) {
   uint8_t buf[sizeof(MsgHeader)+sizeof(LootTickPayload)];
   packHeader(g, (uint8_t)MsgType::LOOT_TICK, sizeof(LootTickPayload), buf);
   auto* t=(LootTickPayload*)(buf+sizeof(MsgHeader));
   t->holdId=holdId; t->carried=carried; t->inventory=stationInv;
-  Transport::broadcast(buf,sizeof(buf));
+  txToStation(stationId, buf,sizeof(buf));
 }
 
-/* ── RX handler (stations → server) ───────────────────────── */
+// --- Batched LOOT_TICK ---
+// One frame per accrual pass: every hold that ticked this pass plus the whole
+// station inventory vector, so frame count doesn't grow with concurrent holds
+// and the per-tick STATION_UPDATE is no longer needed. A pass with more
+// ticks than fit one ESP-NOW frame goes out as several.
+constexpr uint8_t TICK_BATCH_MAX = 28;   // 28 * 5 B entries + 16 inventories keeps the frame < 200 B
+constexpr uint16_t TICK_BATCH_FRAME_MAX = sizeof(MsgHeader) + sizeof(LootTickBatchPayload)
+                                        + MAX_STATIONS * sizeof(uint16_t) + TICK_BATCH_MAX * sizeof(LootTickEntry);
+static_assert(TICK_BATCH_FRAME_MAX <= RXQ_MAX_LEN, "LOOT_TICK_BATCH must fit one ESP-NOW frame");
+static uint8_t sTickBuf[TICK_BATCH_FRAME_MAX];
+static uint8_t sTickEntries = 0;
+static LootTickEntry sTickPending[TICK_BATCH_MAX];
+
+void lootTickBatchAdd(Game& g, uint32_t holdId, uint8_t carried) {
+  if (sTickEntries >= TICK_BATCH_MAX) lootTickBatchFlush(g);
+  sTickPending[sTickEntries].holdId  = holdId;
+  sTickPending[sTickEntries].carried = carried;
+  sTickEntries++;
+}
+
+// Inventories of stations 1..n plus `count` entries into buf; returns the frame length
+static uint16_t packLootTickBatch(Game& g, uint8_t n, const LootTickEntry* ents, uint8_t count,
+                                  uint8_t* buf, uint16_t seqOverride = 0) {
+  const uint16_t payLen = sizeof(LootTickBatchPayload) + n * sizeof(uint16_t)
+                        + count * sizeof(LootTickEntry);
+  packHeader(g, (uint8_t)MsgTypeExt::LOOT_TICK_BATCH, payLen, buf, seqOverride);
+  uint8_t* p = buf + sizeof(MsgHeader);
+  auto* b = (LootTickBatchPayload*)p;
+  b->stationCount = n;
+  b->entryCount   = count;
+  p += sizeof(LootTickBatchPayload);
+  // inventory[] is stations 1..stationCount; memcpy keeps the packed layout
+  memcpy(p, &g.stationInventory[1], n * sizeof(uint16_t));
+  p += n * sizeof(uint16_t);
+  memcpy(p, ents, count * sizeof(LootTickEntry));
+  return sizeof(MsgHeader) + payLen;
+}
+
+void lootTickBatchFlush(Game& g) {
+  if (!sTickEntries) return;
+  txBroadcast(sTickBuf, packLootTickBatch(g, g.stationCount, sTickPending, sTickEntries, sTickBuf));
+  sTickEntries = 0;
+}
+
+// --- Station-count load model (maintenance `stationload`) ---
+// What the room costs on air and in the loop as Loots are added, with every
+// Loot holding: WORLD_FRAME at tickHz, the STATION_INVENTORY refresh, one
+// LOOT_TICK_BATCH per hold tick, every Loot's heartbeat on each tick (its
+// inventory changed) plus the periodic one, and a full LIGHT_SCHEDULE a
+// second. Holds start at different moments, so ticks rarely share a pass;
+// the worst case (one entry per frame) is what is shown. Airtime uses the
+// same model as `status`; pack time is measured by building both frames into
+// scratch buffers (nothing is sent).
+void netPrintStationLoad(Game& g, Print& out) {
+  static const uint8_t COUNTS[] = { 5, 8, 12, 16 };
+  const uint32_t ROUNDS = 2000;
+  const float worldHz    = 1000.0f / worldFramePeriodMs(g);
+  const float lootTickHz = 1000.0f / (g.lootRateMs ? g.lootRateMs : 1000);
+  const float invHz      = 1000.0f / STATION_REFRESH_MS;
+  const float hbHz       = lootTickHz + 1000.0f / STATE_HB_PERIOD_MS;   // per Loot
+  const uint16_t hbLen = sizeof(MsgHeader) + sizeof(StateHeartbeatPayload);
+  const float schedHz = 1.0f;   // LIGHT_SCHEDULE, a flip a second at most
+  const uint16_t schedLen = sizeof(MsgHeader) + sizeof(LightSchedulePayload)
+                          + LIGHT_SCHEDULE_MAX * sizeof(LightScheduleEntry);
+
+  out.printf("stationload: world=%.1f/s lootTick=%.1f/s per hold, every Loot holding\n", worldHz, lootTickHz);
+  const uint16_t worldLen = sizeof(MsgHeader) + sizeof(WorldFramePayload);
+  for (uint8_t n : COUNTS) {
+    if (n > MAX_STATIONS) continue;
+    uint8_t inv[STATION_INV_FRAME_MAX];
+    uint8_t batch[TICK_BATCH_FRAME_MAX];
+    LootTickEntry ents[MAX_STATIONS];
+    for (uint8_t i = 0; i < n; ++i) { ents[i].holdId = i + 1; ents[i].carried = i; }
+
+    const uint16_t invLen   = packStationInventory(g, n, inv, /*seqOverride=*/1);
+    const uint16_t oneLen   = packLootTickBatch(g, n, ents, 1, batch, 1);
+    const uint16_t fullLen  = packLootTickBatch(g, n, ents, n, batch, 1);
+    const float    batchHz  = n * lootTickHz;
+    const float    frameHz  = worldHz + invHz + batchHz + n * hbHz + schedHz;
+    const float    airUs    = worldHz * (AIR_PREAMBLE_US + (AIR_OVERHEAD_BYTES + worldLen) * 8)
+                            + invHz   * (AIR_PREAMBLE_US + (AIR_OVERHEAD_BYTES + invLen) * 8)
+                            + batchHz * (AIR_PREAMBLE_US + (AIR_OVERHEAD_BYTES + oneLen) * 8)
+                            + n * hbHz * (AIR_PREAMBLE_US + (AIR_OVERHEAD_BYTES + hbLen) * 8)
+                            + schedHz * (AIR_PREAMBLE_US + (AIR_OVERHEAD_BYTES + schedLen) * 8);
+
+    volatile uint16_t sink = 0;
+    const uint32_t t0 = micros();
+    for (uint32_t r = 0; r < ROUNDS; ++r) {
+      sink += packStationInventory(g, n, inv, 1);
+      sink += packLootTickBatch(g, n, ents, n, batch, 1);
+    }
+    const uint32_t packNs = (micros() - t0) * 1000UL / ROUNDS;
+    (void)sink;
+
+    out.printf("  n=%2u inv=%3uB batch=%3u..%3uB frames=%5.1f/s airtime=%5.1fms/s pack=%luns\n",
+               (unsigned)n, (unsigned)invLen, (unsigned)oneLen, (unsigned)fullLen,
+               frameHz, airUs / 1000.0f, (unsigned long)packNs);
+  }
+}
+
+static void handleRx(const uint8_t* data, uint16_t len);
+
+// Producer: transport receive callback.
 void onRx(const uint8_t* data, uint16_t len) {
-  if (len < sizeof(MsgHeader)) return;
-  auto* h = (const MsgHeader*)data;
-  if (h->version != TREX_PROTO_VERSION) {
-    Serial.printf("[WARN] Proto mismatch on RX: got=%u exp=%u (type=%u)\n",
-                  h->version, (unsigned)TREX_PROTO_VERSION, h->type);
-    return;
+  if (len > RXQ_MAX_LEN) { sRxOversize++; return; }
+
+  const uint8_t head = sRxHead.load(std::memory_order_relaxed);
+  const uint8_t tail = sRxTail.load(std::memory_order_acquire);
+  const uint8_t depth = (uint8_t)(head - tail);
+  if (depth >= RXQ_SLOTS) { sRxOverflow++; return; }
+
+  RxSlot& s = sRxq[head & (RXQ_SLOTS - 1)];
+  memcpy(s.data, data, len);
+  s.len  = len;
+  s.atUs = micros();
+  sRxHead.store((uint8_t)(head + 1), std::memory_order_release);
+
+  if (depth + 1 > sRxHighWater) sRxHighWater = depth + 1;
+}
+
+// Consumer: loop(), once per pass.
+void netDrainRx() {
+  uint8_t tail = sRxTail.load(std::memory_order_relaxed);
+  const uint8_t head = sRxHead.load(std::memory_order_acquire);
+
+  while (tail != head) {
+    RxSlot& s = sRxq[tail & (RXQ_SLOTS - 1)];
+    const uint32_t lat = micros() - s.atUs;
+    if (lat > sRxLatMaxUs) sRxLatMaxUs = lat;
+    sRxLatSumUs += lat;
+    sRxLatCount++;
+
+    sRxAtUs = s.atUs;
+    handleRx(s.data, s.len);
+    tail++;
+    sRxTail.store(tail, std::memory_order_release);
   }
+}
 
-  // Debug: log *every* incoming message type
-  Serial.printf("[NET] RX type=%u len=%u from=%u\n",
-                (unsigned)h->type,
-                (unsigned)h->payloadLen,
-                (unsigned)h->srcStationId);
+/* ── RX handlers (stations → server) ──────────────────────── */
+// Length and source station are already checked by the route table below.
 
-  if (OtaCampaign::handle(data, len)) return;
+static void rejoinStation(Game& g, uint8_t sid, uint32_t now);   // convergence, below
 
-  switch ((MsgType)h->type) {
-    case MsgType::HELLO: {
-      Serial.printf("[TREX] HELLO from station %u\n", h->srcStationId);
-      break;
-    }
+static void rxHello(const MsgHeader* h, const uint8_t* data) {
+  evlog(EV_HELLO, h->srcStationId);
+  const auto* p = (const HelloPayload*)(data + sizeof(MsgHeader));
+  if (p->stationId == h->srcStationId) learnPeer(p->stationId, p->mac);
 
-    case MsgType::RADIO_CFG: {
-      if (h->payloadLen != sizeof(RadioCfgPayload)) break;
-      // Only accept RADIO_CFG requests from the CONTROL station
-      // (CONTROL uses a fixed STATION_ID; see TREX_Control sketch).
-      if (h->srcStationId != 7) break;
+  // Mid-game this is usually a station that just rebooted: it boots thinking
+  // a game runs but with nothing else (inv 0, no round, no bonus), so send it
+  // everything now rather than let it wait for the next broadcasts
+  Game& G = g;
+  if (G.phase == Phase::PLAYING) rejoinStation(G, h->srcStationId, millis());
+}
 
-      const auto* p = (const RadioCfgPayload*)(data + sizeof(MsgHeader));
-      sRadioCfgReq = *p;
-      sRadioCfgRequested = true;
+static void rxRadioCfg(const MsgHeader*, const uint8_t* data) {
+  const auto* p = (const RadioCfgPayload*)(data + sizeof(MsgHeader));
+  sRadioCfgReq = *p;
+  sRadioCfgRequested = true;
 
-      Serial.printf("[TREX] RADIO_CFG request from CONTROL: chan=%u txFramed=%u rxLegacy=%u",
-                    (unsigned)p->wifiChannel,
-                    (unsigned)p->txFramed,
-                    (unsigned)p->rxLegacy);
-      break;
-    }
+  Serial.printf("[TREX] RADIO_CFG request from CONTROL: chan=%u txFramed=%u rxLegacy=%u",
+                (unsigned)p->wifiChannel,
+                (unsigned)p->txFramed,
+                (unsigned)p->rxLegacy);
+}
 
-    case MsgType::SERVER_CMD: {
-      if (h->payloadLen != sizeof(ServerCmdPayload)) {
-        Serial.printf("[TREX] SERVER_CMD bad len=%u (expected %u)\n",
-                      (unsigned)h->payloadLen,
-                      (unsigned)sizeof(ServerCmdPayload));
-        break;
-      }
+static void rxServerCmd(const MsgHeader* h, const uint8_t* data) {
+  const auto* p = (const ServerCmdPayload*)(data + sizeof(MsgHeader));
+  sServerCmd = *p;
+  sServerCmdRequested = true;
 
-      if (h->srcStationId != 7) {
-        Serial.printf("[TREX] Ignoring SERVER_CMD from non-CONTROL station %u\n",
-                      (unsigned)h->srcStationId);
-        break;
-      }
+  Serial.printf("[TREX] SERVER_CMD op=%u arg8=%u value16=%u from station %u\n",
+                (unsigned)p->op,
+                (unsigned)p->arg8,
+                (unsigned)p->value16,
+                (unsigned)h->srcStationId);
+}
+
+// CONTROL_CMD from Control station (START/STOP/MAINT/LOOT)
+static void rxControlCmd(const MsgHeader* h, const uint8_t* data) {
+  auto* p = (const ControlCmdPayload*)(data + sizeof(MsgHeader));
 
-      const auto* p = (const ServerCmdPayload*)(data + sizeof(MsgHeader));
-      sServerCmd = *p;
-      sServerCmdRequested = true;
+  Serial.printf("[TREX] CONTROL_CMD op=%u targetType=%u targetId=%u from station %u\n",
+                (unsigned)p->op,
+                (unsigned)p->targetType,
+                (unsigned)p->targetId,
+                (unsigned)h->srcStationId);
 
-      Serial.printf("[TREX] SERVER_CMD op=%u arg8=%u value16=%u from station %u\n",
-                    (unsigned)p->op,
-                    (unsigned)p->arg8,
-                    (unsigned)p->value16,
-                    (unsigned)h->srcStationId);
+  // For START/STOP/ENTER_MAINT we only act if the command targets the TREX server.
+  const uint8_t myType = (uint8_t)StationType::TREX;
+  const uint8_t myId   = STATION_ID; // 0 for server
+
+  auto matchesTrex = [&](void) -> bool {
+    // 255 = wildcard for CONTROL_CMD (all types / all ids)
+    bool typeMatch = (p->targetType == myType || p->targetType == 255);
+    bool idMatch   = (p->targetId   == myId   || p->targetId   == 255);
+    return typeMatch && idMatch;
+  };
+
+  switch ((ControlOp)p->op) {
+    case ControlOp::START: {
+      if (matchesTrex()) {
+        sControlStartRequested = true;
+      }
       break;
     }
 
-    // CONTROL_CMD from Control station (START/STOP/MAINT/LOOT)
-    case MsgType::CONTROL_CMD: {
-      if (h->payloadLen != sizeof(ControlCmdPayload)) {
-        Serial.printf("[TREX] CONTROL_CMD bad len=%u (expected %u)\n",
-                      (unsigned)h->payloadLen,
-                      (unsigned)sizeof(ControlCmdPayload));
-        break;
-      }
-      auto* p = (const ControlCmdPayload*)(data + sizeof(MsgHeader));
-
-      // Only accept CONTROL_CMD from the CONTROL station.
-      // (Prevents stray/foreign packets from restarting or stopping games.)
-      if (h->srcStationId != 7) {
-        Serial.printf("[TREX] Ignoring CONTROL_CMD from non-CONTROL station %u\n",
-                      (unsigned)h->srcStationId);
-        break;
+    case ControlOp::STOP: {
+      if (matchesTrex()) {
+        sControlStopRequested = true;
       }
+      break;
+    }
 
-      extern Game g;
-      Game& G = g;
-
-      Serial.printf("[TREX] CONTROL_CMD op=%u targetType=%u targetId=%u from station %u\n",
-                    (unsigned)p->op,
-                    (unsigned)p->targetType,
-                    (unsigned)p->targetId,
-                    (unsigned)h->srcStationId);
-
-      // For START/STOP/ENTER_MAINT we only act if the command targets the TREX server.
-      const uint8_t myType = (uint8_t)StationType::TREX;
-      const uint8_t myId   = STATION_ID; // 0 for server
-
-      auto matchesTrex = [&](void) -> bool {
-        // 255 = wildcard for CONTROL_CMD (all types / all ids)
-        bool typeMatch = (p->targetType == myType || p->targetType == 255);
-        bool idMatch   = (p->targetId   == myId   || p->targetId   == 255);
-        return typeMatch && idMatch;
-      };
-
-      switch ((ControlOp)p->op) {
-        case ControlOp::START: {
-          if (matchesTrex()) {
-            sControlStartRequested = true;
-          }
-          break;
-        }
-
-        case ControlOp::STOP: {
-          if (matchesTrex()) {
-            sControlStopRequested = true;
-          }
-          break;
-        }
-
-        case ControlOp::ENTER_MAINT: {
-          if (matchesTrex()) {
-            sEnterMaintRequested = true;
-          }
-          break;
-        }
-
-        case ControlOp::LOOT_OTA: {
-          // Always orchestrated by the server; targetId says which Loot station(s) to OTA.
-          // 0 => all loot stations (OtaCampaign treats 0 as wildcard for ConfigUpdate targetId)
-          // N => only loot station with STATION_ID == N
-          OtaCampaign::setLootTargetId(p->targetId);
-          sLootOtaRequested = true;
-          break;
-        }
-
-        default:
-          Serial.printf("[TREX] CONTROL_CMD unknown op=%u\n", (unsigned)p->op);
-          break;
+    case ControlOp::ENTER_MAINT: {
+      if (matchesTrex()) {
+        sEnterMaintRequested = true;
       }
       break;
     }
 
-    case MsgType::LOOT_HOLD_START: {
-      if (h->payloadLen != sizeof(LootHoldStartPayload)) break;
-      auto* p = (const LootHoldStartPayload*)(data + sizeof(MsgHeader));
+    case ControlOp::LOOT_OTA: {
+      // Always orchestrated by the server; targetId says which Loot station(s) to OTA.
+      // 0 => all loot stations (OtaCampaign treats 0 as wildcard for ConfigUpdate targetId)
+      // N => only loot station with STATION_ID == N
+      OtaCampaign::setLootTargetId(p->targetId);
+      sLootOtaRequested = true;
+      break;
+    }
 
-      extern Game g; Game& G = g;
-      const uint32_t now = millis();
+    default:
+      Serial.printf("[TREX] CONTROL_CMD unknown op=%u\n", (unsigned)p->op);
+      break;
+  }
+}
 
-      // Compute truthful rateHz from lootRateMs (used in all ACKs)
-      uint8_t rateHz = 1;
-      if (G.lootRateMs > 0) {
-        uint32_t hz = 1000U / G.lootRateMs;
-        if (hz < 1)   hz = 1;
-        if (hz > 255) hz = 255;
-        rateHz = (uint8_t)hz;
-      }
+static void rxLootHoldStart(const MsgHeader* h, const uint8_t* data) {
+  auto* p = (const LootHoldStartPayload*)(data + sizeof(MsgHeader));
 
-      // Validate basic conditions (phase/station id)
-      if (G.phase != Phase::PLAYING || p->stationId < 1 || p->stationId > 5) {
-        uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-        packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-        auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-        a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-        a->carried=0;
-        a->inventory=(p->stationId>=1 && p->stationId<=5) ? G.stationInventory[p->stationId] : 0;
-        a->capacity =(p->stationId>=1 && p->stationId<=5) ? G.stationCapacity[p->stationId]  : 0;
-        a->denyReason=5; // DENIED (bad state or bad station)
-        Transport::broadcast(buf,sizeof(buf));
-        break;
-      }
+  Game& G = g;
+  const uint32_t now = millis();
 
-      // --- RED handling only (YELLOW is allowed like GREEN) ---
-      if (G.light == LightState::RED) {
-        const bool inRedGrace = (now < G.redGraceUntil);
-        const bool allowGraceHold = G.redLootPenaltyAfterGrace && inRedGrace;
-
-        // DROP mode: deny all RED starts immediately.
-        // STRICT mode: during the grace window we allow the hold to exist so the
-        // player can safely remove the tag; if the hold is still active after grace,
-        // the server will consume one life for that RED period.
-        if (!allowGraceHold) {
-          if (!inRedGrace && G.redLootPenaltyAfterGrace &&
-              !sRedLootAttemptRequested && !G.pirLifeLostThisRed) {
-            sRedLootAttemptRequested = true;
-            sRedLootAttemptStationId = p->stationId;
-          }
-
-          uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-          packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-          auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-          a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-          a->carried=0;
-          a->inventory= G.stationInventory[p->stationId];
-          a->capacity = G.stationCapacity[p->stationId];
-          a->denyReason = inRedGrace ? 6 : 2;
-          Transport::broadcast(buf,sizeof(buf));
-          break;
-        }
-      }
+  // Compute truthful rateHz from lootRateMs (used in all ACKs)
+  uint8_t rateHz = 1;
+  if (G.lootRateMs > 0) {
+    uint32_t hz = 1000U / G.lootRateMs;
+    if (hz < 1)   hz = 1;
+    if (hz > 255) hz = 255;
+    rateHz = (uint8_t)hz;
+  }
 
-      // Ensure player record
-      int pi = ensurePlayer(G, p->uid);
-      if (pi < 0) {
-        uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-        packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-        auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-        a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-        a->carried=0;
-        a->inventory=G.stationInventory[p->stationId];
-        a->capacity =G.stationCapacity[p->stationId];
-        a->denyReason=5; // DENIED (no player)
-        Transport::broadcast(buf,sizeof(buf));
-        break;
-      }
+  // Validate basic conditions (phase/station id)
+  if (G.phase != Phase::PLAYING || !isLiveStation(G, p->stationId)) {
+    uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+    packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+    auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+    a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+    a->carried=0;
+    a->inventory=isLiveStation(G, p->stationId) ? G.stationInventory[p->stationId] : 0;
+    a->capacity =isLiveStation(G, p->stationId) ? G.stationCapacity[p->stationId]  : 0;
+    a->denyReason=5; // DENIED (bad state or bad station)
+    txToStation(p->stationId, buf, sizeof(buf));
+    return;
+  }
 
-      // Full carry?
-      if (G.players[pi].carried >= G.maxCarry) {
-        uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-        packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-        auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-        a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-        a->carried=G.players[pi].carried;
-        a->inventory=G.stationInventory[p->stationId];
-        a->capacity =G.stationCapacity[p->stationId];
-        a->denyReason=0; // FULL
-        Transport::broadcast(buf,sizeof(buf));
-        break;
+  // --- RED handling only (YELLOW is allowed like GREEN) ---
+  if (G.light == LightState::RED) {
+    const bool inRedGrace = (now < G.redGraceUntil);
+    const bool allowGraceHold = G.redLootPenaltyAfterGrace && inRedGrace;
+
+    // DROP mode: deny all RED starts immediately.
+    // STRICT mode: during the grace window we allow the hold to exist so the
+    // player can safely remove the tag; if the hold is still active after grace,
+    // the server will consume one life for that RED period.
+    if (!allowGraceHold) {
+      if (!inRedGrace && G.redLootPenaltyAfterGrace &&
+          !sRedLootAttemptRequested && !G.pirLifeLostThisRed) {
+        sRedLootAttemptRequested = true;
+        sRedLootAttemptStationId = p->stationId;
       }
 
-      // Station empty?
-      if (G.stationInventory[p->stationId] == 0) {
-        uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-        packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-        auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-        a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-        a->carried=G.players[pi].carried;
-        a->inventory=0;
-        a->capacity =G.stationCapacity[p->stationId];
-        a->denyReason=1; // EMPTY
-        Transport::broadcast(buf,sizeof(buf));
-        break;
-      }
+      uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+      packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+      auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+      a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+      a->carried=0;
+      a->inventory= G.stationInventory[p->stationId];
+      a->capacity = G.stationCapacity[p->stationId];
+      a->denyReason = inRedGrace ? 6 : 2;
+      txToStation(p->stationId, buf, sizeof(buf));
+      return;
+    }
+  }
 
-      // Allocate hold slot
-      int hi = allocHold(G);
-      if (hi < 0) {
-        uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-        packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-        auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-        a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-        a->carried=G.players[pi].carried;
-        a->inventory=G.stationInventory[p->stationId];
-        a->capacity =G.stationCapacity[p->stationId];
-        a->denyReason=5; // DENIED (no slots)
-        Transport::broadcast(buf,sizeof(buf));
-        break;
-      }
+  // Ensure player record
+  int pi = ensurePlayer(G, p->uid);
+  if (pi < 0) {
+    uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+    packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+    auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+    a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+    a->carried=0;
+    a->inventory=G.stationInventory[p->stationId];
+    a->capacity =G.stationCapacity[p->stationId];
+    a->denyReason=5; // DENIED (no player)
+    txToStation(p->stationId, buf, sizeof(buf));
+    return;
+  }
 
-      // Accept hold
-      G.holds[hi].active     = true;
-      G.holds[hi].holdId     = p->holdId;
-      G.holds[hi].stationId  = p->stationId;
-      G.holds[hi].playerIdx  = pi;
-      G.holds[hi].nextTickAt = now + (G.lootRateMs ? G.lootRateMs : 250); // safe fallback
-
-      {
-        uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
-        packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
-        auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
-        a->holdId=p->holdId; a->accepted=1; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
-        a->carried=G.players[pi].carried;
-        a->inventory=G.stationInventory[p->stationId];
-        a->capacity =G.stationCapacity[p->stationId];
-        a->denyReason=0;
-        Transport::broadcast(buf,sizeof(buf));
-      }
+  // Full carry?
+  if (G.players[pi].carried >= G.maxCarry) {
+    uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+    packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+    auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+    a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+    a->carried=G.players[pi].carried;
+    a->inventory=G.stationInventory[p->stationId];
+    a->capacity =G.stationCapacity[p->stationId];
+    a->denyReason=0; // FULL
+    txToStation(p->stationId, buf, sizeof(buf));
+    return;
+  }
 
-      if (applyBonusOnHoldStart(G, G.holds[hi].playerIdx, G.holds[hi].stationId, G.holds[hi].holdId)) {
-        G.holds[hi].active = false;
-      }
-      break;
-    }
+  // Station empty?
+  if (G.stationInventory[p->stationId] == 0) {
+    uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+    packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+    auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+    a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+    a->carried=G.players[pi].carried;
+    a->inventory=0;
+    a->capacity =G.stationCapacity[p->stationId];
+    a->denyReason=1; // EMPTY
+    txToStation(p->stationId, buf, sizeof(buf));
+    return;
+  }
+
+  // Allocate hold slot
+  int hi = allocHold(G, p->holdId, p->stationId, (uint16_t)pi);
+  if (hi < 0) {
+    uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+    packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+    auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+    a->holdId=p->holdId; a->accepted=0; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+    a->carried=G.players[pi].carried;
+    a->inventory=G.stationInventory[p->stationId];
+    a->capacity =G.stationCapacity[p->stationId];
+    a->denyReason=5; // DENIED (no slots)
+    txToStation(p->stationId, buf, sizeof(buf));
+    return;
+  }
+
+  // Accept hold
+  G.holds[hi].nextTickAt = now + (G.lootRateMs ? G.lootRateMs : 250); // safe fallback
+  timerArm(TMR_HOLD_0 + hi, G.holds[hi].nextTickAt);
+
+  {
+    uint8_t buf[sizeof(MsgHeader)+sizeof(LootHoldAckPayload)];
+    packHeader(G, (uint8_t)MsgType::LOOT_HOLD_ACK, sizeof(LootHoldAckPayload), buf, h->seq);
+    auto* a=(LootHoldAckPayload*)(buf+sizeof(MsgHeader));
+    a->holdId=p->holdId; a->accepted=1; a->rateHz=rateHz; a->maxCarry=G.maxCarry;
+    a->carried=G.players[pi].carried;
+    a->inventory=G.stationInventory[p->stationId];
+    a->capacity =G.stationCapacity[p->stationId];
+    a->denyReason=0;
+    txToStation(p->stationId, buf, sizeof(buf));
+  }
+
+  if (applyBonusOnHoldStart(G, G.holds[hi].playerIdx, G.holds[hi].stationId, G.holds[hi].holdId)) {
+    releaseHold(G, (uint8_t)hi);
+  }
+}
+
+static void rxLootHoldStop(const MsgHeader*, const uint8_t* data) {
+  auto* p = (const LootHoldStopPayload*)(data+sizeof(MsgHeader));
+
+  Game& G = g;
+  int hi = findHoldById(G, p->holdId);
+  if (hi>=0) {
+    const uint8_t sid = G.holds[hi].stationId;
+    releaseHold(G, (uint8_t)hi);
+    sendHoldEnd(G, sid, p->holdId, /*REMOVED*/2);
+  }
+}
 
-    case MsgType::LOOT_HOLD_STOP: {
-      if (h->payloadLen != sizeof(LootHoldStopPayload)) break;
-      auto* p = (const LootHoldStopPayload*)(data+sizeof(MsgHeader));
+static void rxDropRequest(const MsgHeader*, const uint8_t* data) {
+  auto* p = (const DropRequestPayload*)(data+sizeof(MsgHeader));
 
-      extern Game g; Game& G = g;
-      int hi = findHoldById(G, p->holdId);
-      if (hi>=0) {
-        G.holds[hi].active=false;
-        sendHoldEnd(G, p->holdId, /*REMOVED*/2);
+  Game& G = g;
+
+  // Dropping during RED is an immediate violation at the Drop-off station.
+  // Reject the drop (bank nothing), consume at most one life for this RED,
+  // and kick the room back to GREEN like the camera/PIR path does.
+  if (G.phase == Phase::PLAYING && G.light == LightState::RED) {
+    sendDropResult(G, /*dropped=*/0, p->readerIndex);
+
+    if (!G.pirLifeLostThisRed) {
+      const LifeLossResult r = applyLifeLoss(G, /*RED_PIR / red drop*/3, /*DROP station*/TREX_DROPOFF_ID, /*obeyLockout=*/true);
+      if (r == LifeLossResult::LIFE_LOST) {
+        G.pirLifeLostThisRed = true;
+        enterGreen(G);
       }
-      break;
     }
+    return;
+  }
 
-    case MsgType::DROP_REQUEST: {
-      if (h->payloadLen != sizeof(DropRequestPayload)) break;
-      auto* p = (const DropRequestPayload*)(data+sizeof(MsgHeader));
-
-      extern Game g; Game& G = g;
-
-      // Dropping during RED is an immediate violation at the Drop-off station.
-      // Reject the drop (bank nothing), consume at most one life for this RED,
-      // and kick the room back to GREEN like the camera/PIR path does.
-      if (G.phase == Phase::PLAYING && G.light == LightState::RED) {
-        sendDropResult(G, /*dropped=*/0, p->readerIndex);
-
-        if (!G.pirLifeLostThisRed) {
-          const LifeLossResult r = applyLifeLoss(G, /*RED_PIR / red drop*/3, /*DROP station*/6, /*obeyLockout=*/true);
-          if (r == LifeLossResult::LIFE_LOST) {
-            G.pirLifeLostThisRed = true;
-            enterGreen(G);
-          }
-        }
-        break;
-      }
+  int pi = ensurePlayer(G, p->uid);
+  if (pi < 0) return;
+
+  uint16_t dropped = G.players[pi].carried;
+  G.players[pi].carried = 0;
+  G.players[pi].banked += dropped;
+  G.teamScore += dropped;
 
-      int pi = ensurePlayer(G, p->uid);
-      if (pi < 0) break;
+  sendDropResult(G, dropped, p->readerIndex);
+  bcastScore(G);
+}
+
+static void rxMgResult(const MsgHeader*, const uint8_t* data) {
+  const auto* p = (const MgResultPayload*)(data + sizeof(MsgHeader));
 
-      uint16_t dropped = G.players[pi].carried;
-      G.players[pi].carried = 0;
-      G.players[pi].banked += dropped;
-      G.teamScore += dropped;
+  Game& G = g;
+  if (!G.mgActive) return;
+  if (!isLiveStation(G, p->stationId)) return;
 
-      sendDropResult(G, dropped, p->readerIndex);
+  const uint32_t bit = (1u << p->stationId);
+
+  if (!(G.mgTriedMask & bit)) {
+    G.mgTriedMask |= bit;
+    if (p->success) {
+      G.mgSuccessMask |= bit;
+      G.teamScore += 10;
       bcastScore(G);
-      break;
     }
+    const uint32_t allMask = allStationsMask(G);
+    if ((G.mgTriedMask & allMask) == allMask && G.mgAllTriedAt == 0) {
+      G.mgAllTriedAt = millis();
+    }
+  }
+}
+
+// Stations' own view of their clock (TIME_SYNC_REQ), see `clock`
+struct ClockReport {
+  uint32_t atMs;        // 0 = never heard
+  uint32_t count;
+  int32_t  errUs;
+  uint32_t rttUs;
+  int16_t  driftPpm10;
+  uint8_t  synced;
+};
+static ClockReport sClock[TREX_CONTROL_ID + 1];
+
+static void rxTimeSync(const MsgHeader* h, const uint8_t* data) {
+  // t2 is when the callback queued it, not when loop() got here
+  const int64_t nowUs = esp_timer_get_time();
+  const uint64_t t2 = (uint64_t)(nowUs - (int64_t)(uint32_t)(micros() - sRxAtUs));
+  const auto* p = (const TimeSyncReqPayload*)(data + sizeof(MsgHeader));
+
+  Game& G = g;
+  uint8_t buf[sizeof(MsgHeader) + sizeof(TimeSyncRespPayload)];
+  packHeader(G, (uint8_t)MsgTypeExt::TIME_SYNC_RESP, sizeof(TimeSyncRespPayload), buf);
+  auto* r = (TimeSyncRespPayload*)(buf + sizeof(MsgHeader));
+  memset(r, 0, sizeof(*r));
+  r->targetId = h->srcStationId;
+  r->t1Us     = p->t1Us;
+  r->t2Us     = t2;
+  r->t3Us     = (uint64_t)esp_timer_get_time();
+  txToStation(h->srcStationId, buf, sizeof(buf));
+
+  if (h->srcStationId > TREX_CONTROL_ID) return;
+  ClockReport& c = sClock[h->srcStationId];
+  c.atMs       = millis();
+  c.count++;
+  c.errUs      = p->errUs;
+  c.rttUs      = p->rttUs;
+  c.driftPpm10 = p->driftPpm10;
+  c.synced     = p->synced;
+}
+
+void netPrintClockSync(Print& out) {
+  const uint32_t now = millis();
+  bool any = false;
+  for (uint8_t sid = 0; sid <= TREX_CONTROL_ID; ++sid) {
+    const ClockReport& c = sClock[sid];
+    if (!c.atMs) continue;
+    any = true;
+    out.printf("clock sid=%-2u %s err=%ldus rtt=%luus drift=%.1fppm reqs=%lu age=%lums\n",
+               (unsigned)sid, c.synced ? "synced  " : "UNSYNCED", (long)c.errUs,
+               (unsigned long)c.rttUs, c.driftPpm10 / 10.0f, (unsigned long)c.count,
+               (unsigned long)(now - c.atMs));
+  }
+  if (!any) out.println("clock: no station has asked for the time yet");
+}
+
+/* ── Anti-entropy (STATE_HEARTBEAT -> STATION_RESYNC) ────── */
+// What each station should believe, in the digest layout of its role
+static StationDigest expectedDigest(const Game& g, uint8_t sid) {
+  StationDigest d;
+  memset(&d, 0, sizeof(d));
+  d.phase      = (uint8_t)g.phase;
+  d.light      = (uint8_t)g.light;
+  d.roundIndex = g.roundIndex;
+  if (trexIsLootId(sid)) {
+    d.bonusMask = g.bonusActiveMask & (1u << sid);
+    if (isLiveStation(g, sid)) {
+      d.inventory = g.stationInventory[sid];
+      d.capacity  = g.stationCapacity[sid];
+    }
+  } else if (sid == TREX_DROPOFF_ID) {
+    d.bonusMask = g.bonusActiveMask;
+    d.teamScore = g.teamScore;
+  } else if (sid == TREX_CONTROL_ID) {
+    d.lives     = g.livesRemaining;
+    d.teamScore = g.teamScore;
+  }
+  return d;
+}
 
-    case MsgType::MG_RESULT: {
-      if (h->payloadLen != sizeof(MgResultPayload)) break;
-      const auto* p = (const MgResultPayload*)(data + sizeof(MsgHeader));
-
-      extern Game g; Game& G = g;
-      if (!G.mgActive) break;
-      if (p->stationId < 1 || p->stationId > MAX_STATIONS) break;
-
-      const uint32_t bit = (1u << p->stationId);
-
-      if (!(G.mgTriedMask & bit)) {
-        G.mgTriedMask |= bit;
-        if (p->success) {
-          G.mgSuccessMask |= bit;
-          G.teamScore += 10;
-          bcastScore(G);
-        }
-        uint32_t allMask = 0; for (uint8_t sid=1; sid<=MAX_STATIONS; ++sid) allMask |= (1u<<sid);
-        if ((G.mgTriedMask & allMask) == allMask && G.mgAllTriedAt == 0) {
-          G.mgAllTriedAt = millis();
-        }
-      }
-      break;
+// A station counts as confirmed once it reports the hash we expect. When the
+// truth moves (or it reports something else) it has STATE_HB_CONFIRM_MS to
+// catch up on its own before it gets a STATION_RESYNC.
+struct StationConv {
+  uint32_t repAtMs;      // last heartbeat, 0 = never heard
+  uint32_t repHash;
+  uint32_t expHash;
+  uint32_t sinceMs;      // start of the current unconfirmed stretch
+  uint32_t resyncAtMs;
+  uint8_t  resyncs;      // sent during this stretch
+  bool     confirmed;
+  bool     rejoin;       // this stretch started with a HELLO (counted in sConvRejoin)
+};
+static StationConv sConv[TREX_CONTROL_ID + 1];
+
+constexpr uint32_t CONV_STALE_MS      = 3 * STATE_HB_PERIOD_MS;   // silent this long: stop tracking
+constexpr uint32_t CONV_RETRY_MS      = 300;
+constexpr uint32_t CONV_RETRY_SLOW_MS = STATE_HB_PERIOD_MS;       // after CONV_RETRY_FAST resyncs
+constexpr uint8_t  CONV_RETRY_FAST    = 4;
+constexpr uint32_t CONV_REJOIN_RETRY_MS = 40;   // after a HELLO: it is listening and has nothing
+
+// Convergence time: truth changed (or station diverged) -> station reports it
+struct ConvStat { uint32_t n, sumMs, maxMs; };
+static ConvStat sConvDirect = {0, 0, 0};   // caught up on its own
+static ConvStat sConvResync = {0, 0, 0};   // needed a STATION_RESYNC
+static ConvStat sConvRejoin = {0, 0, 0};   // HELLO mid-game -> first matching heartbeat
+static uint32_t sHbRx = 0, sHbMismatch = 0, sResyncTx = 0;
+
+static void noteTruth(const Game& g, uint8_t sid, uint32_t now) {
+  StationConv& c = sConv[sid];
+  const StationDigest d = expectedDigest(g, sid);
+  const uint32_t h = trexDigestHash(d);
+  if (h == c.expHash) return;
+  c.expHash = h;
+  if (c.repHash == h) {                       // it got there first (e.g. a scheduled flip)
+    c.confirmed = true;
+  } else if (c.confirmed) {
+    c.confirmed = false;
+    c.sinceMs   = now;
+    c.resyncs   = 0;
+  }
+}
+
+static void sendStationResync(Game& g, uint8_t sid) {
+  const uint32_t now = millis();
+  const bool playing = (g.phase == Phase::PLAYING);
+
+  uint8_t buf[sizeof(MsgHeader) + sizeof(StationResyncPayload)];
+  packHeader(g, (uint8_t)MsgTypeExt::STATION_RESYNC, sizeof(StationResyncPayload), buf);
+  auto* p = (StationResyncPayload*)(buf + sizeof(MsgHeader));
+  memset(p, 0, sizeof(*p));
+  p->targetId        = sid;
+  p->phase           = (uint8_t)g.phase;
+  p->lightState      = (uint8_t)g.light;
+  p->roundIndex      = g.roundIndex;
+  p->livesRemaining  = g.livesRemaining;
+  p->livesMax        = g.livesMax;
+  p->flags           = (g.mgActive ? WF_FLAG_MG_ACTIVE : 0) |
+                       ((g.bonusIntermission || g.bonusIntermission2) ? WF_FLAG_INTERMISSION : 0);
+  if (isLiveStation(g, sid)) {
+    p->inventory     = g.stationInventory[sid];
+    p->capacity      = g.stationCapacity[sid];
+  }
+  p->schedEpoch      = cadenceEpoch();
+  p->bonusMask       = g.bonusActiveMask;
+  p->teamScore       = g.teamScore;
+  p->roundStartScore = g.roundStartScore;
+  p->roundGoalAbs    = g.roundGoal;
+  p->serverNowMs     = serverNow();
+  p->msLeftStage     = playing ? stageMsLeft(g, now) : 0;
+  p->msLeftGame      = (playing && g.gameEndAt > now) ? (g.gameEndAt - now) : 0;
+  if (g.mgActive && trexIsLootId(sid) && !(g.mgTriedMask & (1u << sid)) &&
+      (int32_t)(g.mgDeadline - now) > 0) {
+    const uint32_t left = g.mgDeadline - now;
+    p->mgSeed        = g.mgCfg.seed;
+    p->mgMsLeft      = (left > 0xFFFF) ? 0xFFFF : (uint16_t)left;
+    p->mgSpeedMinMs  = g.mgCfg.speedMinMs;
+    p->mgSpeedMaxMs  = g.mgCfg.speedMaxMs;
+    p->mgSegMin      = g.mgCfg.segMin;
+    p->mgSegMax      = g.mgCfg.segMax;
+  }
+  txToStation(sid, buf, sizeof(buf));
+  sResyncTx++;
+}
+
+static void rxStateHeartbeat(const MsgHeader* h, const uint8_t* data) {
+  const uint8_t sid = h->srcStationId;
+  if (sid > TREX_CONTROL_ID) return;
+  const auto* p = (const StateHeartbeatPayload*)(data + sizeof(MsgHeader));
+
+  Game& G = g;
+  const uint32_t now = millis();
+  StationConv& c = sConv[sid];
+  if (!c.repAtMs) c.confirmed = true;         // first report: noteTruth() starts from here
+  c.repAtMs = now;
+  c.repHash = p->stateHash;
+  sHbRx++;
+  if (G.phase != Phase::PLAYING) return;
+
+  noteTruth(G, sid, now);
+  if (c.repHash != c.expHash && p->reason == STATE_HB_BOOT && !c.rejoin) {
+    rejoinStation(G, sid, now);               // rebooted and its HELLO didn't make it
+    c.repHash = p->stateHash;
+    return;
+  }
+  if (c.repHash != c.expHash) {
+    sHbMismatch++;
+    if (c.confirmed) {                        // it moved away on its own
+      c.confirmed = false;
+      c.sinceMs   = now;
+      c.resyncs   = 0;
     }
+    return;
+  }
+  if (c.confirmed) return;
+
+  c.confirmed = true;
+  ConvStat& s = c.rejoin ? sConvRejoin : c.resyncs ? sConvResync : sConvDirect;
+  c.rejoin = false;
+  const uint32_t ms = now - c.sinceMs;
+  s.n++;
+  s.sumMs += ms;
+  if (ms > s.maxMs) s.maxMs = ms;
+}
 
-    default:
-      break;
+void netConvergeTick(Game& g, uint32_t now) {
+  const bool playing = (g.phase == Phase::PLAYING);
+  for (uint8_t sid = 1; sid <= TREX_CONTROL_ID; ++sid) {
+    StationConv& c = sConv[sid];
+    if (!c.repAtMs) continue;
+    if (!playing || now - c.repAtMs > CONV_STALE_MS) { c.confirmed = true; c.rejoin = false; continue; }
+
+    noteTruth(g, sid, now);
+    if (c.confirmed) continue;
+    if (!c.rejoin && now - c.sinceMs < STATE_HB_CONFIRM_MS) continue;
+    const uint32_t fast = c.rejoin ? CONV_REJOIN_RETRY_MS : CONV_RETRY_MS;
+    const uint32_t gap  = (c.resyncs < CONV_RETRY_FAST) ? fast : CONV_RETRY_SLOW_MS;
+    if (c.resyncs && now - c.resyncAtMs < gap) continue;
+
+    sendStationResync(g, sid);
+    c.resyncAtMs = now;
+    if (c.resyncs < 255) c.resyncs++;
   }
 }
+
+// HELLO while PLAYING: resync now and keep at it (CONV_REJOIN_RETRY_MS)
+// until the station's heartbeat matches. A periodic HELLO from a station
+// that is fine costs one resync and one heartbeat.
+static void rejoinStation(Game& g, uint8_t sid, uint32_t now) {
+  if (sid == 0 || sid > TREX_CONTROL_ID) return;
+  StationConv& c = sConv[sid];
+  c.repAtMs   = now;                 // whatever it reported before the reboot is void
+  c.repHash   = 0;
+  c.expHash   = trexDigestHash(expectedDigest(g, sid));
+  c.confirmed = false;
+  c.rejoin    = true;
+  c.sinceMs   = now;
+  sendStationResync(g, sid);
+  c.resyncAtMs = now;
+  c.resyncs    = 1;
+}
+
+void netPrintConvergence(Print& out) {
+  const uint32_t now = millis();
+  out.printf("converge direct n=%lu avg=%lums max=%lums | via resync n=%lu avg=%lums max=%lums\n",
+             (unsigned long)sConvDirect.n,
+             (unsigned long)(sConvDirect.n ? sConvDirect.sumMs / sConvDirect.n : 0),
+             (unsigned long)sConvDirect.maxMs, (unsigned long)sConvResync.n,
+             (unsigned long)(sConvResync.n ? sConvResync.sumMs / sConvResync.n : 0),
+             (unsigned long)sConvResync.maxMs);
+  out.printf("converge rejoin (HELLO -> match) n=%lu avg=%lums max=%lums\n",
+             (unsigned long)sConvRejoin.n,
+             (unsigned long)(sConvRejoin.n ? sConvRejoin.sumMs / sConvRejoin.n : 0),
+             (unsigned long)sConvRejoin.maxMs);
+  out.printf("converge heartbeats=%lu mismatched=%lu resyncsSent=%lu\n",
+             (unsigned long)sHbRx, (unsigned long)sHbMismatch, (unsigned long)sResyncTx);
+  for (uint8_t sid = 1; sid <= TREX_CONTROL_ID; ++sid) {
+    const StationConv& c = sConv[sid];
+    if (!c.repAtMs) continue;
+    if (c.confirmed) {
+      out.printf("  sid=%-2u ok hash=%08lx heard %lums ago\n", (unsigned)sid,
+                 (unsigned long)c.repHash, (unsigned long)(now - c.repAtMs));
+    } else {
+      out.printf("  sid=%-2u %s %lums has=%08lx want=%08lx resyncs=%u\n", (unsigned)sid,
+                 c.rejoin ? "REJOINING" : "DIVERGED", (unsigned long)(now - c.sinceMs),
+                 (unsigned long)c.repHash, (unsigned long)c.expHash, (unsigned)c.resyncs);
+    }
+  }
+}
+
+/* ── RX route table ───────────────────────────────────────── */
+// One entry per MsgType: handler, exact payload length, allowed source.
+using RxHandler = void (*)(const MsgHeader* h, const uint8_t* data);
+
+struct RxRoute {
+  RxHandler fn;
+  uint16_t  len;   // exact payloadLen, or RX_LEN_ANY
+  uint8_t   src;   // required srcStationId, or RX_SRC_ANY
+};
+
+constexpr uint16_t RX_LEN_ANY     = 0xFFFF;
+constexpr uint8_t  RX_SRC_ANY     = 0xFF;
+constexpr uint8_t  RX_SRC_CONTROL = TREX_CONTROL_ID;   // fixed id, see TrexProtocolExt.h
+
+// The route for one type; constexpr so the table below is built by the
+// compiler and stays in flash (C++11 constexpr: one return, hence the chain)
+constexpr RxRoute rxRouteFor(unsigned t) {
+  return t == (uint8_t)MsgType::HELLO           ? RxRoute{ rxHello,         sizeof(HelloPayload),         RX_SRC_ANY }
+       : t == (uint8_t)MsgType::RADIO_CFG       ? RxRoute{ rxRadioCfg,      sizeof(RadioCfgPayload),      RX_SRC_CONTROL }
+       : t == (uint8_t)MsgType::SERVER_CMD      ? RxRoute{ rxServerCmd,     sizeof(ServerCmdPayload),     RX_SRC_CONTROL }
+       : t == (uint8_t)MsgType::CONTROL_CMD     ? RxRoute{ rxControlCmd,    sizeof(ControlCmdPayload),    RX_SRC_CONTROL }
+       : t == (uint8_t)MsgType::LOOT_HOLD_START ? RxRoute{ rxLootHoldStart, sizeof(LootHoldStartPayload), RX_SRC_ANY }
+       : t == (uint8_t)MsgType::LOOT_HOLD_STOP  ? RxRoute{ rxLootHoldStop,  sizeof(LootHoldStopPayload),  RX_SRC_ANY }
+       : t == (uint8_t)MsgType::DROP_REQUEST    ? RxRoute{ rxDropRequest,   sizeof(DropRequestPayload),   RX_SRC_ANY }
+       : t == (uint8_t)MsgType::MG_RESULT       ? RxRoute{ rxMgResult,      sizeof(MgResultPayload),      RX_SRC_ANY }
+       : t == (uint8_t)MsgTypeExt::TIME_SYNC_REQ   ? RxRoute{ rxTimeSync,       sizeof(TimeSyncReqPayload),    RX_SRC_ANY }
+       : t == (uint8_t)MsgTypeExt::STATE_HEARTBEAT ? RxRoute{ rxStateHeartbeat, sizeof(StateHeartbeatPayload), RX_SRC_ANY }
+       : RxRoute{ nullptr, 0, 0 };
+}
+
+#define RX_ROUTES_4(n)  rxRouteFor(n), rxRouteFor(n + 1), rxRouteFor(n + 2), rxRouteFor(n + 3)
+#define RX_ROUTES_16(n) RX_ROUTES_4(n), RX_ROUTES_4(n + 4), RX_ROUTES_4(n + 8), RX_ROUTES_4(n + 12)
+#define RX_ROUTES_64(n) RX_ROUTES_16(n), RX_ROUTES_16(n + 16), RX_ROUTES_16(n + 32), RX_ROUTES_16(n + 48)
+static constexpr RxRoute kRxRoutes[256] = {
+  RX_ROUTES_64(0), RX_ROUTES_64(64), RX_ROUTES_64(128), RX_ROUTES_64(192)
+};
+#undef RX_ROUTES_64
+#undef RX_ROUTES_16
+#undef RX_ROUTES_4
+
+static void handleRx(const uint8_t* data, uint16_t len) {
+  if (len < sizeof(MsgHeader)) return;
+  auto* h = (const MsgHeader*)data;
+  if (h->version != TREX_PROTO_VERSION) {
+    sRxBadVersion++;
+    Serial.printf("[WARN] Proto mismatch on RX: got=%u exp=%u (type=%u)\n",
+                  h->version, (unsigned)TREX_PROTO_VERSION, h->type);
+    return;
+  }
+
+  RxCounters& c = sRxCount[h->type];
+  c.rx++;
+
+  if (sRxVerbose) {
+    Serial.printf("[NET] RX type=%u len=%u from=%u\n",
+                  (unsigned)h->type,
+                  (unsigned)h->payloadLen,
+                  (unsigned)h->srcStationId);
+  }
+
+  if (OtaCampaign::handle(data, len)) return;
+
+  const RxRoute& r = kRxRoutes[h->type];
+  if (!r.fn) return;
+
+  if (len < sizeof(MsgHeader) + h->payloadLen ||
+      (r.len != RX_LEN_ANY && h->payloadLen != r.len)) {
+    c.malformed++;
+    Serial.printf("[NET] type=%u bad len=%u (expected %u)\n",
+                  (unsigned)h->type, (unsigned)h->payloadLen,
+                  (unsigned)(r.len == RX_LEN_ANY ? len - sizeof(MsgHeader) : r.len));
+    return;
+  }
+  if (r.src != RX_SRC_ANY && h->srcStationId != r.src) {
+    c.dropped++;
+    Serial.printf("[NET] Ignoring type=%u from station %u\n",
+                  (unsigned)h->type, (unsigned)h->srcStationId);
+    return;
+  }
+
+  // Clock sync and heartbeats change nothing in the game; replaying them would only add noise
+  if (h->type != (uint8_t)MsgTypeExt::TIME_SYNC_REQ &&
+      h->type != (uint8_t)MsgTypeExt::STATE_HEARTBEAT) journalRx(data, sizeof(MsgHeader) + h->payloadLen);
+  r.fn(h, data);
+}
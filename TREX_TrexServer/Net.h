@@ -1,20 +1,29 @@
 #pragma once
 #include <TrexProtocol.h>
+#include "TrexProtocolExt.h"
 #include "GameModel.h"
 #include "ServerConfig.h"
 
+// Server time as stations see it (their ClockSync estimates this clock)
+inline uint32_t serverNow() { return millis(); }
+
 // Broadcasts
-void sendStateTick(const Game& g, uint32_t msLeft);
+// Periodic WORLD_FRAME spacing (tickHz, >= 10 ms)
+uint32_t worldFramePeriodMs(const Game& g);
+// Coalesced per-tick snapshot (light, timers, round, score, lives, bonus mask).
+// copies > 1 repeats the same frame (same seq) gapMs apart via netTxPump().
+void bcastWorldFrame(Game& g, uint8_t copies = 1, uint16_t gapMs = 0);
+// Upcoming light segments (Cadence.cpp); n == 0 tells stations the cadence stopped
+void bcastLightSchedule(Game& g, uint16_t epoch, const LightScheduleEntry* e, uint8_t n,
+                        uint8_t copies = 1, uint16_t gapMs = 0);
 void bcastGameStart(Game& g);
 void bcastGameOver(Game& g, uint8_t reason, uint8_t blameSid = GAMEOVER_BLAME_ALL);
 void bcastScore(Game& g);
-void bcastStation(Game& g, uint8_t stationId);
 // Broadcast that a drop has completed
 void sendDropResult(Game& g, uint16_t dropped, uint8_t readerIndex = DROP_READER_UNKNOWN);
 
 void bcastRoundStatus(Game& g);
 void bcastBonusUpdate(Game& g);
-void bcastGameStatus(const Game& g);
 
 // Lives system
 enum class LifeLossResult : uint8_t { IGNORED=0, LIFE_LOST=1, GAME_OVER=2 };
@@ -25,12 +34,39 @@ LifeLossResult applyLifeLoss(Game& g, uint8_t reason, uint8_t blameSid = GAMEOVE
 void bcastMgStart(Game& g, const Game::MgConfig& cfg);
 void bcastMgStop(Game& g);
 
-// Point messages
-void sendHoldEnd(Game& g, uint32_t holdId, uint8_t reason);
-void sendLootTick(Game& g, uint32_t holdId, uint8_t carried, uint16_t stationInv);
+// Point messages: unicast to stationId when its MAC is known (from HELLO),
+// broadcast otherwise
+void sendHoldEnd(Game& g, uint8_t stationId, uint32_t holdId, uint8_t reason);
+void sendLootTick(Game& g, uint8_t stationId, uint32_t holdId, uint8_t carried, uint16_t stationInv);
+// Only legacy (unframed) wire mode can bypass Transport for unicast
+void netSetUnicastEnabled(bool on);
+// Release + HOLD_END (to the owning station) every hold on `sid` / on any
+// station. Return the count / the first station that had a hold (0 = none).
+uint8_t endHoldsOnStation(Game& g, uint8_t sid, uint8_t reason);
+uint8_t endAllHolds(Game& g, uint8_t reason);
+
+// Accrual pass: queue each hold that ticked, then flush once at the end of
+// the pass. A frame carries up to TICK_BATCH_MAX (28) entries plus every
+// station inventory; a longer pass goes out as several LOOT_TICK_BATCH frames.
+void lootTickBatchAdd(Game& g, uint32_t holdId, uint8_t carried);
+void lootTickBatchFlush(Game& g);
+// Station inventory sync: flush g.stationDirty (rate-limited) + periodic
+// full refresh while PLAYING; call once per loop() pass.
+void netStationSync(Game& g, uint32_t now);
+// Anti-entropy: compare every heartbeating station with the truth and
+// unicast STATION_RESYNC to the ones that haven't caught up; once per pass.
+void netConvergeTick(Game& g, uint32_t now);
+// Bins TX airtime by concurrent hold count; call once per accrual pass.
+void netNoteAccrualPass(uint8_t activeHolds, uint32_t now);
 
-// RX dispatcher
+// RX: onRx is the transport callback and only enqueues; netDrainRx()
+// dispatches everything queued so far (call from loop()).
 void onRx(const uint8_t* data, uint16_t len);
+void netDrainRx();
+
+// Per-packet "[NET] RX" logging (off by default; `rxlog on|off`)
+void netSetRxVerbose(bool on);
+bool netRxVerbose();
 
 // Maintenance / control helpers
 bool netConsumeEnterMaintRequest();
@@ -52,3 +88,25 @@ void bcastRadioCfg(Game& g, const RadioCfgPayload& cfg);
 
 // Radio config request (from CONTROL)
 bool netConsumeRadioCfgRequest(RadioCfgPayload& out);
+
+// TX accounting: frames/bytes/time per stage (1..5 = rounds)
+enum : uint8_t {
+  NET_STAGE_IDLE  = 0,
+  NET_STAGE_BONUS = 6,   // R2.5 / R3.5 intermissions
+  NET_STAGE_MG    = 7,
+  NET_STAGE_COUNT = 8
+};
+void netPrintStats(Print& out);
+// Last TIME_SYNC_REQ per station: its estimate error, rtt, drift (`clock`)
+void netPrintClockSync(Print& out);
+// Convergence time (direct / via resync), per-station agree/diverged (`sync`)
+void netPrintConvergence(Print& out);
+// Frame sizes, frames/s, airtime and pack time at 5/8/12/16 Loots (`stationload`)
+void netPrintStationLoad(Game& g, Print& out);
+
+// Spaced retransmit bursts are drained from here (never delay()s)
+void netTxPump(uint32_t now);
+
+// Loop health: longest gap between gameplay loop() passes, see netPrintStats
+void netNoteLoopPass(uint32_t nowUs);
+void netLoopPaused();
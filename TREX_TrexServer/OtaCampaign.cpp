@@ -2,6 +2,8 @@
 #include <Arduino.h>
 #include <TrexProtocol.h>
 #include <esp_random.h>
+#include "ServerConfig.h"
+#include "TrexProtocolExt.h"
 
 // Provided by Net.cpp (see shim above)
 extern void netBroadcastRaw(const uint8_t* data, uint16_t len);
@@ -15,7 +17,8 @@ static uint8_t      g_expectMajor = 0, g_expectMinor = 0;
 
 // StationState is defined in OtaCampaign.h, with fields:
 // phase, error, fwMajor, fwMinor, bytes, total
-static StationState g_state[6]; // index by stationId 0..5 (we use 1..5)
+static StationState g_state[TREX_MAX_LOOT_STATIONS + 1]; // index by stationId (we use 1..g_stationCount)
+static uint8_t      g_stationCount = DEFAULT_STATION_COUNT;
 static bool         g_active = false;
 
 // NEW: 0 = all loot, else specific STATION_ID
@@ -25,6 +28,10 @@ void setLootTargetId(uint8_t targetId) {
   g_lootTargetId = targetId;
 }
 
+void setStationCount(uint8_t n) {
+  g_stationCount = (n > TREX_MAX_LOOT_STATIONS) ? TREX_MAX_LOOT_STATIONS : n;
+}
+
 void begin() {
   memset(g_state, 0, sizeof(g_state));
   g_active = false;
@@ -38,7 +45,7 @@ void summary(const char* why) {
                 (unsigned long)g_campaignId,
                 g_expectMajor,
                 g_expectMinor);
-  for (int id=1; id<=5; ++id) {
+  for (int id=1; id<=g_stationCount; ++id) {
     StationState &s = g_state[id];
     const char* ph = (s.phase==0)?"PENDING":
                      (s.phase==(uint8_t)OtaPhase::ACK)?"ACK":
@@ -111,7 +118,7 @@ bool handle(const uint8_t* data, uint16_t len) {
     if (p->stationType != (uint8_t)StationType::LOOT) return true;
 
     uint8_t id = p->stationId;
-    if (id < 1 || id > 5) return true;
+    if (id < 1 || id > g_stationCount) return true;
 
     StationState &s = g_state[id];
     s.phase  = p->phase;
@@ -132,7 +139,7 @@ bool handle(const uint8_t* data, uint16_t len) {
     // Early finish if everyone succeeded
     if (p->phase == (uint8_t)OtaPhase::SUCCESS) {
       bool allDone = true;
-      for (int i=1;i<=5;i++)
+      for (int i=1;i<=g_stationCount;i++)
         if (g_state[i].phase != (uint8_t)OtaPhase::SUCCESS) { allDone=false; break; }
       if (allDone) { summary("complete"); g_active=false; }
     }
@@ -147,7 +154,7 @@ bool handle(const uint8_t* data, uint16_t len) {
     if (p->stationType != (uint8_t)StationType::LOOT) return false;
 
     uint8_t id = p->stationId;
-    if (id < 1 || id > 5) return false;
+    if (id < 1 || id > g_stationCount) return false;
 
     // Version match rule: 0 = wildcard (ignore that field)
     bool majOK = (g_expectMajor == 0) || (p->fwMajor == g_expectMajor);
@@ -163,7 +170,7 @@ bool handle(const uint8_t* data, uint16_t len) {
         Serial.printf("[OTA] Loot-%u SUCCESS via HELLO v=%u.%u\n", id, p->fwMajor, p->fwMinor);
 
         bool allDone = true;
-        for (int i=1;i<=5;i++)
+        for (int i=1;i<=g_stationCount;i++)
           if (g_state[i].phase != (uint8_t)OtaPhase::SUCCESS) { allDone=false; break; }
         if (allDone) { summary("complete"); g_active=false; }
       }
@@ -23,6 +23,9 @@ void sendLootOtaToAll(const char* url, uint8_t expectMajor, uint8_t expectMinor)
 // store which loot station(s) should be targeted in the next campaign
 void setLootTargetId(uint8_t targetId);   // 0 = all loot, else specific STATION_ID
 
+// Loot ids 1..n are tracked (and must all report SUCCESS to finish early)
+void setStationCount(uint8_t n);
+
 // Call from your server onRx() early; returns true if message was handled
 bool handle(const uint8_t* data, uint16_t len);
 
@@ -0,0 +1,159 @@
+#include "PlayerTable.h"
+#include <string.h>
+#include <new>
+
+static const uint32_t MASK = PLAYER_INDEX_SLOTS - 1;
+
+static uint32_t sLookups   = 0;
+static uint32_t sProbes    = 0;
+static uint16_t sProbeMax  = 0;
+static uint32_t sEvictions = 0;
+static uint32_t sDenied    = 0;
+
+uint64_t playerKey(const TrexUid& u) {
+  const uint8_t n = (u.len > sizeof(u.bytes)) ? sizeof(u.bytes) : u.len;
+  uint64_t k = (uint64_t)n << 56;
+  for (uint8_t i = 0; i < n; ++i) k ^= (uint64_t)u.bytes[i] << (8 * (i % 7));
+  return k;
+}
+
+static inline uint32_t slotOf(uint64_t key) {
+  return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & MASK;
+}
+
+static inline bool sameUid(const PlayerRec& r, uint64_t key, const TrexUid& u) {
+  if (r.key != key) return false;
+  if (u.len <= 7) return true;    // lossless key
+  return memcmp(r.uid.bytes, u.bytes, u.len) == 0;
+}
+
+void playersClear(PlayerTable& t) {
+  for (uint16_t i = 0; i < MAX_PLAYERS; ++i) t.recs[i] = PlayerRec{};
+  for (uint32_t s = 0; s < PLAYER_INDEX_SLOTS; ++s) t.index[s] = PLAYER_NONE;
+  // Hand out low indices first
+  t.freeTop = 0;
+  for (uint16_t i = MAX_PLAYERS; i-- > 0; ) t.freeList[t.freeTop++] = i;
+  t.count = 0;
+}
+
+PlayerTable::PlayerTable() { playersClear(*this); }
+
+int playersFind(const PlayerTable& t, const TrexUid& u) {
+  const uint64_t key = playerKey(u);
+  uint32_t s = slotOf(key);
+  uint16_t probes = 1;
+  int found = -1;
+  for (;; s = (s + 1) & MASK, ++probes) {
+    const uint16_t ri = t.index[s];
+    if (ri == PLAYER_NONE) break;
+    if (sameUid(t.recs[ri], key, u)) { found = ri; break; }
+  }
+  sLookups++;
+  sProbes += probes;
+  if (probes > sProbeMax) sProbeMax = probes;
+  return found;
+}
+
+int playersInsert(PlayerTable& t, const TrexUid& u, uint32_t now) {
+  if (!t.freeTop) return -1;
+  const uint16_t ri = t.freeList[--t.freeTop];
+
+  PlayerRec& r = t.recs[ri];
+  r = PlayerRec{};
+  r.used = true;
+  r.uid  = u;
+  r.key  = playerKey(u);
+  r.lastSeenMs = now;
+
+  uint32_t s = slotOf(r.key);
+  while (t.index[s] != PLAYER_NONE) s = (s + 1) & MASK;
+  t.index[s] = ri;
+  t.count++;
+  return ri;
+}
+
+void playersRemove(PlayerTable& t, uint16_t idx) {
+  if (idx >= MAX_PLAYERS || !t.recs[idx].used) return;
+
+  uint32_t s = slotOf(t.recs[idx].key);
+  while (t.index[s] != idx) s = (s + 1) & MASK;
+  t.index[s] = PLAYER_NONE;
+
+  // Backward-shift deletion: pull later members of the probe run into the
+  // hole when the hole lies between their home slot and where they sit,
+  // so lookups never need tombstones.
+  for (uint32_t j = (s + 1) & MASK; t.index[j] != PLAYER_NONE; j = (j + 1) & MASK) {
+    const uint32_t home = slotOf(t.recs[t.index[j]].key);
+    if (((j - home) & MASK) >= ((j - s) & MASK)) {
+      t.index[s] = t.index[j];
+      t.index[j] = PLAYER_NONE;
+      s = j;
+    }
+  }
+
+  t.recs[idx] = PlayerRec{};
+  t.freeList[t.freeTop++] = idx;
+  t.count--;
+}
+
+void playersNoteFull(bool evicted) {
+  if (evicted) sEvictions++; else sDenied++;
+}
+
+void playersPrintStats(Print& out, const PlayerTable& t) {
+  out.printf("players %u/%u slots=%lu lookups=%lu avgProbe=%.2f maxProbe=%u evicted=%lu denied=%lu\n",
+             (unsigned)t.count, (unsigned)MAX_PLAYERS, (unsigned long)PLAYER_INDEX_SLOTS,
+             (unsigned long)sLookups, sLookups ? (double)sProbes / sLookups : 0.0,
+             (unsigned)sProbeMax, (unsigned long)sEvictions, (unsigned long)sDenied);
+}
+
+static TrexUid benchUid(uint32_t n) {
+  // Same shape as real tags: 7-byte NXP UIDs sharing a manufacturer byte
+  TrexUid u{};
+  u.len = 7;
+  u.bytes[0] = 0x04;
+  for (uint8_t b = 1; b < 7; ++b) { n = n * 1664525u + 1013904223u; u.bytes[b] = (uint8_t)(n >> 24); }
+  return u;
+}
+
+void playersBench(Print& out) {
+  PlayerTable* t = new (std::nothrow) PlayerTable;
+  if (!t) { out.print("playerbench: no memory\n"); return; }
+
+  const uint32_t saveLookups = sLookups, saveProbes = sProbes;
+  const uint16_t saveMax = sProbeMax;
+  static const uint16_t SIZES[] = { 24, 128, 256 };
+  const uint32_t ROUNDS = 4000;
+
+  for (uint16_t n : SIZES) {
+    if (n > MAX_PLAYERS) { out.printf("n=%u: above MAX_PLAYERS=%u\n", n, (unsigned)MAX_PLAYERS); continue; }
+    playersClear(*t);
+    for (uint16_t i = 0; i < n; ++i) playersInsert(*t, benchUid(i), 0);
+
+    sLookups = sProbes = 0; sProbeMax = 0;
+    volatile int sink = 0;
+    uint32_t t0 = micros();
+    for (uint32_t r = 0; r < ROUNDS; ++r) sink += playersFind(*t, benchUid(r % n));
+    const uint32_t hitUs = micros() - t0;
+    const float hitProbe = (float)sProbes / sLookups;
+
+    // The bench UIDs are generated per lookup in both runs; measure that alone
+    t0 = micros();
+    for (uint32_t r = 0; r < ROUNDS; ++r) sink += benchUid(r % n).bytes[1];
+    const uint32_t genUs = micros() - t0;
+
+    sLookups = sProbes = 0;
+    t0 = micros();
+    for (uint32_t r = 0; r < ROUNDS; ++r) sink += playersFind(*t, benchUid(100000 + r));
+    const uint32_t missUs = micros() - t0;
+    (void)sink;
+
+    out.printf("n=%3u hit=%4luns (%.2f probes) miss=%4luns (%.2f probes)\n", n,
+               (unsigned long)((hitUs > genUs ? hitUs - genUs : 0) * 1000UL / ROUNDS), hitProbe,
+               (unsigned long)((missUs > genUs ? missUs - genUs : 0) * 1000UL / ROUNDS),
+               (float)sProbes / sLookups);
+  }
+
+  sLookups = saveLookups; sProbes = saveProbes; sProbeMax = saveMax;
+  delete t;
+}
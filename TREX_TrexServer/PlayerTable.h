@@ -0,0 +1,68 @@
+#pragma once
+// Player records keyed by wristband UID.
+//
+// recs[] is the record store; a record keeps its index for as long as it
+// lives, so holds can refer to it by playerIdx. index[] is an open-addressing
+// (linear probing) hash over recs[] keyed by the UID packed into 64 bits:
+// length in the top byte, UID bytes below it. 4- and 7-byte UIDs pack
+// losslessly; 10-byte UIDs fold their tail in, so a key match on those is
+// confirmed against the full UID.
+#include <Arduino.h>
+#include <TrexProtocol.h>
+
+#ifndef TREX_MAX_PLAYERS
+#define TREX_MAX_PLAYERS 256
+#endif
+
+// Reuse the least-recently-seen record with nothing carried (and no live
+// hold) when the table is full, instead of denying the new wristband.
+#ifndef PLAYER_EVICT_LRU
+#define PLAYER_EVICT_LRU 1
+#endif
+
+constexpr uint16_t MAX_PLAYERS = TREX_MAX_PLAYERS;
+constexpr uint16_t PLAYER_NONE = 0xFFFF;
+static_assert(MAX_PLAYERS > 0 && MAX_PLAYERS < PLAYER_NONE, "player index is 16-bit");
+
+static constexpr uint32_t playerIndexSlots(uint32_t want, uint32_t p = 16) {
+  return (p >= want) ? p : playerIndexSlots(want, p * 2);
+}
+// Power of two, load factor <= 0.5
+constexpr uint32_t PLAYER_INDEX_SLOTS = playerIndexSlots(2u * MAX_PLAYERS);
+
+struct PlayerRec {
+  TrexUid  uid{};
+  bool     used=false;
+  uint8_t  carried=0;
+  uint32_t banked=0;
+  uint64_t key=0;          // playerKey(uid)
+  uint32_t lastSeenMs=0;   // last ensurePlayer(); LRU eviction order
+};
+
+struct PlayerTable {
+  PlayerRec recs[MAX_PLAYERS];
+  uint16_t  index[PLAYER_INDEX_SLOTS];   // record index or PLAYER_NONE
+  uint16_t  freeList[MAX_PLAYERS];       // unused record indices (stack)
+  uint16_t  freeTop = 0;
+  uint16_t  count   = 0;
+
+  PlayerTable();   // starts cleared (playersClear)
+
+  PlayerRec&       operator[](uint16_t i)       { return recs[i]; }
+  const PlayerRec& operator[](uint16_t i) const { return recs[i]; }
+};
+
+uint64_t playerKey(const TrexUid& u);
+
+void playersClear(PlayerTable& t);
+int  playersFind(const PlayerTable& t, const TrexUid& u);
+// New record for `u` (caller checked it isn't present); -1 when full
+int  playersInsert(PlayerTable& t, const TrexUid& u, uint32_t now);
+void playersRemove(PlayerTable& t, uint16_t idx);
+
+void playersNoteFull(bool evicted);   // ensurePlayer() outcome when full
+void playersPrintStats(Print& out, const PlayerTable& t);
+
+// Lookup cost at 24/128/256 resident players (maintenance `playerbench`);
+// builds its own scratch table, leaves the game's alone.
+void playersBench(Print& out);
@@ -0,0 +1,20 @@
+// Server loop() sections for Profiler (no include guard: X-macro list).
+//
+// PROF(NAME, "label") -> PS_NAME. Order is print order only.
+
+PROF(LOOP,      "loop")        // whole pass, after the maintenance gate
+PROF(CONTROL,   "control")     // CONTROL / server-cmd / radio-cfg requests
+PROF(NET,       "net")         // OtaCampaign + Transport::loop + RX drain + TX pump
+PROF(PUMPS,     "pumps")       // evlog / journal / snapshot
+PROF(SERIAL,    "serial")      // line parser
+PROF(TIMERS,    "timers")      // timersRun
+PROF(DRIP,      "drip")        // GAME_START / score drip
+PROF(STN_SYNC,  "stationSync") // netStationSync
+PROF(WORLD,     "worldFrame")  // WORLD_FRAME broadcast
+PROF(MINIGAME,  "minigame")
+PROF(ACCRUAL,   "accrual")     // hold ticks + loot tick batch
+PROF(RED_HOLDS, "redHolds")    // RED hold end / strict grace
+PROF(PIR,       "pir")
+PROF(CLASSIC,   "modeClassic") // onPlayingTick + maybeAdvance
+PROF(CADENCE,   "cadence")     // tickCadence / bonus intermissions
+PROF(FLIP,      "flipToBcast") // enterGreen/Yellow/Red entry -> WORLD_FRAME out
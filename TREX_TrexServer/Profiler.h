@@ -0,0 +1,65 @@
+#pragma once
+// Loop-section cycle profiler.
+//
+//   { PROF_SCOPE(PS_DRIP); ...section... }
+//   PROF_BEGIN(PS_SERIAL); ...section... PROF_END(PS_SERIAL);
+//
+// times the enclosing block (or the BEGIN..END span, closed early by a
+// return out of the function) with the CPU cycle counter and files the result
+// into that section's log2 histogram (bucket b holds [2^b, 2^(b+1)) cycles),
+// next to count / sum / min / max. profPrint() turns that into
+// min/avg/p99/max in microseconds; p99 is the upper edge of its bucket, so
+// it is at most 2x pessimistic. Sections are per sketch (ProfSections.h);
+// they may nest, each just measures its own block.
+//
+// Build with -DTREX_PROF=0 and the PROF_ macros compile to nothing; profPrint()
+// then only says so. Profiler.h/.cpp are identical copies in each sketch
+// that uses it. Not ISR/task safe: call from loop() only.
+#include <Arduino.h>
+
+#ifndef TREX_PROF
+#define TREX_PROF 1
+#endif
+
+enum ProfId : uint8_t {
+#define PROF(name, label) PS_##name,
+#include "ProfSections.h"
+#undef PROF
+  PS_COUNT
+};
+
+constexpr uint8_t PROF_BUCKETS = 32;   // log2 of a 32-bit cycle delta
+
+#if TREX_PROF
+void profAdd(ProfId id, uint32_t cycles);
+
+class ProfScope {
+public:
+  explicit ProfScope(ProfId id) : id_(id), t0_(ESP.getCycleCount()) {}
+  ~ProfScope() { stop(); }
+  void stop() {
+    if (id_ == PS_COUNT) return;
+    profAdd(id_, ESP.getCycleCount() - t0_);
+    id_ = PS_COUNT;
+  }
+  ProfScope(const ProfScope&) = delete;
+  ProfScope& operator=(const ProfScope&) = delete;
+private:
+  ProfId   id_;
+  uint32_t t0_;
+};
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b)  PROF_CAT2(a, b)
+#define PROF_SCOPE(id)  ProfScope PROF_CAT(_prof_, __LINE__)(id)
+#define PROF_BEGIN(id)  ProfScope PROF_CAT(_prof_, id)(id)
+#define PROF_END(id)    PROF_CAT(_prof_, id).stop()
+#else
+#define PROF_SCOPE(id)  do {} while (0)
+#define PROF_BEGIN(id)  do {} while (0)
+#define PROF_END(id)    do {} while (0)
+#endif
+
+// One line per section that has samples (maintenance / serial `prof`).
+void profPrint(Print& out);
+void profReset();                      // `prof reset`
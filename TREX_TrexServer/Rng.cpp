@@ -0,0 +1,15 @@
+#include "Rng.h"
+
+// splitmix32 expands the 32-bit seed into the 128-bit state (never all-zero).
+static uint32_t splitmix32(uint32_t& x) {
+  uint32_t z = (x += 0x9E3779B9u);
+  z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+  z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+  return z ^ (z >> 16);
+}
+
+void rngSeed(Rng& r, uint32_t seed) {
+  uint32_t x = seed;
+  for (uint8_t i = 0; i < 4; ++i) r.s[i] = splitmix32(x);
+  if (!(r.s[0] | r.s[1] | r.s[2] | r.s[3])) r.s[0] = 1;
+}
@@ -0,0 +1,38 @@
+#pragma once
+// Gameplay PRNG: xoshiro128** (32-bit state words, so it's a handful of
+// ALU ops on the S3 instead of a hardware RNG register read).
+//
+// Game owns one (g.rng) and every gameplay draw goes through it, so a game
+// replays bit-exactly from its seed plus its inputs. The seed is logged at
+// game start; SEED <n> on serial pins the seed of the next game.
+#include <stdint.h>
+
+struct Rng {
+  uint32_t s[4] = {1, 2, 3, 4};
+};
+
+void rngSeed(Rng& r, uint32_t seed);
+
+static inline uint32_t rngRotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+static inline uint32_t rngNext(Rng& r) {
+  const uint32_t result = rngRotl(r.s[1] * 5, 7) * 9;
+  const uint32_t t = r.s[1] << 9;
+  r.s[2] ^= r.s[0];
+  r.s[3] ^= r.s[1];
+  r.s[1] ^= r.s[2];
+  r.s[0] ^= r.s[3];
+  r.s[2] ^= t;
+  r.s[3] = rngRotl(r.s[3], 11);
+  return result;
+}
+
+// Uniform in [0, n) (multiply-shift; n == 0 returns 0)
+static inline uint32_t rngBelow(Rng& r, uint32_t n) {
+  return (uint32_t)(((uint64_t)rngNext(r) * n) >> 32);
+}
+
+// Uniform in [lo, hi] (inclusive, lo <= hi)
+static inline uint32_t rngRange(Rng& r, uint32_t lo, uint32_t hi) {
+  return lo + rngBelow(r, hi - lo + 1);
+}
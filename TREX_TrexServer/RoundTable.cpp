@@ -0,0 +1,184 @@
+#include "RoundTable.h"
+#include <LittleFS.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ---- Built-in rounds ----
+//   dur    goal carry/tick rate  split              red    yellow  green        red         yellow      pirFloor bounce  bonus                                      after
+static constexpr RoundDesc kRounds[ROUND_COUNT] = {
+  { 70000, 40, 20, 4, 1000, SplitMode::EVEN,   false, false,     0,     0,    0,    0,    0,    0, false,  0, { BonusKind::NONE,   0, 0,     0,     0,     0 }, AfterRound::NEXT      },
+  { 75000, 40, 20, 4, 1000, SplitMode::EVEN,   true,  true,      0,     0,    0,    0,    0,    0, false,  0, { BonusKind::NONE,   0, 0,     0,     0,     0 }, AfterRound::BONUS_ALL },
+  { 75000, 40, 10, 4, 1000, SplitMode::RANDOM, true,  true,  14000, 18000, 6500, 8000,    0,    0, false,  0, { BonusKind::ALL,    5, 3, 12000, 45000, 10000 }, AfterRound::BONUS_HOP },
+  { 60000, 40, 10, 4, 1000, SplitMode::RANDOM, true,  true,  10000, 14000, 6000, 7000, 3000, 3000, true,  50, { BonusKind::SINGLE, 1, 3, 10000, 35000,  8000 }, AfterRound::MINIGAME  },
+  // R5 is GREEN-only; its green window keeps the R4 feel
+  { 60000, 40, 10, 4, 1000, SplitMode::HOT,    false, false, 10000, 14000, 6000, 7000, 3000, 3000, false,  0, { BonusKind::NONE,   0, 0,     0,     0,     0 }, AfterRound::LOOP      },
+};
+
+// ---- Invariants (C++11 constexpr: one expression each) ----
+static constexpr bool windowOk(uint16_t mn, uint16_t mx) {
+  return (mn == 0 && mx == 0) || (mn > 0 && mn <= mx);
+}
+
+static constexpr bool bonusOk(const BonusPolicy& b) {
+  return (b.kind == BonusKind::NONE)
+    ? (b.maxSpawnsPerRound == 0)
+    : (b.maxConcurrent >= 1 && b.maxSpawnsPerRound >= 1 && b.durationMs > 0 &&
+       b.intervalMeanMs > b.intervalJitterMs);
+}
+
+static constexpr bool roundOk(const RoundDesc& d, bool last) {
+  return d.durationMs >= 1000 && d.goalDelta > 0 &&
+         d.maxCarry > 0 && d.lootPerTick > 0 && d.lootRateMs >= 100 &&
+         windowOk(d.greenMin, d.greenMax) && windowOk(d.redMin, d.redMax) &&
+         windowOk(d.yellowMin, d.yellowMax) &&
+         d.yellowBouncePct <= 100 &&
+         (d.yellowBouncePct == 0 || (d.red && d.yellow)) &&   // a bounce is a YELLOW that skips RED
+         (d.split != SplitMode::HOT || !d.red) &&             // the hop engine holds GREEN
+         bonusOk(d.bonus) &&
+         ((d.after == AfterRound::LOOP) == last);             // only the last round loops; it must
+}
+
+static constexpr bool tableOk(const RoundDesc* t, uint8_t n, uint8_t i = 0) {
+  return (i >= n) || (roundOk(t[i], i + 1 == n) && tableOk(t, n, i + 1));
+}
+
+static_assert(ROUND_COUNT >= 1, "need at least one round");
+static_assert(sizeof(kRounds) / sizeof(kRounds[0]) == ROUND_COUNT, "one descriptor per round");
+static_assert(tableOk(kRounds, ROUND_COUNT), "built-in round table breaks an invariant");
+
+// Active table: built-ins plus whatever roundTableLoad() accepted
+static RoundDesc sRounds[ROUND_COUNT] = { kRounds[0], kRounds[1], kRounds[2], kRounds[3], kRounds[4] };
+static_assert(ROUND_COUNT == 5, "update the sRounds initializer");
+static bool sOverridden[ROUND_COUNT] = {};
+
+const RoundDesc& roundDesc(uint8_t idx) {
+  if (idx < 1) idx = 1;
+  if (idx > ROUND_COUNT) idx = ROUND_COUNT;
+  return sRounds[idx - 1];
+}
+
+// ---- Override file ----
+enum FieldKind : uint8_t { F_U8, F_U16, F_U32, F_BOOL, F_SPLIT, F_BONUS, F_AFTER };
+
+struct Field {
+  const char* name;
+  FieldKind   kind;
+  size_t      off;
+};
+
+#define RF(n, k)  { #n, k, offsetof(RoundDesc, n) }
+static const Field kFields[] = {
+  RF(durationMs, F_U32),        RF(goalDelta, F_U16),
+  RF(maxCarry, F_U8),           RF(lootPerTick, F_U8),     RF(lootRateMs, F_U16),
+  RF(split, F_SPLIT),           RF(red, F_BOOL),           RF(yellow, F_BOOL),
+  RF(greenMin, F_U16),          RF(greenMax, F_U16),
+  RF(redMin, F_U16),            RF(redMax, F_U16),
+  RF(yellowMin, F_U16),         RF(yellowMax, F_U16),
+  RF(redFloorPirArm, F_BOOL),   RF(yellowBouncePct, F_U8),
+  RF(bonus.kind, F_BONUS),      RF(bonus.maxConcurrent, F_U8),
+  RF(bonus.maxSpawnsPerRound, F_U8),
+  RF(bonus.durationMs, F_U16),  RF(bonus.intervalMeanMs, F_U16),
+  RF(bonus.intervalJitterMs, F_U16),
+  RF(after, F_AFTER),
+};
+#undef RF
+
+static const char* const kSplitNames[] = { "even", "random", "hot" };
+static const char* const kBonusNames[] = { "none", "all", "single" };
+static const char* const kAfterNames[] = { "next", "bonusAll", "bonusHop", "minigame", "loop" };
+
+template <size_t N>
+static bool enumByName(const char* const (&names)[N], const char* v, uint8_t& out) {
+  for (uint8_t i = 0; i < N; ++i) if (!strcasecmp(names[i], v)) { out = i; return true; }
+  return false;
+}
+
+static bool setField(RoundDesc& d, const char* key, const char* val) {
+  for (const Field& f : kFields) {
+    if (strcmp(f.name, key)) continue;
+    uint8_t* p = (uint8_t*)&d + f.off;
+    char* end = nullptr;
+    const unsigned long n = strtoul(val, &end, 0);
+    const bool num = (end && end != val && *end == 0);
+    uint8_t e = 0;
+    switch (f.kind) {
+      case F_U8:    if (!num || n > 0xFF)   return false; *p = (uint8_t)n; return true;
+      case F_U16:   if (!num || n > 0xFFFF) return false; *(uint16_t*)p = (uint16_t)n; return true;
+      case F_U32:   if (!num) return false;               *(uint32_t*)p = (uint32_t)n; return true;
+      case F_BOOL:  if (!num || n > 1)      return false; *(bool*)p = (n != 0); return true;
+      case F_SPLIT: if (!enumByName(kSplitNames, val, e)) return false; *(SplitMode*)p  = (SplitMode)e;  return true;
+      case F_BONUS: if (!enumByName(kBonusNames, val, e)) return false; *(BonusKind*)p  = (BonusKind)e;  return true;
+      case F_AFTER: if (!enumByName(kAfterNames, val, e)) return false; *(AfterRound*)p = (AfterRound)e; return true;
+    }
+  }
+  return false;
+}
+
+// "<round> k=v k=v ..." -> sRounds[round-1] if the result is valid
+static void applyLine(char* line, uint16_t lineNo) {
+  if (char* hash = strchr(line, '#')) *hash = 0;
+  char* save = nullptr;
+  char* tok = strtok_r(line, " \t\r\n", &save);
+  if (!tok) return;   // blank / comment
+
+  const long idx = strtol(tok, nullptr, 10);
+  if (idx < 1 || idx > ROUND_COUNT) {
+    Serial.printf("[ROUNDS] line %u: bad round '%s'\n", (unsigned)lineNo, tok);
+    return;
+  }
+
+  RoundDesc d = sRounds[idx - 1];
+  uint8_t changed = 0;
+  while ((tok = strtok_r(nullptr, " \t\r\n", &save))) {
+    char* eq = strchr(tok, '=');
+    if (!eq) { Serial.printf("[ROUNDS] line %u: expected field=value, got '%s'\n", (unsigned)lineNo, tok); return; }
+    *eq = 0;
+    if (!setField(d, tok, eq + 1)) {
+      Serial.printf("[ROUNDS] line %u: bad field '%s=%s'\n", (unsigned)lineNo, tok, eq + 1);
+      return;
+    }
+    changed++;
+  }
+  if (!roundOk(d, idx == ROUND_COUNT)) {
+    Serial.printf("[ROUNDS] line %u: round %ld would break an invariant; ignored\n", (unsigned)lineNo, idx);
+    return;
+  }
+  sRounds[idx - 1] = d;
+  sOverridden[idx - 1] = true;
+  Serial.printf("[ROUNDS] R%ld: %u field(s) overridden\n", idx, (unsigned)changed);
+}
+
+void roundTableLoad() {
+  if (!LittleFS.begin()) return;   // no FS: built-ins only
+  if (!LittleFS.exists(ROUND_TABLE_PATH)) return;
+  File f = LittleFS.open(ROUND_TABLE_PATH, "r");
+  if (!f) return;
+
+  char line[160];
+  uint16_t lineNo = 0;
+  while (f.available()) {
+    const size_t n = f.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[n] = 0;
+    applyLine(line, ++lineNo);
+  }
+  f.close();
+}
+
+void roundTablePrint(Print& out) {
+  for (uint8_t i = 0; i < ROUND_COUNT; ++i) {
+    const RoundDesc& d = sRounds[i];
+    out.printf("R%u%s dur=%lu goal=+%u carry=%u tick=%u/%ums split=%s red=%u yellow=%u\n",
+               (unsigned)(i + 1), sOverridden[i] ? "*" : "",
+               (unsigned long)d.durationMs, (unsigned)d.goalDelta, (unsigned)d.maxCarry,
+               (unsigned)d.lootPerTick, (unsigned)d.lootRateMs, kSplitNames[(uint8_t)d.split],
+               (unsigned)d.red, (unsigned)d.yellow);
+    out.printf("   green=%u..%u red=%u..%u%s yellow=%u..%u bounce=%u%% bonus=%s x%u max%u %ums every %u+-%ums after=%s\n",
+               (unsigned)d.greenMin, (unsigned)d.greenMax, (unsigned)d.redMin, (unsigned)d.redMax,
+               d.redFloorPirArm ? "(>=pirArm)" : "", (unsigned)d.yellowMin, (unsigned)d.yellowMax,
+               (unsigned)d.yellowBouncePct, kBonusNames[(uint8_t)d.bonus.kind],
+               (unsigned)d.bonus.maxSpawnsPerRound, (unsigned)d.bonus.maxConcurrent,
+               (unsigned)d.bonus.durationMs, (unsigned)d.bonus.intervalMeanMs,
+               (unsigned)d.bonus.intervalJitterMs, kAfterNames[(uint8_t)d.after]);
+  }
+}
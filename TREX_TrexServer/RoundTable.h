@@ -0,0 +1,77 @@
+#pragma once
+// Round descriptors.
+//
+// Everything that tells Round 1..ROUND_COUNT apart lives in one table
+// (RoundTable.cpp): duration, goal, carry and loot rate, how inventory is
+// split, cadence windows, yellow fake-outs, bonus rules and what follows
+// the round. startRound() / the retry path apply a descriptor, and round
+// transitions walk `after`. The built-in table is checked with
+// static_assert; /rounds.cfg on LittleFS can override fields at boot
+// (see roundTableLoad).
+#include <Arduino.h>
+
+enum class SplitMode : uint8_t {
+  EVEN   = 0,   // round total spread evenly over the live stations
+  RANDOM = 1,   // random split, each station <= capacity
+  HOT    = 2,   // R5 hop engine: one station full at a time
+};
+
+enum class BonusKind : uint8_t {
+  NONE   = 0,
+  ALL    = 1,   // a spawn lights every eligible station
+  SINGLE = 2,   // a spawn lights one random eligible station
+};
+
+// What happens when the round's goal is met (or its timer runs out met)
+enum class AfterRound : uint8_t {
+  NEXT      = 0,   // straight into the next round
+  BONUS_ALL = 1,   // R2.5: every station bonus, auto-drains, then next round
+  BONUS_HOP = 2,   // R3.5: one bonus station hopping, then next round
+  MINIGAME  = 3,   // minigame, then next round
+  LOOP      = 4,   // roll another segment of this round until the game timer ends
+};
+
+struct BonusPolicy {
+  BonusKind kind;
+  uint8_t   maxConcurrent;
+  uint8_t   maxSpawnsPerRound;
+  uint16_t  durationMs;
+  uint16_t  intervalMeanMs;
+  uint16_t  intervalJitterMs;
+};
+
+struct RoundDesc {
+  uint32_t    durationMs;
+  uint16_t    goalDelta;        // roundGoal = score at round start + goalDelta
+  uint8_t     maxCarry;
+  uint8_t     lootPerTick;
+  uint16_t    lootRateMs;
+  SplitMode   split;
+  bool        red;              // RED phases this round
+  bool        yellow;           // YELLOW phases (without red: GREEN <-> YELLOW)
+  // Cadence windows (ms). 0/0 = the fixed greenMs / redMs / yellowMs tunable.
+  uint16_t    greenMin, greenMax;
+  uint16_t    redMin, redMax;
+  uint16_t    yellowMin, yellowMax;
+  bool        redFloorPirArm;   // raise the red window to pirArmDelayMs
+  uint8_t     yellowBouncePct;  // % of YELLOWs that fall back to GREEN
+  BonusPolicy bonus;
+  AfterRound  after;
+};
+
+constexpr uint8_t ROUND_COUNT = 5;
+
+#ifndef ROUND_TABLE_PATH
+#define ROUND_TABLE_PATH "/rounds.cfg"
+#endif
+
+// 1-based; out-of-range indices clamp to the first/last round
+const RoundDesc& roundDesc(uint8_t idx);
+
+// Boot: apply ROUND_TABLE_PATH over the built-in table. One round per line,
+//   <round> <field>=<value> [<field>=<value> ...]      # comment
+// with field names as in RoundDesc (bonus fields as bonus.<name>) and enum
+// values by name, e.g. "3 maxCarry=12 split=even bonus.kind=single".
+// A line that doesn't parse, or leaves its round invalid, is ignored.
+void roundTableLoad();
+void roundTablePrint(Print& out);   // maintenance `rounds`
@@ -4,6 +4,8 @@
 // Radio / identity
 constexpr uint8_t  DEFAULT_WIFI_CHANNEL = 6;
 constexpr uint8_t  STATION_ID   = 0;   // server is always 0
+// Loot stations in a room unless NVS says otherwise (serial STATIONS <n>)
+constexpr uint8_t  DEFAULT_STATION_COUNT = 5;
 
 // Board blue user LED on UM FeatherS3 (active-HIGH)
 constexpr int BOARD_BLUE_LED = 13;
@@ -21,3 +23,16 @@ constexpr uint32_t PIR_DEBOUNCE_MS = 60;
 constexpr uint32_t SPRITE_BAUD = 9600;
 constexpr int SPRITE_RX = 44;  // optional
 constexpr int SPRITE_TX = 43;  // to Sprite RX
+
+// Media task (Media.h). MEDIA_TASK=0 runs media commands inline in the
+// caller, as before the task existed (for A/B timing with `prof`).
+#ifndef MEDIA_TASK
+#define MEDIA_TASK 1
+#endif
+constexpr uint8_t  MEDIA_QUEUE_LEN   = 16;
+constexpr uint32_t MEDIA_TASK_STACK  = 3072;
+constexpr uint8_t  MEDIA_TASK_PRIO   = 2;
+
+// Light segments drawn ahead of the current one and sent as LIGHT_SCHEDULE
+// (Cadence.cpp); stations flip on their own until the plan runs out
+constexpr uint8_t  CADENCE_PLAN_LEN  = 4;
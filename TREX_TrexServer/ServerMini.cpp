@@ -2,7 +2,6 @@
 #include "GameModel.h"   // now include the full Game definition in the .cpp
 #include "Net.h"         // bcastMgStart/bcastMgStop, bcastScore
 #include <Arduino.h>
-#include <esp_random.h>
 
 // Award hook – swap to your real scorer if needed
 static void awardBonusPoint(Game& g, const TrexUid& uid) {
@@ -18,7 +17,7 @@ void MG_Init(Game& g) {
   g.mgAllTriedAt       = 0;
   g.mgTriedMask        = 0;
   g.mgSuccessMask      = 0;
-  g.mgExpectedStations = 5;  // adjust to your Loot count
+  g.mgExpectedStations = g.stationCount;
   g.mgCfg = Game::MgConfig{};
 }
 
@@ -26,7 +25,7 @@ void MG_Start(Game& g, const MgConfig& cfg, uint32_t nowMs) {
   if (g.mgActive) return;
 
   // Copy config into Game::mgCfg with safe defaults
-  g.mgCfg.seed       = cfg.seed       ? cfg.seed       : esp_random();
+  g.mgCfg.seed       = cfg.seed       ? cfg.seed       : rngNext(g.rng);
   g.mgCfg.timerMs    = cfg.timerMs    ? cfg.timerMs    : 60000;
   g.mgCfg.speedMinMs = cfg.speedMinMs ? cfg.speedMinMs : 20;
   g.mgCfg.speedMaxMs = cfg.speedMaxMs ? cfg.speedMaxMs : 80;
@@ -0,0 +1,358 @@
+#include "Snapshot.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include "Timers.h"
+#include "Net.h"
+#include "Media.h"
+#include "ModeClassic.h"
+
+static const uint32_t SNAP_MAGIC   = 0x314E5354;   // "TSN1"
+static const uint16_t SNAP_VERSION = 3;
+static const int32_t  REL_UNSET    = INT32_MIN;    // deadline field was 0
+static const uint8_t  SNAP_PLAYERS = 32;           // players carrying loot
+
+enum : uint8_t {
+  SF_NO_RED      = 1 << 0,
+  SF_ALLOW_YEL   = 1 << 1,
+  SF_BONUS_INTER = 1 << 2,
+  SF_BONUS_INT2  = 1 << 3,
+  SF_R5          = 1 << 4,
+  SF_MG          = 1 << 5,
+  SF_PIR_LOST    = 1 << 6,
+};
+
+#pragma pack(push, 1)
+struct SnapPlayer {
+  TrexUid  uid;
+  uint8_t  carried;
+  uint32_t banked;
+};
+
+struct SnapImage {
+  // header (covered by crc except `crc` itself)
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  uint32_t saveSeq;
+  uint32_t elapsedMs;          // now - gameStartAt when saved
+
+  // discrete state
+  uint8_t  phase, light, roundIndex, flags;
+  uint8_t  livesMax, livesRemaining, stationCount;
+  uint8_t  bonus2Sid, bonus2Idx, bonus2Order[MAX_STATIONS];
+  uint8_t  r5HotSid, r5Idx, r5Order[MAX_STATIONS];
+  uint8_t  bonusSpawnsThisRound;
+  uint16_t roundGoal;
+  uint16_t bonusInterMs, bonus2Ms, bonus2HopMs;
+  uint32_t teamScore, roundStartScore;
+  uint32_t bonusActiveMask;
+  uint16_t stationInventory[MAX_STATIONS + 1];
+  uint16_t stationCapacity[MAX_STATIONS + 1];
+
+  // deadlines, relative to gameStartAt (REL_UNSET = 0)
+  int32_t  gameEndAt, roundStartAt, roundEndAt;
+  int32_t  nextSwitch, lastFlipMs, redGraceUntil, pirArmAt, lifeLossLockoutUntil;
+  int32_t  bonusInterStart, bonusInterEnd;
+  int32_t  bonus2Start, bonus2End, bonus2NextHopAt;
+  int32_t  bonusNextSpawnAt, bonusEndsAt[MAX_STATIONS + 1];
+  int32_t  r5DwellEndAt, r5NextDepleteAt;
+
+  uint32_t rngState[4], rngSeedValue;
+  SnapPlayer players[SNAP_PLAYERS];
+
+  uint32_t crc;
+};
+#pragma pack(pop)
+
+static const size_t SNAP_WORDS = (sizeof(SnapImage) + 3) / 4;
+static_assert(sizeof(SnapImage) <= 0xFFFF, "size field is 16-bit");
+
+// Built in RAM, then copied word-wise (RTC slow memory wants 32-bit access)
+union SnapBuf {
+  SnapImage img;
+  uint32_t  w[SNAP_WORDS];
+};
+
+RTC_NOINIT_ATTR static uint32_t sRtc[2][SNAP_WORDS];
+
+static SnapBuf  sLast;               // last image written (for change detection)
+static bool     sHaveLast   = false;
+static uint32_t sSaveSeq    = 0;
+static uint32_t sLastSaveMs = 0;
+static uint32_t sSaves      = 0;
+static uint32_t sSaveUsMax  = 0;
+static bool     sResumed    = false;
+static uint32_t sResumeMs   = 0;     // boot -> resumed world re-broadcast
+static uint32_t sResumeSeq  = 0;
+
+static uint32_t crc32(const uint8_t* p, size_t n) {
+  static const uint32_t T[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C };
+  uint32_t c = 0xFFFFFFFFu;
+  while (n--) {
+    c ^= *p++;
+    c = (c >> 4) ^ T[c & 15];
+    c = (c >> 4) ^ T[c & 15];
+  }
+  return ~c;
+}
+
+static uint32_t imageCrc(const SnapImage& s) {
+  return crc32((const uint8_t*)&s, offsetof(SnapImage, crc));
+}
+
+static int32_t rel(const Game& g, uint32_t at) {
+  return at ? (int32_t)(at - g.gameStartAt) : REL_UNSET;
+}
+
+static uint32_t abs_(const Game& g, int32_t r) {
+  return (r == REL_UNSET) ? 0 : g.gameStartAt + (uint32_t)r;
+}
+
+static void build(const Game& g, uint32_t now, SnapImage& s) {
+  memset(&s, 0, sizeof(s));
+  s.magic   = SNAP_MAGIC;
+  s.version = SNAP_VERSION;
+  s.size    = sizeof(SnapImage);
+  s.elapsedMs = now - g.gameStartAt;
+
+  s.phase      = (uint8_t)g.phase;
+  s.light      = (uint8_t)g.light;
+  s.roundIndex = g.roundIndex;
+  s.flags = (g.noRedThisRound       ? SF_NO_RED      : 0)
+          | (g.allowYellowThisRound ? SF_ALLOW_YEL   : 0)
+          | (g.bonusIntermission    ? SF_BONUS_INTER : 0)
+          | (g.bonusIntermission2   ? SF_BONUS_INT2  : 0)
+          | (g.r5Active             ? SF_R5          : 0)
+          | (g.mgActive             ? SF_MG          : 0)
+          | (g.pirLifeLostThisRed   ? SF_PIR_LOST    : 0);
+  s.livesMax       = g.livesMax;
+  s.livesRemaining = g.livesRemaining;
+  s.stationCount   = g.stationCount;
+  s.bonus2Sid = g.bonus2Sid;
+  s.bonus2Idx = g.bonus2Idx;
+  memcpy(s.bonus2Order, g.bonus2Order, sizeof(s.bonus2Order));
+  s.r5HotSid = g.r5HotSid;
+  s.r5Idx    = g.r5Idx;
+  memcpy(s.r5Order, g.r5Order, sizeof(s.r5Order));
+  s.bonusSpawnsThisRound = g.bonusSpawnsThisRound;
+  s.roundGoal    = g.roundGoal;
+  s.bonusInterMs = g.bonusInterMs;
+  s.bonus2Ms     = g.bonus2Ms;
+  s.bonus2HopMs  = g.bonus2HopMs;
+  s.teamScore       = g.teamScore;
+  s.roundStartScore = g.roundStartScore;
+  s.bonusActiveMask = g.bonusActiveMask;
+  for (uint8_t sid = 0; sid <= MAX_STATIONS; ++sid) {
+    s.stationInventory[sid] = g.stationInventory[sid];
+    s.stationCapacity[sid]  = g.stationCapacity[sid];
+    s.bonusEndsAt[sid]      = rel(g, g.bonusEndsAt[sid]);
+  }
+
+  s.gameEndAt       = rel(g, g.gameEndAt);
+  s.roundStartAt    = rel(g, g.roundStartAt);
+  s.roundEndAt      = rel(g, g.roundEndAt);
+  s.nextSwitch      = rel(g, g.nextSwitch);
+  s.lastFlipMs      = rel(g, g.lastFlipMs);
+  s.redGraceUntil   = rel(g, g.redGraceUntil);
+  s.pirArmAt        = rel(g, g.pirArmAt);
+  s.lifeLossLockoutUntil = rel(g, g.lifeLossLockoutUntil);
+  s.bonusInterStart = rel(g, g.bonusInterStart);
+  s.bonusInterEnd   = rel(g, g.bonusInterEnd);
+  s.bonus2Start     = rel(g, g.bonus2Start);
+  s.bonus2End       = rel(g, g.bonus2End);
+  s.bonus2NextHopAt = rel(g, g.bonus2NextHopAt);
+  s.bonusNextSpawnAt= rel(g, g.bonusNextSpawnAt);
+  s.r5DwellEndAt    = rel(g, g.r5DwellEndAt);
+  s.r5NextDepleteAt = rel(g, g.r5NextDepleteAt);
+
+  memcpy(s.rngState, g.rng.s, sizeof(s.rngState));
+  s.rngSeedValue = g.rngSeedValue;
+
+  // Only records with loot in hand matter for a resume; the rest are
+  // recreated on their next tap
+  uint8_t n = 0;
+  for (uint16_t i = 0; i < MAX_PLAYERS && n < SNAP_PLAYERS; ++i) {
+    if (!g.players[i].used || !g.players[i].carried) continue;
+    s.players[n].uid     = g.players[i].uid;
+    s.players[n].carried = g.players[i].carried;
+    s.players[n].banked  = g.players[i].banked;
+    n++;
+  }
+}
+
+// Valid image with the highest saveSeq (copied out of RTC memory), or nullptr
+static const SnapImage* newestValid() {
+  static SnapBuf slot[2];
+  const SnapImage* best = nullptr;
+  for (uint8_t k = 0; k < 2; ++k) {
+    for (size_t i = 0; i < SNAP_WORDS; ++i) slot[k].w[i] = sRtc[k][i];
+    const SnapImage& s = slot[k].img;
+    if (s.magic != SNAP_MAGIC || s.version != SNAP_VERSION || s.size != sizeof(SnapImage)) continue;
+    if (s.crc != imageCrc(s)) continue;
+    if (!best || (int32_t)(s.saveSeq - best->saveSeq) > 0) best = &s;
+  }
+  return best;
+}
+
+static void invalidate() {
+  sRtc[0][0] = 0;
+  sRtc[1][0] = 0;
+  sHaveLast = false;
+}
+
+bool snapshotRestore(Game& g) {
+  const esp_reset_reason_t rr = esp_reset_reason();
+  if (rr == ESP_RST_POWERON) { invalidate(); return false; }   // RTC contents are noise
+
+  const SnapImage* sp = newestValid();
+  if (!sp || sp->phase != (uint8_t)Phase::PLAYING) { invalidate(); return false; }
+  const SnapImage& s = *sp;
+
+  // The image's station count wins over NVS: its inventories and orders are
+  // laid out for it
+  setStationCount(g, s.stationCount);
+  resetGameState(g);   // fresh tables/timers; everything below overlays it
+
+  // Rebase: the game clock resumes where the image left it (downtime is not
+  // counted against the players).
+  const uint32_t now = millis();
+  g.gameStartAt = now - s.elapsedMs;
+
+  g.phase      = Phase::PLAYING;
+  g.light      = (LightState)s.light;
+  g.roundIndex = s.roundIndex;
+  applyRoundRules(g, roundDesc(g.roundIndex));   // carry, loot rate, cadence windows
+  g.noRedThisRound       = (s.flags & SF_NO_RED)      != 0;
+  g.allowYellowThisRound = (s.flags & SF_ALLOW_YEL)   != 0;
+  g.bonusIntermission    = (s.flags & SF_BONUS_INTER) != 0;
+  g.bonusIntermission2   = (s.flags & SF_BONUS_INT2)  != 0;
+  g.r5Active             = (s.flags & SF_R5)          != 0;
+  g.pirLifeLostThisRed   = (s.flags & SF_PIR_LOST)    != 0;
+  g.livesMax       = s.livesMax;
+  g.livesRemaining = s.livesRemaining;
+  g.bonus2Sid = s.bonus2Sid;
+  g.bonus2Idx = s.bonus2Idx;
+  memcpy(g.bonus2Order, s.bonus2Order, sizeof(g.bonus2Order));
+  g.r5HotSid = s.r5HotSid;
+  g.r5Idx    = s.r5Idx;
+  memcpy(g.r5Order, s.r5Order, sizeof(g.r5Order));
+  g.bonusSpawnsThisRound = s.bonusSpawnsThisRound;
+  g.roundGoal    = s.roundGoal;
+  g.bonusInterMs = s.bonusInterMs;
+  g.bonus2Ms     = s.bonus2Ms;
+  g.bonus2HopMs  = s.bonus2HopMs;
+  g.teamScore       = s.teamScore;
+  g.roundStartScore = s.roundStartScore;
+  g.bonusActiveMask = s.bonusActiveMask;
+  for (uint8_t sid = 0; sid <= MAX_STATIONS; ++sid) {
+    g.stationInventory[sid] = s.stationInventory[sid];
+    g.stationCapacity[sid]  = s.stationCapacity[sid];
+    g.bonusEndsAt[sid]      = abs_(g, s.bonusEndsAt[sid]);
+  }
+
+  g.gameEndAt       = abs_(g, s.gameEndAt);
+  g.roundStartAt    = abs_(g, s.roundStartAt);
+  g.roundEndAt      = abs_(g, s.roundEndAt);
+  g.nextSwitch      = abs_(g, s.nextSwitch);
+  g.lastFlipMs      = abs_(g, s.lastFlipMs);
+  g.redGraceUntil   = abs_(g, s.redGraceUntil);
+  g.pirArmAt        = abs_(g, s.pirArmAt);
+  g.lifeLossLockoutUntil = abs_(g, s.lifeLossLockoutUntil);
+  g.bonusInterStart = abs_(g, s.bonusInterStart);
+  g.bonusInterEnd   = abs_(g, s.bonusInterEnd);
+  g.bonus2Start     = abs_(g, s.bonus2Start);
+  g.bonus2End       = abs_(g, s.bonus2End);
+  g.bonus2NextHopAt = abs_(g, s.bonus2NextHopAt);
+  g.bonusNextSpawnAt= abs_(g, s.bonusNextSpawnAt);
+  g.r5DwellEndAt    = abs_(g, s.r5DwellEndAt);
+  g.r5NextDepleteAt = abs_(g, s.r5NextDepleteAt);
+
+  memcpy(g.rng.s, s.rngState, sizeof(g.rng.s));
+  g.rngSeedValue = s.rngSeedValue;
+
+  for (uint8_t i = 0; i < SNAP_PLAYERS; ++i) {
+    if (!s.players[i].uid.len) continue;
+    const int pi = playersInsert(g.players, s.players[i].uid, now);
+    if (pi < 0) break;
+    g.players[pi].carried = s.players[i].carried;
+    g.players[pi].banked  = s.players[i].banked;
+  }
+
+  // Deadlines back onto the scheduler (holds are not restored: the Loots'
+  // in-flight holds died with the old holdIds; players simply re-tap)
+  if (g.nextSwitch)       timerArm(TMR_CADENCE, g.nextSwitch);
+  if (g.bonusNextSpawnAt) timerArm(TMR_BONUS_SPAWN, g.bonusNextSpawnAt);
+  if (g.r5Active) {
+    timerArm(TMR_R5_DWELL,   g.r5DwellEndAt);
+    timerArm(TMR_R5_DEPLETE, g.r5NextDepleteAt);
+  }
+
+  spritePlay(g.light == LightState::RED ? CLIP_LOOKING : CLIP_NOT_LOOKING);
+
+  // Re-broadcast now rather than waiting for the periodic frames
+  markAllStationsDirty(g);
+  bcastWorldFrame(g);
+  bcastScore(g);
+  bcastBonusUpdate(g);
+  bcastRoundStatus(g);
+
+  // The minigame's per-station attempts can't be resumed; continue at R5
+  // exactly like the operator "next" during MG does.
+  if (s.flags & SF_MG) {
+    g.mgActive = true;
+    modeClassicNextRound(g, /*playWin=*/false);
+  }
+
+  sSaveSeq   = s.saveSeq;
+  sResumed   = true;
+  sResumeSeq = s.saveSeq;
+  sResumeMs  = (uint32_t)(esp_timer_get_time() / 1000);
+  Serial.printf("[SNAP] Resumed after reset reason=%d: round=%u score=%lu lives=%u t=+%lus in %lums since boot\n",
+                (int)rr, g.roundIndex, (unsigned long)g.teamScore, g.livesRemaining,
+                (unsigned long)(s.elapsedMs / 1000), (unsigned long)sResumeMs);
+  return true;
+}
+
+void snapshotPump(Game& g, uint32_t now) {
+  if (g.phase != Phase::PLAYING) {
+    if (sHaveLast) invalidate();
+    return;
+  }
+
+  const uint32_t since = now - sLastSaveMs;
+  if (sHaveLast && since < SNAP_MIN_MS) return;
+
+  const uint32_t t0 = micros();
+  static SnapBuf cur;
+  build(g, now, cur.img);
+
+  // Change detection ignores the header (elapsedMs moves every pass)
+  const size_t bodyOfs = offsetof(SnapImage, phase);
+  const bool changed = !sHaveLast ||
+      memcmp((const uint8_t*)&cur.img + bodyOfs, (const uint8_t*)&sLast.img + bodyOfs,
+             offsetof(SnapImage, crc) - bodyOfs) != 0;
+  if (!changed && since < SNAP_REFRESH_MS) return;
+
+  cur.img.saveSeq = ++sSaveSeq;
+  cur.img.crc     = imageCrc(cur.img);
+  uint32_t* dst = sRtc[sSaveSeq & 1];
+  for (size_t i = 0; i < SNAP_WORDS; ++i) dst[i] = cur.w[i];
+
+  sLast       = cur;
+  sHaveLast   = true;
+  sLastSaveMs = now;
+  sSaves++;
+  const uint32_t us = micros() - t0;
+  if (us > sSaveUsMax) sSaveUsMax = us;
+}
+
+void snapshotPrintStats(Print& out) {
+  out.printf("snapshot size=%uB saves=%lu seq=%lu saveMax=%luus",
+             (unsigned)sizeof(SnapImage), (unsigned long)sSaves,
+             (unsigned long)sSaveSeq, (unsigned long)sSaveUsMax);
+  if (sResumed) out.printf(" resumed(seq=%lu in %lums)", (unsigned long)sResumeSeq, (unsigned long)sResumeMs);
+  out.print('\n');
+}
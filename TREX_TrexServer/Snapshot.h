@@ -0,0 +1,35 @@
+#pragma once
+// Warm-reset resume.
+//
+// While a game runs, the essentials of `Game` (phase, round, score, lives,
+// station inventory, bonus / intermission / R5 state, players' carried loot,
+// RNG state) are checkpointed into RTC slow memory, which survives WDT,
+// panic and software resets (not power-on). Deadlines are stored relative to
+// gameStartAt so they rebase onto the new millis() after the reset.
+//
+// Two alternating slots, each with magic/version/size and a CRC32, so a
+// reset in the middle of a write still leaves the previous image intact.
+// Checkpoints are taken only when the image changed (at most every
+// SNAP_MIN_MS), plus a SNAP_REFRESH_MS refresh so the clock doesn't rewind
+// far. Both slots are invalidated once the game ends.
+#include <Arduino.h>
+#include "GameModel.h"
+
+#ifndef SNAP_MIN_MS
+#define SNAP_MIN_MS      100
+#endif
+#ifndef SNAP_REFRESH_MS
+#define SNAP_REFRESH_MS  1000
+#endif
+
+// setup(): if the last reset was warm and a valid image exists, rebuild `g`
+// from it (resetGameState + the round's rules + overlay), re-arm timers and
+// re-broadcast the world. The resumed game is not journalled: a journal
+// replays from GAME_START, and this one starts mid-game.
+// Returns false (g untouched) when there's nothing to resume.
+bool snapshotRestore(Game& g);
+
+// loop(): checkpoint if the image changed.
+void snapshotPump(Game& g, uint32_t now);
+
+void snapshotPrintStats(Print& out);
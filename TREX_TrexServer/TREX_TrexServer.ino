@@ -20,6 +20,12 @@
 #include "OtaCampaign.h"
 #include "GameAudio.h"
 #include "Bonus.h"
+#include "EventLog.h"
+#include "Timers.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "RoundTable.h"
+#include "Profiler.h"
 
 // --- OTA defaults (edit these per release) ---
 #define DEFAULT_OTA_URL          "http://172.20.10.3:8000/TrexHeist/TREX_Loot/build/esp32.esp32.um_feathers3/TREX_Loot.ino.bin"
@@ -33,6 +39,8 @@ Game g;
 //   chan = Wi-Fi channel (1..13)
 //   txf  = TX framed (0/1)   (wire header / magic)
 //   rxl  = RX accept legacy (0/1)
+//   stations = Loot stations in play (1..MAX_STATIONS), see loadStationConfig
+//   lagSpr / lagAud / lagLed = media output lag (ms), see Media.h
 static uint8_t WIFI_CHANNEL     = DEFAULT_WIFI_CHANNEL;
 static bool    TX_FRAMED        = false;  // false = legacy packets (no wire header)
 static bool    RX_ACCEPT_LEGACY = true;   // true = accept packets without wire header
@@ -65,6 +73,26 @@ static void saveRadioConfig(uint8_t ch, bool txFramed, bool rxLegacy) {
   p.end();
 }
 
+// Station count: Loots 1..n take part; ids above n are refused (hold start,
+// minigame result) and left out of inventory frames, bonus and shuffle bags.
+static void loadStationConfig() {
+  Preferences p;
+  p.begin("trex", true);
+  const uint8_t n = p.getUChar("stations", DEFAULT_STATION_COUNT);
+  p.end();
+
+  setStationCount(g, n);
+  OtaCampaign::setStationCount(g.stationCount);
+  Serial.printf("[TREX] Stations: %u (max %u)\n", (unsigned)g.stationCount, (unsigned)MAX_STATIONS);
+}
+
+static void saveStationConfig(uint8_t n) {
+  Preferences p;
+  p.begin("trex", false);
+  p.putUChar("stations", n);
+  p.end();
+}
+
 // Broadcast + persist + reboot into new settings.
 // Request format supports "no change":
 //   wifiChannel: 0 => keep current
@@ -107,11 +135,13 @@ void triggerLootOta(Game& g) {
   bcastGameOver(g, /*MANUAL*/2, GAMEOVER_BLAME_ALL);
   Serial.println("[OTA] GAME_OVER sent; broadcasting in 3s…");
 
-  // Simple grace period; keeps loops active while waiting
+  // Simple grace period; keeps loops active while waiting (netTxPump sends
+  // the GAME_OVER repeats, which loop() isn't here to do)
   uint32_t t0 = millis();
   while (millis() - t0 < 3000) {
     OtaCampaign::loop();
     Transport::loop();
+    netTxPump(millis());
     delay(10);
   }
 
@@ -136,6 +166,7 @@ void setup() {
   loadRadioConfig();
 
   OtaCampaign::begin();
+  loadStationConfig();
 
   // PIR pins, media, etc. (unchanged)
   for (int i = 0; i < 4; i++) {
@@ -157,10 +188,17 @@ void setup() {
     while (1) delay(1000);
   }
   Serial.printf("Trex header ver: %d\n", TREX_PROTO_VERSION);
+  netSetUnicastEnabled(!TX_FRAMED);   // raw esp_now_send has no wire header
+
+  journalBegin();
+  roundTableLoad();     // /rounds.cfg overrides (LittleFS is mounted by journalBegin)
 
-  // Game + Mode
-  resetGame(g);
-  modeClassicInit(g);   // Warmup enabled here
+  // Game + Mode: pick up a game interrupted by a WDT/panic/brownout reset,
+  // otherwise start fresh
+  if (!snapshotRestore(g)) {
+    resetGame(g);
+    modeClassicInit(g);   // Warmup enabled here
+  }
   // Broadcast initial lives to Control/UI
   bcastLivesUpdate(g, /*reason=*/0, GAMEOVER_BLAME_ALL);
 
@@ -189,6 +227,8 @@ void loop() {
   }
   if (justEntered || Maint::active) {
     if (!maintLEDOn) { digitalWrite(BOARD_BLUE_LED, HIGH); maintLEDOn = true; }
+    netLoopPaused();
+    netDrainRx();   // keep the RX ring moving while paused
     Maint::loop();
     return;
   } else if (maintLEDOn) {
@@ -196,7 +236,10 @@ void loop() {
     maintLEDOn = false;
   }
 
+  PROF_SCOPE(PS_LOOP);
+
   // --- Network control commands (from CONTROL station) ---
+  PROF_BEGIN(PS_CONTROL);
   if (netConsumeControlStartRequest()) {
     startNewGame(g);
     bcastLivesUpdate(g, /*reason=*/0, GAMEOVER_BLAME_ALL);
@@ -214,7 +257,7 @@ void loop() {
       case ServerCmdOp::START_TEST_ROUND: {
         uint8_t round = serverCmd.arg8;
         if (round < 1) round = 1;
-        if (round > 5) round = 5;
+        if (round > ROUND_COUNT) round = ROUND_COUNT;
 
         startNewGame(g);
         bcastLivesUpdate(g, /*reason=*/0, GAMEOVER_BLAME_ALL);
@@ -228,7 +271,7 @@ void loop() {
       case ServerCmdOp::SET_PIR_ARM_MS: {
         g.pirArmDelayMs = (uint32_t)serverCmd.value16;
         if (g.phase == Phase::PLAYING && g.light == LightState::RED) {
-          g.pirArmAt = g.lastFlipMs + g.pirArmDelayMs;
+          cadenceRearmPir(g);
         }
         Serial.printf("[TEST] pirArmDelayMs=%u\n", (unsigned)g.pirArmDelayMs);
         break;
@@ -253,11 +296,26 @@ void loop() {
     applyRadioCfgAndReboot(rcReq, "CONTROL");
     return;
   }
+  PROF_END(PS_CONTROL);
 
+  PROF_BEGIN(PS_NET);
   OtaCampaign::loop();
   Transport::loop();
+  netNoteLoopPass(micros());
+
+  // Handle everything the radio queued since the last pass before gameplay runs.
+  netDrainRx();
 
   uint32_t now = millis();
+  netTxPump(now);
+  PROF_END(PS_NET);
+
+  PROF_BEGIN(PS_PUMPS);
+  mediaPump(now);
+  evlogPump(Serial);
+  journalPump(now);
+  snapshotPump(g, now);
+  PROF_END(PS_PUMPS);
 
   // ---- Serial commands (line-based; keeps 1-char shortcuts) ----
   // Examples:
@@ -270,7 +328,12 @@ void loop() {
   //   WIRE STRICT  (txFramed=1 rxLegacy=0)
   //   TEST R2      (new game, jump straight to Round 2)
   //   PIRARM 600   (set camera arm delay, ms)
+  //   SEED 12345   (seed the next game's PRNG, for replaying a logged game)
   //   REDLOOT DROP | REDLOOT STRICT
+  //   STATS        (TX frames per stage, RX/TX queues + per-type counters, max loop gap, station clocks, convergence, timer lateness, media queue)
+  //   RXLOG ON|OFF (per-packet RX logging)
+  //   EVLOG        (dump the event ring) | EVLOG OFF|TEXT|BIN (background drain mode)
+  //   PROF         (loop-section timings) | PROF RESET
 
   auto handleChar = [&](char c) -> bool {
     if (c=='m' || c=='M') { Maint::begin(mcfg); digitalWrite(BOARD_BLUE_LED, HIGH); return true; }
@@ -303,6 +366,7 @@ void loop() {
   static char   lineBuf[96];
   static size_t lineLen = 0;
 
+  PROF_BEGIN(PS_SERIAL);
   while (Serial.available()) {
     char c = (char)Serial.read();
     if (c == '\r') continue;
@@ -314,6 +378,7 @@ void loop() {
       lineLen = 0;
 
       if (line.length() == 0) continue;
+      journalCmd('S', line);
 
       // 1-char shortcuts are still supported
       if (line.length() == 1) {
@@ -369,6 +434,67 @@ void loop() {
         continue;
       }
 
+      if (u.startsWith("STATIONS")) {
+        String val = u.substring(8);
+        val.trim();
+        const long n = val.toInt();
+        if (val.length() == 0) {
+          Serial.printf("[TREX] stations=%u (max %u)\n", (unsigned)g.stationCount, (unsigned)MAX_STATIONS);
+        } else if (n >= 1 && n <= MAX_STATIONS) {
+          saveStationConfig((uint8_t)n);
+          setStationCount(g, (uint8_t)n);
+          OtaCampaign::setStationCount(g.stationCount);
+          startNewGame(g);   // inventories, bags and masks are laid out per count
+          bcastLivesUpdate(g, /*reason=*/0, GAMEOVER_BLAME_ALL);
+          Serial.printf("[TREX] stations=%u saved; new game started\n", (unsigned)g.stationCount);
+        } else {
+          Serial.printf("[TREX] Usage: STATIONS <1..%u>\n", (unsigned)MAX_STATIONS);
+        }
+        continue;
+      }
+
+      if (u == "STATS") {
+        netPrintStats(Serial);
+        netPrintClockSync(Serial);
+        netPrintConvergence(Serial);
+        playersPrintStats(Serial, g.players);
+        timersPrintStats(Serial);
+        snapshotPrintStats(Serial);
+        mediaPrintStats(Serial);
+        continue;
+      }
+
+      if (u == "EVLOG") {
+        evlogDump(Serial);
+        continue;
+      }
+
+      if (u == "PROF") {
+        profPrint(Serial);
+        continue;
+      }
+      if (u == "PROF RESET") {
+        profReset();
+        Serial.println("[PROF] reset");
+        continue;
+      }
+      if (u.startsWith("EVLOG ")) {
+        String mode = u.substring(6);
+        mode.trim();
+        if      (mode == "OFF")  evlogSetDrain(EvDrain::OFF);
+        else if (mode == "TEXT") evlogSetDrain(EvDrain::TEXT);
+        else if (mode == "BIN")  evlogSetDrain(EvDrain::BIN);
+        else { Serial.println("[EVLOG] Usage: EVLOG [OFF|TEXT|BIN]"); continue; }
+        Serial.printf("[EVLOG] drain=%s\n", mode.c_str());
+        continue;
+      }
+
+      if (u == "RXLOG ON" || u == "RXLOG OFF") {
+        netSetRxVerbose(u == "RXLOG ON");
+        Serial.printf("[NET] rxlog=%s\n", netRxVerbose() ? "on" : "off");
+        continue;
+      }
+
       if (u == "RADIO" || u == "RADIO?") {
         Serial.printf("[RADIO] Current: chan=%u txFramed=%u rxLegacy=%u\n",
                       (unsigned)WIFI_CHANNEL,
@@ -383,7 +509,7 @@ void loop() {
         if (spec.startsWith("R")) spec = spec.substring(1);
 
         int round = spec.toInt();
-        if (round >= 1 && round <= 5) {
+        if (round >= 1 && round <= ROUND_COUNT) {
           startNewGame(g);
           bcastLivesUpdate(g, /*reason=*/0, GAMEOVER_BLAME_ALL);
           if (round != 1) {
@@ -391,7 +517,20 @@ void loop() {
           }
           Serial.printf("[TEST] Started new game at round %d\n", round);
         } else {
-          Serial.println("[TEST] Usage: TEST R<1..5>");
+          Serial.printf("[TEST] Usage: TEST R<1..%u>\n", (unsigned)ROUND_COUNT);
+        }
+        continue;
+      }
+
+      if (u.startsWith("SEED ")) {
+        String val = u.substring(5);
+        val.trim();
+        const uint32_t seed = (uint32_t)strtoul(val.c_str(), nullptr, 0);
+        if (seed) {
+          setNextGameSeed(seed);
+          Serial.printf("[TEST] next game seed=%lu\n", (unsigned long)seed);
+        } else {
+          Serial.println("[TEST] Usage: SEED <nonzero, dec or 0x hex>");
         }
         continue;
       }
@@ -403,7 +542,7 @@ void loop() {
         if (ms >= 0 && ms <= 65535L) {
           g.pirArmDelayMs = (uint32_t)ms;
           if (g.phase == Phase::PLAYING && g.light == LightState::RED) {
-            g.pirArmAt = g.lastFlipMs + g.pirArmDelayMs;
+            cadenceRearmPir(g);
           }
           Serial.printf("[TEST] pirArmDelayMs=%u\n", (unsigned)g.pirArmDelayMs);
         } else {
@@ -428,17 +567,25 @@ void loop() {
         continue;
       }
 
-      Serial.println("[SERIAL] Unknown cmd. Try: CHAN <1..13> | WIRE LEGACY/FRAMED/STRICT | RADIO | TEST R<1..5> | PIRARM <ms> | REDLOOT DROP/STRICT");
+      Serial.printf("[SERIAL] Unknown cmd. Try: CHAN <1..13> | WIRE LEGACY/FRAMED/STRICT | RADIO | TEST R<1..%u> | PIRARM <ms> | SEED <n> | REDLOOT DROP/STRICT | STATIONS <n> | PROF [RESET]\n",
+                    (unsigned)ROUND_COUNT);
       continue;
     }
 
     if ((c == 8 || c == 127) && lineLen > 0) { lineLen--; continue; }
     if (lineLen < sizeof(lineBuf)-1) lineBuf[lineLen++] = c;
   }
+  PROF_END(PS_SERIAL);
+
+  now = millis();
+  {
+    PROF_SCOPE(PS_TIMERS);
+    timersRun(now);   // everything below acts only on deadlines that fired
+    tickLightCues(g);
+  }
 
   // A fresh/new loot attempt during RED after the grace window can cost one life.
   // (Active holds that survive past grace are handled later in the RED hold section.)
-  now = millis();
   uint8_t redLootAttemptSid = 0;
   if (netConsumeRedLootAttempt(redLootAttemptSid) &&
       g.phase == Phase::PLAYING &&
@@ -457,88 +604,42 @@ void loop() {
     }
   }
 
-  // Drip broadcast on new game / round / bonus transitions.
-  // Re-send station inventory in a few full passes so Loot clients recover if
-  // one ESP-NOW broadcast gets dropped during a busy scene change.
+  // Drip broadcast on new game / round transitions: GAME_START, then score.
   static uint32_t lastSend = 0;
+  PROF_BEGIN(PS_DRIP);
   if (now - lastSend >= 50) { // ~20 msgs/sec
     if (g.pending.needGameStart) {
       bcastGameStart(g);
       g.pending.needGameStart = false;
       lastSend = now;
-    } else if (g.pending.stationPasses && g.pending.nextStation >= 1 && g.pending.nextStation <= 5) {
-      const uint8_t sid = g.pending.nextStation;
-      bcastStation(g, sid);
-      ++g.pending.nextStation;
-      if (g.pending.nextStation > 5) {
-        g.pending.nextStation = 1;
-        if (g.pending.stationPasses > 0) {
-          --g.pending.stationPasses;
-        }
-        if (g.pending.stationPasses == 0) {
-          g.pending.nextStation = 0;
-        }
-      }
-      lastSend = now;
     } else if (g.pending.needScore) {
       bcastScore(g);
       g.pending.needScore = false;
       lastSend = now;
     }
   }
+  PROF_END(PS_DRIP);
+
+  // Station inventories: dirty stations flushed as one frame, plus a periodic
+  // full refresh (replaces the old per-station sync passes); then resync any
+  // station whose heartbeat says it missed something.
+  {
+    PROF_SCOPE(PS_STN_SYNC);
+    netStationSync(g, now);
+    netConvergeTick(g, now);
+  }
 
-  // --- ROUND_STATUS redundancy (helps DROP gauges reset reliably on round transitions) ---
-  static uint8_t  lastRoundIdxForBcast      = 0;
-  static uint32_t lastRoundStatusSentMs     = 0;
-  static uint32_t roundStatusBurstUntilMs   = 0;
-  static uint32_t lastBonusMaskForSync      = 0xFFFFFFFFUL;
-  static uint32_t lastBonusSyncSentMs       = 0;
-  static uint32_t bonusSyncBurstUntilMs     = 0;
-
-  // STATE_TICK @ tickHz (only while PLAYING; use current phase timer)
-  const uint32_t tickMs = max<uint32_t>(10, 1000 / g.tickHz);
-  if (now - g.lastTickSentMs >= tickMs) {
+  // WORLD_FRAME @ tickHz (only while PLAYING). One coalesced frame carries the
+  // light, stage/game timers, round goal, score, lives and bonus mask. Missed
+  // events are repaired per station by heartbeat + STATION_RESYNC, so this is
+  // a slow backstop (light flips send their own frame right away).
+  if (timerTake(TMR_WORLD_FRAME)) {
+    PROF_SCOPE(PS_WORLD);
     if (g.phase == Phase::PLAYING) {
-      uint32_t msLeft = 0;
-      if      (g.mgActive)           msLeft = (g.mgDeadline    > now)?(g.mgDeadline    - now):0;
-      else if (g.bonusIntermission)  msLeft = (g.bonusInterEnd  > now)?(g.bonusInterEnd  - now):0;
-      else if (g.bonusIntermission2) msLeft = (g.bonus2End      > now)?(g.bonus2End      - now):0;
-      else                           msLeft = (g.roundEndAt     > now)?(g.roundEndAt     - now):0;
-      sendStateTick(g, msLeft); 
-      bcastGameStatus(g);
-
-      // Keep ROUND_STATUS reliable (ESP-NOW broadcasts can drop).
-      // Burst at tickHz for ~1.5s after a round change, then keep-alive once per second.
-      if (g.roundIndex != lastRoundIdxForBcast) {
-        lastRoundIdxForBcast    = g.roundIndex;
-        roundStatusBurstUntilMs = now + 1500;
-        lastRoundStatusSentMs   = 0; // force an immediate send
-      }
-
-      const uint32_t roundStatusIntervalMs = (now < roundStatusBurstUntilMs) ? tickMs : 1000;
-      if (now - lastRoundStatusSentMs >= roundStatusIntervalMs) {
-        bcastRoundStatus(g);
-        lastRoundStatusSentMs = now;
-      }
+      bcastWorldFrame(g);
     }
     g.lastTickSentMs = now;
-  }
-
-  // Keep BONUS_UPDATE reliable too, especially at bonus start/hop transitions.
-  if (g.phase == Phase::PLAYING) {
-    if (g.bonusActiveMask != lastBonusMaskForSync) {
-      lastBonusMaskForSync  = g.bonusActiveMask;
-      bonusSyncBurstUntilMs = now + 1500;
-      lastBonusSyncSentMs   = 0;
-    }
-
-    if (g.bonusActiveMask != 0) {
-      const uint32_t bonusSyncIntervalMs = (now < bonusSyncBurstUntilMs) ? 500 : 1500;
-      if (now - lastBonusSyncSentMs >= bonusSyncIntervalMs) {
-        bcastBonusUpdate(g);
-        lastBonusSyncSentMs = now;
-      }
-    }
+    timerArm(TMR_WORLD_FRAME, now + worldFramePeriodMs(g));
   }
 
   // Overall success timer: if the team makes it to 6:00, end successfully.
@@ -551,7 +652,7 @@ void loop() {
       !g.mgActive &&
       !g.bonusIntermission &&
       !g.bonusIntermission2 &&
-      (g.roundIndex == 4) &&
+      (roundDesc(g.roundIndex).after == AfterRound::MINIGAME) &&
       (g.teamScore >= g.roundGoal);
 
   if (g.phase == Phase::PLAYING &&
@@ -565,6 +666,7 @@ void loop() {
 
   // === Minigame tick ===
   if (g.mgActive) {
+    PROF_SCOPE(PS_MINIGAME);
     const uint32_t now = millis();
 
     // Stop by timer
@@ -572,7 +674,7 @@ void loop() {
       g.mgActive = false;
       bcastMgStop(g);
       // Resume normal flow: proceed to Round 5
-      modeClassicForceRound(g, 5, /*playWin=*/false);
+      modeClassicForceRound(g, g.roundIndex + 1, /*playWin=*/false);
       return;
     }
 
@@ -580,7 +682,7 @@ void loop() {
     if (g.mgAllTriedAt && (now - g.mgAllTriedAt >= 3000)) {
       g.mgActive = false;
       bcastMgStop(g);
-      modeClassicForceRound(g, 5, /*playWin=*/false);
+      modeClassicForceRound(g, g.roundIndex + 1, /*playWin=*/false);
       return;
     }
     
@@ -592,42 +694,46 @@ void loop() {
   // Accrual while GREEN and YELLOW (tick every lootRateMs; grant lootPerTick each tick)
   if (g.phase == Phase::PLAYING &&
     (g.light == LightState::GREEN || g.light == LightState::YELLOW)) {
-    for (int i = 0; i < MAX_HOLDS; ++i) if (g.holds[i].active) {
+    PROF_SCOPE(PS_ACCRUAL);
+    netNoteAccrualPass(g.holds.count, now);
+
+    uint8_t tid;
+    while (timerTakeFirst(TMR_HOLD_0, TMR_COUNT, tid)) {
+      const uint8_t i = tid - TMR_HOLD_0;
       auto &h  = g.holds[i];
+      if (!h.active) continue;              // ended since it was armed
       uint8_t sid = h.stationId;
-      if (sid < 1 || sid > 5) { h.active = false; continue; }   // safety
+      if (!isLiveStation(g, sid)) { releaseHold(g, i); continue; }   // safety
 
       auto &pl = g.players[h.playerIdx];
 
-      if ((int32_t)(now - h.nextTickAt) >= 0) {
-        const uint32_t period  = (g.lootRateMs ? g.lootRateMs : 1000U);
-        uint8_t  room  = (pl.carried >= g.maxCarry) ? 0 : (uint8_t)(g.maxCarry - pl.carried);
-        uint16_t avail = g.stationInventory[sid];
-
-        // Grant N items this tick, but never exceed carry cap or inventory
-        uint16_t grant = g.lootPerTick;
-        if (grant > room)  grant = room;
-        if (grant > avail) grant = avail;
-
-        if (grant == 0) {
-          // No room or no inventory → close the hold with a clear reason
-          h.active = false;
-          sendHoldEnd(g, h.holdId, (avail == 0) ? /*EMPTY*/1 : /*FULL*/0);
-          h.nextTickAt += period;   // keep schedule monotonic
-          continue;
-        }
-
-        pl.carried              = (uint8_t)(pl.carried + grant);
-        g.stationInventory[sid] = (uint16_t)(g.stationInventory[sid] - grant);
+      const uint32_t period  = (g.lootRateMs ? g.lootRateMs : 1000U);
+      uint8_t  room  = (pl.carried >= g.maxCarry) ? 0 : (uint8_t)(g.maxCarry - pl.carried);
+      uint16_t avail = g.stationInventory[sid];
 
-        // Notify player + everyone else (now at tick period cadence)
-        sendLootTick(g, h.holdId, pl.carried, g.stationInventory[sid]);
-        bcastStation(g, sid);
+      // Grant N items this tick, but never exceed carry cap or inventory
+      uint16_t grant = g.lootPerTick;
+      if (grant > room)  grant = room;
+      if (grant > avail) grant = avail;
 
-        h.nextTickAt += period;
-        // If you want catch-up on long stalls, change the 'if' to a 'while' loop.
+      if (grant == 0) {
+        // No room or no inventory → close the hold with a clear reason
+        const uint32_t holdId = h.holdId;
+        releaseHold(g, i);
+        sendHoldEnd(g, sid, holdId, (avail == 0) ? /*EMPTY*/1 : /*FULL*/0);
+        continue;
       }
+
+      pl.carried              = (uint8_t)(pl.carried + grant);
+      g.stationInventory[sid] = (uint16_t)(g.stationInventory[sid] - grant);
+
+      // Player + everyone else hear about it in this pass's batch frame
+      lootTickBatchAdd(g, h.holdId, pl.carried);
+
+      h.nextTickAt += period;
+      timerArm(TMR_HOLD_0 + i, h.nextTickAt);   // after a stall, overdue ticks fire one per pass
     }
+    lootTickBatchFlush(g);
   }
 
   // RED looting behavior:
@@ -635,31 +741,20 @@ void loop() {
   //   STRICT mode -> active holds get the grace window; if still active after grace, that RED costs one life.
   static LightState lastLight = LightState::RED;  // pessimistic init
   if (g.phase == Phase::PLAYING) {
+    PROF_SCOPE(PS_RED_HOLDS);
     // RED rising edge
     if (g.light == LightState::RED && lastLight != LightState::RED) {
       if (!g.redLootPenaltyAfterGrace) {
-        for (auto &h : g.holds) {
-          if (h.active) {
-            sendHoldEnd(g, h.holdId, /*RED*/2);
-            h.active = false;
-          }
-        }
+        endAllHolds(g, /*RED*/2);
       }
     }
 
     // STRICT mode: after the grace window, any hold still active means the player
     // kept looting into RED. End the hold(s) and consume one life for that RED period.
-    if (g.light == LightState::RED && g.redLootPenaltyAfterGrace && now >= g.redGraceUntil) {
-      uint8_t blameSid = 0;
-      bool hadActiveHold = false;
-
-      for (auto &h : g.holds) {
-        if (!h.active) continue;
-        if (!blameSid) blameSid = h.stationId;
-        hadActiveHold = true;
-        sendHoldEnd(g, h.holdId, /*RED*/2);
-        h.active = false;
-      }
+    if (g.light == LightState::RED && g.redLootPenaltyAfterGrace && now >= g.redGraceUntil &&
+        g.holds.count) {
+      const uint8_t blameSid = endAllHolds(g, /*RED*/2);
+      const bool hadActiveHold = (blameSid != 0);
 
       if (hadActiveHold && !g.pirLifeLostThisRed) {
         const LifeLossResult r = applyLifeLoss(g, /*RED_PIR / loot-in-red*/3, blameSid ? blameSid : GAMEOVER_BLAME_ALL, /*obeyLockout=*/true);
@@ -680,6 +775,7 @@ void loop() {
   // Motion input violation during RED (after arming delay).
   // The Pi camera bridge re-uses the same active-LOW Feather pin the PIR used.
   if (g.phase == Phase::PLAYING && g.light == LightState::RED && g.pirEnforce) {
+    PROF_SCOPE(PS_PIR);
     if (now >= g.pirArmAt) {
       for (int i = 0; i < 4; ++i) {
         int pin = g.pir[i].pin;
@@ -692,6 +788,7 @@ void loop() {
           if (trig != prev) {
             g.pir[i].last = trig;
             g.pir[i].lastChange = now;
+            journalPir((uint8_t)i, trig);
           }
 
           // On new LOW edge after arming delay, consume a life (up to 5)
@@ -725,10 +822,12 @@ void loop() {
 
   // Level progression (Classic mode)
   if (g.phase == Phase::PLAYING) {
+    PROF_SCOPE(PS_CLASSIC);
     modeClassicOnPlayingTick(g, now);
     modeClassicMaybeAdvance(g);
   }
 
+  PROF_SCOPE(PS_CADENCE);
   if      (g.bonusIntermission)  { tickBonusIntermission(g, now); }
   else if (g.bonusIntermission2) { tickBonusIntermission2(g, now); }
   else                           { tickCadence(g, now); }
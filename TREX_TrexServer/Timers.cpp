@@ -0,0 +1,154 @@
+#include "Timers.h"
+
+// Binary min-heap of timer ids ordered by deadline (wrap-safe), plus each
+// id's heap slot so arm/cancel are O(log n) without searching.
+static uint32_t sAt[TMR_COUNT];
+static uint8_t  sHeap[TMR_COUNT];
+static uint8_t  sPos[TMR_COUNT];      // heap slot, or NOT_QUEUED
+static uint8_t  sSize  = 0;
+static const uint8_t FIRED_WORDS = (TMR_COUNT + 31) / 32;
+static uint32_t sFired[FIRED_WORDS];  // bit id => fired, not taken yet
+
+static const uint8_t NOT_QUEUED = 0xFF;
+static bool sInit = false;
+
+struct TimerStats {
+  uint32_t fires;
+  uint32_t lateSumMs;
+  uint32_t lateMaxMs;
+};
+static TimerStats sStats[TMR_COUNT];
+
+static inline void setFired(uint8_t id)   { sFired[id >> 5] |=  (1u << (id & 31)); }
+static inline void clearFired(uint8_t id) { sFired[id >> 5] &= ~(1u << (id & 31)); }
+
+static inline bool before(uint8_t a, uint8_t b) {
+  return (int32_t)(sAt[a] - sAt[b]) < 0;
+}
+
+static inline void place(uint8_t slot, uint8_t id) {
+  sHeap[slot] = id;
+  sPos[id]    = slot;
+}
+
+static void siftUp(uint8_t slot) {
+  const uint8_t id = sHeap[slot];
+  while (slot > 0) {
+    const uint8_t parent = (slot - 1) / 2;
+    if (!before(id, sHeap[parent])) break;
+    place(slot, sHeap[parent]);
+    slot = parent;
+  }
+  place(slot, id);
+}
+
+static void siftDown(uint8_t slot) {
+  const uint8_t id = sHeap[slot];
+  for (;;) {
+    uint8_t child = 2 * slot + 1;
+    if (child >= sSize) break;
+    if (child + 1 < sSize && before(sHeap[child + 1], sHeap[child])) child++;
+    if (!before(sHeap[child], id)) break;
+    place(slot, sHeap[child]);
+    slot = child;
+  }
+  place(slot, id);
+}
+
+static void removeAt(uint8_t slot) {
+  const uint8_t id = sHeap[slot];
+  sPos[id] = NOT_QUEUED;
+  if (--sSize == slot) return;
+  const uint8_t moved = sHeap[sSize];   // last element fills the hole
+  place(slot, moved);
+  siftDown(slot);
+  siftUp(sPos[moved]);
+}
+
+static void ensureInit() {
+  if (sInit) return;
+  for (uint8_t i = 0; i < TMR_COUNT; ++i) sPos[i] = NOT_QUEUED;
+  sInit = true;
+}
+
+void timerArm(uint8_t id, uint32_t at) {
+  if (id >= TMR_COUNT) return;
+  ensureInit();
+  clearFired(id);
+  sAt[id] = at;
+  if (sPos[id] == NOT_QUEUED) {
+    place(sSize, id);
+    sSize++;
+    siftUp(sPos[id]);
+  } else {
+    siftUp(sPos[id]);
+    siftDown(sPos[id]);
+  }
+}
+
+void timerCancel(uint8_t id) {
+  if (id >= TMR_COUNT) return;
+  ensureInit();
+  clearFired(id);
+  if (sPos[id] != NOT_QUEUED) removeAt(sPos[id]);
+}
+
+void timersReset() {
+  ensureInit();
+  for (uint8_t i = 0; i < TMR_COUNT; ++i) sPos[i] = NOT_QUEUED;
+  sSize  = 0;
+  memset(sFired, 0, sizeof(sFired));
+}
+
+void timersRun(uint32_t now) {
+  while (sSize && (int32_t)(now - sAt[sHeap[0]]) >= 0) {
+    const uint8_t id = sHeap[0];
+    removeAt(0);
+    setFired(id);
+
+    const uint32_t late = now - sAt[id];
+    TimerStats& s = sStats[id];
+    s.fires++;
+    s.lateSumMs += late;
+    if (late > s.lateMaxMs) s.lateMaxMs = late;
+  }
+}
+
+bool timerFired(uint8_t id) {
+  return id < TMR_COUNT && (sFired[id >> 5] & (1u << (id & 31)));
+}
+
+bool timerTake(uint8_t id) {
+  if (!timerFired(id)) return false;
+  clearFired(id);
+  return true;
+}
+
+bool timerTakeFirst(uint8_t lo, uint8_t hi, uint8_t& id) {
+  if (hi > TMR_COUNT) hi = TMR_COUNT;
+  for (uint8_t w = lo >> 5; lo < hi; w++, lo = w << 5) {
+    uint32_t bits = sFired[w] & (~0u << (lo & 31));
+    if (!bits) continue;
+    const uint8_t found = (uint8_t)((w << 5) + __builtin_ctz(bits));
+    if (found >= hi) return false;
+    clearFired(found);
+    id = found;
+    return true;
+  }
+  return false;
+}
+
+void timersPrintStats(Print& out) {
+  static const char* const kNames[TMR_HOLD_0] = {
+    "cadence", "worldFrame", "r5Dwell", "r5Deplete", "bonusSpawn", "cueSprite", "cueAudio"
+  };
+  out.printf("timers armed=%u/%u lateness (fire - scheduled):\n", (unsigned)sSize, (unsigned)TMR_COUNT);
+  for (uint8_t i = 0; i < TMR_COUNT; ++i) {
+    const TimerStats& s = sStats[i];
+    if (!s.fires) continue;
+    if (i < TMR_HOLD_0) out.printf("  %-10s", kNames[i]);
+    else                out.printf("  hold%-6u", (unsigned)(i - TMR_HOLD_0));
+    out.printf(" fires=%lu avg=%lums max=%lums\n", (unsigned long)s.fires,
+               (unsigned long)(s.lateSumMs / s.fires), (unsigned long)s.lateMaxMs);
+  }
+}
@@ -0,0 +1,42 @@
+#pragma once
+// Server deadline scheduler.
+//
+// Subsystems arm/cancel their deadlines here instead of loop() comparing every
+// field on every pass. timersRun() pops everything that is due off a small
+// min-heap (O(1) when nothing is due) and marks it fired; the owner then
+// takes the fire when it is able to act on it. A fire that isn't taken stays
+// pending, so "deadline has passed but we can't act yet" (e.g. a bonus spawn
+// due during RED) behaves exactly like the old `now >= deadline` polling.
+//
+// Lateness (pop time - scheduled time) is tracked per timer; see `status`.
+#include <Arduino.h>
+#include "GameModel.h"
+
+enum TimerId : uint8_t {
+  TMR_CADENCE = 0,     // g.nextSwitch
+  TMR_WORLD_FRAME,     // next periodic WORLD_FRAME
+  TMR_R5_DWELL,        // g.r5DwellEndAt
+  TMR_R5_DEPLETE,      // g.r5NextDepleteAt
+  TMR_BONUS_SPAWN,     // g.bonusNextSpawnAt
+  TMR_CUE_SPRITE,      // light media fired ahead of the next cadence flip (Cadence.cpp)
+  TMR_CUE_AUDIO,
+  TMR_HOLD_0,          // g.holds[i].nextTickAt -> TMR_HOLD_0 + i
+  TMR_COUNT = TMR_HOLD_0 + MAX_HOLDS
+};
+static_assert(TMR_COUNT < 0xFF, "timer ids are 8-bit");
+
+// (Re)schedule `id` for `at` (millis). Clears a pending, untaken fire.
+void timerArm(uint8_t id, uint32_t at);
+void timerCancel(uint8_t id);
+void timersReset();                 // cancel everything (new game)
+
+// Once per loop() pass: move every due timer into the fired set.
+void timersRun(uint32_t now);
+
+bool timerFired(uint8_t id);        // peek
+bool timerTake(uint8_t id);         // true once per fire
+// Take the lowest fired id in [lo, hi); false when none. Cost is per 32
+// ids, not per id, so hold timers can be drained without a slot scan.
+bool timerTakeFirst(uint8_t lo, uint8_t hi, uint8_t& id);
+
+void timersPrintStats(Print& out);
@@ -0,0 +1,180 @@
+#include "Arduino.h"
+#include "Host.h"
+#include <chrono>
+#include <deque>
+#include <map>
+
+// ---- Virtual clock ----
+static uint64_t sNowUs = 0;
+
+uint64_t hostNowUs()                { return sNowUs; }
+void     hostSetNowUs(uint64_t us)  { sNowUs = us; }
+void     hostAdvanceUs(uint64_t us) { sNowUs += us; }
+
+uint32_t millis()                   { return (uint32_t)(sNowUs / 1000); }
+uint32_t micros()                   { return (uint32_t)sNowUs; }
+void     delay(uint32_t ms)         { sNowUs += (uint64_t)ms * 1000; }
+void     delayMicroseconds(uint32_t us) { sNowUs += us; }
+void     yield() {}
+
+// ---- GPIO ----
+static std::map<int, int> sPinIn;
+static std::map<int, int> sPinOut;
+
+void pinMode(int, int) {}
+int  digitalRead(int pin) {
+  auto it = sPinIn.find(pin);
+  return (it == sPinIn.end()) ? HIGH : it->second;
+}
+void digitalWrite(int pin, int level) { sPinOut[pin] = level; }
+
+void hostSetPin(int pin, int level) { sPinIn[pin] = level; }
+int  hostPinOut(int pin) {
+  auto it = sPinOut.find(pin);
+  return (it == sPinOut.end()) ? LOW : it->second;
+}
+
+// ---- random() / esp_random() ----
+// xorshift32; Arduino's random() and esp_random() share it
+static uint32_t sRand = 1;
+
+void hostSeedEspRandom(uint32_t seed) { sRand = seed ? seed : 1; }
+
+uint32_t esp_random() {
+  uint32_t x = sRand;
+  x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+  return sRand = x;
+}
+
+long random(long hi)         { return hi > 0 ? (long)(esp_random() % (uint32_t)hi) : 0; }
+long random(long lo, long hi) { return hi > lo ? lo + random(hi - lo) : lo; }
+
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  const size_t n = strlen(src);
+  if (size) {
+    const size_t c = (n >= size) ? size - 1 : n;
+    memcpy(dst, src, c);
+    dst[c] = 0;
+  }
+  return n;
+}
+
+// ---- String ----
+void String::trim() {
+  const char* ws = " \t\r\n";
+  const size_t a = s_.find_first_not_of(ws);
+  if (a == std::string::npos) { s_.clear(); return; }
+  s_ = s_.substr(a, s_.find_last_not_of(ws) - a + 1);
+}
+
+void String::toUpperCase() { for (char& c : s_) c = (char)toupper((unsigned char)c); }
+void String::toLowerCase() { for (char& c : s_) c = (char)tolower((unsigned char)c); }
+
+bool String::endsWith(const String& p) const {
+  return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+}
+
+int String::indexOf(char c, unsigned from) const {
+  const size_t i = s_.find(c, from);
+  return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::indexOf(const String& t, unsigned from) const {
+  const size_t i = s_.find(t.s_, from);
+  return i == std::string::npos ? -1 : (int)i;
+}
+
+String String::substring(unsigned from) const {
+  return from >= s_.size() ? String() : String(s_.substr(from));
+}
+
+String String::substring(unsigned from, unsigned to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= s_.size()) return String();
+  return String(s_.substr(from, to - from));
+}
+
+String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+String operator+(const String& a, const char* b)   { String r(a); r += b; return r; }
+String operator+(const char* a, const String& b)   { String r(a); r += b; return r; }
+
+// ---- Print ----
+size_t Print::write(const uint8_t* buf, size_t n) {
+  size_t w = 0;
+  while (n--) w += write(*buf++);
+  return w;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+  char small[256];
+  va_list ap;
+  va_start(ap, fmt);
+  const int n = vsnprintf(small, sizeof(small), fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  if ((size_t)n < sizeof(small)) return write((const uint8_t*)small, (size_t)n);
+
+  std::string big((size_t)n + 1, '\0');
+  va_start(ap, fmt);
+  vsnprintf(&big[0], big.size(), fmt, ap);
+  va_end(ap);
+  return write((const uint8_t*)big.data(), (size_t)n);
+}
+
+// ---- Serial ----
+static std::deque<char> sSerialIn;
+static bool             sSerialEcho    = false;
+static bool             sSerialCapture = false;
+static std::string      sSerialOut;
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void hostSerialFeed(const std::string& text) { sSerialIn.insert(sSerialIn.end(), text.begin(), text.end()); }
+void hostSerialEcho(bool on)                  { sSerialEcho = on; }
+void hostSerialCapture(bool on)               { sSerialCapture = on; }
+std::string& hostSerialOut()                  { return sSerialOut; }
+
+int HardwareSerial::available() { return port_ == 0 ? (int)sSerialIn.size() : 0; }
+
+int HardwareSerial::read() {
+  if (port_ != 0 || sSerialIn.empty()) return -1;
+  const char c = sSerialIn.front();
+  sSerialIn.pop_front();
+  return (uint8_t)c;
+}
+
+int HardwareSerial::peek() {
+  return (port_ != 0 || sSerialIn.empty()) ? -1 : (uint8_t)sSerialIn.front();
+}
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  if (port_ != 0) return n;
+  if (sSerialEcho)    fwrite(buf, 1, n, stdout);
+  if (sSerialCapture) sSerialOut.append((const char*)buf, n);
+  return n;
+}
+
+// ---- ESP ----
+EspClass ESP;
+
+static std::function<void()> sOnRestart;
+void hostOnRestart(std::function<void()> fn) { sOnRestart = fn; }
+
+void EspClass::restart() {
+  if (sOnRestart) { sOnRestart(); return; }
+  fflush(stdout);
+  fprintf(stderr, "[HOST] ESP.restart() at %lu ms\n", (unsigned long)millis());
+  exit(3);
+}
+
+uint32_t EspClass::getCycleCount() {
+  using namespace std::chrono;
+  const uint64_t ns = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  return (uint32_t)(ns * 240 / 1000);
+}
+
+uint64_t EspClass::getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
@@ -0,0 +1,157 @@
+#pragma once
+// Host stand-in for the ESP32 Arduino core: just the parts the sketches use.
+//
+// Time is virtual. millis()/micros()/esp_timer_get_time() read a clock that
+// only moves when the host driver advances it (hostAdvanceUs, Host.h) or the
+// code under test calls delay(). Serial prints go to stdout when echo is on
+// and can be captured; Serial input is whatever the driver fed it.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define SERIAL_8N1   0x800001c
+
+#define PROGMEM
+#define IRAM_ATTR
+#define F(x) x
+
+using std::min;
+using std::max;
+
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);               // advances the virtual clock
+void     delayMicroseconds(uint32_t us);   // likewise
+void     yield();
+
+void pinMode(int pin, int mode);
+int  digitalRead(int pin);                 // unset pins read HIGH (pulled up)
+void digitalWrite(int pin, int level);
+
+long random(long max);
+long random(long min, long max);
+
+size_t strlcpy(char* dst, const char* src, size_t size);
+
+// ---- String ----
+class String {
+public:
+  String() {}
+  String(const char* c) : s_(c ? c : "") {}
+  String(const std::string& x) : s_(x) {}
+  String(char c) : s_(1, c) {}
+  explicit String(int v)           { s_ = std::to_string(v); }
+  explicit String(unsigned v)      { s_ = std::to_string(v); }
+  explicit String(long v)          { s_ = std::to_string(v); }
+  explicit String(unsigned long v) { s_ = std::to_string(v); }
+
+  unsigned    length() const { return (unsigned)s_.size(); }
+  const char* c_str()  const { return s_.c_str(); }
+  char operator[](unsigned i) const { return i < s_.size() ? s_[i] : 0; }
+  char charAt(unsigned i) const     { return (*this)[i]; }
+
+  void trim();
+  void toUpperCase();
+  void toLowerCase();
+  bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String& p) const;
+  bool equals(const String& o) const           { return s_ == o.s_; }
+  bool equalsIgnoreCase(const String& o) const { return !strcasecmp(s_.c_str(), o.c_str()); }
+  int  indexOf(char c, unsigned from = 0) const;
+  int  indexOf(const String& t, unsigned from = 0) const;
+  String substring(unsigned from) const;
+  String substring(unsigned from, unsigned to) const;
+  long  toInt() const   { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o)   { s_ += o; return *this; }
+  String& operator+=(char c)          { s_ += c; return *this; }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const   { return s_ == o; }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* o) const   { return s_ != o; }
+
+  const std::string& str() const { return s_; }
+
+private:
+  std::string s_;
+};
+
+String operator+(const String& a, const String& b);
+String operator+(const String& a, const char* b);
+String operator+(const char* a, const String& b);
+
+// ---- Print ----
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n);
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  virtual int availableForWrite() { return 1 << 16; }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+  size_t print(const char* s)   { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c)          { return write((uint8_t)c); }
+  size_t print(int v)           { return printf("%d", v); }
+  size_t print(unsigned v)      { return printf("%u", v); }
+  size_t print(long v)          { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+  size_t println()                { return write("\r\n"); }
+  template <class T> size_t println(const T& v)    { size_t n = print(v); return n + println(); }
+  size_t println(double v, int digits)             { size_t n = print(v, digits); return n + println(); }
+};
+
+// Serial: output optionally echoed to stdout and/or captured (hostSerial*,
+// Host.h); input is a byte queue the host fills
+class HardwareSerial : public Print {
+public:
+  explicit HardwareSerial(int port) : port_(port) {}
+  void begin(uint32_t, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1) {}
+  void end() {}
+  int  available();
+  int  read();
+  int  peek();
+  void flush() {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  operator bool() const { return true; }
+
+private:
+  int port_;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;   // Sprite UART on the Feather; writes are discarded
+extern HardwareSerial Serial2;
+
+// ---- ESP ----
+// getCycleCount() runs off the host's real monotonic clock at 240 MHz, so
+// the Profiler's sections report what they really cost on this machine.
+struct EspClass {
+  void     restart();              // ends the host process (exit code 3)
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint64_t getEfuseMac();
+  uint32_t getFreeHeap()   { return 200 * 1024; }
+};
+extern EspClass ESP;
@@ -0,0 +1,63 @@
+#pragma once
+// Host-side controls for the shimmed platform (not part of any sketch).
+//
+// A host program links one sketch's sources against host/shim and drives it:
+// it moves the virtual clock, feeds Serial and input pins, injects received
+// ESP-NOW frames and sees every frame the sketch sends. All of it is
+// single-threaded and per process; sketches keep their state in file
+// statics, so one process is one device.
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+// ---- Virtual clock ----
+// Starts at 0, like millis() after boot.
+uint64_t hostNowUs();
+void     hostSetNowUs(uint64_t us);
+void     hostAdvanceUs(uint64_t us);
+static inline void hostAdvanceMs(uint32_t ms) { hostAdvanceUs((uint64_t)ms * 1000); }
+
+// ---- Serial ----
+void hostSerialFeed(const std::string& text);   // queued as Serial input
+void hostSerialEcho(bool on);                    // print Serial output to stdout (default off)
+void hostSerialCapture(bool on);                 // keep Serial output in hostSerialOut()
+std::string& hostSerialOut();
+
+// ---- GPIO ----
+void hostSetPin(int pin, int level);
+int  hostPinOut(int pin);                        // last digitalWrite level
+
+// ---- esp_random() ----
+void hostSeedEspRandom(uint32_t seed);           // default seed 1: runs repeat
+
+// ---- LittleFS ----
+// Paths map into this directory (created if missing). Default: none set,
+// LittleFS.begin() fails and the sketch behaves as without a filesystem.
+void hostFsRoot(const std::string& dir);
+std::string hostFsPath(const char* path);
+
+// ---- ESP-NOW ----
+struct HostFrame {
+  uint64_t             atUs;
+  bool                 unicast;                  // esp_now_send to a peer; else Transport::broadcast
+  uint8_t              mac[6];                   // unicast destination
+  std::vector<uint8_t> data;
+};
+using HostTxSink = std::function<void(const HostFrame&)>;
+
+void hostSetTxSink(HostTxSink sink);             // every frame the sketch sends
+void hostInjectRx(const uint8_t* data, uint16_t len);   // into Transport::init's callback
+// esp_now_send() result for the next unicasts (default ESP_OK). Whether a
+// frame arrives is the caller's link model; this only fakes a local error.
+void hostSetUnicastResult(int err);
+
+// ---- Maintenance (TrexMaintenance) ----
+// Runs one telnet command line through Maint::CustomHandler(); false when
+// the handler doesn't know it (or none is registered).
+bool hostMaintCommand(const char* line, std::string& out);
+
+// ---- ESP.restart() ----
+// Called instead of exiting when set (e.g. to restart the sketch in a fork).
+void hostOnRestart(std::function<void()> fn);
@@ -0,0 +1,38 @@
+#pragma once
+// Host stand-in for LittleFS: files live under hostFsRoot() (Host.h)
+#include <Arduino.h>
+#include <memory>
+
+class File : public Print {
+public:
+  File() {}
+  explicit File(FILE* f) : f_(f, fclose) {}
+
+  explicit operator bool() const { return (bool)f_; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  size_t read(uint8_t* buf, size_t n);
+  int    read();
+  int    available();
+  size_t readBytesUntil(char term, char* buf, size_t n);
+  size_t size();
+  bool   seek(uint32_t pos);
+  size_t position();
+  void   flush();
+  void   close() { f_.reset(); }
+
+private:
+  std::shared_ptr<FILE> f_;
+};
+
+class LittleFSClass {
+public:
+  bool begin(bool formatOnFail = false);
+  void end() {}
+  File open(const char* path, const char* mode = "r");
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+};
+extern LittleFSClass LittleFS;
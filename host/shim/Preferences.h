@@ -0,0 +1,31 @@
+#pragma once
+// Host stand-in for NVS Preferences: an in-memory store per process
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  uint8_t  getUChar(const char* key, uint8_t def = 0);
+  size_t   putUChar(const char* key, uint8_t v);
+  uint16_t getUShort(const char* key, uint16_t def = 0);
+  size_t   putUShort(const char* key, uint16_t v);
+  uint32_t getUInt(const char* key, uint32_t def = 0);
+  size_t   putUInt(const char* key, uint32_t v);
+  bool     getBool(const char* key, bool def = false);
+  size_t   putBool(const char* key, bool v);
+  String   getString(const char* key, const String& def = String());
+  size_t   putString(const char* key, const String& v);
+  size_t   getBytesLength(const char* key);
+  size_t   getBytes(const char* key, void* buf, size_t maxLen);
+  size_t   putBytes(const char* key, const void* buf, size_t len);
+
+private:
+  std::string ns_;
+  bool        open_ = false;
+  bool        ro_   = false;
+};
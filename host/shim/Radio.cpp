@@ -0,0 +1,88 @@
+// ESP-NOW, TrexTransport, TrexMaintenance and the esp_* odds and ends
+#include "Host.h"
+#include "TrexTransport.h"
+#include "TrexMaintenance.h"
+#include "esp_now.h"
+#include "esp_timer.h"
+#include <set>
+#include <array>
+
+int64_t esp_timer_get_time()          { return (int64_t)hostNowUs(); }
+esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+WiFiClass WiFi;
+
+// ---- TX sink / RX injection ----
+static HostTxSink           sSink;
+static Transport::RxCallback sRx = nullptr;
+static int                  sUnicastResult = ESP_OK;
+
+void hostSetTxSink(HostTxSink sink) { sSink = sink; }
+void hostSetUnicastResult(int err)  { sUnicastResult = err; }
+
+void hostInjectRx(const uint8_t* data, uint16_t len) {
+  if (sRx) sRx(data, len);
+}
+
+static void emit(bool unicast, const uint8_t* mac, const uint8_t* data, size_t len) {
+  if (!sSink) return;
+  HostFrame f;
+  f.atUs    = hostNowUs();
+  f.unicast = unicast;
+  if (mac) memcpy(f.mac, mac, 6); else memset(f.mac, 0xFF, 6);
+  f.data.assign(data, data + len);
+  sSink(f);
+}
+
+namespace Transport {
+bool init(const TransportConfig&, RxCallback onRx) { sRx = onRx; return true; }
+bool broadcast(const uint8_t* data, uint16_t len)   { emit(false, nullptr, data, len); return true; }
+bool sendToServer(const uint8_t* data, uint16_t len) { return broadcast(data, len); }
+void loop() {}
+}
+
+// ---- ESP-NOW peers ----
+static std::set<std::array<uint8_t, 6>> sPeers;
+
+static std::array<uint8_t, 6> macKey(const uint8_t* mac) {
+  std::array<uint8_t, 6> k;
+  memcpy(k.data(), mac, 6);
+  return k;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+  sPeers.insert(macKey(peer->peer_addr));
+  return ESP_OK;
+}
+
+bool esp_now_is_peer_exist(const uint8_t* mac) { return sPeers.count(macKey(mac)) != 0; }
+
+esp_err_t esp_now_send(const uint8_t* mac, const uint8_t* data, size_t len) {
+  if (!mac || !sPeers.count(macKey(mac))) return ESP_FAIL;
+  if (sUnicastResult != ESP_OK) return sUnicastResult;
+  emit(true, mac, data, len);
+  return ESP_OK;
+}
+
+// ---- Maintenance ----
+namespace Maint {
+bool active = false;
+
+bool checkRuntimeEntry(Config&) { return false; }
+void begin(Config&)             { active = true; }
+void loop() {}
+
+Handler& CustomHandler() {
+  static Handler h = nullptr;
+  return h;
+}
+}
+
+bool hostMaintCommand(const char* line, std::string& out) {
+  Maint::Handler h = Maint::CustomHandler();
+  if (!h) return false;
+  WiFiClient client;
+  const bool known = h(String(line), client);
+  out = client.text();
+  return known;
+}
@@ -0,0 +1,163 @@
+// LittleFS (a host directory) and Preferences (in memory)
+#include "Host.h"
+#include "LittleFS.h"
+#include "Preferences.h"
+#include <map>
+#include <vector>
+#include <sys/stat.h>
+
+// ---- LittleFS ----
+LittleFSClass LittleFS;
+
+static std::string sFsRoot;
+
+void hostFsRoot(const std::string& dir) {
+  sFsRoot = dir;
+  if (!sFsRoot.empty()) mkdir(sFsRoot.c_str(), 0755);
+}
+
+std::string hostFsPath(const char* path) {
+  return sFsRoot + (path[0] == '/' ? "" : "/") + path;
+}
+
+bool LittleFSClass::begin(bool) { return !sFsRoot.empty(); }
+
+File LittleFSClass::open(const char* path, const char* mode) {
+  if (sFsRoot.empty()) return File();
+  const char* m = (mode[0] == 'w') ? "wb" : (mode[0] == 'a') ? "ab" : "rb";
+  FILE* f = fopen(hostFsPath(path).c_str(), m);
+  return f ? File(f) : File();
+}
+
+bool LittleFSClass::exists(const char* path) {
+  struct stat st;
+  return !sFsRoot.empty() && stat(hostFsPath(path).c_str(), &st) == 0;
+}
+
+bool LittleFSClass::remove(const char* path) {
+  return !sFsRoot.empty() && ::remove(hostFsPath(path).c_str()) == 0;
+}
+
+bool LittleFSClass::rename(const char* from, const char* to) {
+  return !sFsRoot.empty() && ::rename(hostFsPath(from).c_str(), hostFsPath(to).c_str()) == 0;
+}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buf, size_t n) {
+  return f_ ? fwrite(buf, 1, n, f_.get()) : 0;
+}
+
+size_t File::read(uint8_t* buf, size_t n) {
+  return f_ ? fread(buf, 1, n, f_.get()) : 0;
+}
+
+int File::read() {
+  if (!f_) return -1;
+  const int c = fgetc(f_.get());
+  return c == EOF ? -1 : c;
+}
+
+int File::available() {
+  if (!f_) return 0;
+  const long pos = ftell(f_.get());
+  return (int)(size() - (size_t)pos);
+}
+
+size_t File::readBytesUntil(char term, char* buf, size_t n) {
+  size_t i = 0;
+  while (i < n) {
+    const int c = read();
+    if (c < 0 || c == term) break;
+    buf[i++] = (char)c;
+  }
+  return i;
+}
+
+size_t File::size() {
+  if (!f_) return 0;
+  const long pos = ftell(f_.get());
+  fseek(f_.get(), 0, SEEK_END);
+  const long end = ftell(f_.get());
+  fseek(f_.get(), pos, SEEK_SET);
+  return (size_t)end;
+}
+
+bool   File::seek(uint32_t pos) { return f_ && fseek(f_.get(), (long)pos, SEEK_SET) == 0; }
+size_t File::position()         { return f_ ? (size_t)ftell(f_.get()) : 0; }
+void   File::flush()            { if (f_) fflush(f_.get()); }
+
+// ---- Preferences ----
+using PrefsNs = std::map<std::string, std::vector<uint8_t>>;
+static std::map<std::string, PrefsNs> sPrefs;
+
+bool Preferences::begin(const char* name, bool readOnly) {
+  ns_ = name;
+  ro_ = readOnly;
+  open_ = true;
+  return true;
+}
+
+void Preferences::end() { open_ = false; }
+
+bool Preferences::clear() {
+  if (!open_ || ro_) return false;
+  sPrefs[ns_].clear();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  return open_ && !ro_ && sPrefs[ns_].erase(key) != 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  return open_ && sPrefs[ns_].count(key) != 0;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!open_) return 0;
+  auto it = sPrefs[ns_].find(key);
+  return it == sPrefs[ns_].end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  if (!open_) return 0;
+  auto it = sPrefs[ns_].find(key);
+  if (it == sPrefs[ns_].end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::putBytes(const char* key, const void* buf, size_t len) {
+  if (!open_ || ro_) return 0;
+  const uint8_t* b = (const uint8_t*)buf;
+  sPrefs[ns_][key].assign(b, b + len);
+  return len;
+}
+
+// Scalars are stored as their bytes, like NVS blobs of that width
+template <class T>
+static T getScalar(Preferences& p, const char* key, T def) {
+  T v;
+  return p.getBytes(key, &v, sizeof(v)) == sizeof(v) ? v : def;
+}
+
+uint8_t  Preferences::getUChar(const char* k, uint8_t d)   { return getScalar(*this, k, d); }
+size_t   Preferences::putUChar(const char* k, uint8_t v)   { return putBytes(k, &v, sizeof(v)); }
+uint16_t Preferences::getUShort(const char* k, uint16_t d) { return getScalar(*this, k, d); }
+size_t   Preferences::putUShort(const char* k, uint16_t v) { return putBytes(k, &v, sizeof(v)); }
+uint32_t Preferences::getUInt(const char* k, uint32_t d)   { return getScalar(*this, k, d); }
+size_t   Preferences::putUInt(const char* k, uint32_t v)   { return putBytes(k, &v, sizeof(v)); }
+bool     Preferences::getBool(const char* k, bool d)       { return getScalar<uint8_t>(*this, k, d ? 1 : 0) != 0; }
+size_t   Preferences::putBool(const char* k, bool v)       { return putUChar(k, v ? 1 : 0); }
+
+String Preferences::getString(const char* key, const String& def) {
+  if (!open_) return def;
+  auto it = sPrefs[ns_].find(key);
+  if (it == sPrefs[ns_].end()) return def;
+  return String(std::string(it->second.begin(), it->second.end()));
+}
+
+size_t Preferences::putString(const char* key, const String& v) {
+  return putBytes(key, v.c_str(), v.length());
+}
@@ -0,0 +1,32 @@
+#pragma once
+// Host stand-in for the TrexMaintenance library. There is no Wi-Fi or
+// telnet: maintenance is never entered on its own, and the registered
+// command handler is reached through hostMaintCommand() (Host.h).
+#include <Arduino.h>
+#include <WiFi.h>
+#include <TrexProtocol.h>
+
+namespace Maint {
+struct Config {
+  const char* ssid;
+  const char* pass;
+  const char* host;
+  bool        apFallback;
+  uint8_t     apChannel;
+  const char* apPass;
+  int         buttonPin;
+  uint32_t    holdMs;
+  StationType stationType;
+  uint8_t     stationId;
+  bool        enableBeacon;
+};
+
+extern bool active;
+
+bool checkRuntimeEntry(Config& cfg);   // always false on the host
+void begin(Config& cfg);               // sets `active`; nothing else happens
+void loop();
+
+typedef bool (*Handler)(const String& line, WiFiClient& out);
+Handler& CustomHandler();
+}
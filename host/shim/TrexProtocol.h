@@ -0,0 +1,148 @@
+#pragma once
+// Host stand-in for the shared TrexProtocol library header.
+//
+// The library lives outside this repo; this copy declares the message ids
+// and payloads the sketches use, laid out the same way (packed, little
+// endian). Host runs only ever talk to each other through it, so what must
+// hold is that every sketch and host tool agrees on it, not that the ids
+// match the library byte for byte.
+#include <stddef.h>
+#include <stdint.h>
+
+#define TREX_PROTO_VERSION 3
+
+enum class MsgType : uint8_t {
+  HELLO = 1,
+  STATE_TICK,
+  GAME_START,
+  GAME_OVER,
+  SCORE_UPDATE,
+  STATION_UPDATE,
+  ROUND_STATUS,
+  BONUS_UPDATE,
+  GAME_STATUS,
+  LIVES_UPDATE,
+  RADIO_CFG,
+  SERVER_CMD,
+  CONTROL_CMD,
+  LOOT_HOLD_START,
+  LOOT_HOLD_STOP,
+  LOOT_HOLD_ACK,
+  LOOT_TICK,
+  HOLD_END,
+  DROP_REQUEST,
+  DROP_RESULT,
+  MG_START,
+  MG_STOP,
+  MG_RESULT,
+  CONFIG_UPDATE,
+  OTA_STATUS,
+};
+
+enum class LightState  : uint8_t { GREEN = 0, RED = 1, YELLOW = 2 };
+enum class StationType : uint8_t { TREX = 0, LOOT = 1, DROP = 2, CONTROL = 3 };
+enum class ControlOp   : uint8_t { START = 1, STOP, ENTER_MAINT, LOOT_OTA };
+enum class ServerCmdOp : uint8_t { START_TEST_ROUND = 1, SET_PIR_ARM_MS, SET_RED_LOOT_MODE };
+enum class RedLootMode : uint8_t { DROP_ONLY = 0, PENALIZE_AFTER_GRACE = 1 };
+enum class OtaPhase    : uint8_t { ACK = 1, STARTING, FAIL, SUCCESS };
+
+constexpr uint8_t GAMEOVER_BLAME_ALL            = 255;
+constexpr uint8_t GAMEOVER_REASON_SUCCESS       = 0;
+constexpr uint8_t GAMEOVER_REASON_MANUAL        = 2;
+constexpr uint8_t GAMEOVER_REASON_RED_VIOLATION = 3;
+constexpr uint8_t GAMEOVER_REASON_GOAL_NOT_MET  = 4;
+constexpr uint8_t DROP_READER_UNKNOWN           = 255;
+
+#pragma pack(push, 1)
+struct TrexUid { uint8_t len; uint8_t bytes[10]; };
+
+struct MsgHeader {
+  uint8_t  version;
+  uint8_t  type;
+  uint8_t  srcStationId;
+  uint8_t  flags;
+  uint16_t payloadLen;
+  uint16_t seq;
+};
+
+struct HelloPayload         { uint8_t stationType, stationId, fwMajor, fwMinor, wifiChannel; uint8_t mac[6]; };
+struct StateTickPayload     { uint8_t state; uint32_t msLeft; };
+struct GameOverPayload      { uint8_t reason, blameSid; };
+struct ScoreUpdatePayload   { uint32_t teamScore; };
+struct StationUpdatePayload { uint8_t stationId; uint16_t inventory, capacity; };
+struct RoundStatusPayload   { uint8_t roundIndex, reserved; uint16_t _pad; uint32_t roundStartScore, roundGoalAbs, msLeftRound; };
+struct BonusUpdatePayload   { uint32_t mask; };
+struct GameStatusPayload    { uint32_t teamScore, msLeftGame, msLeftRound; uint8_t roundIndex, phase, lightState, _pad; };
+struct LivesUpdatePayload   { uint8_t livesRemaining, livesMax, reason, blameSid; };
+struct RadioCfgPayload      { uint8_t wifiChannel, txFramed, rxLegacy, _pad; };
+struct ServerCmdPayload     { uint8_t op, arg8; uint16_t value16; };
+struct ControlCmdPayload    { uint8_t op, targetType, targetId, _pad; };
+
+struct LootHoldStartPayload { uint32_t holdId; TrexUid uid; uint8_t stationId; };
+struct LootHoldStopPayload  { uint32_t holdId; };
+struct LootHoldAckPayload   { uint32_t holdId; uint8_t accepted, rateHz, maxCarry, carried; uint16_t inventory, capacity; uint8_t denyReason; };
+struct LootTickPayload      { uint32_t holdId; uint8_t carried; uint16_t inventory; };
+struct HoldEndPayload       { uint32_t holdId; uint8_t reason; };
+struct DropRequestPayload   { TrexUid uid; uint8_t readerIndex; };
+struct DropResultPayload    { uint16_t dropped; uint32_t teamScore; uint8_t readerIndex; };
+
+struct MgStartPayload       { uint32_t seed; uint16_t timerMs; uint8_t speedMinMs, speedMaxMs, segMin, segMax; };
+struct MgResultPayload      { TrexUid uid; uint8_t stationId, success; };
+
+struct ConfigUpdatePayload  { uint8_t stationType, targetId; char otaUrl[96]; uint32_t campaignId; uint8_t expectMajor, expectMinor; };
+struct OtaStatusPayload     { uint8_t stationType, stationId, phase, error, fwMajor, fwMinor; uint32_t bytes, total; };
+#pragma pack(pop)
+
+// The layouts the sketches were written against: a field added, reordered or
+// left unpacked here breaks the host build instead of silently shifting every
+// payload after it.
+static_assert(sizeof(TrexUid) == 11, "wire layout");
+static_assert(sizeof(MsgHeader) == 8, "wire layout");
+static_assert(offsetof(MsgHeader, payloadLen) == 4, "wire layout");
+static_assert(offsetof(MsgHeader, seq) == 6, "wire layout");
+static_assert(sizeof(HelloPayload) == 11, "wire layout");
+static_assert(offsetof(HelloPayload, mac) == 5, "wire layout");
+static_assert(sizeof(StateTickPayload) == 5, "wire layout");
+static_assert(offsetof(StateTickPayload, msLeft) == 1, "wire layout");
+static_assert(sizeof(GameOverPayload) == 2, "wire layout");
+static_assert(sizeof(ScoreUpdatePayload) == 4, "wire layout");
+static_assert(sizeof(StationUpdatePayload) == 5, "wire layout");
+static_assert(offsetof(StationUpdatePayload, capacity) == 3, "wire layout");
+static_assert(sizeof(RoundStatusPayload) == 16, "wire layout");
+static_assert(offsetof(RoundStatusPayload, roundStartScore) == 4, "wire layout");
+static_assert(offsetof(RoundStatusPayload, msLeftRound) == 12, "wire layout");
+static_assert(sizeof(BonusUpdatePayload) == 4, "wire layout");
+static_assert(sizeof(GameStatusPayload) == 16, "wire layout");
+static_assert(offsetof(GameStatusPayload, roundIndex) == 12, "wire layout");
+static_assert(sizeof(LivesUpdatePayload) == 4, "wire layout");
+static_assert(sizeof(RadioCfgPayload) == 4, "wire layout");
+static_assert(sizeof(ServerCmdPayload) == 4, "wire layout");
+static_assert(offsetof(ServerCmdPayload, value16) == 2, "wire layout");
+static_assert(sizeof(ControlCmdPayload) == 4, "wire layout");
+static_assert(sizeof(LootHoldStartPayload) == 16, "wire layout");
+static_assert(offsetof(LootHoldStartPayload, uid) == 4, "wire layout");
+static_assert(offsetof(LootHoldStartPayload, stationId) == 15, "wire layout");
+static_assert(sizeof(LootHoldStopPayload) == 4, "wire layout");
+static_assert(sizeof(LootHoldAckPayload) == 13, "wire layout");
+static_assert(offsetof(LootHoldAckPayload, inventory) == 8, "wire layout");
+static_assert(offsetof(LootHoldAckPayload, denyReason) == 12, "wire layout");
+static_assert(sizeof(LootTickPayload) == 7, "wire layout");
+static_assert(offsetof(LootTickPayload, inventory) == 5, "wire layout");
+static_assert(sizeof(HoldEndPayload) == 5, "wire layout");
+static_assert(sizeof(DropRequestPayload) == 12, "wire layout");
+static_assert(offsetof(DropRequestPayload, readerIndex) == 11, "wire layout");
+static_assert(sizeof(DropResultPayload) == 7, "wire layout");
+static_assert(offsetof(DropResultPayload, teamScore) == 2, "wire layout");
+static_assert(offsetof(DropResultPayload, readerIndex) == 6, "wire layout");
+static_assert(sizeof(MgStartPayload) == 10, "wire layout");
+static_assert(offsetof(MgStartPayload, timerMs) == 4, "wire layout");
+static_assert(offsetof(MgStartPayload, segMax) == 9, "wire layout");
+static_assert(sizeof(MgResultPayload) == 13, "wire layout");
+static_assert(offsetof(MgResultPayload, stationId) == 11, "wire layout");
+static_assert(sizeof(ConfigUpdatePayload) == 104, "wire layout");
+static_assert(offsetof(ConfigUpdatePayload, otaUrl) == 2, "wire layout");
+static_assert(offsetof(ConfigUpdatePayload, campaignId) == 98, "wire layout");
+static_assert(offsetof(ConfigUpdatePayload, expectMinor) == 103, "wire layout");
+static_assert(sizeof(OtaStatusPayload) == 14, "wire layout");
+static_assert(offsetof(OtaStatusPayload, bytes) == 6, "wire layout");
+static_assert(offsetof(OtaStatusPayload, total) == 10, "wire layout");
@@ -0,0 +1,21 @@
+#pragma once
+// Host stand-in for the TrexTransport library: broadcast goes to the host's
+// TX sink (hostSetTxSink, Host.h) and the RX callback is what
+// hostInjectRx() calls.
+#include <stdint.h>
+
+struct TransportConfig {
+  bool    maintenanceMode;
+  uint8_t wifiChannel;
+  bool    txFramed;
+  bool    rxAcceptLegacy;
+};
+
+namespace Transport {
+typedef void (*RxCallback)(const uint8_t* data, uint16_t len);
+
+bool init(const TransportConfig& cfg, RxCallback onRx);
+bool broadcast(const uint8_t* data, uint16_t len);
+bool sendToServer(const uint8_t* data, uint16_t len);   // stations; broadcast on the host
+void loop();
+}
@@ -0,0 +1,4 @@
+#pragma once
+// Host stand-in for the shared firmware version header
+#define TREX_FW_MAJOR 1
+#define TREX_FW_MINOR 0
@@ -0,0 +1,26 @@
+#pragma once
+// Host stand-in: WiFiClient is a Print that collects what is written to it
+#include <Arduino.h>
+
+class WiFiClient : public Print {
+public:
+  size_t write(uint8_t c) override { out_ += (char)c; return 1; }
+  size_t write(const uint8_t* buf, size_t n) override { out_.append((const char*)buf, n); return n; }
+  using Print::write;
+  const std::string& text() const { return out_; }
+
+private:
+  std::string out_;
+};
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP  2
+
+struct WiFiClass {
+  void   mode(int) {}
+  void   disconnect(bool = false, bool = false) {}
+  String macAddress() { return "02:00:00:00:00:00"; }
+  void   macAddress(uint8_t* mac) { static const uint8_t m[6] = { 2, 0, 0, 0, 0, 0 }; memcpy(mac, m, 6); }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,5 @@
+#pragma once
+// RTC memory doesn't survive a host process; RTC_NOINIT_ATTR is plain storage
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define IRAM_ATTR
@@ -0,0 +1,23 @@
+#pragma once
+// Host stand-in for ESP-NOW unicast: esp_now_send() hands the frame to the
+// host's TX sink (Host.h) tagged with its destination MAC
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_system.h"
+
+#define ESP_NOW_ETH_ALEN 6
+
+typedef enum { WIFI_IF_STA = 0, WIFI_IF_AP = 1 } wifi_interface_t;
+
+typedef struct {
+  uint8_t          peer_addr[ESP_NOW_ETH_ALEN];
+  uint8_t          lmk[16];
+  uint8_t          channel;
+  wifi_interface_t ifidx;
+  bool             encrypt;
+  void*            priv;
+} esp_now_peer_info_t;
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+bool      esp_now_is_peer_exist(const uint8_t* mac);
+esp_err_t esp_now_send(const uint8_t* mac, const uint8_t* data, size_t len);
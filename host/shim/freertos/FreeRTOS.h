@@ -0,0 +1,19 @@
+#pragma once
+// Host stand-in: one thread per sketch, so critical sections are no-ops
+#include <stdint.h>
+
+typedef struct { uint32_t owner; uint32_t count; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+static inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+static inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+static inline void portENTER_CRITICAL_ISR(portMUX_TYPE*) {}
+static inline void portEXIT_CRITICAL_ISR(portMUX_TYPE*) {}
+
+typedef int      BaseType_t;
+typedef uint32_t TickType_t;
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define portMAX_DELAY 0xffffffffUL
+#define pdMS_TO_TICKS(ms) (ms)
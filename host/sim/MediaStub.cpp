@@ -0,0 +1,85 @@
+#include "MediaStub.h"
+#include "GameAudio.h"
+#include "EventLog.h"
+#include <Preferences.h>
+
+static std::vector<MediaEvent> sLog;
+
+struct Deferred {
+  bool     armed;
+  MediaOp  op;
+  uint16_t arg;
+  uint32_t at;
+};
+static Deferred sDeferred[2];   // [0] Sprite, [1] DY audio
+static uint16_t sLagMs[(uint8_t)MediaOut::COUNT] = {};
+static const char* const kLagKeys[(uint8_t)MediaOut::COUNT] = { "lagSpr", "lagAud", "lagLed" };
+static uint16_t sCurrentTrack = 0;
+
+const std::vector<MediaEvent>& mediaStubLog() { return sLog; }
+void mediaStubClear() { sLog.clear(); }
+
+static void execute(MediaOp op, uint16_t arg) { sLog.push_back(MediaEvent{ millis(), op, arg }); }
+
+void mediaInit() {
+  Preferences p;
+  p.begin("trex", true);
+  for (uint8_t o = 0; o < (uint8_t)MediaOut::COUNT; ++o) {
+    const uint16_t v = p.getUShort(kLagKeys[o], 0);
+    sLagMs[o] = (v > MEDIA_LAG_MAX_MS) ? MEDIA_LAG_MAX_MS : v;
+  }
+  p.end();
+}
+
+void mediaPost(MediaOp op, uint16_t arg, uint32_t at) {
+  Deferred& d = sDeferred[op == MediaOp::SPRITE ? 0 : 1];
+  if (at && (int32_t)(at - millis()) > 0) {
+    d = Deferred{ true, op, arg, at };
+    return;
+  }
+  d.armed = false;
+  execute(op, arg);
+}
+
+void mediaPump(uint32_t now) {
+  for (Deferred& d : sDeferred) {
+    if (!d.armed || (int32_t)(now - d.at) < 0) continue;
+    d.armed = false;
+    execute(d.op, d.arg);
+  }
+}
+
+void spritePlay(uint8_t clip, uint32_t at) {
+  evlog(EV_SPRITE_PLAY, clip);
+  mediaPost(MediaOp::SPRITE, clip, at);
+}
+
+uint16_t mediaLagMs(MediaOut o) {
+  return ((uint8_t)o < (uint8_t)MediaOut::COUNT) ? sLagMs[(uint8_t)o] : 0;
+}
+
+void mediaSetLagMs(MediaOut o, uint16_t ms) {
+  if ((uint8_t)o >= (uint8_t)MediaOut::COUNT) return;
+  sLagMs[(uint8_t)o] = (ms > MEDIA_LAG_MAX_MS) ? MEDIA_LAG_MAX_MS : ms;
+}
+
+void mediaPrintStats(Print& out) {
+  out.printf("media host stub: %u commands logged\n", (unsigned)sLog.size());
+}
+
+void gameAudioInit(uint8_t, uint8_t, uint32_t, uint8_t) { sCurrentTrack = 0; }
+
+void gameAudioPlayOnce(uint16_t track, uint32_t at) {
+  mediaPost(MediaOp::AUDIO_PLAY, track, at);
+  sCurrentTrack = track;
+}
+
+void gameAudioStop(uint32_t at) {
+  if (sCurrentTrack == 0) return;
+  mediaPost(MediaOp::AUDIO_STOP, 0, at);
+  sCurrentTrack = 0;
+}
+
+uint16_t gameAudioCurrentTrack() { return sCurrentTrack; }
+void gameAudioDevPlay(uint16_t) {}
+void gameAudioDevStop() {}
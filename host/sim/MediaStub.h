@@ -0,0 +1,16 @@
+#pragma once
+// Host replacement for the server's Media.cpp + GameAudio.cpp (Sprite and DY
+// UARTs). Commands keep Media.h's timing rules (deferred `at`, one pending
+// command per device) and land in a log instead of on a UART.
+#include <stdint.h>
+#include <vector>
+#include "Media.h"
+
+struct MediaEvent {
+  uint32_t atMs;     // when it would have reached the UART
+  MediaOp  op;
+  uint16_t arg;
+};
+
+const std::vector<MediaEvent>& mediaStubLog();
+void mediaStubClear();
@@ -0,0 +1,858 @@
+#include "Room.h"
+#include <chrono>
+#include <queue>
+#include <math.h>
+#include "Arduino.h"
+#include "Preferences.h"
+#include "Net.h"
+#include "Rng.h"
+
+extern Game g;
+void setup();
+void loop();
+
+namespace {
+
+constexpr uint8_t  FW_MAJOR = 1, FW_MINOR = 0;
+constexpr uint32_t ACK_TIMEOUT_MS  = 1500;   // no answer to a tap: lift and tap again
+constexpr uint32_t RECHECK_MS      = 250;    // waiting for the light / a free station
+constexpr uint32_t HOLD_STALL_MS   = 4000;   // gauge hasn't moved: tag off and move on
+constexpr uint8_t  PIR_PIN         = 5;      // PIN_PIR[0], active-LOW
+constexpr uint32_t HELLO_PERIOD_MS = 15000;  // TREX_Loot.ino: Loots repeat HELLO
+
+// A frame in the air
+struct Flight {
+  uint64_t atUs;
+  uint64_t order;                  // FIFO among equal times
+  int16_t  to;                     // station index, -1 = server
+  std::vector<uint8_t> data;
+};
+struct FlightLater {
+  bool operator()(const Flight& a, const Flight& b) const {
+    return a.atUs != b.atUs ? a.atUs > b.atUs : a.order > b.order;
+  }
+};
+
+enum class Act : uint8_t { IDLE, TO_LOOT, AT_LOOT, WAIT_ACK, HOLDING, TO_DROP, AT_DROP, WAIT_DROP };
+
+struct Player {
+  Act      act      = Act::IDLE;
+  int      loot     = -1;          // reader this player is at / walking to
+  uint32_t actAt    = 0;           // next timed step (room ms)
+  uint8_t  seen     = (uint8_t)LightState::GREEN;
+  uint32_t freezeAt = 0;           // saw RED, still moving until then (0 = no)
+  uint32_t liftAt   = 0;           // saw YELLOW while holding (0 = no)
+  bool     frozen   = false;
+  uint32_t frozenAt = 0;
+  uint8_t  carried  = 0;
+  uint8_t  target   = 0;           // lift at this many
+  uint32_t gainAt   = 0;           // holding: last time carried went up
+  TrexUid  uid{};
+};
+
+struct Station {
+  uint8_t  sid      = 0;
+  uint8_t  type     = (uint8_t)StationType::LOOT;
+  uint8_t  mac[6]   = {0x02, 0x54, 0x52, 0x45, 0x58, 0};
+  uint16_t seq      = 1;
+
+  // What the sketch believes
+  bool     active   = false;
+  uint8_t  light    = (uint8_t)LightState::GREEN;
+  uint8_t  round    = 0;
+  bool     bonus    = false;
+  uint16_t inv = 0, cap = 0;
+  bool     holdActive = false;
+  uint32_t holdId   = 0;
+  uint32_t holdSeq  = 0;
+  uint8_t  carried  = 0, maxCarry = 8;
+  int      player   = -1;          // reserved by
+  bool     mg       = false;
+  uint32_t mgResultAt = 0;
+  uint16_t mgSeq    = 0;
+  uint32_t mgSeqAt  = 0;
+
+  // LIGHT_SCHEDULE (clock perfectly synced)
+  LightScheduleEntry sched[LIGHT_SCHEDULE_MAX] = {};
+  uint8_t  schedN   = 0;
+  uint16_t epoch    = 0;
+  bool     schedApplied = false;
+  uint32_t schedAppliedAt = 0;
+
+  // STATE_HEARTBEAT (StateHeartbeat.cpp)
+  bool     hbEver   = false, hbResynced = false, hbPending = false;
+  uint32_t hbHash   = 0, hbAt = 0, hbDueAt = 0;
+
+  uint32_t helloAt  = 0;           // next periodic HELLO (Loots)
+
+  // StationLoopModel
+  uint64_t loopAtUs = 0;           // next loop() pass
+  std::vector<std::vector<uint8_t>> inbox;
+};
+
+}  // namespace
+
+struct Room::Impl {
+  Room&    room;
+  Rng      rng;
+  std::vector<Station> st;         // Loots 1..n at [0..n-1], the Drop-off last
+  std::vector<Player>  pl;
+  std::priority_queue<Flight, std::vector<Flight>, FlightLater> air;
+  uint64_t order    = 0;
+  bool     booted   = false;
+  bool     playing  = false;       // players act (after startGame)
+  uint32_t startMs  = 0;
+
+  // Stage tracking for RoundStats
+  uint8_t  curRound = 0;
+  uint32_t curStart = 0;
+  uint8_t  curKind  = 0xFF;        // 0 round, 1 intermission, 2 minigame
+  uint32_t curGoal  = 0;
+  uint32_t curScore0 = 0;
+  uint32_t curFromMs = 0;
+
+  explicit Impl(Room& r) : room(r) {}
+
+  Station& drop() { return st.back(); }
+  uint8_t  loots() const { return (uint8_t)(st.size() - 1); }
+
+  uint32_t nowMs() const { return (uint32_t)(hostNowUs() / 1000); }
+
+  // ---- randomness ----
+  uint32_t range(uint32_t lo, uint32_t hi) { return hi > lo ? rngRange(rng, lo, hi) : lo; }
+  bool     pct(uint8_t p) { return rngBelow(rng, 100) < p; }
+  double   unit() { return (rngNext(rng) + 0.5) / 4294967296.0; }
+  uint32_t expo(uint32_t mean) { return (uint32_t)(-log(unit()) * mean); }
+  uint32_t react() {
+    const PlayerModel& m = room.cfg_.player;
+    const double n = sqrt(-2.0 * log(unit())) * cos(6.283185307179586 * unit());
+    double ms = m.reactMeanMs + n * m.reactSdMs;
+    if (ms < 120) ms = 120;
+    if (pct(m.lapsePct)) ms *= 3;
+    return (uint32_t)ms;
+  }
+
+  // ---- link ----
+  void launch(int16_t to, const uint8_t* d, uint16_t len, bool unicast) {
+    const LinkModel& l = room.cfg_.link;
+    const uint8_t tries = unicast ? (uint8_t)(1 + l.macRetries) : 1;
+    uint64_t delay = range(l.airMinUs, l.airMaxUs);
+    uint8_t t = 0;
+    while (t < tries && pct(l.lossPct)) { t++; delay += l.retryUs; }
+    if (t == tries) { room.st_.lost++; return; }
+    air.push(Flight{hostNowUs() + delay, order++, to, std::vector<uint8_t>(d, d + len)});
+  }
+
+  void onServerTx(const HostFrame& f) {
+    RoomStats& s = room.st_;
+    s.txFrames++;
+    s.txBytes += (uint32_t)f.data.size();
+    if (f.data.size() >= sizeof(MsgHeader)) {
+      const auto* h = (const MsgHeader*)f.data.data();
+      s.txByType[h->type]++;
+      if (playing && !s.ended && h->type == (uint8_t)MsgType::GAME_OVER &&
+          f.data.size() >= sizeof(MsgHeader) + sizeof(GameOverPayload)) {
+        s.ended  = true;
+        s.reason = ((const GameOverPayload*)(f.data.data() + sizeof(MsgHeader)))->reason;
+        s.endMs  = room.gameMs();
+      }
+    }
+    if (room.txTap_) room.txTap_(f);
+
+    const uint16_t len = (uint16_t)f.data.size();
+    if (f.unicast) {
+      for (size_t i = 0; i < st.size(); ++i) {
+        if (!memcmp(st[i].mac, f.mac, 6)) { launch((int16_t)i, f.data.data(), len, true); return; }
+      }
+      return;
+    }
+    for (size_t i = 0; i < st.size(); ++i) launch((int16_t)i, f.data.data(), len, false);
+  }
+
+  void send(Station& s, uint8_t type, const void* pay, uint16_t payLen) {
+    uint8_t buf[sizeof(MsgHeader) + 64];
+    auto* h = (MsgHeader*)buf;
+    h->version      = TREX_PROTO_VERSION;
+    h->type         = type;
+    h->srcStationId = s.sid;
+    h->flags        = 0;
+    h->payloadLen   = payLen;
+    h->seq          = s.seq++;
+    memcpy(buf + sizeof(MsgHeader), pay, payLen);
+    const uint16_t len = (uint16_t)(sizeof(MsgHeader) + payLen);
+    if (room.stTap_) room.stTap_(s.sid, buf, len);
+    launch(-1, buf, len, false);
+  }
+
+  void deliverUntil(uint64_t us) {
+    while (!air.empty() && air.top().atUs <= us) {
+      Flight f = air.top();
+      air.pop();
+      if (f.atUs > hostNowUs()) hostSetNowUs(f.atUs);
+      if (f.to < 0) {
+        room.st_.rxFrames++;
+        hostInjectRx(f.data.data(), (uint16_t)f.data.size());
+      } else {
+        if (room.srTap_) room.srTap_(st[f.to].sid, f.data.data(), (uint16_t)f.data.size());
+        if (room.cfg_.stationLoop.maxUs) st[f.to].inbox.push_back(std::move(f.data));
+        else stationRx(st[f.to], f.data.data(), (uint16_t)f.data.size());
+      }
+    }
+  }
+
+  // ---- stations ----
+  Station* bySid(uint8_t sid) {
+    for (Station& s : st) if (s.sid == sid) return &s;
+    return nullptr;
+  }
+
+  // One server pass: the station's loop() if it is due (StationLoopModel)
+  void stationPass(Station& s, uint32_t now) {
+    const StationLoopModel& l = room.cfg_.stationLoop;
+    if (!l.maxUs) { stationTick(s, now); return; }
+    if (hostNowUs() < s.loopAtUs) return;
+    std::vector<std::vector<uint8_t>> rx;
+    rx.swap(s.inbox);
+    for (const std::vector<uint8_t>& d : rx) stationRx(s, d.data(), (uint16_t)d.size());
+    stationTick(s, now);
+    s.loopAtUs = hostNowUs() + (pct(l.stallPct) ? l.stallUs : range(l.minUs, l.maxUs));
+  }
+
+  StationDigest digest(const Station& s) const {
+    StationDigest d;
+    memset(&d, 0, sizeof(d));
+    d.phase      = s.active ? 1 : 2;
+    d.light      = s.light;
+    d.roundIndex = s.round;
+    d.bonusMask  = s.bonus ? (1u << s.sid) : 0;
+    d.inventory  = s.inv;
+    d.capacity   = s.cap;
+    return d;
+  }
+
+  void hello(Station& s) {
+    HelloPayload p{};
+    p.stationType = s.type;
+    p.stationId   = s.sid;
+    p.fwMajor     = FW_MAJOR;
+    p.fwMinor     = FW_MINOR;
+    p.wifiChannel = DEFAULT_WIFI_CHANNEL;
+    memcpy(p.mac, s.mac, 6);
+    send(s, (uint8_t)MsgType::HELLO, &p, sizeof(p));
+  }
+
+  bool isLoot(const Station& s) const { return s.type == (uint8_t)StationType::LOOT; }
+
+  void setLight(Station& s, uint8_t light) { s.light = light; }
+
+  void schedRx(Station& s, const uint8_t* p, uint16_t len) {
+    LightSchedulePayload hp;
+    memcpy(&hp, p, sizeof(hp));
+    uint8_t n = hp.count > LIGHT_SCHEDULE_MAX ? LIGHT_SCHEDULE_MAX : hp.count;
+    if (len < sizeof(hp) + n * sizeof(LightScheduleEntry)) return;
+    memcpy(s.sched, p + sizeof(hp), n * sizeof(LightScheduleEntry));
+    s.schedN = n;
+    s.epoch  = hp.epoch;
+  }
+
+  int8_t schedCur(const Station& s, uint32_t now) const {
+    int8_t cur = -1;
+    for (uint8_t i = 0; i < s.schedN; ++i) {
+      if ((int32_t)(now - s.sched[i].atMs) < 0) break;
+      cur = (int8_t)i;
+    }
+    return cur;
+  }
+
+  bool schedOverrides(const Station& s) const {
+    if (!s.schedN) return false;
+    const int8_t cur = schedCur(s, nowMs());
+    return cur >= 0 && cur != s.schedN - 1;
+  }
+
+  void schedPoll(Station& s) {
+    if (!s.active || s.mg || !s.schedN) return;
+    const int8_t cur = schedCur(s, nowMs());
+    if (cur < 0) return;
+    if (s.schedApplied && s.schedAppliedAt == s.sched[cur].atMs) return;
+    s.schedApplied   = true;
+    s.schedAppliedAt = s.sched[cur].atMs;
+    setLight(s, s.sched[cur].light);
+  }
+
+  void applyBonus(Station& s, uint32_t mask) { s.bonus = ((mask >> s.sid) & 1u) != 0; }
+
+  void stationRx(Station& s, const uint8_t* d, uint16_t len) {
+    if (len < sizeof(MsgHeader)) return;
+    const auto* h = (const MsgHeader*)d;
+    const uint8_t* p = d + sizeof(MsgHeader);
+    if (len < sizeof(MsgHeader) + h->payloadLen) return;
+
+    switch ((MsgTypeExt)h->type) {
+      case MsgTypeExt::WORLD_FRAME: {
+        if (h->payloadLen < sizeof(WorldFramePayload)) return;
+        const auto* w = (const WorldFramePayload*)p;
+        if (s.schedN && w->schedEpoch != s.epoch) s.schedN = 0;
+        s.round = w->roundIndex;
+        if (isLoot(s)) applyBonus(s, w->bonusMask);
+        if (!schedOverrides(s)) setLight(s, w->lightState);
+        if (s.mg && w->roundIndex >= 5) s.mg = false;
+        return;
+      }
+      case MsgTypeExt::LIGHT_SCHEDULE:   // Loots only; the Drop-off follows frame lights
+        if (!isLoot(s) || h->payloadLen < sizeof(LightSchedulePayload)) return;
+        schedRx(s, p, h->payloadLen);
+        schedPoll(s);
+        return;
+      case MsgTypeExt::STATION_RESYNC: {
+        if (h->payloadLen != sizeof(StationResyncPayload)) return;
+        const auto* r = (const StationResyncPayload*)p;
+        if (r->targetId != s.sid || r->phase != (uint8_t)Phase::PLAYING) return;
+        s.active = true;
+        if (s.schedN && r->schedEpoch != s.epoch) s.schedN = 0;
+        s.round = r->roundIndex;
+        if (isLoot(s)) {
+          applyBonus(s, r->bonusMask);
+          s.inv = r->inventory;
+          s.cap = r->capacity;
+          if (r->mgMsLeft && !s.mg) mgBegin(s, r->mgMsLeft);
+        }
+        if (s.light != r->lightState) { s.schedN = 0; setLight(s, r->lightState); }
+        s.hbResynced = true;
+        return;
+      }
+      case MsgTypeExt::LOOT_TICK_BATCH: {
+        if (!isLoot(s) || s.mg) return;
+        const auto* b = (const LootTickBatchPayload*)p;
+        if (s.sid > b->stationCount) return;
+        uint16_t inv;
+        memcpy(&inv, p + sizeof(*b) + (s.sid - 1) * sizeof(uint16_t), sizeof(inv));
+        s.inv = inv;
+        const uint8_t* e = p + sizeof(*b) + b->stationCount * sizeof(uint16_t);
+        for (uint8_t i = 0; s.holdActive && i < b->entryCount; ++i, e += sizeof(LootTickEntry)) {
+          LootTickEntry ent;
+          memcpy(&ent, e, sizeof(ent));
+          if (ent.holdId == s.holdId) { tick(s, ent.carried); break; }
+        }
+        return;
+      }
+      case MsgTypeExt::STATION_INVENTORY: {
+        if (!isLoot(s)) return;
+        const auto* v = (const StationInventoryPayload*)p;
+        if (s.sid > v->stationCount) return;
+        StationInvEntry e;
+        memcpy(&e, p + sizeof(*v) + (s.sid - 1) * sizeof(StationInvEntry), sizeof(e));
+        s.cap = e.capacity;
+        if (!s.holdActive) s.inv = e.inventory;
+        return;
+      }
+      default:
+        break;
+    }
+
+    switch ((MsgType)h->type) {
+      case MsgType::GAME_START:
+        s.active = true;
+        s.mg = false;
+        return;
+      case MsgType::GAME_OVER: {
+        const uint8_t reason = h->payloadLen >= 1 ? p[0] : 0;
+        s.active = false;
+        s.mg     = false;
+        s.bonus  = false;
+        s.schedN = 0;
+        s.schedApplied = false;
+        s.light = (reason == GAMEOVER_REASON_SUCCESS) ? (uint8_t)LightState::GREEN
+                                                      : (uint8_t)LightState::RED;
+        if (s.holdActive) endHold(s);
+        return;
+      }
+      case MsgType::BONUS_UPDATE:
+        if (isLoot(s) && h->payloadLen >= 4) { uint32_t m; memcpy(&m, p, 4); applyBonus(s, m); }
+        return;
+      case MsgType::LOOT_HOLD_ACK: {
+        if (!isLoot(s) || s.mg) return;
+        const auto* a = (const LootHoldAckPayload*)p;
+        if (a->holdId != s.holdId || !s.holdId) return;
+        s.maxCarry = a->maxCarry;
+        s.carried  = a->carried;
+        s.inv      = a->inventory;
+        s.cap      = a->capacity;
+        if (a->accepted && s.active) { s.holdActive = true; accepted(s); }
+        else                         { s.holdActive = false; denied(s, a->denyReason); }
+        return;
+      }
+      case MsgType::LOOT_TICK: {
+        if (!isLoot(s) || s.mg) return;
+        const auto* t = (const LootTickPayload*)p;
+        if (!s.holdActive || t->holdId != s.holdId) return;
+        s.inv = t->inventory;
+        tick(s, t->carried);
+        return;
+      }
+      case MsgType::HOLD_END: {
+        if (!isLoot(s) || s.mg) return;
+        const auto* e = (const HoldEndPayload*)p;
+        if (e->holdId != s.holdId || !s.holdId) return;
+        endHold(s);
+        return;
+      }
+      case MsgType::DROP_RESULT: {
+        if (isLoot(s)) return;
+        const auto* r = (const DropResultPayload*)p;
+        if (r->readerIndex < pl.size()) dropped(pl[r->readerIndex], r->dropped);
+        return;
+      }
+      case MsgType::MG_START: {
+        if (!isLoot(s) || h->payloadLen != sizeof(MgStartPayload)) return;
+        const uint32_t now = nowMs();
+        if (s.mg && h->seq == s.mgSeq && now - s.mgSeqAt < 1000) return;   // repeat copy
+        s.mgSeq   = h->seq;
+        s.mgSeqAt = now;
+        mgBegin(s, ((const MgStartPayload*)p)->timerMs);
+        return;
+      }
+      case MsgType::MG_STOP:
+        s.mg = false;
+        return;
+      default:
+        return;
+    }
+  }
+
+  void mgBegin(Station& s, uint32_t timerMs) {
+    if (s.holdActive) endHold(s);
+    s.mg = true;
+    const uint32_t late = timerMs > 1500 ? timerMs - 500 : timerMs;
+    s.mgResultAt = nowMs() + range(late < 1500 ? late : 1500, late < 6000 ? late : 6000);
+  }
+
+  void stationTick(Station& s, uint32_t now) {
+    schedPoll(s);
+
+    if (isLoot(s) && (int32_t)(now - s.helloAt) >= 0) {
+      hello(s);
+      s.helloAt = now + HELLO_PERIOD_MS;
+    }
+
+    if (s.mg && s.mgResultAt && (int32_t)(now - s.mgResultAt) >= 0) {
+      s.mgResultAt = 0;
+      MgResultPayload r{};
+      r.uid       = pl.empty() ? TrexUid{} : pl[0].uid;
+      r.stationId = s.sid;
+      r.success   = pct(room.cfg_.player.mgSuccessPct) ? 1 : 0;
+      send(s, (uint8_t)MsgType::MG_RESULT, &r, sizeof(r));
+    }
+
+    if (!room.cfg_.heartbeats || !isLoot(s)) return;
+    const uint32_t hash = trexDigestHash(digest(s));
+
+    uint8_t reason;
+    if (!s.hbEver)                                reason = STATE_HB_BOOT;
+    else if (s.hbResynced)                        reason = STATE_HB_RESYNCED;
+    else if (now - s.hbAt >= STATE_HB_PERIOD_MS)  reason = STATE_HB_PERIODIC;
+    else if (hash != s.hbHash) {
+      if (!s.hbPending) { s.hbPending = true; s.hbDueAt = now + range(0, STATE_HB_JITTER_MS); }
+      if ((int32_t)(now - s.hbDueAt) < 0) return;
+      reason = STATE_HB_CHANGED;
+    } else { s.hbPending = false; return; }
+
+    s.hbPending = false;
+    s.hbResynced = false;
+    s.hbEver = true;
+    s.hbHash = hash;
+    s.hbAt   = now;
+    StateHeartbeatPayload hb{};
+    hb.stateHash = hash;
+    hb.reason    = reason;
+    send(s, (uint8_t)MsgTypeExt::STATE_HEARTBEAT, &hb, sizeof(hb));
+  }
+
+  // ---- players, through their station ----
+  Player* holder(Station& s) { return s.player >= 0 ? &pl[s.player] : nullptr; }
+
+  void tapLoot(Station& s, Player& p) {
+    s.holdId = ((uint32_t)s.sid << 24) | (++s.holdSeq & 0xFFFFFF);
+    LootHoldStartPayload r{};
+    r.holdId    = s.holdId;
+    r.uid       = p.uid;
+    r.stationId = s.sid;
+    send(s, (uint8_t)MsgType::LOOT_HOLD_START, &r, sizeof(r));
+    p.act   = Act::WAIT_ACK;
+    p.actAt = nowMs() + ACK_TIMEOUT_MS;
+  }
+
+  // Tag off the reader (HOLD_STOP if a hold is open or asked for)
+  void liftTag(Station& s) {
+    if (s.holdId) {
+      LootHoldStopPayload r{};
+      r.holdId = s.holdId;
+      send(s, (uint8_t)MsgType::LOOT_HOLD_STOP, &r, sizeof(r));
+    }
+    s.holdActive = false;
+    s.holdId     = 0;
+  }
+
+  void leave(Player& p, uint32_t now) {
+    if (p.loot >= 0 && st[p.loot].player == (int)(&p - &pl[0])) st[p.loot].player = -1;
+    const uint32_t walk = range(room.cfg_.player.walkMinMs, room.cfg_.player.walkMaxMs);
+    if (p.carried) { p.act = Act::TO_DROP; p.actAt = now + walk; }
+    else           { p.act = Act::IDLE;    p.actAt = now; }
+  }
+
+  void accepted(Station& s) {
+    Player* p = holder(s);
+    if (!p || p->act != Act::WAIT_ACK) { liftTag(s); return; }
+    p->act     = Act::HOLDING;
+    p->carried = s.carried;
+    p->gainAt  = nowMs();
+    const uint32_t t = (uint32_t)s.maxCarry * room.cfg_.player.carryPct / 100;
+    p->target  = (uint8_t)(t ? t : 1);
+    if (p->carried >= p->target) { liftTag(s); leave(*p, nowMs()); }
+  }
+
+  void denied(Station& s, uint8_t reason) {
+    s.holdId = 0;
+    Player* p = holder(s);
+    if (!p || p->act != Act::WAIT_ACK) return;
+    p->carried = s.carried;
+    if (reason == 2 || reason == 6) { p->act = Act::AT_LOOT; p->actAt = nowMs() + RECHECK_MS; return; }
+    leave(*p, nowMs());
+  }
+
+  void tick(Station& s, uint8_t carried) {
+    s.carried = carried;
+    Player* p = holder(s);
+    if (!p || p->act != Act::HOLDING) return;
+    if (carried > p->carried) p->gainAt = nowMs();
+    p->carried = carried;
+    if (carried >= p->target) { liftTag(s); leave(*p, nowMs()); }
+  }
+
+  void endHold(Station& s) {
+    s.holdActive = false;
+    s.holdId     = 0;
+    Player* p = holder(s);
+    if (!p || (p->act != Act::HOLDING && p->act != Act::WAIT_ACK)) return;
+    p->carried = s.carried;
+    leave(*p, nowMs());
+  }
+
+  void dropped(Player& p, uint16_t n) {
+    if (p.act != Act::WAIT_DROP) return;
+    // Refused during RED: wait it out and drop again. Otherwise the server
+    // has nothing on this tag any more (e.g. the round restarted): walk on.
+    if (!n && p.carried && drop().light == (uint8_t)LightState::RED) {
+      p.act = Act::AT_DROP; p.actAt = nowMs() + RECHECK_MS; return;
+    }
+    p.carried = 0;
+    p.act     = Act::IDLE;
+    p.actAt   = nowMs();
+  }
+
+  // What this player sees (the ring of the reader it is at or heading to)
+  const Station& view(const Player& p) const { return st[p.loot >= 0 ? p.loot : 0]; }
+
+  bool anyMinigame() const {
+    for (uint8_t i = 0; i < loots(); ++i) if (st[i].mg) return true;
+    return false;
+  }
+
+  int pickLoot() {
+    int best = -1;
+    uint32_t bestScore = 0, ties = 0;
+    for (uint8_t i = 0; i < loots(); ++i) {
+      const Station& s = st[i];
+      if (s.player >= 0 || !s.active || s.mg || s.inv == 0) continue;
+      const uint32_t score = s.inv + ((s.bonus && room.cfg_.player.chaseBonus) ? 100000u : 0u);
+      if (score > bestScore)                              { best = i; bestScore = score; ties = 1; }
+      else if (score == bestScore && rngBelow(rng, ++ties) == 0) best = i;
+    }
+    return best;
+  }
+
+  void playerTick(Player& p, uint32_t now) {
+    const PlayerModel& m = room.cfg_.player;
+    const uint8_t light = view(p).light;
+    const bool stillOnYellow = m.stopOnYellow && light == (uint8_t)LightState::YELLOW;
+
+    if (light != p.seen) {
+      p.seen = light;
+      p.liftAt = 0;
+      if (light == (uint8_t)LightState::RED) {
+        p.freezeAt = now + react();
+      } else {
+        p.freezeAt = 0;
+        if (p.frozen) {                                  // walking resumes where it stopped
+          if (p.act == Act::TO_LOOT || p.act == Act::TO_DROP) p.actAt += now - p.frozenAt;
+          p.frozen = false;
+        }
+        if (stillOnYellow && p.act == Act::HOLDING) p.liftAt = now + react();
+      }
+    }
+
+    if (p.freezeAt && (int32_t)(now - p.freezeAt) >= 0) {
+      p.freezeAt = 0;
+      p.frozen   = true;
+      p.frozenAt = now;
+      if (p.act == Act::HOLDING || p.act == Act::WAIT_ACK) { liftTag(st[p.loot]); leave(p, now); }
+    }
+    if (p.liftAt && (int32_t)(now - p.liftAt) >= 0) {
+      p.liftAt = 0;
+      if (p.act == Act::HOLDING) { liftTag(st[p.loot]); leave(p, now); }
+    }
+    if (p.frozen || (int32_t)(now - p.actAt) < 0) return;
+
+    const bool red = (light == (uint8_t)LightState::RED);
+    switch (p.act) {
+      case Act::IDLE: {
+        const int i = anyMinigame() ? -1 : pickLoot();
+        if (i < 0) { p.actAt = now + RECHECK_MS; return; }
+        st[i].player = (int)(&p - &pl[0]);
+        p.loot  = i;
+        p.act   = Act::TO_LOOT;
+        p.actAt = now + range(m.walkMinMs, m.walkMaxMs);
+        return;
+      }
+      case Act::TO_LOOT:
+        p.act   = Act::AT_LOOT;
+        p.actAt = now + expo(m.tapMeanMs);
+        return;
+      case Act::AT_LOOT: {
+        Station& s = st[p.loot];
+        if (red || stillOnYellow || s.mg) { p.actAt = now + RECHECK_MS; return; }
+        if (!s.active || s.inv == 0) { leave(p, now); return; }
+        tapLoot(s, p);
+        return;
+      }
+      case Act::WAIT_ACK:                                // nothing came back: try again
+        liftTag(st[p.loot]);
+        p.act   = Act::AT_LOOT;
+        p.actAt = now + expo(m.tapMeanMs);
+        return;
+      case Act::HOLDING:                                 // e.g. its HOLD_END got lost
+        if (now - p.gainAt >= HOLD_STALL_MS) { liftTag(st[p.loot]); leave(p, now); return; }
+        p.actAt = now + RECHECK_MS;
+        return;
+      case Act::TO_DROP:
+        p.act   = Act::AT_DROP;
+        p.actAt = now + expo(m.tapMeanMs);
+        return;
+      case Act::AT_DROP:
+      case Act::WAIT_DROP: {
+        if (red) { p.actAt = now + RECHECK_MS; return; }
+        DropRequestPayload r{};
+        r.uid         = p.uid;
+        r.readerIndex = (uint8_t)(&p - &pl[0]);
+        send(drop(), (uint8_t)MsgType::DROP_REQUEST, &r, sizeof(r));
+        p.act   = Act::WAIT_DROP;
+        p.actAt = now + ACK_TIMEOUT_MS;
+        return;
+      }
+    }
+  }
+
+  bool moving() const {
+    for (const Player& p : pl) {
+      if (!p.frozen && (p.act == Act::TO_LOOT || p.act == Act::TO_DROP)) return true;
+    }
+    return false;
+  }
+
+  // ---- RoundStats ----
+  void noteStage(uint32_t now) {
+    RoomStats& s = room.st_;
+    if (g.phase != Phase::PLAYING) return;
+    const uint8_t kind = g.mgActive ? 2 : (g.bonusIntermission || g.bonusIntermission2) ? 1 : 0;
+    if (g.roundIndex > s.roundReached) s.roundReached = g.roundIndex;
+    if (kind == curKind && g.roundIndex == curRound && g.roundStartAt == curStart) return;
+
+    closeStage(now);
+    curKind   = kind;
+    curRound  = g.roundIndex;
+    curStart  = g.roundStartAt;
+    curGoal   = g.roundGoal;
+    curScore0 = g.teamScore;
+    curFromMs = now;
+    if (kind == 0 && curRound >= 1 && curRound <= ROUND_COUNT) s.rounds[curRound].attempts++;
+  }
+
+  void closeStage(uint32_t now) {
+    if (curKind != 0 || curRound < 1 || curRound > ROUND_COUNT) return;
+    RoundStats& r = room.st_.rounds[curRound];
+    r.scored   += g.teamScore - curScore0;
+    r.playedMs += now - curFromMs;
+    if (!r.goalAtMs && curGoal && g.teamScore >= curGoal) r.goalAtMs = now - curFromMs;
+    curKind = 0xFF;
+  }
+};
+
+/* ── Room ─────────────────────────────────────────────────── */
+Room::Room(const RoomConfig& cfg) : cfg_(cfg), im_(new Impl(*this)) {
+  rngSeed(im_->rng, cfg_.seed ^ 0x524F4F4Du);
+
+  for (uint8_t sid = 1; sid <= cfg_.stations; ++sid) {
+    Station s;
+    s.sid    = sid;
+    s.mac[5] = sid;
+    im_->st.push_back(s);
+  }
+  Station d;
+  d.sid    = TREX_DROPOFF_ID;
+  d.type   = (uint8_t)StationType::DROP;
+  d.mac[5] = TREX_DROPOFF_ID;
+  im_->st.push_back(d);
+
+  im_->pl.resize(cfg_.players);
+  for (uint8_t i = 0; i < cfg_.players; ++i) {
+    im_->pl[i].uid.len = 4;
+    im_->pl[i].uid.bytes[0] = 0xC0;
+    im_->pl[i].uid.bytes[3] = (uint8_t)(i + 1);
+  }
+}
+
+Room::~Room() {}
+
+uint32_t Room::gameMs() const { return im_->playing ? im_->nowMs() - im_->startMs : 0; }
+
+void Room::boot() {
+  if (im_->booted) return;
+  im_->booted = true;
+
+  hostSeedEspRandom(cfg_.seed);
+  hostSetPin(PIR_PIN, HIGH);
+  if (!cfg_.fsRoot.empty()) {
+    hostFsRoot(cfg_.fsRoot);
+    if (!cfg_.roundsCfg.empty()) {
+      FILE* f = fopen(hostFsPath("/rounds.cfg").c_str(), "wb");
+      if (f) { fputs(cfg_.roundsCfg.c_str(), f); fclose(f); }
+    }
+  }
+  Preferences p;
+  p.begin("trex", false);
+  p.putUChar("stations", cfg_.stations);
+  p.end();
+
+  hostSetTxSink([this](const HostFrame& f) { im_->onServerTx(f); });
+  setup();
+
+  // Stations come up with the server and say hello; Loots repeat it every
+  // HELLO_PERIOD_MS (they didn't all power up in the same second)
+  for (Station& s : im_->st) {
+    im_->hello(s);
+    s.helloAt = im_->nowMs() + im_->range(1000, HELLO_PERIOD_MS);
+  }
+  for (uint16_t i = 0; i < 20; ++i) step();
+}
+
+void Room::startGame() {
+  boot();
+  hostSerialFeed("SEED " + std::to_string(cfg_.seed) + "\n");
+  hostSerialFeed("n\n");
+  step();
+  im_->playing = true;
+  im_->startMs = im_->nowMs();
+  for (Player& p : im_->pl) {
+    const TrexUid uid = p.uid;
+    p = Player();
+    p.uid   = uid;
+    p.actAt = im_->startMs;
+  }
+}
+
+void Room::step() {
+  Impl& m = *im_;
+  const uint64_t at = hostNowUs() + cfg_.serverLoopUs;
+  m.deliverUntil(at);
+  hostSetNowUs(at);
+
+  const uint32_t now = m.nowMs();
+  for (Station& s : m.st) m.stationPass(s, now);
+  if (m.playing) {
+    for (Player& p : m.pl) m.playerTick(p, now);
+  }
+  m.deliverUntil(at);   // anything launched with no air time
+  hostSetPin(PIR_PIN, m.moving() ? LOW : HIGH);
+
+  using namespace std::chrono;
+  const auto t0 = steady_clock::now();
+  loop();
+  const uint32_t ns = (uint32_t)duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+  st_.loops++;
+  st_.loopNsSum += ns;
+  if (ns > st_.loopNsMax) st_.loopNsMax = ns;
+
+  if (m.playing && !st_.ended) m.noteStage(now);
+}
+
+bool Room::rebootStation(uint8_t sid, bool hello) {
+  Station* s = im_->bySid(sid);
+  if (!s || s->player >= 0 || s->holdId || s->holdActive) return false;
+  Station fresh;
+  fresh.sid  = s->sid;
+  fresh.type = s->type;
+  memcpy(fresh.mac, s->mac, 6);
+  fresh.seq     = s->seq;
+  fresh.holdSeq = s->holdSeq;
+  fresh.active  = true;              // the sketches keep gameActive across a reboot
+  fresh.helloAt = im_->nowMs() + HELLO_PERIOD_MS;
+  *s = fresh;
+  if (hello) im_->hello(*s);
+  return true;
+}
+
+StationDigest Room::stationDigest(uint8_t sid) const {
+  for (const Station& s : im_->st) if (s.sid == sid) return im_->digest(s);
+  StationDigest d;
+  memset(&d, 0, sizeof(d));
+  return d;
+}
+
+const RoomStats& Room::run() {
+  startGame();
+  while (!st_.ended && gameMs() < cfg_.gameLimitMs) step();
+  im_->closeStage(im_->nowMs());
+  st_.teamScore = g.teamScore;
+  st_.livesLost = (uint8_t)(g.livesMax - g.livesRemaining);
+  for (uint32_t end = im_->nowMs() + cfg_.tailMs; im_->nowMs() < end;) step();
+  return st_;
+}
+
+double airUs(uint32_t len) { return 192 + (39 + len) * 8.0; }
+
+const char* roomTypeName(uint8_t type) {
+  switch (type) {
+    case (uint8_t)MsgType::HELLO:             return "HELLO";
+    case (uint8_t)MsgType::STATE_TICK:        return "STATE_TICK";
+    case (uint8_t)MsgType::GAME_START:        return "GAME_START";
+    case (uint8_t)MsgType::GAME_OVER:         return "GAME_OVER";
+    case (uint8_t)MsgType::SCORE_UPDATE:      return "SCORE_UPDATE";
+    case (uint8_t)MsgType::STATION_UPDATE:    return "STATION_UPDATE";
+    case (uint8_t)MsgType::ROUND_STATUS:      return "ROUND_STATUS";
+    case (uint8_t)MsgType::BONUS_UPDATE:      return "BONUS_UPDATE";
+    case (uint8_t)MsgType::GAME_STATUS:       return "GAME_STATUS";
+    case (uint8_t)MsgType::LIVES_UPDATE:      return "LIVES_UPDATE";
+    case (uint8_t)MsgType::RADIO_CFG:         return "RADIO_CFG";
+    case (uint8_t)MsgType::SERVER_CMD:        return "SERVER_CMD";
+    case (uint8_t)MsgType::CONTROL_CMD:       return "CONTROL_CMD";
+    case (uint8_t)MsgType::LOOT_HOLD_START:   return "LOOT_HOLD_START";
+    case (uint8_t)MsgType::LOOT_HOLD_STOP:    return "LOOT_HOLD_STOP";
+    case (uint8_t)MsgType::LOOT_HOLD_ACK:     return "LOOT_HOLD_ACK";
+    case (uint8_t)MsgType::LOOT_TICK:         return "LOOT_TICK";
+    case (uint8_t)MsgType::HOLD_END:          return "HOLD_END";
+    case (uint8_t)MsgType::DROP_REQUEST:      return "DROP_REQUEST";
+    case (uint8_t)MsgType::DROP_RESULT:       return "DROP_RESULT";
+    case (uint8_t)MsgType::MG_START:          return "MG_START";
+    case (uint8_t)MsgType::MG_STOP:           return "MG_STOP";
+    case (uint8_t)MsgType::MG_RESULT:         return "MG_RESULT";
+    case (uint8_t)MsgTypeExt::WORLD_FRAME:    return "WORLD_FRAME";
+    case (uint8_t)MsgTypeExt::LOOT_TICK_BATCH: return "LOOT_TICK_BATCH";
+    case (uint8_t)MsgTypeExt::STATION_INVENTORY: return "STATION_INVENTORY";
+    case (uint8_t)MsgTypeExt::LIGHT_SCHEDULE: return "LIGHT_SCHEDULE";
+    case (uint8_t)MsgTypeExt::TIME_SYNC_REQ:  return "TIME_SYNC_REQ";
+    case (uint8_t)MsgTypeExt::TIME_SYNC_RESP: return "TIME_SYNC_RESP";
+    case (uint8_t)MsgTypeExt::STATE_HEARTBEAT: return "STATE_HEARTBEAT";
+    case (uint8_t)MsgTypeExt::STATION_RESYNC: return "STATION_RESYNC";
+    default:                                  return "?";
+  }
+}
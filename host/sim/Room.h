@@ -0,0 +1,148 @@
+#pragma once
+// The room around a host-built server: Loot stations, the Drop-off and the
+// players, talking to the real setup()/loop() over the shimmed radio.
+//
+// Time is the shim's virtual clock. step() runs one server loop() pass: it
+// delivers every frame that is due (to the server or to a station), lets the
+// stations and players act, sets the camera pin and calls loop(). Frames take
+// LinkModel's air time and may be lost; unicast gets MAC retries, broadcast
+// is one try per receiver.
+//
+// Stations follow what the sketches do on the wire (HELLO, hold start/stop,
+// heartbeats, LIGHT_SCHEDULE with a perfect clock, minigame result); players
+// are PlayerModel: how fast they tag on, how long they take to see RED, how
+// much they carry before walking to the Drop-off. Every random draw comes
+// from the room's own Rng, so a run repeats from (seed, config).
+//
+// The server keeps its state in file statics: one Room per process, and the
+// server's setup() runs once per process (Room::boot()).
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include "Host.h"
+#include "GameModel.h"
+#include "RoundTable.h"
+
+struct PlayerModel {
+  uint32_t tapMeanMs     = 700;    // at a reader -> tag on it (exponential)
+  uint32_t reactMeanMs   = 350;    // light turns RED -> player still (normal)
+  uint32_t reactSdMs     = 120;
+  uint8_t  lapsePct      = 2;      // REDs a player reacts 3x slower
+  uint8_t  carryPct      = 100;    // lift at this share of maxCarry
+  bool     stopOnYellow  = true;   // lift on YELLOW (else keep looting into it)
+  bool     chaseBonus    = true;   // go for bonus stations first
+  uint32_t walkMinMs     = 2000;   // reader <-> Drop-off
+  uint32_t walkMaxMs     = 4500;
+  uint8_t  mgSuccessPct  = 60;     // minigame attempts that land
+};
+
+struct LinkModel {
+  uint8_t  lossPct        = 0;     // per try, each direction
+  uint32_t airMinUs       = 1000;
+  uint32_t airMaxUs       = 4000;
+  uint8_t  macRetries     = 3;     // unicast tries after the first
+  uint32_t retryUs        = 1000;  // per retry
+};
+
+// When Loots and the Drop-off run their loop(). Off (maxUs 0), a station
+// handles a frame the moment it lands and acts every server pass; on, frames
+// wait in its queue for its next pass, like Transport::loop() drains them.
+struct StationLoopModel {
+  uint32_t minUs          = 0;     // between passes
+  uint32_t maxUs          = 0;
+  uint8_t  stallPct       = 0;     // passes that take stallUs instead (a long redraw, flash)
+  uint32_t stallUs        = 0;
+};
+
+struct RoomConfig {
+  uint32_t    seed          = 1;   // room and server (SEED) randomness
+  uint8_t     players       = 4;
+  uint8_t     stations      = DEFAULT_STATION_COUNT;
+  PlayerModel player;
+  LinkModel   link;
+  StationLoopModel stationLoop;
+  bool        heartbeats    = true;  // Loots send STATE_HEARTBEAT
+  uint32_t    serverLoopUs  = 1000;  // virtual time per loop() pass
+  uint32_t    gameLimitMs   = 7 * 60 * 1000;   // run() gives up after this
+  uint32_t    tailMs        = 1000;  // run() keeps going after GAME_OVER (journal flush)
+  std::string fsRoot;               // LittleFS directory ("" = none)
+  std::string roundsCfg;            // written to /rounds.cfg before boot
+};
+
+struct RoundStats {
+  uint32_t attempts    = 0;         // starts, including retries after a missed goal
+  uint32_t scored      = 0;         // team score gained in the round
+  uint32_t goalAtMs    = 0;         // round start -> goal met (0 = never)
+  uint32_t playedMs    = 0;
+};
+
+struct RoomStats {
+  bool       ended        = false;
+  uint8_t    reason       = 0xFF;   // GAME_OVER reason
+  uint32_t   endMs        = 0;      // game start -> GAME_OVER
+  uint32_t   teamScore    = 0;
+  uint8_t    roundReached = 0;
+  uint8_t    livesLost    = 0;
+  RoundStats rounds[ROUND_COUNT + 1];   // [1..ROUND_COUNT]
+
+  uint32_t   txFrames     = 0;      // server -> air
+  uint32_t   txBytes      = 0;
+  uint32_t   txByType[256] = {};
+  uint32_t   rxFrames     = 0;      // stations -> server (delivered)
+  uint32_t   lost         = 0;      // frames the link dropped (all tries)
+
+  uint32_t   loops        = 0;      // loop() passes and their real cost
+  uint64_t   loopNsSum    = 0;
+  uint32_t   loopNsMax    = 0;
+};
+
+class Room {
+public:
+  explicit Room(const RoomConfig& cfg);
+  ~Room();
+
+  // Server setup() plus station HELLOs; once per process
+  void boot();
+  // Seed and start a game the way an operator does (SEED <n>, then n)
+  void startGame();
+  // One loop() pass (cfg.serverLoopUs of virtual time)
+  void step();
+  // startGame(), then step() until GAME_OVER or gameLimitMs
+  const RoomStats& run();
+
+  const RoomStats&  stats() const  { return st_; }
+  const RoomConfig& config() const { return cfg_; }
+  uint32_t gameMs() const;         // virtual ms since startGame()
+
+  // Station `sid` restarts the way a sketch comes back mid-game: game on,
+  // nothing else known (no round, bonus, inventory or schedule). It says
+  // HELLO unless `hello` is false; its first heartbeat is STATE_HB_BOOT.
+  // False (and nothing happens) while a player is at it.
+  bool rebootStation(uint8_t sid, bool hello = true);
+  // What station `sid` believes, as its STATE_HEARTBEAT digest
+  StationDigest stationDigest(uint8_t sid) const;
+
+  // Every frame the server sent (before the link), in order
+  void onTx(std::function<void(const HostFrame&)> fn) { txTap_ = fn; }
+  // Every frame a station handed to the link for the server
+  void onStationTx(std::function<void(uint8_t sid, const uint8_t*, uint16_t)> fn) { stTap_ = fn; }
+  // Every server frame the link delivered to a station
+  void onStationRx(std::function<void(uint8_t sid, const uint8_t*, uint16_t)> fn) { srTap_ = fn; }
+
+  struct Impl;
+private:
+  RoomConfig cfg_;
+  RoomStats  st_;
+  std::function<void(const HostFrame&)> txTap_;
+  std::function<void(uint8_t, const uint8_t*, uint16_t)> stTap_;
+  std::function<void(uint8_t, const uint8_t*, uint16_t)> srTap_;
+  std::unique_ptr<Impl> im_;
+};
+
+// Message type name for reports
+const char* roomTypeName(uint8_t type);
+// Air time of one `len`-byte frame at 1 Mbps ESP-NOW: preamble plus MAC and
+// vendor overhead, the model the server's `status` uses (Net.cpp)
+double airUs(uint32_t len);
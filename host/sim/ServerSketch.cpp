@@ -0,0 +1,3 @@
+// The server sketch's own setup()/loop() and global Game, compiled as C++.
+// The .ino has no Arduino-generated prototypes to lean on, so it builds as is.
+#include "TREX_TrexServer.ino"
@@ -0,0 +1,21 @@
+#pragma once
+// Assertions for the host tests: a failed CHECK prints where and why and the
+// test carries on; checkExit() turns the failures into the exit code ctest
+// looks at.
+#include <stdio.h>
+
+static int sCheckFailures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+                      sCheckFailures++; } } while (0)
+
+// CHECK with the values that matter printed on failure
+#define CHECKF(cond, ...) \
+  do { if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+                      fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); sCheckFailures++; } } while (0)
+
+static inline int checkExit() {
+  printf("%s\n", sCheckFailures ? "FAILED" : "ok");
+  return sCheckFailures ? 1 : 0;
+}
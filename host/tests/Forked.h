@@ -0,0 +1,36 @@
+#pragma once
+// Runs a Room in a child process. The server keeps its state in file statics,
+// so a test that compares two configurations gives each its own process and
+// gets the result back as plain bytes over a pipe.
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <functional>
+#include <type_traits>
+
+template <class T>
+static bool forked(T& out, const std::function<T()>& fn) {
+  static_assert(std::is_trivially_copyable<T>::value, "result goes over a pipe");
+  int fds[2];
+  if (pipe(fds) != 0) return false;
+  fflush(stdout);
+  fflush(stderr);
+  const pid_t pid = fork();
+  if (pid < 0) return false;
+  if (pid == 0) {
+    close(fds[0]);
+    const T r = fn();
+    const bool ok = write(fds[1], &r, sizeof(r)) == (ssize_t)sizeof(r);
+    fflush(stdout);
+    _exit(ok ? 0 : 1);
+  }
+  close(fds[1]);
+  size_t got = 0;
+  ssize_t n;
+  uint8_t* p = (uint8_t*)&out;
+  while (got < sizeof(T) && (n = read(fds[0], p + got, sizeof(T) - got)) > 0) got += (size_t)n;
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return got == sizeof(T) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+// The game stage the server is in right now, for tests that break a game's
+// traffic down per stage: each round, the bonus intermissions and the
+// minigame, and everything outside PLAYING as "idle".
+#include "GameModel.h"
+
+extern Game g;
+
+enum { ST_IDLE, ST_R1, ST_R5 = ST_R1 + 4, ST_BONUS, ST_MG, ST_COUNT };
+static const char* const kStage[ST_COUNT] = { "idle", "R1", "R2", "R3", "R4", "R5", "bonus", "minigame" };
+
+static inline int stageNow() {
+  if (g.phase != Phase::PLAYING)                   return ST_IDLE;
+  if (g.mgActive)                                  return ST_MG;
+  if (g.bonusIntermission || g.bonusIntermission2) return ST_BONUS;
+  if (g.roundIndex >= 1 && g.roundIndex <= 5)      return ST_R1 + g.roundIndex - 1;
+  return ST_IDLE;
+}
@@ -0,0 +1,115 @@
+#pragma once
+// One Loot's clock and radio, for the tests that run the Loot's ClockSync /
+// LightSchedule (trex_loot_clock). The shim has one clock per process, so a
+// process is one station (fork one per station, tests/Forked.h).
+//
+// Time runs in "true" microseconds. The station's own clock (millis(),
+// esp_timer_get_time()) is  offset + true * (1 + ppm / 1e6);  the server's is
+// true minus its last boot. Each pass() moves true time on by one station
+// loop() gap, answers the TIME_SYNC_REQ the way the server does (t2 = when the
+// RX callback queued it, t3 = when loop() got to it) and hands the frames that
+// arrived during the gap to the caller.
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "Host.h"
+#include "ClockSync.h"
+
+struct StationLink {
+  uint32_t airMinUs   = 1000;   // radio, per frame
+  uint32_t airMaxUs   = 3000;
+  uint32_t queueMeanUs = 0;     // exponential queueing delay on top (0 = none)
+  uint8_t  lossPct    = 0;      // per frame, each direction
+  uint32_t serverLoopUs = 2000; // t2 -> t3
+};
+
+struct StationClockCfg {
+  uint32_t seed      = 1;
+  int64_t  offsetUs  = 0;       // station clock at true 0
+  double   ppm       = 0;       // station clock rate error
+  uint32_t loopMinUs = 1000;    // station loop() gap
+  uint32_t loopMaxUs = 4000;
+  StationLink link;
+};
+
+class StationClock {
+public:
+  explicit StationClock(const StationClockCfg& c) : c_(c), rng_(c.seed) { setClock(0); }
+
+  uint64_t trueUs() const { return t_; }
+  uint32_t serverMs() const { return serverMsAt(t_); }
+  uint32_t serverMsAt(uint64_t t) const { return (uint32_t)((t - serverBootUs_) / 1000); }
+  // Server restarts now: its millis() starts over from 0
+  void serverReboot() { serverBootUs_ = t_; }
+
+  // A server frame sent at true time `sentUs`: arrives after the radio delay,
+  // unless the link drops it (or `drop`)
+  void send(uint64_t sentUs, const std::vector<uint8_t>& frame, bool drop = false) {
+    if (drop || lost()) return;
+    inbox_.push_back(Pending{ sentUs + delayUs(), frame });
+  }
+
+  // One station loop() pass; `onFrame(data)` for each frame that arrived
+  template <class F>
+  void pass(F onFrame) {
+    t_ += range(c_.loopMinUs, c_.loopMaxUs);
+    // Time sync answers go through the RX callback at their arrival
+    std::sort(resp_.begin(), resp_.end(), [](const Resp& a, const Resp& b) { return a.atUs < b.atUs; });
+    while (!resp_.empty() && resp_.front().atUs <= t_) {
+      setClock(resp_.front().atUs);
+      clockSyncOnResp(resp_.front().p);
+      resp_.erase(resp_.begin());
+    }
+    setClock(t_);
+    std::stable_sort(inbox_.begin(), inbox_.end(),
+                     [](const Pending& a, const Pending& b) { return a.atUs < b.atUs; });
+    size_t n = 0;
+    while (n < inbox_.size() && inbox_[n].atUs <= t_) ++n;
+    std::vector<Pending> due(inbox_.begin(), inbox_.begin() + n);
+    inbox_.erase(inbox_.begin(), inbox_.begin() + n);
+    for (const Pending& p : due) onFrame(p.frame);
+
+    TimeSyncReqPayload req;
+    if (clockSyncDue(millis(), req) && !lost()) {
+      const uint64_t atServer = t_ + delayUs();
+      const uint64_t sentBack = atServer + range(0, c_.link.serverLoopUs);
+      if (!lost()) {
+        TimeSyncRespPayload r;
+        memset(&r, 0, sizeof(r));
+        r.t1Us = req.t1Us;
+        r.t2Us = atServer - serverBootUs_;
+        r.t3Us = sentBack - serverBootUs_;
+        resp_.push_back(Resp{ sentBack + delayUs(), r });
+      }
+    }
+  }
+
+  // serverNow() minus the server's real millis(), in ms
+  int32_t errMs() const { return (int32_t)(serverNow() - serverMs()); }
+
+private:
+  struct Pending { uint64_t atUs; std::vector<uint8_t> frame; };
+  struct Resp    { uint64_t atUs; TimeSyncRespPayload p; };
+
+  void setClock(uint64_t t) {
+    hostSetNowUs((uint64_t)(c_.offsetUs + (int64_t)t + llround((double)t * c_.ppm / 1e6)));
+  }
+  uint32_t range(uint32_t lo, uint32_t hi) {
+    return std::uniform_int_distribution<uint32_t>(lo, hi)(rng_);
+  }
+  bool lost() { return c_.link.lossPct && range(0, 99) < c_.link.lossPct; }
+  uint32_t delayUs() {
+    uint32_t d = range(c_.link.airMinUs, c_.link.airMaxUs);
+    if (c_.link.queueMeanUs) d += (uint32_t)std::exponential_distribution<double>(1.0 / c_.link.queueMeanUs)(rng_);
+    return d;
+  }
+
+  StationClockCfg c_;
+  std::mt19937 rng_;
+  uint64_t t_ = 0, serverBootUs_ = 0;
+  std::vector<Pending> inbox_;
+  std::vector<Resp> resp_;
+};
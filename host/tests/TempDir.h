@@ -0,0 +1,30 @@
+#pragma once
+// A fresh directory under /tmp for the server's LittleFS (journal, snapshot,
+// rounds.cfg), removed with everything in it when the TempDir goes out of
+// scope. Inside forked(), keep it in the child's function so the child
+// cleans up before it exits.
+#include <stdio.h>
+#include <stdlib.h>
+#include <ftw.h>
+#include <string>
+
+class TempDir {
+public:
+  explicit TempDir(const char* prefix = "trex_test") {
+    std::string tmpl = std::string("/tmp/") + prefix + ".XXXXXX";
+    if (mkdtemp(&tmpl[0])) path_ = tmpl;
+    else perror("mkdtemp");
+  }
+  ~TempDir() {
+    if (!path_.empty()) nftw(path_.c_str(), removeEntry, 8, FTW_DEPTH | FTW_PHYS);
+  }
+  TempDir(const TempDir&) = delete;
+  TempDir& operator=(const TempDir&) = delete;
+
+  explicit operator bool() const { return !path_.empty(); }
+  const std::string& path() const { return path_; }
+
+private:
+  static int removeEntry(const char* p, const struct stat*, int, struct FTW*) { return ::remove(p); }
+  std::string path_;
+};
@@ -0,0 +1,16 @@
+# trex_balance twice over the same seeds, once on one job and once on four:
+# the reports must match byte for byte.
+execute_process(COMMAND ${BALANCE} --sets ${SETS} --games 4 --seed 11 --jobs 1
+                OUTPUT_VARIABLE one RESULT_VARIABLE rc1)
+execute_process(COMMAND ${BALANCE} --sets ${SETS} --games 4 --seed 11 --jobs 4
+                OUTPUT_VARIABLE four RESULT_VARIABLE rc4)
+if(NOT rc1 EQUAL 0 OR NOT rc4 EQUAL 0)
+  message(FATAL_ERROR "trex_balance failed: ${rc1} / ${rc4}")
+endif()
+if(NOT one STREQUAL four)
+  message(FATAL_ERROR "reports differ\n--- jobs 1\n${one}\n--- jobs 4\n${four}")
+endif()
+if(NOT one MATCHES "\\[baseline\\] games=4" OR NOT one MATCHES "\\[tight\\] games=4")
+  message(FATAL_ERROR "unexpected report\n${one}")
+endif()
+message("${one}")
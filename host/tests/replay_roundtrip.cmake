@@ -0,0 +1,19 @@
+# trex_sim plays a game (with 10% loss, so there are retries),
+# trex_replay re-drives a fresh server with its journal: every record,
+# including the per-second TX hashes, must come out the same.
+file(REMOVE_RECURSE ${WORK})
+file(MAKE_DIRECTORY ${WORK})
+execute_process(COMMAND ${SIM} --seed 5 --loss 10 --fs ${WORK}
+                OUTPUT_VARIABLE simOut RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+  message(FATAL_ERROR "trex_sim failed (${rc})\n${simOut}")
+endif()
+execute_process(COMMAND ${REPLAY} ${WORK}/journal.bin
+                OUTPUT_VARIABLE out RESULT_VARIABLE rc)
+message("${out}")
+if(NOT rc EQUAL 0 OR NOT out MATCHES "replay identical")
+  message(FATAL_ERROR "replay differs (${rc})")
+endif()
+if(out MATCHES "\\(0 TX windows\\)")
+  message(FATAL_ERROR "journal has no TX windows")
+endif()
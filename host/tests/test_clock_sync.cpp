@@ -0,0 +1,104 @@
+// Station clock sync (user-023): the Loot's ClockSync against a server over a
+// link with 10% loss each way and an exponential queueing delay (mean 0.5 ms)
+// on top of the ~0.8 ms a sync frame spends on air, stations at -150 / 0 /
+// +150 ppm, and the server rebooting half way. Each run is one station in its
+// own process (tests/StationClock.h). Checked:
+//   - synced (clockSynced()) in about 1 s in the median run, 2 s in every run:
+//     it takes CLOCK_SYNC_MIN_SAMPLES answers at CLOCK_SYNC_FAST_MS, 0.76 s
+//     with no loss and 250 ms more per lost exchange
+//   - serverNow() within 2 ms of the server's millis() from then on (both
+//     sides truncate to 1 ms, so 2 ms is the floor here)
+//   - after the reboot, back within 2 ms in under 5 s and staying there
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "StationClock.h"
+#include "Check.h"
+#include "Forked.h"
+
+static const uint32_t kRunMs    = 120000;
+static const uint32_t kRebootMs = 60000;
+static const uint32_t kSeeds    = 40;
+
+struct ClockResult {
+  uint32_t syncedAtMs;      // first clockSynced(), 0 = never
+  int32_t  maxErrMs;        // |serverNow() - server millis()| once synced, before the reboot
+  uint32_t recoverMs;       // reboot -> within 2 ms for good, 0 = never
+  int32_t  maxErrAfterMs;   // once recovered
+};
+
+static ClockResult run(double ppm, int64_t offsetUs, uint32_t seed) {
+  ClockResult r;
+  memset(&r, 0, sizeof(r));
+  StationClockCfg cfg;
+  cfg.seed             = seed;
+  cfg.ppm              = ppm;
+  cfg.offsetUs         = offsetUs;
+  cfg.link.airMinUs    = 700;
+  cfg.link.airMaxUs    = 900;
+  cfg.link.queueMeanUs = 500;
+  cfg.link.lossPct     = 10;
+  StationClock st(cfg);
+
+  bool rebooted = false;
+  uint32_t lastBadMs = 0;
+  int32_t  maxAfter  = 0;   // since lastBadMs
+  while (st.trueUs() < (uint64_t)kRunMs * 1000) {
+    st.pass([](const std::vector<uint8_t>&) {});
+    const uint32_t tMs = (uint32_t)(st.trueUs() / 1000);
+    if (!rebooted && tMs >= kRebootMs) { st.serverReboot(); rebooted = true; }
+    if (!clockSynced()) {
+      if (rebooted) { lastBadMs = tMs; maxAfter = 0; }
+      continue;
+    }
+    if (!r.syncedAtMs) r.syncedAtMs = tMs;
+    const int32_t err = abs(st.errMs());
+    if (!rebooted) {
+      if (err > r.maxErrMs) r.maxErrMs = err;
+    } else if (err > 2) {
+      lastBadMs = tMs;
+      maxAfter  = 0;
+    } else if (err > maxAfter) {
+      maxAfter = err;
+    }
+  }
+  if (lastBadMs + 10000 < kRunMs) r.recoverMs = lastBadMs > kRebootMs ? lastBadMs - kRebootMs : 1;
+  r.maxErrAfterMs = maxAfter;
+  return r;
+}
+
+int main() {
+  static const double  kPpm[]    = { -150, 0, 150 };
+  static const int64_t kOffset[] = { 5000000, 123456789, 40000000000LL };
+  std::vector<uint32_t> synced;
+  printf("ppm   runs  synced max  max err  reboot->ok max  max err after\n");
+  for (int i = 0; i < 3; ++i) {
+    ClockResult worst;
+    memset(&worst, 0, sizeof(worst));
+    for (uint32_t seed = 1; seed <= kSeeds; ++seed) {
+      ClockResult r;
+      CHECK(forked<ClockResult>(r, [i, seed] { return run(kPpm[i], kOffset[i], seed); }));
+      synced.push_back(r.syncedAtMs ? r.syncedAtMs : UINT32_MAX);
+      worst.syncedAtMs    = std::max(worst.syncedAtMs, r.syncedAtMs);
+      worst.maxErrMs      = std::max(worst.maxErrMs, r.maxErrMs);
+      worst.recoverMs     = std::max(worst.recoverMs, r.recoverMs);
+      worst.maxErrAfterMs = std::max(worst.maxErrAfterMs, r.maxErrAfterMs);
+      CHECKF(r.syncedAtMs > 0 && r.syncedAtMs <= 2000, "%+.0f ppm seed %lu: synced at %lu ms", kPpm[i],
+             (unsigned long)seed, (unsigned long)r.syncedAtMs);
+      CHECKF(r.maxErrMs <= 2, "%+.0f ppm seed %lu: off by %ld ms", kPpm[i], (unsigned long)seed,
+             (long)r.maxErrMs);
+      CHECKF(r.recoverMs > 0 && r.recoverMs <= 5000, "%+.0f ppm seed %lu: %lu ms to recover from the reboot",
+             kPpm[i], (unsigned long)seed, (unsigned long)r.recoverMs);
+      CHECKF(r.maxErrAfterMs <= 2, "%+.0f ppm seed %lu: off by %ld ms after the reboot", kPpm[i],
+             (unsigned long)seed, (long)r.maxErrAfterMs);
+    }
+    printf("%+4.0f  %4lu  %8lums  %5ldms  %12lums  %11ldms\n", kPpm[i], (unsigned long)kSeeds,
+           (unsigned long)worst.syncedAtMs, (long)worst.maxErrMs, (unsigned long)worst.recoverMs,
+           (long)worst.maxErrAfterMs);
+  }
+  std::sort(synced.begin(), synced.end());
+  const uint32_t p50 = synced[synced.size() / 2];
+  printf("synced at p50=%lums max=%lums\n", (unsigned long)p50, (unsigned long)synced.back());
+  CHECKF(p50 <= 1100, "median sync %lu ms", (unsigned long)p50);
+  return checkExit();
+}
@@ -0,0 +1,264 @@
+// LIGHT_SCHEDULE (user-022): three Loots with different clock offsets follow
+// the same server plan over a 1-3 ms radio, each with 1-4 ms between loop()
+// passes, and handle frames the way LootRx does (WORLD_FRAME: note the epoch,
+// then the frame light unless the schedule owns it; LIGHT_SCHEDULE: take it
+// and poll; poll again every pass). The server sends the schedule (current
+// segment + the next 4) at every flip and a WORLD_FRAME once a second; half
+// way it breaks its plan (new epoch, 3 copies 12 ms apart) and station 3
+// loses all three copies. 40 plans; checked:
+//   - every flip the stations knew ahead of time lands on all of them within
+//     5 ms of each other, 4 ms for 99% of flips (a loop() gap of up to 4 ms
+//     plus each station's serverNow() error)
+//   - station 3 keeps the stale plan until the next WORLD_FRAME, drops it on
+//     the epoch there and shows the frame's light, flips within 10 ms of the
+//     next planned flip (the schedule sent at it) and is back in step after
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "StationClock.h"
+#include "LightSchedule.h"
+#include "TrexProtocolExt.h"
+#include "Check.h"
+#include "Forked.h"
+
+static const uint32_t kRunMs     = 60000;
+static const uint32_t kPlanMs    = 4000;    // first schedule; stations are synced by then
+static const uint32_t kFrameMs   = 1000;    // WORLD_FRAME period (tickHz 1, the slowest)
+static const uint8_t  kAhead     = 4;       // CADENCE_PLAN_LEN
+static const uint8_t  kCopies    = 3;       // a correction goes out 3x...
+static const uint32_t kCopyGapMs = 12;      // ...12 ms apart
+static const uint8_t  kStations  = 3;
+static const uint8_t  kDeaf      = 2;       // station 3 misses the correction
+static const uint32_t kPlans     = 40;
+static const uint32_t kMaxSpreadUs  = 5000;
+static const uint32_t kMaxCatchUpUs = 10000;
+
+struct Seg { uint32_t atMs; uint8_t light; uint16_t epoch; };
+
+struct ServerFrame { uint32_t atMs; std::vector<uint8_t> data; bool correction; };
+
+struct Plan {
+  std::vector<Seg> segs;      // what the server actually shows, in order
+  size_t fix;                 // index of the correction segment
+  std::vector<ServerFrame> frames;
+};
+
+static uint8_t otherLight(std::mt19937& rng, uint8_t not1) {
+  uint8_t l;
+  do l = (uint8_t)std::uniform_int_distribution<int>(0, 2)(rng); while (l == not1);
+  return l;
+}
+
+static std::vector<uint8_t> frame(MsgTypeExt type, const void* payload, uint16_t len) {
+  std::vector<uint8_t> d(sizeof(MsgHeader) + len);
+  MsgHeader h;
+  memset(&h, 0, sizeof(h));
+  h.version    = TREX_PROTO_VERSION;
+  h.type       = (uint8_t)type;
+  h.payloadLen = len;
+  memcpy(d.data(), &h, sizeof(h));
+  memcpy(d.data() + sizeof(h), payload, len);
+  return d;
+}
+
+// Schedule as sent at segment `i`: it and the next kAhead of the same epoch
+static std::vector<uint8_t> schedule(const std::vector<Seg>& segs, size_t i) {
+  uint8_t buf[sizeof(LightSchedulePayload) + LIGHT_SCHEDULE_MAX * sizeof(LightScheduleEntry)];
+  LightSchedulePayload p;
+  memset(&p, 0, sizeof(p));
+  p.epoch = segs[i].epoch;
+  for (size_t j = i; j < segs.size() && j <= i + kAhead && segs[j].epoch == p.epoch; ++j) {
+    const LightScheduleEntry e = { segs[j].atMs, segs[j].light };
+    memcpy(buf + sizeof(p) + p.count * sizeof(e), &e, sizeof(e));
+    p.count++;
+  }
+  memcpy(buf, &p, sizeof(p));
+  return frame(MsgTypeExt::LIGHT_SCHEDULE, buf, sizeof(p) + p.count * sizeof(LightScheduleEntry));
+}
+
+static Plan makePlan(uint32_t seed) {
+  Plan pl;
+  std::mt19937 rng(seed);
+  auto segMs = [&] { return std::uniform_int_distribution<uint32_t>(1500, 4000)(rng); };
+
+  // Epoch 1 to the end, then cut mid-segment around half way and redrawn
+  std::vector<Seg> e1;
+  uint8_t light = (uint8_t)LightState::GREEN;
+  for (uint32_t t = kPlanMs; t < kRunMs; t += segMs()) {
+    light = otherLight(rng, light);
+    e1.push_back(Seg{ t, light, 1 });
+  }
+  size_t cut = 0;
+  while (e1[cut + 1].atMs <= kRunMs / 2) ++cut;
+  const uint32_t fixMs = e1[cut].atMs + (e1[cut + 1].atMs - e1[cut].atMs) / 2;
+  pl.segs.assign(e1.begin(), e1.begin() + cut + 1);
+  pl.fix = pl.segs.size();
+  light = otherLight(rng, e1[cut].light);
+  pl.segs.push_back(Seg{ fixMs, light, 2 });
+  for (uint32_t t = fixMs + segMs(); t < kRunMs; t += segMs()) {
+    light = otherLight(rng, light);
+    pl.segs.push_back(Seg{ t, light, 2 });
+  }
+
+  // The schedule at each flip (epoch 1 from the old plan, which the server
+  // had sent before the cut), the correction's copies, WORLD_FRAME every kFrameMs
+  for (size_t i = 0; i < pl.segs.size(); ++i) {
+    const bool fix = i == pl.fix;
+    const std::vector<uint8_t> s = i < pl.fix ? schedule(e1, i) : schedule(pl.segs, i);
+    for (uint8_t c = 0; c < (fix ? kCopies : 1); ++c) {
+      pl.frames.push_back(ServerFrame{ pl.segs[i].atMs + c * kCopyGapMs, s, fix });
+    }
+  }
+  for (uint32_t t = kFrameMs; t < kRunMs; t += kFrameMs) {
+    WorldFramePayload w;
+    memset(&w, 0, sizeof(w));
+    w.frameVersion = WORLD_FRAME_VERSION;
+    w.phase        = 1;
+    w.lightState   = (uint8_t)LightState::GREEN;
+    w.serverNowMs  = t;
+    for (const Seg& s : pl.segs) {
+      if (s.atMs > t) break;
+      w.lightState = s.light;
+      w.schedEpoch = s.epoch;
+    }
+    pl.frames.push_back(ServerFrame{ t, frame(MsgTypeExt::WORLD_FRAME, &w, sizeof(w)), false });
+  }
+  return pl;
+}
+
+struct Trace {
+  uint16_t n;
+  struct { uint64_t atUs; uint8_t light; } ch[64];   // light changes, true time
+};
+
+static Trace station(const Plan& pl, uint32_t seed, uint8_t idx) {
+  static const int64_t kOffset[kStations] = { 5000000, 123456789, 40000000000LL };
+  Trace tr;
+  memset(&tr, 0, sizeof(tr));
+  StationClockCfg cfg;
+  cfg.seed     = seed * kStations + idx;
+  cfg.offsetUs = kOffset[idx];
+  StationClock st(cfg);
+  for (const ServerFrame& f : pl.frames) st.send((uint64_t)f.atMs * 1000, f.data, f.correction && idx == kDeaf);
+
+  uint8_t shown = 0xFF;
+  auto apply = [&](uint8_t light) {
+    if (light == shown) return;
+    shown = light;
+    if (tr.n < sizeof(tr.ch) / sizeof(tr.ch[0])) tr.ch[tr.n++] = { st.trueUs(), light };
+  };
+  auto onFrame = [&](const std::vector<uint8_t>& d) {
+    const auto* h = (const MsgHeader*)d.data();
+    const uint8_t* payload = d.data() + sizeof(MsgHeader);
+    uint8_t light;
+    if (h->type == (uint8_t)MsgTypeExt::WORLD_FRAME) {
+      const auto* p = (const WorldFramePayload*)payload;
+      schedNoteEpoch(p->schedEpoch);
+      if (!schedOverrides(p->lightState)) apply(p->lightState);
+    } else if (h->type == (uint8_t)MsgTypeExt::LIGHT_SCHEDULE) {
+      schedRx(payload, h->payloadLen);
+      if (schedPoll(light)) apply(light);
+    }
+  };
+  while (st.trueUs() < (uint64_t)kRunMs * 1000) {
+    st.pass(onFrame);
+    uint8_t light;
+    if (schedPoll(light)) apply(light);
+  }
+  return tr;
+}
+
+// The light station trace `tr` shows at true time `us`
+static uint8_t shownAt(const Trace& tr, uint64_t us) {
+  uint8_t l = 0xFF;
+  for (uint16_t i = 0; i < tr.n && tr.ch[i].atUs <= us; ++i) l = tr.ch[i].light;
+  return l;
+}
+
+// When station `tr` changed to `light` within 50 ms of `atMs`, 0 if it didn't
+static uint64_t flipAt(const Trace& tr, uint32_t atMs, uint8_t light) {
+  for (uint16_t i = 0; i < tr.n; ++i) {
+    const int64_t d = (int64_t)tr.ch[i].atUs - (int64_t)atMs * 1000;
+    if (tr.ch[i].light == light && d > -5000 && d < 50000) return tr.ch[i].atUs;
+  }
+  return 0;
+}
+
+struct RunResult {
+  uint32_t flips;
+  uint32_t spreadMaxUs;
+  uint32_t catchUpUs;   // station 3's first flip after the correction, past its time
+};
+
+static RunResult check(uint32_t seed, std::vector<uint32_t>& spreads) {
+  RunResult r;
+  memset(&r, 0, sizeof(r));
+  const Plan pl = makePlan(seed);
+  Trace tr[kStations];
+  for (uint8_t i = 0; i < kStations; ++i) {
+    CHECK(forked<Trace>(tr[i], [&pl, seed, i] { return station(pl, seed, i); }));
+  }
+
+  const Seg& fix = pl.segs[pl.fix];
+  const uint32_t frameMs = (fix.atMs / kFrameMs + 1) * kFrameMs;   // first WORLD_FRAME after it
+  CHECK(pl.fix + 1 < pl.segs.size() && frameMs < pl.segs[pl.fix + 1].atMs);
+
+  // Flips announced ahead: all stations within kMaxSpreadUs. Not the first
+  // schedule or the correction (those flip on arrival), nor station 3's
+  // catch-up flip on the schedule after the correction
+  for (size_t k = 1; k < pl.segs.size(); ++k) {
+    if (k == pl.fix) continue;
+    uint64_t lo = UINT64_MAX, hi = 0;
+    for (uint8_t i = 0; i < kStations; ++i) {
+      if (i == kDeaf && k == pl.fix + 1) continue;
+      const uint64_t at = flipAt(tr[i], pl.segs[k].atMs, pl.segs[k].light);
+      CHECKF(at, "plan %lu: station %u missed the flip at %lu ms", (unsigned long)seed, (unsigned)i + 1,
+             (unsigned long)pl.segs[k].atMs);
+      if (!at) continue;
+      lo = std::min(lo, at);
+      hi = std::max(hi, at);
+    }
+    if (hi < lo) continue;
+    r.flips++;
+    spreads.push_back((uint32_t)(hi - lo));
+    r.spreadMaxUs = std::max(r.spreadMaxUs, (uint32_t)(hi - lo));
+    CHECKF(hi - lo <= kMaxSpreadUs, "plan %lu: flip at %lu ms, stations %.1f ms apart", (unsigned long)seed,
+           (unsigned long)pl.segs[k].atMs, (hi - lo) / 1000.0);
+  }
+  CHECKF(r.flips >= 15, "plan %lu: only %lu flips", (unsigned long)seed, (unsigned long)r.flips);
+
+  // Station 3: stale until the WORLD_FRAME, on the frame's light after it,
+  // the next flip from the schedule that follows
+  const Trace& deaf = tr[kDeaf];
+  const Seg& prev = pl.segs[pl.fix - 1];
+  const Seg& next = pl.segs[pl.fix + 1];
+  const uint64_t fixUs = (uint64_t)fix.atMs * 1000, frameUs = (uint64_t)frameMs * 1000;
+  CHECKF(shownAt(deaf, std::min(fixUs + 50000, frameUs)) == prev.light,
+         "plan %lu: station 3 left the old plan before the frame", (unsigned long)seed);
+  CHECKF(shownAt(deaf, frameUs + 20000) == fix.light, "plan %lu: station 3 not on %u after the frame at %lu ms",
+         (unsigned long)seed, (unsigned)fix.light, (unsigned long)frameMs);
+  const uint64_t caught = flipAt(deaf, next.atMs, next.light);
+  r.catchUpUs = caught ? (uint32_t)(caught - std::min(caught, (uint64_t)next.atMs * 1000)) : UINT32_MAX;
+  CHECKF(r.catchUpUs <= kMaxCatchUpUs, "plan %lu: station 3 caught up %.1f ms late", (unsigned long)seed,
+         r.catchUpUs / 1000.0);
+  return r;
+}
+
+int main() {
+  std::vector<uint32_t> spreads;
+  uint32_t flips = 0, catchUpMax = 0;
+  for (uint32_t seed = 1; seed <= kPlans; ++seed) {
+    const RunResult r = check(seed, spreads);
+    flips += r.flips;
+    catchUpMax = std::max(catchUpMax, r.catchUpUs);
+  }
+  std::sort(spreads.begin(), spreads.end());
+  const uint32_t p50 = spreads[spreads.size() / 2], p99 = spreads[spreads.size() * 99 / 100];
+  printf("plans=%lu flips=%lu spread p50=%.1fms p99=%.1fms max=%.1fms; station 3 caught up <= %.1fms late\n",
+         (unsigned long)kPlans, (unsigned long)flips, p50 / 1000.0, p99 / 1000.0, spreads.back() / 1000.0,
+         catchUpMax / 1000.0);
+  CHECKF(p99 <= 4000, "spread p99 %.1f ms", p99 / 1000.0);
+  return checkExit();
+}
@@ -0,0 +1,175 @@
+// Rejoin (user-025): Loots rebooted mid-game, one at a time, about once a
+// second, in full games against the real server. Radio 1-4 ms (unicast with
+// the MAC's retries), server loop() every 2 ms, station loop() every 1-8 ms
+// with 5% of passes stalling 30 ms. For each reboot:
+//   correct  = reboot -> the Loot's digest is what the server holds for it
+//   confirm  = correct -> the server has its matching heartbeat (`sync` ok)
+// Checked, per arm (3 games, ~1000 reboots each):
+//   - 0% loss, HELLO at boot: p50 <= 10 ms, p99 <= 40 ms (the stalls are
+//     most of the tail), confirmed within 60 ms of correct
+//   - no HELLO (as if lost): the STATE_HB_BOOT heartbeat alone, about as fast
+//   - 10% loss: p50 <= 12 ms, p95 <= 60 ms, p99 <= 400 ms. The rest lost the
+//     HELLO and the boot heartbeat both and wait for the next heartbeat
+//     (STATE_HB_CONFIRM_MS, then a resync) or the broadcasts; every reboot
+//     is correct within 5 s and confirmed within 400 ms of that
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "Room.h"
+#include "Check.h"
+#include "Forked.h"
+
+extern Game g;
+
+static const uint32_t kSeeds     = 3;
+static const uint32_t kMaxRuns   = 400;     // reboots per game kept
+static const uint32_t kGiveUpMs  = 6000;    // not correct by then: counted at this
+
+struct Arm {
+  const char* name;
+  uint8_t     lossPct;
+  bool        hello;
+  uint32_t    p50Ms, p95Ms, p99Ms, maxMs;   // reboot -> correct
+  uint32_t    confirmMs;                   // correct -> confirmed, worst
+};
+
+static const Arm kArms[] = {
+  { "0% loss",           0, true,  10, 40,  40,   60,  60 },
+  { "10% loss",         10, true,  12, 60, 400, 5000, 400 },
+  { "0% loss, no HELLO", 0, false, 12, 40,  45,   60,  60 },
+};
+
+struct Game1 {
+  uint32_t n;
+  uint16_t correctMs[kMaxRuns];
+  uint16_t confirmMs[kMaxRuns];   // after correct, 0xFFFF = never
+  uint32_t resyncs;               // STATION_RESYNC sent for these reboots
+  uint8_t  ended;
+};
+
+static StationDigest expected(uint8_t sid) {
+  StationDigest d;
+  memset(&d, 0, sizeof(d));
+  d.phase      = (uint8_t)g.phase;
+  d.light      = (uint8_t)g.light;
+  d.roundIndex = g.roundIndex;
+  d.bonusMask  = g.bonusActiveMask & (1u << sid);
+  if (isLiveStation(g, sid)) {
+    d.inventory = g.stationInventory[sid];
+    d.capacity  = g.stationCapacity[sid];
+  }
+  return d;
+}
+
+// `sync` says "  sid=<n> ok hash=.. heard <ms>ms ago" once the server has
+// the heartbeat it wants; it has to be one sent since the reboot
+static bool serverConfirmed(uint8_t sid, uint32_t sinceMs) {
+  std::string out;
+  hostMaintCommand("sync", out);
+  char key[16];
+  snprintf(key, sizeof(key), "  sid=%-2u ok ", (unsigned)sid);
+  const size_t at = out.find(key);
+  if (at == std::string::npos) return false;
+  const size_t heard = out.find("heard ", at);
+  return heard != std::string::npos && strtoul(out.c_str() + heard + 6, nullptr, 10) < sinceMs;
+}
+
+static Game1 play(const Arm& arm, uint32_t seed) {
+  Game1 r;
+  memset(&r, 0, sizeof(r));
+
+  RoomConfig cfg;
+  cfg.seed                 = seed;
+  cfg.serverLoopUs         = 2000;
+  cfg.link.lossPct         = arm.lossPct;
+  cfg.stationLoop.minUs    = 1000;
+  cfg.stationLoop.maxUs    = 8000;
+  cfg.stationLoop.stallPct = 5;
+  cfg.stationLoop.stallUs  = 30000;
+  Room room(cfg);
+
+  uint8_t  sid = 0;              // rebooted, not confirmed yet
+  uint32_t resyncs = 0;
+  room.onTx([&](const HostFrame& f) {
+    if (!sid || f.data[1] != (uint8_t)MsgTypeExt::STATION_RESYNC) return;
+    const auto* p = (const StationResyncPayload*)(f.data.data() + sizeof(MsgHeader));
+    if (p->targetId == sid) resyncs++;
+  });
+
+  room.boot();
+  room.startGame();
+  std::mt19937 rng(seed);
+  uint32_t nextAt = 3000, bootAt = 0, correctAt = 0;
+  const RoomStats& s = room.stats();
+  while (!s.ended && room.gameMs() < cfg.gameLimitMs && r.n < kMaxRuns) {
+    room.step();
+    const uint32_t now = room.gameMs();
+    if (!sid) {
+      if (now < nextAt || g.phase != Phase::PLAYING) continue;
+      const uint8_t pick = (uint8_t)std::uniform_int_distribution<int>(1, g.stationCount)(rng);
+      if (!room.rebootStation(pick, arm.hello)) continue;
+      sid       = pick;
+      bootAt    = now;
+      correctAt = 0;
+      resyncs   = 0;
+      continue;
+    }
+    if (!correctAt && trexDigestHash(room.stationDigest(sid)) == trexDigestHash(expected(sid))) {
+      correctAt = now;
+    }
+    const bool giveUp = now - bootAt >= kGiveUpMs;
+    const bool confirmed = correctAt && serverConfirmed(sid, now - bootAt);
+    if (!confirmed && !giveUp) continue;
+    r.correctMs[r.n] = (uint16_t)((correctAt ? correctAt : bootAt + kGiveUpMs) - bootAt);
+    r.confirmMs[r.n] = confirmed ? (uint16_t)(now - correctAt) : 0xFFFF;
+    r.n++;
+    r.resyncs += resyncs;
+    sid    = 0;
+    nextAt = now + std::uniform_int_distribution<uint32_t>(500, 1500)(rng);
+  }
+  r.ended = s.ended;
+  return r;
+}
+
+static uint32_t pctile(const std::vector<uint32_t>& v, uint32_t p) {
+  return v[std::min(v.size() - 1, v.size() * p / 100)];
+}
+
+int main() {
+  printf("arm                 runs  p50  p95  p99  max  confirm after  resyncs/run\n");
+  for (const Arm& arm : kArms) {
+    std::vector<uint32_t> correct, confirm;
+    uint32_t resyncs = 0, unconfirmed = 0;
+    for (uint32_t seed = 1; seed <= kSeeds; ++seed) {
+      Game1 r;
+      CHECK(forked<Game1>(r, [&arm, seed] { return play(arm, seed); }));
+      CHECKF(r.ended, "%s seed %lu: game didn't end", arm.name, (unsigned long)seed);
+      for (uint32_t i = 0; i < r.n; ++i) {
+        correct.push_back(r.correctMs[i]);
+        if (r.confirmMs[i] == 0xFFFF) unconfirmed++;
+        else                          confirm.push_back(r.confirmMs[i]);
+      }
+      resyncs += r.resyncs;
+    }
+    CHECKF(correct.size() >= 300, "%s: only %lu reboots", arm.name, (unsigned long)correct.size());
+    if (correct.empty() || confirm.empty()) continue;
+    std::sort(correct.begin(), correct.end());
+    std::sort(confirm.begin(), confirm.end());
+    printf("%-18s %5lu %4lu %4lu %4lu %4lu  %5lu..%-5lu   %11.2f\n", arm.name, (unsigned long)correct.size(),
+           (unsigned long)pctile(correct, 50), (unsigned long)pctile(correct, 95),
+           (unsigned long)pctile(correct, 99), (unsigned long)correct.back(), (unsigned long)confirm.front(),
+           (unsigned long)confirm.back(), (double)resyncs / correct.size());
+
+    CHECKF(pctile(correct, 50) <= arm.p50Ms, "%s: p50 %lu ms", arm.name, (unsigned long)pctile(correct, 50));
+    CHECKF(pctile(correct, 95) <= arm.p95Ms, "%s: p95 %lu ms", arm.name, (unsigned long)pctile(correct, 95));
+    CHECKF(pctile(correct, 99) <= arm.p99Ms, "%s: p99 %lu ms", arm.name, (unsigned long)pctile(correct, 99));
+    CHECKF(correct.back() < arm.maxMs, "%s: worst %lu ms", arm.name, (unsigned long)correct.back());
+    CHECKF(unconfirmed == 0, "%s: %lu reboots never confirmed", arm.name, (unsigned long)unconfirmed);
+    CHECKF(confirm.back() <= arm.confirmMs, "%s: confirmed %lu ms after correct", arm.name,
+           (unsigned long)confirm.back());
+  }
+  return checkExit();
+}
@@ -0,0 +1,41 @@
+// A whole game through the host build: the server's own setup()/loop() with
+// the room model playing, start to GAME_OVER.
+#include <sys/stat.h>
+#include "Room.h"
+#include "Check.h"
+#include "TempDir.h"
+
+int main() {
+  TempDir dir;
+  if (!dir) return 2;
+
+  RoomConfig cfg;
+  cfg.seed   = 7;
+  cfg.fsRoot = dir.path();
+  Room room(cfg);
+  const RoomStats& s = room.run();
+
+  CHECK(s.ended);
+  CHECKF(s.endMs <= 360000, "ended at %lu ms", (unsigned long)s.endMs);
+  CHECKF(s.reason == GAMEOVER_REASON_SUCCESS || s.reason == GAMEOVER_REASON_RED_VIOLATION ||
+         s.reason == GAMEOVER_REASON_GOAL_NOT_MET, "reason %u", (unsigned)s.reason);
+
+  // Players scored and the rounds moved on
+  CHECKF(s.teamScore > 0, "score %lu", (unsigned long)s.teamScore);
+  CHECK(s.rounds[1].attempts >= 1);
+  CHECKF(s.roundReached >= 2, "round reached %u", (unsigned)s.roundReached);
+
+  // Frames went out both ways; WORLD_FRAME alone is at least 1 Hz
+  CHECK(s.txFrames > 0 && s.rxFrames > 0);
+  CHECKF(s.txByType[(uint8_t)MsgTypeExt::WORLD_FRAME] >= s.endMs / 1000,
+         "%lu WORLD_FRAMEs in %lu ms", (unsigned long)s.txByType[(uint8_t)MsgTypeExt::WORLD_FRAME],
+         (unsigned long)s.endMs);
+  CHECK(s.txByType[(uint8_t)MsgType::GAME_OVER] >= 1);
+
+  // One loop() pass per virtual ms, and the journal was written after the end
+  CHECK(s.loops >= s.endMs);
+  struct stat jst;
+  CHECK(stat((dir.path() + "/journal.bin").c_str(), &jst) == 0 && jst.st_size > 0);
+
+  return checkExit();
+}
@@ -0,0 +1,130 @@
+// STATION_INVENTORY (user-008): station inventory frames per round, now (one
+// all-stations frame per STATION_FLUSH_MS while something is dirty) against
+// what the old scheme sent for the same game:
+//   one STATION_UPDATE per station whose inventory or capacity changed in a
+//   loop() pass, hold ticks aside (those ride in LOOT_TICK_BATCH), and
+//   3 full passes over the stations at a round start, 2 at a bonus start.
+// Changes to the same station within one pass count once, so "before" is a
+// lower bound. The periodic refresh that replaces the drip (a frame a full
+// refresh period after the previous one) is counted on its own. In R5 a hop
+// is at most the frames it was before, but the depletion steps are further
+// apart than the flush window and stay one frame each, so R5 gains least.
+#include <stdio.h>
+#include "Room.h"
+#include "Check.h"
+#include "Stage.h"
+
+static const uint8_t ROUND_SYNC_PASSES = 3;
+static const uint8_t BONUS_SYNC_PASSES = 2;
+
+static const uint32_t kRefreshUs = 5000000;   // Net.cpp STATION_REFRESH_MS
+
+static int stationOfHold(uint32_t holdId) {
+  for (uint8_t i = 0; i < MAX_HOLDS; ++i) {
+    if (g.holds[i].active && g.holds[i].holdId == holdId) return g.holds[i].stationId;
+  }
+  return -1;
+}
+
+int main() {
+  RoomConfig cfg;
+  cfg.seed = 4;
+  Room room(cfg);
+
+  uint32_t stageMs[ST_COUNT] = {}, entries[ST_COUNT] = {};
+  uint32_t now[ST_COUNT] = {}, refresh[ST_COUNT] = {}, before[ST_COUNT] = {};
+  uint32_t hops = 0, hopUpdates = 0, depleteUpdates = 0;   // R5's share of "before"
+  uint32_t ticked = 0;   // stations with a hold tick in this pass
+  uint32_t legacy = 0;
+  uint64_t lastInvUs = 0;
+  room.onTx([&](const HostFrame& f) {
+    const uint8_t t = f.data[1];
+    if (t == (uint8_t)MsgType::STATION_UPDATE) legacy++;
+    if (t == (uint8_t)MsgTypeExt::STATION_INVENTORY) {
+      // the refresh goes out a whole period after the last frame (1 ms passes)
+      if (lastInvUs && f.atUs - lastInvUs >= kRefreshUs - 1000) refresh[stageNow()]++;
+      else                                                     now[stageNow()]++;
+      lastInvUs = f.atUs;
+    }
+    if (t != (uint8_t)MsgTypeExt::LOOT_TICK_BATCH) return;
+    const auto* b = (const LootTickBatchPayload*)(f.data.data() + sizeof(MsgHeader));
+    const uint8_t* e = (const uint8_t*)(b + 1) + b->stationCount * sizeof(uint16_t);
+    for (uint8_t i = 0; i < b->entryCount; ++i) {
+      LootTickEntry ent;
+      memcpy(&ent, e + i * sizeof(ent), sizeof(ent));
+      const int sid = stationOfHold(ent.holdId);
+      if (sid > 0) ticked |= 1u << sid;
+    }
+  });
+
+  room.boot();
+  room.startGame();
+  uint8_t  lastRound = 0, lastHot = 0;
+  uint32_t lastStart = 0;
+  int      lastStage = ST_IDLE;
+  while (!room.stats().ended && room.gameMs() < cfg.gameLimitMs) {
+    uint16_t inv[MAX_STATIONS + 1], cap[MAX_STATIONS + 1];
+    memcpy(inv, g.stationInventory, sizeof(inv));
+    memcpy(cap, g.stationCapacity, sizeof(cap));
+    ticked = 0;
+    room.step();
+
+    const int s = stageNow();
+    stageMs[s]++;
+    uint32_t changed = 0;
+    for (uint8_t sid = 1; sid <= g.stationCount; ++sid) {
+      const bool capChanged = cap[sid] != g.stationCapacity[sid];
+      const bool invChanged = inv[sid] != g.stationInventory[sid];
+      if (capChanged || (invChanged && !(ticked & (1u << sid)))) changed++;
+    }
+    before[s] += changed;
+    // The drip the round / bonus transitions used to start
+    const bool roundStart = s >= ST_R1 && s <= ST_R5 &&
+                            (s != lastStage || g.roundIndex != lastRound || g.roundStartAt != lastStart);
+    const bool bonusStart = s == ST_BONUS && lastStage != ST_BONUS;
+    if (roundStart) before[s] += ROUND_SYNC_PASSES * g.stationCount;
+    if (bonusStart) before[s] += BONUS_SYNC_PASSES * g.stationCount;
+    if (roundStart || bonusStart) entries[s]++;
+    if (s == ST_R5 && !roundStart && changed) {
+      if (g.r5HotSid != lastHot) { hops++; hopUpdates += changed; }
+      else                       depleteUpdates += changed;
+    }
+    lastStage = s;
+    lastRound = g.roundIndex;
+    lastStart = g.roundStartAt;
+    lastHot   = g.r5HotSid;
+  }
+  CHECK(room.stats().ended);
+  CHECKF(legacy == 0, "%lu STATION_UPDATE", (unsigned long)legacy);
+
+  printf("stage      secs  starts  before  now  refresh  before/s  now/s  reduction\n");
+  for (int s = ST_R1; s < ST_COUNT; ++s) {
+    if (!stageMs[s]) continue;
+    const double secs = stageMs[s] / 1000.0;
+    printf("%-9s %5.0f  %6lu  %6lu  %3lu  %7lu  %8.2f  %5.2f  %8.1fx\n", kStage[s], secs,
+           (unsigned long)entries[s], (unsigned long)before[s], (unsigned long)now[s],
+           (unsigned long)refresh[s], before[s] / secs, now[s] / secs,
+           now[s] ? (double)before[s] / now[s] : 0.0);
+  }
+  printf("R5: %lu hops (%lu STATION_UPDATE before), %lu depletion steps\n", (unsigned long)hops,
+         (unsigned long)hopUpdates, (unsigned long)depleteUpdates);
+
+  // Changes alone: never more than before
+  for (int s = ST_R1; s < ST_COUNT; ++s) {
+    CHECKF(now[s] <= before[s], "%s: %lu frames now vs %lu before", kStage[s],
+           (unsigned long)now[s], (unsigned long)before[s]);
+  }
+  // R1..R4 are mostly the round-start drip: half of it or less
+  for (int s = ST_R1; s < ST_R5; ++s) {
+    if (!stageMs[s]) continue;
+    CHECKF(now[s] * 2 <= before[s], "%s: %lu frames now vs %lu before", kStage[s],
+           (unsigned long)now[s], (unsigned long)before[s]);
+  }
+  // The refresh is one frame per 5 s of PLAYING at most
+  for (int s = ST_R1; s < ST_COUNT; ++s) {
+    CHECKF(refresh[s] <= stageMs[s] / 5000 + 1, "%s: %lu refreshes in %lu ms", kStage[s],
+           (unsigned long)refresh[s], (unsigned long)stageMs[s]);
+  }
+  CHECKF(hops >= 10, "only %lu R5 hops", (unsigned long)hops);
+  return checkExit();
+}
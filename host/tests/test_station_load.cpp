@@ -0,0 +1,134 @@
+// Station count (user-017): the same game with 5, 8, 12 and 16 Loots (one
+// player per Loot), measuring what goes on air while PLAYING -- server frames
+// and the Loots' own -- and what a loop() pass costs, next to the worst case
+// the maintenance `stationload` command prints for that count (every Loot
+// holding all the time). Airtime uses the model of `status` / `stationload`.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "Room.h"
+#include "Host.h"
+#include "Check.h"
+#include "Forked.h"
+
+extern Game g;
+
+static const uint8_t kCounts[] = { 5, 8, 12, 16 };
+
+struct Load {
+  uint8_t  ended;
+  uint32_t playMs;
+  uint32_t txFrames, rxFrames;   // server -> air, Loots -> air
+  double   txAirUs, rxAirUs;
+  uint32_t invLen, batchMax;     // STATION_INVENTORY, longest LOOT_TICK_BATCH
+  uint32_t loops;
+  uint64_t loopNsSum;
+  uint32_t loopNsMax;
+  float    modelFps, modelAirMs;  // stationload for this count
+};
+
+// "  n= 8 inv= 40B batch= 29.. 64B frames= 40.1/s airtime= 23.4ms/s pack=..."
+static void parseModel(const std::string& out, uint8_t n, Load& r) {
+  char key[16];
+  snprintf(key, sizeof(key), "n=%2u ", (unsigned)n);
+  const size_t at = out.find(key);
+  if (at == std::string::npos) return;
+  const size_t f = out.find("frames=", at), a = out.find("airtime=", at);
+  if (f != std::string::npos) r.modelFps   = strtof(out.c_str() + f + 7, nullptr);
+  if (a != std::string::npos) r.modelAirMs = strtof(out.c_str() + a + 8, nullptr);
+}
+
+static Load play(uint8_t n) {
+  Load r;
+  memset(&r, 0, sizeof(r));
+
+  RoomConfig cfg;
+  cfg.seed     = 2;
+  cfg.stations = n;
+  cfg.players  = n;
+  Room room(cfg);
+  room.onTx([&](const HostFrame& f) {
+    if (g.phase != Phase::PLAYING) return;
+    const uint32_t len = (uint32_t)f.data.size();
+    r.txFrames++;
+    r.txAirUs += airUs(len);
+    if (f.data[1] == (uint8_t)MsgTypeExt::STATION_INVENTORY) r.invLen = len;
+    if (f.data[1] == (uint8_t)MsgTypeExt::LOOT_TICK_BATCH && len > r.batchMax) r.batchMax = len;
+  });
+  room.onStationTx([&](uint8_t, const uint8_t*, uint16_t len) {
+    if (g.phase != Phase::PLAYING) return;
+    r.rxFrames++;
+    r.rxAirUs += airUs(len);
+  });
+
+  room.boot();
+  std::string out;
+  hostMaintCommand("stationload", out);
+  parseModel(out, n, r);
+
+  room.startGame();
+  const RoomStats& s = room.stats();
+  uint32_t loops0 = 0;
+  uint64_t ns0 = 0;
+  while (!s.ended && room.gameMs() < cfg.gameLimitMs) {
+    loops0 = s.loops;
+    ns0    = s.loopNsSum;
+    room.step();
+    if (g.phase == Phase::PLAYING || s.ended) {
+      r.playMs++;
+      r.loops     += s.loops - loops0;
+      r.loopNsSum += s.loopNsSum - ns0;
+    }
+  }
+  r.ended     = s.ended;
+  r.loopNsMax = s.loopNsMax;
+  return r;
+}
+
+int main() {
+  Load load[sizeof(kCounts)];
+  for (size_t i = 0; i < sizeof(kCounts); ++i) {
+    const uint8_t n = kCounts[i];
+    CHECK(forked<Load>(load[i], [n] { return play(n); }));
+  }
+
+  printf("loots  secs  inv  batch  server/s  loots/s  air ms/s  model/s  model ms/s  loop avg  loop max\n");
+  for (size_t i = 0; i < sizeof(kCounts); ++i) {
+    const Load& r = load[i];
+    const double secs = r.playMs / 1000.0;
+    printf("%5u  %4.0f  %3luB  %4luB  %8.1f  %7.1f  %8.2f  %7.1f  %10.1f  %6.1fus  %6.1fus\n",
+           (unsigned)kCounts[i], secs, (unsigned long)r.invLen, (unsigned long)r.batchMax,
+           r.txFrames / secs, r.rxFrames / secs, (r.txAirUs + r.rxAirUs) / 1000 / secs, r.modelFps,
+           r.modelAirMs, r.loops ? r.loopNsSum / 1000.0 / r.loops : 0.0, r.loopNsMax / 1000.0);
+  }
+
+  const Load& base = load[0];
+  const double baseSecs = base.playMs / 1000.0;
+  for (size_t i = 0; i < sizeof(kCounts); ++i) {
+    const Load& r = load[i];
+    const uint8_t n = kCounts[i];
+    const double secs = r.playMs / 1000.0;
+    CHECKF(r.ended && r.playMs > 60000, "%u Loots: ended=%u after %lu ms", (unsigned)n, (unsigned)r.ended,
+           (unsigned long)r.playMs);
+    // One all-stations frame: 4 B per Loot more, never a frame per Loot
+    CHECKF(r.invLen == base.invLen + 4u * (n - kCounts[0]), "%u Loots: STATION_INVENTORY %lu B",
+           (unsigned)n, (unsigned long)r.invLen);
+    CHECKF(r.batchMax < 250, "%u Loots: LOOT_TICK_BATCH %lu B", (unsigned)n, (unsigned long)r.batchMax);
+    // Broadcast load grows at most in proportion to the Loots (their ticks
+    // and heartbeats), not with Loots x Loots
+    const double txRate = r.txFrames / secs, baseTx = base.txFrames / baseSecs;
+    CHECKF(txRate <= baseTx * n / kCounts[0], "%u Loots: %.1f server frames/s vs %.1f at %u", (unsigned)n,
+           txRate, baseTx, (unsigned)kCounts[0]);
+    // The model is the worst case (everyone holding all the time)
+    const double airMs = (r.txAirUs + r.rxAirUs) / 1000 / secs;
+    CHECKF(r.modelAirMs > 0 && airMs <= r.modelAirMs, "%u Loots: %.2f ms/s on air, model %.1f", (unsigned)n,
+           airMs, r.modelAirMs);
+  }
+  // Loop cost: the per-pass work follows the live holds and stations, so 16
+  // Loots stay within a small factor of 5 (wall clock; loose on purpose)
+  const Load& top = load[sizeof(kCounts) - 1];
+  const double avg0 = base.loopNsSum / (double)base.loops, avgN = top.loopNsSum / (double)top.loops;
+  CHECKF(avgN <= avg0 * 4 + 20000, "loop avg %.1fus at %u Loots vs %.1fus at %u", avgN / 1000,
+         (unsigned)kCounts[sizeof(kCounts) - 1], avg0 / 1000, (unsigned)kCounts[0]);
+  return checkExit();
+}
@@ -0,0 +1,117 @@
+// LOOT_TICK_BATCH (user-007): accrual frames and estimated airtime binned by
+// the number of holds active in each loop() pass, against the old scheme of
+// one LOOT_TICK + one STATION_UPDATE per hold tick.
+//
+// Every hold that ticks in a pass goes into that pass's one batch frame, so
+// the frame count per pass stays at one however many holds tick together;
+// holds keep their own phase, so passes with a tick still grow with the hold
+// count, but each costs one preamble instead of two per hold. Airtime uses
+// the model of the server's `status` bins (1 Mbps ESP-NOW). A game rarely
+// lines ticks up in one pass, so the end also flushes 1..28 ticks at once.
+#include <stdio.h>
+#include "Room.h"
+#include "Net.h"
+#include "Check.h"
+
+extern Game g;
+
+static const uint8_t  kBins = 9;   // 0..7 holds, 8+ together
+
+struct Bin {
+  uint32_t ms;          // accrual passes spent at this hold count
+  uint32_t frames;      // LOOT_TICK_BATCH frames
+  uint32_t ticks;       // hold ticks they carried
+  double   nowUs;       // their airtime
+  double   beforeUs;    // LOOT_TICK + STATION_UPDATE per tick
+};
+
+int main() {
+  RoomConfig cfg;
+  cfg.seed     = 7;
+  cfg.players  = 10;
+  cfg.stations = 8;
+  Room room(cfg);
+
+  const uint32_t tickLen = sizeof(MsgHeader) + sizeof(LootTickPayload);
+  const uint32_t updLen  = sizeof(MsgHeader) + sizeof(StationUpdatePayload);
+  Bin bins[kBins] = {};
+  uint32_t passFrames = 0, passTicks = 0, passBytes = 0, maxPerPass = 0, otherTicks = 0;
+  double passUs = 0;
+  room.onTx([&](const HostFrame& f) {
+    if (f.data[1] == (uint8_t)MsgType::LOOT_TICK) otherTicks++;
+    if (f.data[1] != (uint8_t)MsgTypeExt::LOOT_TICK_BATCH) return;
+    const auto* b = (const LootTickBatchPayload*)(f.data.data() + sizeof(MsgHeader));
+    passFrames++;
+    passTicks += b->entryCount;
+    passBytes += (uint32_t)f.data.size();
+    passUs    += airUs((uint32_t)f.data.size());
+  });
+
+  room.boot();
+  room.startGame();
+  while (!room.stats().ended && room.gameMs() < cfg.gameLimitMs) {
+    // The count the accrual pass sees is the one before the pass
+    const bool accrual = g.phase == Phase::PLAYING &&
+                         (g.light == LightState::GREEN || g.light == LightState::YELLOW);
+    const uint8_t holds = g.holds.count;
+    passFrames = passTicks = 0;
+    passUs = 0;
+    room.step();
+    if (!accrual) continue;
+    Bin& b = bins[holds < kBins ? holds : kBins - 1];
+    b.ms++;
+    b.frames += passFrames;
+    b.ticks  += passTicks;
+    b.nowUs  += passUs;
+    b.beforeUs += passTicks * (airUs(tickLen) + airUs(updLen));
+    if (passFrames > maxPerPass) maxPerPass = passFrames;
+  }
+  CHECK(room.stats().ended);
+
+  printf("holds   secs  ticks/s  frames/s  before/s  air ms/s  before ms/s\n");
+  uint32_t ticks = 0, frames = 0, multi = 0;
+  for (uint8_t n = 1; n < kBins; ++n) {
+    const Bin& b = bins[n];
+    if (b.ms < 2000) continue;
+    const double secs = b.ms / 1000.0;
+    printf("%4u%s %6.1f  %7.2f  %8.2f  %8.2f  %8.3f  %11.3f\n", (unsigned)n, n == kBins - 1 ? "+" : " ",
+           secs, b.ticks / secs, b.frames / secs, 2 * b.ticks / secs, b.nowUs / 1000 / secs,
+           b.beforeUs / 1000 / secs);
+    ticks  += b.ticks;
+    frames += b.frames;
+    if (n >= 2) multi++;
+    // At most one frame per tick, never the two the old scheme sent; one
+    // batch costs about 0.6 of a LOOT_TICK + STATION_UPDATE pair on air
+    CHECKF(b.frames <= b.ticks, "%u holds: %lu frames for %lu ticks", (unsigned)n,
+           (unsigned long)b.frames, (unsigned long)b.ticks);
+    CHECKF(b.nowUs <= b.beforeUs * 0.7, "%u holds: %.3f vs %.3f ms/s", (unsigned)n,
+           b.nowUs / 1000 / secs, b.beforeUs / 1000 / secs);
+  }
+  printf("batch frames=%lu for %lu hold ticks; most frames in one pass=%lu\n", (unsigned long)frames,
+         (unsigned long)ticks, (unsigned long)maxPerPass);
+
+  // One batch per pass whatever the hold count (entries fit in one frame)
+  CHECKF(maxPerPass == 1, "%lu batch frames in one pass", (unsigned long)maxPerPass);
+  CHECKF(otherTicks == 0 || otherTicks * 10 < ticks, "%lu LOOT_TICK beside the batch",
+         (unsigned long)otherTicks);
+  CHECKF(ticks >= 100, "only %lu hold ticks", (unsigned long)ticks);
+  CHECKF(multi >= 2, "only %u hold counts >= 2 seen long enough", multi);
+
+  // Ticks that do land in the same pass: n holds, still one frame (up to the
+  // 28 entries a frame carries), where the old scheme sent 2n
+  printf("same-pass ticks  frames  bytes  air us  before us\n");
+  static const uint8_t kSame[] = { 1, 2, 4, 8, 16, 28 };
+  for (uint8_t n : kSame) {
+    passFrames = passTicks = passBytes = 0;
+    passUs = 0;
+    for (uint8_t i = 0; i < n; ++i) lootTickBatchAdd(g, 1000 + i, i);
+    lootTickBatchFlush(g);
+    const double before = n * (airUs(tickLen) + airUs(updLen));
+    printf("%15u  %6lu  %5lu  %6.0f  %9.0f\n", (unsigned)n, (unsigned long)passFrames,
+           (unsigned long)passBytes, passUs, before);
+    CHECKF(passFrames == 1 && passTicks == n, "%u ticks: %lu frames, %lu entries", (unsigned)n,
+           (unsigned long)passFrames, (unsigned long)passTicks);
+    if (n >= 2) CHECKF(passUs < before / 2, "%u ticks: %.0f us vs %.0f", (unsigned)n, passUs, before);
+  }
+  return checkExit();
+}
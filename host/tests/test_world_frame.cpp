@@ -0,0 +1,80 @@
+// WORLD_FRAME (user-001): per-type frame counts through a whole game, and the
+// game-state frames per second in each stage against what the old per-tick
+// STATE_TICK + GAME_STATUS pair and the ROUND_STATUS / BONUS_UPDATE
+// keep-alives sent.
+//
+// The old schedule, at tickHz while PLAYING:
+//   STATE_TICK + GAME_STATUS     2 x tickHz
+//   ROUND_STATUS keep-alive      1 /s
+//   BONUS_UPDATE keep-alive      3 copies every 1.5 s while a bonus is up
+// plus the event bursts (ROUND_STATUS on a round change, BONUS_UPDATE,
+// LIVES_UPDATE), which both schedules send. The 1.5 s bursts after a round
+// or bonus change are left out, so "before" is a lower bound.
+#include <stdio.h>
+#include "Room.h"
+#include "Check.h"
+#include "Stage.h"
+
+static bool isStateType(uint8_t t) {
+  return t == (uint8_t)MsgType::STATE_TICK   || t == (uint8_t)MsgType::GAME_STATUS ||
+         t == (uint8_t)MsgType::ROUND_STATUS || t == (uint8_t)MsgType::BONUS_UPDATE ||
+         t == (uint8_t)MsgType::LIVES_UPDATE || t == (uint8_t)MsgTypeExt::WORLD_FRAME;
+}
+
+int main() {
+  const uint8_t tickHz = 5;   // what STATE_TICK used to run at
+  RoomConfig cfg;
+  cfg.seed = 3;
+  Room room(cfg);
+
+  uint32_t stageMs[ST_COUNT] = {}, bonusMs[ST_COUNT] = {};
+  uint32_t world[ST_COUNT] = {}, events[ST_COUNT] = {};
+  uint32_t byType[256] = {};
+  room.onTx([&](const HostFrame& f) {
+    const uint8_t t = f.data[1];
+    byType[t]++;
+    if (!isStateType(t)) return;
+    const int s = stageNow();
+    if (t == (uint8_t)MsgTypeExt::WORLD_FRAME) world[s]++;
+    else                                       events[s]++;
+  });
+
+  room.boot();
+  g.tickHz = tickHz;
+  room.startGame();
+  while (!room.stats().ended && room.gameMs() < cfg.gameLimitMs) {
+    room.step();
+    const int s = stageNow();
+    stageMs[s]++;
+    if (g.bonusActiveMask) bonusMs[s]++;
+  }
+  CHECK(room.stats().ended);
+
+  printf("per type over the game:\n");
+  for (int t = 0; t < 256; ++t) {
+    if (byType[t]) printf("  %-18s %6lu\n", roomTypeName((uint8_t)t), (unsigned long)byType[t]);
+  }
+  // Retired per-tick types are gone; WORLD_FRAME carries their fields
+  CHECKF(byType[(uint8_t)MsgType::STATE_TICK] == 0, "%lu STATE_TICK", (unsigned long)byType[(uint8_t)MsgType::STATE_TICK]);
+  CHECKF(byType[(uint8_t)MsgType::GAME_STATUS] == 0, "%lu GAME_STATUS", (unsigned long)byType[(uint8_t)MsgType::GAME_STATUS]);
+
+  printf("stage      secs  world/s  event/s   now/s  before/s  reduction\n");
+  int checked = 0;
+  for (int s = ST_R1; s < ST_COUNT; ++s) {
+    if (stageMs[s] < 5000) continue;
+    const double secs   = stageMs[s] / 1000.0;
+    const double now    = (world[s] + events[s]) / secs;
+    const double before = (secs * (2 * tickHz + 1) + bonusMs[s] / 1000.0 * 2 + events[s]) / secs;
+    printf("%-9s %5.0f  %7.2f  %7.2f  %6.2f  %8.2f  %8.1fx\n", kStage[s], secs, world[s] / secs,
+           events[s] / secs, now, before, before / now);
+
+    // One WORLD_FRAME per tick, give or take the immediate ones on flips
+    CHECKF(world[s] / secs >= tickHz * 0.95 && world[s] / secs <= tickHz * 1.5,
+           "%s: %.2f WORLD_FRAME/s at tickHz %u", kStage[s], world[s] / secs, (unsigned)tickHz);
+    // Well under the old rate in every stage (measured: about half)
+    CHECKF(now <= before * 0.6, "%s: %.2f frames/s now vs %.2f before", kStage[s], now, before);
+    checked++;
+  }
+  CHECKF(checked >= 5, "only %d stages long enough to measure", checked);
+  return checkExit();
+}
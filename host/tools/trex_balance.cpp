@@ -0,0 +1,327 @@
+// trex_balance: Monte-Carlo balancing. Plays many seeded games of the real
+// server loop for each parameter set and prints the distributions.
+//
+//   trex_balance [--sets FILE] [--games N] [--seed N] [--jobs N] [--csv FILE]
+//
+// Every game is its own process (fork) with its own Room, Game and LittleFS
+// temp dir -- the server keeps its state in file statics -- and --jobs of them
+// (default: one per core) run at once. Game i of every set uses seed --seed+i,
+// so sets are compared on the same rooms, and the report does not depend on
+// --jobs or on the order games finish in.
+//
+// A sets file is blocks of
+//   [name]
+//   3 maxCarry=12 lootPerTick=3        rounds.cfg lines (RoundTable.h syntax)
+//   player tap=700 react=350 carry=100 yellow=1 bonus=1 walk=2000..4500 mg=60
+//   game r5DwellMinMs=4000 r5DwellMaxMs=9000 r5DepletePerStep=2 pirArmDelayMs=900
+//   link loss=5
+// '#' starts a comment. Without --sets the built-in table is played as "baseline".
+//
+// Per set: success rate, lives lost, and per round the score gained and the
+// time from round start to goal, each as mean / p10 / p50 / p90.
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Room.h"
+#include "TempDir.h"
+
+extern Game g;
+
+struct ParamSet {
+  std::string name;
+  std::string roundsCfg;
+  PlayerModel player;
+  LinkModel   link;
+  std::map<std::string, uint32_t> game;   // Game tunables, set after boot
+};
+
+// What a child sends back; plain bytes over a pipe
+struct GameResult {
+  uint8_t  ended, reason, roundReached, livesLost;
+  uint32_t endMs, teamScore;
+  struct { uint32_t attempts, scored, goalAtMs; } rounds[ROUND_COUNT + 1];
+};
+
+static void usage() {
+  fprintf(stderr, "usage: trex_balance [--sets FILE] [--games N] [--seed N] [--jobs N] [--csv FILE]\n");
+  exit(2);
+}
+
+// ---- Sets file ----
+static bool setGameField(Game& game, const std::string& key, uint32_t v) {
+  if      (key == "r5DwellMinMs")     game.r5DwellMinMs     = (uint16_t)v;
+  else if (key == "r5DwellMaxMs")     game.r5DwellMaxMs     = (uint16_t)v;
+  else if (key == "r5DepletePerStep") game.r5DepletePerStep = (uint16_t)v;
+  else if (key == "r5DepleteStepMs")  game.r5DepleteStepMs  = (uint16_t)v;
+  else if (key == "pirArmDelayMs")    game.pirArmDelayMs    = v;
+  else if (key == "redHoldGraceMs")   game.redHoldGraceMs   = v;
+  else return false;
+  return true;
+}
+
+static bool setPlayerField(PlayerModel& p, const std::string& key, const std::string& val) {
+  const uint32_t v = (uint32_t)strtoul(val.c_str(), nullptr, 0);
+  if      (key == "tap")    p.tapMeanMs    = v;
+  else if (key == "react")  p.reactMeanMs  = v;
+  else if (key == "reactSd") p.reactSdMs   = v;
+  else if (key == "lapse")  p.lapsePct     = (uint8_t)v;
+  else if (key == "carry")  p.carryPct     = (uint8_t)v;
+  else if (key == "yellow") p.stopOnYellow = v != 0;
+  else if (key == "bonus")  p.chaseBonus   = v != 0;
+  else if (key == "mg")     p.mgSuccessPct = (uint8_t)v;
+  else if (key == "walk") {
+    const size_t dots = val.find("..");
+    if (dots == std::string::npos) return false;
+    p.walkMinMs = v;
+    p.walkMaxMs = (uint32_t)strtoul(val.c_str() + dots + 2, nullptr, 0);
+  }
+  else return false;
+  return true;
+}
+
+static bool loadSets(const char* path, std::vector<ParamSet>& sets) {
+  std::ifstream f(path);
+  if (!f) { fprintf(stderr, "trex_balance: can't read %s\n", path); return false; }
+  std::string line;
+  unsigned lineNo = 0;
+  while (std::getline(f, line)) {
+    ++lineNo;
+    const size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ss(line);
+    std::string head;
+    if (!(ss >> head)) continue;
+
+    if (head[0] == '[') {
+      ParamSet s;
+      s.name = head.substr(1, head.find(']') - 1);
+      sets.push_back(s);
+      continue;
+    }
+    if (sets.empty()) { fprintf(stderr, "%s:%u: no [set] yet\n", path, lineNo); return false; }
+    ParamSet& s = sets.back();
+    if (isdigit((unsigned char)head[0])) { s.roundsCfg += line + "\n"; continue; }
+
+    std::string kv;
+    while (ss >> kv) {
+      const size_t eq = kv.find('=');
+      if (eq == std::string::npos) { fprintf(stderr, "%s:%u: '%s'?\n", path, lineNo, kv.c_str()); return false; }
+      const std::string key = kv.substr(0, eq), val = kv.substr(eq + 1);
+      bool ok = false;
+      if      (head == "player") ok = setPlayerField(s.player, key, val);
+      else if (head == "link" && key == "loss") { s.link.lossPct = (uint8_t)atoi(val.c_str()); ok = true; }
+      else if (head == "game") {
+        Game probe;
+        const uint32_t v = (uint32_t)strtoul(val.c_str(), nullptr, 0);
+        ok = setGameField(probe, key, v);
+        if (ok) s.game[key] = v;
+      }
+      if (!ok) { fprintf(stderr, "%s:%u: unknown %s field '%s'\n", path, lineNo, head.c_str(), key.c_str()); return false; }
+    }
+  }
+  return !sets.empty();
+}
+
+// ---- One game, in a child ----
+static GameResult playGame(const ParamSet& set, uint32_t seed) {
+  GameResult r;
+  memset(&r, 0, sizeof(r));
+
+  TempDir dir("trex_balance");
+  RoomConfig cfg;
+  cfg.seed      = seed;
+  cfg.player    = set.player;
+  cfg.link      = set.link;
+  cfg.roundsCfg = set.roundsCfg;
+  cfg.tailMs    = 0;
+  if (dir) cfg.fsRoot = dir.path();
+
+  Room room(cfg);
+  room.boot();
+  for (const auto& kv : set.game) setGameField(g, kv.first, kv.second);
+  const RoomStats& s = room.run();
+
+  r.ended        = s.ended;
+  r.reason       = s.reason;
+  r.roundReached = s.roundReached;
+  r.livesLost    = s.livesLost;
+  r.endMs        = s.endMs;
+  r.teamScore    = s.teamScore;
+  for (uint8_t i = 1; i <= ROUND_COUNT; ++i) {
+    r.rounds[i].attempts = s.rounds[i].attempts;
+    r.rounds[i].scored   = s.rounds[i].scored;
+    r.rounds[i].goalAtMs = s.rounds[i].goalAtMs;
+  }
+  return r;
+}
+
+struct Child { pid_t pid; int fd; size_t job; };
+
+static bool reap(std::vector<Child>& running, std::vector<GameResult>& out) {
+  int status = 0;
+  const pid_t pid = waitpid(-1, &status, 0);
+  if (pid < 0) return false;
+  for (size_t i = 0; i < running.size(); ++i) {
+    if (running[i].pid != pid) continue;
+    GameResult r;
+    const bool ok = read(running[i].fd, &r, sizeof(r)) == (ssize_t)sizeof(r);
+    close(running[i].fd);
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "trex_balance: game %zu failed (status 0x%x)\n", running[i].job, status);
+      return false;
+    }
+    out[running[i].job] = r;
+    running.erase(running.begin() + i);
+    return true;
+  }
+  return true;
+}
+
+// ---- Report ----
+struct Dist { double mean, p10, p50, p90; size_t n; };
+
+static Dist dist(std::vector<double> v) {
+  Dist d = { 0, 0, 0, 0, v.size() };
+  if (v.empty()) return d;
+  std::sort(v.begin(), v.end());
+  for (double x : v) d.mean += x;
+  d.mean /= v.size();
+  auto pct = [&v](int p) { return v[(v.size() - 1) * p / 100]; };
+  d.p10 = pct(10); d.p50 = pct(50); d.p90 = pct(90);
+  return d;
+}
+
+static void printDist(const char* label, const Dist& d, double scale = 1.0) {
+  printf("  %-16s n=%-5zu mean=%8.1f p10=%8.1f p50=%8.1f p90=%8.1f\n", label, d.n,
+         d.mean / scale, d.p10 / scale, d.p50 / scale, d.p90 / scale);
+}
+
+static void report(const ParamSet& set, const GameResult* r, size_t n) {
+  size_t success = 0, ended = 0;
+  std::vector<double> lives, score, endS;
+  for (size_t i = 0; i < n; ++i) {
+    if (r[i].ended) ++ended;
+    if (r[i].ended && r[i].reason == 0) ++success;
+    lives.push_back(r[i].livesLost);
+    score.push_back(r[i].teamScore);
+    endS.push_back(r[i].endMs);
+  }
+  printf("[%s] games=%zu success=%.1f%% ended=%zu\n", set.name.c_str(), n, 100.0 * success / n, ended);
+  printDist("lives lost", dist(lives));
+  printDist("team score", dist(score));
+  printDist("game over (s)", dist(endS), 1000.0);
+
+  for (uint8_t k = 1; k <= ROUND_COUNT; ++k) {
+    std::vector<double> scored, goal;
+    size_t played = 0, tries = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (!r[i].rounds[k].attempts) continue;
+      ++played;
+      tries += r[i].rounds[k].attempts;
+      scored.push_back(r[i].rounds[k].scored);
+      if (r[i].rounds[k].goalAtMs) goal.push_back(r[i].rounds[k].goalAtMs);
+    }
+    if (!played) continue;
+    printf(" R%u played=%zu tries/game=%.2f goal met=%.1f%%\n", (unsigned)k, played,
+           (double)tries / played, 100.0 * goal.size() / played);
+    printDist("score", dist(scored));
+    printDist("time to goal (s)", dist(goal), 1000.0);
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* setsPath = nullptr;
+  const char* csvPath  = nullptr;
+  size_t   games = 1000;
+  uint32_t seed0 = 1;
+  long     jobs  = sysconf(_SC_NPROCESSORS_ONLN);
+
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const bool more = (i + 1 < argc);
+    if      (!strcmp(a, "--sets")  && more) setsPath = argv[++i];
+    else if (!strcmp(a, "--csv")   && more) csvPath = argv[++i];
+    else if (!strcmp(a, "--games") && more) games = (size_t)strtoul(argv[++i], nullptr, 0);
+    else if (!strcmp(a, "--seed")  && more) seed0 = (uint32_t)strtoul(argv[++i], nullptr, 0);
+    else if (!strcmp(a, "--jobs")  && more) jobs = atol(argv[++i]);
+    else usage();
+  }
+  if (games < 1) usage();
+  if (jobs < 1) jobs = 1;
+
+  std::vector<ParamSet> sets;
+  if (setsPath) {
+    if (!loadSets(setsPath, sets)) return 2;
+  } else {
+    sets.push_back(ParamSet());
+    sets.back().name = "baseline";
+  }
+
+  // Children write their result and exit: nothing buffered may be flushed twice
+  fflush(stdout);
+  fflush(stderr);
+
+  const size_t total = sets.size() * games;
+  std::vector<GameResult> results(total);
+  std::vector<Child> running;
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for (size_t job = 0; job < total; ++job) {
+    while (running.size() >= (size_t)jobs) {
+      if (!reap(running, results)) return 1;
+    }
+    int fds[2];
+    if (pipe(fds) != 0) { perror("pipe"); return 1; }
+    const pid_t pid = fork();
+    if (pid < 0) { perror("fork"); return 1; }
+    if (pid == 0) {
+      close(fds[0]);
+      const GameResult r = playGame(sets[job / games], seed0 + (uint32_t)(job % games));
+      const bool ok = write(fds[1], &r, sizeof(r)) == (ssize_t)sizeof(r);
+      _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    running.push_back(Child{ pid, fds[0], job });
+  }
+  while (!running.empty()) {
+    if (!reap(running, results)) return 1;
+  }
+  const double wallS =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("games/set=%zu seeds=%lu..%lu\n", games, (unsigned long)seed0, (unsigned long)(seed0 + games - 1));
+  for (size_t k = 0; k < sets.size(); ++k) report(sets[k], &results[k * games], games);
+  fprintf(stderr, "%zu games on %ld jobs in %.1f s\n", total, jobs, wallS);
+
+  if (csvPath) {
+    FILE* csv = fopen(csvPath, "w");
+    if (!csv) { perror(csvPath); return 1; }
+    fprintf(csv, "set,seed,ended,reason,end_ms,score,round_reached,lives_lost");
+    for (unsigned k = 1; k <= ROUND_COUNT; ++k) fprintf(csv, ",r%u_tries,r%u_scored,r%u_goal_ms", k, k, k);
+    fprintf(csv, "\n");
+    for (size_t job = 0; job < total; ++job) {
+      const GameResult& r = results[job];
+      fprintf(csv, "%s,%lu,%u,%u,%lu,%lu,%u,%u", sets[job / games].name.c_str(),
+              (unsigned long)(seed0 + job % games), (unsigned)r.ended, (unsigned)r.reason,
+              (unsigned long)r.endMs, (unsigned long)r.teamScore, (unsigned)r.roundReached,
+              (unsigned)r.livesLost);
+      for (unsigned k = 1; k <= ROUND_COUNT; ++k) {
+        fprintf(csv, ",%lu,%lu,%lu", (unsigned long)r.rounds[k].attempts,
+                (unsigned long)r.rounds[k].scored, (unsigned long)r.rounds[k].goalAtMs);
+      }
+      fprintf(csv, "\n");
+    }
+    fclose(csv);
+  }
+  return 0;
+}
@@ -0,0 +1,254 @@
+// trex_replay: re-drive the server with a recorded input journal and check
+// that it does what the recorded server did.
+//
+//   trex_replay JOURNAL [--rounds FILE] [--dump FILE] [--echo]
+//
+// JOURNAL is a /journal.bin (TREX_TrexServer/Journal.h, version 2) from a
+// server or from trex_sim --fs. The replay boots the host-built server,
+// starts the game the way an operator does (SEED <seed>, then n) at the
+// recorded game-start millis(), then at each recorded millis() injects the
+// journalled RX frames, holds the camera input at the journalled level and
+// feeds the serial ('S') and telnet ('T') commands, one loop() pass per ms.
+//
+// The replayed server journals the game again; the two journals are compared
+// record by record. JR_TX records carry a hash of everything sent in each
+// second of the game, so a mismatch there is the second the TX diverged.
+// Exit code 0 = identical.
+//   --rounds F   copied to /rounds.cfg before boot (the journal doesn't keep it)
+//   --dump F     every replayed frame, in trex_sim --dump format
+//   --echo       server Serial output on stdout
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Host.h"
+#include "Preferences.h"
+#include "GameModel.h"
+#include "Journal.h"
+#include "TempDir.h"
+
+extern Game g;
+void setup();
+void loop();
+
+struct Record {
+  uint32_t t;
+  uint8_t  kind;
+  std::vector<uint8_t> data;
+};
+
+static const char* kKinds[] = { "?", "START", "RX", "PIR", "CMD", "END", "TX" };
+
+static void usage() {
+  fprintf(stderr, "usage: trex_replay JOURNAL [--rounds FILE] [--dump FILE] [--echo]\n");
+  exit(2);
+}
+
+static std::vector<Record> parseRecords(const uint8_t* p, uint32_t n) {
+  std::vector<Record> out;
+  uint32_t pos = 0;
+  while (pos + 6 <= n) {
+    Record r;
+    memcpy(&r.t, p + pos, 4);
+    r.kind = p[pos + 4];
+    const uint8_t len = p[pos + 5];
+    pos += 6;
+    if (pos + len > n) break;
+    r.data.assign(p + pos, p + pos + len);
+    pos += len;
+    out.push_back(r);
+  }
+  return out;
+}
+
+static std::string describe(const Record& r, uint32_t t0) {
+  char buf[96];
+  snprintf(buf, sizeof(buf), "%lu +%.3fs %-5s ", (unsigned long)r.t, (r.t - t0) / 1000.0,
+           r.kind < 7 ? kKinds[r.kind] : "?");
+  std::string s = buf;
+  if (r.kind == JR_TX && r.data.size() >= 8) {
+    uint16_t window, frames;
+    uint32_t hash;
+    memcpy(&window, &r.data[0], 2);
+    memcpy(&frames, &r.data[2], 2);
+    memcpy(&hash,   &r.data[4], 4);
+    snprintf(buf, sizeof(buf), "window=%u frames=%u hash=%08lx", (unsigned)window, (unsigned)frames,
+             (unsigned long)hash);
+    return s + buf;
+  }
+  if (r.kind == JR_CMD && !r.data.empty()) {
+    return s + (char)r.data[0] + " \"" + std::string(r.data.begin() + 1, r.data.end()) + "\"";
+  }
+  for (uint8_t b : r.data) { snprintf(buf, sizeof(buf), "%02x", b); s += buf; }
+  return s;
+}
+
+static bool pirArmed() {
+  return g.phase == Phase::PLAYING && g.light == LightState::RED && g.pirEnforce &&
+         millis() >= g.pirArmAt;
+}
+
+int main(int argc, char** argv) {
+  const char* journalPath = nullptr;
+  const char* dumpPath = nullptr;
+  std::string roundsCfg;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const bool more = (i + 1 < argc);
+    if      (!strcmp(a, "--dump") && more) dumpPath = argv[++i];
+    else if (!strcmp(a, "--echo"))         hostSerialEcho(true);
+    else if (!strcmp(a, "--rounds") && more) {
+      std::ifstream f(argv[++i]);
+      if (!f) { fprintf(stderr, "trex_replay: can't read %s\n", argv[i]); return 2; }
+      std::stringstream ss;
+      ss << f.rdbuf();
+      roundsCfg = ss.str();
+    }
+    else if (a[0] != '-' && !journalPath) journalPath = a;
+    else usage();
+  }
+  if (!journalPath) usage();
+
+  // ---- Recorded journal ----
+  std::ifstream jf(journalPath, std::ios::binary);
+  if (!jf) { fprintf(stderr, "trex_replay: can't read %s\n", journalPath); return 2; }
+  const std::vector<uint8_t> blob((std::istreambuf_iterator<char>(jf)), std::istreambuf_iterator<char>());
+  JournalFileHeader hdr;
+  if (blob.size() < sizeof(hdr)) { fprintf(stderr, "trex_replay: journal too short\n"); return 2; }
+  memcpy(&hdr, blob.data(), sizeof(hdr));
+  if (memcmp(hdr.magic, "TRJ1", 4) != 0 || hdr.version != 2) {
+    fprintf(stderr, "trex_replay: not a version 2 journal\n");
+    return 2;
+  }
+  if (hdr.dropped) fprintf(stderr, "trex_replay: journal dropped %lu records; the tail won't match\n",
+                           (unsigned long)hdr.dropped);
+  const uint32_t bodyLen = (uint32_t)std::min<size_t>(hdr.bytes, blob.size() - sizeof(hdr));
+  const std::vector<Record> rec = parseRecords(blob.data() + sizeof(hdr), bodyLen);
+  if (rec.empty() || rec[0].kind != JR_GAME_START || rec[0].data.size() < 5) {
+    fprintf(stderr, "trex_replay: journal doesn't start with GAME_START\n");
+    return 2;
+  }
+  const uint32_t t0 = rec[0].t;
+  const uint32_t tLast = rec.back().t;
+  const uint8_t  stations = rec[0].data[4];
+
+  // ---- Server ----
+  TempDir dir("trex_replay");
+  if (!dir) return 1;
+  hostFsRoot(dir.path());
+  if (!roundsCfg.empty()) {
+    FILE* f = fopen(hostFsPath("/rounds.cfg").c_str(), "wb");
+    if (f) { fputs(roundsCfg.c_str(), f); fclose(f); }
+  }
+  Preferences p;
+  p.begin("trex", false);
+  p.putUChar("stations", stations);
+  p.end();
+  hostSeedEspRandom(hdr.seed);
+
+  FILE* dump = nullptr;
+  if (dumpPath && !(dump = fopen(dumpPath, "wb"))) { perror(dumpPath); return 1; }
+  hostSetTxSink([dump](const HostFrame& f) {
+    if (!dump) return;
+    const uint8_t  uni = f.unicast ? 1 : 0;
+    const uint16_t len = (uint16_t)f.data.size();
+    fwrite(&f.atUs, sizeof(f.atUs), 1, dump);
+    fwrite(&uni, 1, 1, dump);
+    fwrite(f.mac, 1, 6, dump);
+    fwrite(&len, sizeof(len), 1, dump);
+    fwrite(f.data.data(), 1, len, dump);
+  });
+
+  // Boot up to a second before the game started, idle up to it, then start it
+  const uint32_t bootMs = (t0 > 1000) ? t0 - 1000 : 0;
+  hostSetNowUs((uint64_t)bootMs * 1000);
+  setup();
+  std::vector<int> pirPins;
+  for (int i = 0; i < 4; ++i) {
+    if (g.pir[i].pin >= 0) hostSetPin(g.pir[i].pin, HIGH);
+    pirPins.push_back(g.pir[i].pin);
+  }
+  for (uint32_t ms = bootMs + 1; ms < t0; ++ms) {
+    hostSetNowUs((uint64_t)ms * 1000);
+    loop();
+  }
+  hostSetNowUs((uint64_t)t0 * 1000);
+  hostSerialFeed("SEED " + std::to_string(hdr.seed) + "\nn\n");
+
+  // ---- Inputs at their recorded millis() ----
+  bool pirLow[4] = { false, false, false, false };
+  size_t next = 1;
+  for (uint32_t ms = t0; ; ++ms) {
+    hostSetNowUs((uint64_t)ms * 1000);
+    for (; next < rec.size() && rec[next].t <= ms; ++next) {
+      const Record& r = rec[next];
+      if (r.kind == JR_RX) {
+        hostInjectRx(r.data.data(), (uint16_t)r.data.size());
+      } else if (r.kind == JR_PIR && r.data.size() >= 2 && r.data[0] < 4) {
+        pirLow[r.data[0]] = r.data[1] != 0;
+      } else if (r.kind == JR_CMD && !r.data.empty()) {
+        const std::string line(r.data.begin() + 1, r.data.end());
+        if (r.data[0] == 'S') hostSerialFeed(line + "\n");
+        else { std::string out; hostMaintCommand(line.c_str(), out); }
+      }
+    }
+    // The input is only read (and journalled) while RED is armed; outside
+    // that the recorded room is unknown, so it reads as still
+    const bool armed = pirArmed();
+    for (int i = 0; i < 4; ++i) {
+      if (!armed) pirLow[i] = false;
+      if (pirPins[i] >= 0) hostSetPin(pirPins[i], pirLow[i] ? LOW : HIGH);
+    }
+    loop();
+    if (ms >= tLast && next >= rec.size()) break;
+  }
+  if (dump) fclose(dump);
+
+  // ---- Compare ----
+  uint32_t n = 0;
+  const uint8_t* mine = journalRecords(n);
+  const std::vector<Record> got = parseRecords(mine, n);
+
+  size_t firstDiff = SIZE_MAX;
+  for (size_t i = 0; i < rec.size() && i < got.size(); ++i) {
+    if (rec[i].t != got[i].t || rec[i].kind != got[i].kind || rec[i].data != got[i].data) { firstDiff = i; break; }
+  }
+  if (firstDiff == SIZE_MAX && rec.size() != got.size()) firstDiff = std::min(rec.size(), got.size());
+
+  // TX windows side by side, so a divergence shows where the output changed
+  // even when the inputs still line up
+  std::map<uint16_t, std::vector<uint8_t>> recTx, gotTx;
+  for (const Record& r : rec) if (r.kind == JR_TX && r.data.size() >= 8) recTx[r.data[0] | (r.data[1] << 8)] = r.data;
+  for (const Record& r : got) if (r.kind == JR_TX && r.data.size() >= 8) gotTx[r.data[0] | (r.data[1] << 8)] = r.data;
+  std::vector<uint16_t> badWindows;
+  for (const auto& kv : recTx) {
+    auto it = gotTx.find(kv.first);
+    if (it == gotTx.end() || it->second != kv.second) badWindows.push_back(kv.first);
+  }
+  for (const auto& kv : gotTx) if (!recTx.count(kv.first)) badWindows.push_back(kv.first);
+  std::sort(badWindows.begin(), badWindows.end());
+
+  printf("journal seed=%lu stations=%u records=%zu (%zu TX windows), replay records=%zu\n",
+         (unsigned long)hdr.seed, (unsigned)stations, rec.size(), recTx.size(), got.size());
+  if (firstDiff == SIZE_MAX) {
+    printf("replay identical: every input, TX window and the game end match\n");
+    return 0;
+  }
+  printf("first difference at record %zu:\n", firstDiff);
+  printf("  recorded %s\n", firstDiff < rec.size() ? describe(rec[firstDiff], t0).c_str() : "(end)");
+  printf("  replay   %s\n", firstDiff < got.size() ? describe(got[firstDiff], t0).c_str() : "(end)");
+  if (!badWindows.empty()) {
+    printf("TX differs in %zu of %zu windows, first at %u..%us:", badWindows.size(), recTx.size(),
+           (unsigned)(badWindows[0] * JOURNAL_TX_WINDOW_MS / 1000),
+           (unsigned)((badWindows[0] + 1) * JOURNAL_TX_WINDOW_MS / 1000));
+    for (size_t i = 0; i < badWindows.size() && i < 12; ++i) printf(" %u", (unsigned)badWindows[i]);
+    printf(badWindows.size() > 12 ? " ...\n" : "\n");
+  }
+  return 1;
+}
@@ -0,0 +1,127 @@
+// trex_sim: one full game of the real server loop against the room model.
+//
+//   trex_sim [--seed N] [--players N] [--stations N] [--loss PCT]
+//            [--react MS] [--tap MS] [--carry PCT] [--rounds FILE]
+//            [--fs DIR] [--dump FILE] [--echo] [--prof]
+//
+// Runs setup(), starts a game with SEED N, then one loop() pass per virtual
+// millisecond until GAME_OVER (a 6:00 game takes a second or two of wall
+// time). Prints the result, per-round score and time to goal, frames per
+// type, and what each loop() pass really cost on this machine.
+//   --fs DIR     LittleFS root (journal, rounds.cfg); default: a temp dir, removed at exit
+//   --rounds F   copied to /rounds.cfg before boot (RoundTable.h syntax)
+//   --dump F     every server frame: u64 atUs, u8 unicast, u8 mac[6], u16 len, data
+//   --echo       server Serial output on stdout
+//   --prof       the sketch's PROF table at the end
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include "Room.h"
+#include "Profiler.h"
+#include "TempDir.h"
+
+static void usage() {
+  fprintf(stderr, "usage: trex_sim [--seed N] [--players N] [--stations N] [--loss PCT] [--react MS]\n"
+                  "                [--tap MS] [--carry PCT] [--rounds FILE] [--fs DIR] [--dump FILE]\n"
+                  "                [--echo] [--prof]\n");
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  RoomConfig cfg;
+  const char* dumpPath = nullptr;
+  bool prof = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const bool more = (i + 1 < argc);
+    if      (!strcmp(a, "--seed")     && more) cfg.seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+    else if (!strcmp(a, "--players")  && more) cfg.players = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--stations") && more) cfg.stations = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--loss")     && more) cfg.link.lossPct = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--react")    && more) cfg.player.reactMeanMs = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--tap")      && more) cfg.player.tapMeanMs = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--carry")    && more) cfg.player.carryPct = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--fs")       && more) cfg.fsRoot = argv[++i];
+    else if (!strcmp(a, "--dump")     && more) dumpPath = argv[++i];
+    else if (!strcmp(a, "--echo"))             hostSerialEcho(true);
+    else if (!strcmp(a, "--prof"))             prof = true;
+    else if (!strcmp(a, "--rounds")   && more) {
+      std::ifstream f(argv[++i]);
+      if (!f) { fprintf(stderr, "trex_sim: can't read %s\n", argv[i]); return 2; }
+      std::stringstream ss;
+      ss << f.rdbuf();
+      cfg.roundsCfg = ss.str();
+    }
+    else usage();
+  }
+  if (cfg.stations < 1 || cfg.stations > TREX_MAX_LOOT_STATIONS || cfg.players < 1) usage();
+
+  std::unique_ptr<TempDir> tmp;
+  if (cfg.fsRoot.empty()) {
+    tmp.reset(new TempDir("trex_sim"));
+    if (!*tmp) return 1;
+    cfg.fsRoot = tmp->path();
+  }
+
+  FILE* dump = nullptr;
+  if (dumpPath && !(dump = fopen(dumpPath, "wb"))) { perror(dumpPath); return 1; }
+
+  Room room(cfg);
+  if (dump) {
+    room.onTx([dump](const HostFrame& f) {
+      const uint8_t  uni = f.unicast ? 1 : 0;
+      const uint16_t len = (uint16_t)f.data.size();
+      fwrite(&f.atUs, sizeof(f.atUs), 1, dump);
+      fwrite(&uni, 1, 1, dump);
+      fwrite(f.mac, 1, 6, dump);
+      fwrite(&len, sizeof(len), 1, dump);
+      fwrite(f.data.data(), 1, len, dump);
+    });
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  room.boot();
+  profReset();
+  const RoomStats& s = room.run();
+  const double wallMs =
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  if (dump) fclose(dump);
+
+  static const char* kReason[] = { "success", "?", "manual", "red violation", "goal not met" };
+  printf("seed=%lu players=%u stations=%u loss=%u%% fs=%s\n", (unsigned long)cfg.seed,
+         (unsigned)cfg.players, (unsigned)cfg.stations, (unsigned)cfg.link.lossPct, cfg.fsRoot.c_str());
+  if (s.ended) {
+    printf("GAME_OVER %s (reason %u) at %lu.%03lus, score=%lu, round reached=%u, lives lost=%u\n",
+           s.reason < 5 ? kReason[s.reason] : "?", (unsigned)s.reason,
+           (unsigned long)(s.endMs / 1000), (unsigned long)(s.endMs % 1000),
+           (unsigned long)s.teamScore, (unsigned)s.roundReached, (unsigned)s.livesLost);
+  } else {
+    printf("no GAME_OVER within %lu ms\n", (unsigned long)cfg.gameLimitMs);
+  }
+
+  printf("round  tries  scored  goal-at    played\n");
+  for (uint8_t r = 1; r <= ROUND_COUNT; ++r) {
+    const RoundStats& rs = s.rounds[r];
+    if (!rs.attempts) continue;
+    printf("R%u     %5lu  %6lu  %7.1fs  %7.1fs\n", (unsigned)r, (unsigned long)rs.attempts,
+           (unsigned long)rs.scored, rs.goalAtMs / 1000.0, rs.playedMs / 1000.0);
+  }
+
+  printf("tx frames=%lu bytes=%lu, rx delivered=%lu, lost on air=%lu\n", (unsigned long)s.txFrames,
+         (unsigned long)s.txBytes, (unsigned long)s.rxFrames, (unsigned long)s.lost);
+  for (int t = 0; t < 256; ++t) {
+    if (s.txByType[t]) printf("  %-18s %7lu\n", roomTypeName((uint8_t)t), (unsigned long)s.txByType[t]);
+  }
+
+  printf("loop() passes=%lu avg=%.2fus max=%.1fus; wall %.0f ms for %.1f s of game (x%.0f)\n",
+         (unsigned long)s.loops, s.loops ? s.loopNsSum / 1000.0 / s.loops : 0.0, s.loopNsMax / 1000.0,
+         wallMs, room.gameMs() / 1000.0, wallMs > 0 ? room.gameMs() / wallMs : 0.0);
+  if (prof) { hostSerialEcho(true); profPrint(Serial); }
+  fflush(stdout);
+  return s.ended ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+Decode the binary EventLog drain (EVLOG BIN / evlog bin) back into the
+usual human-readable log lines.
+
+The device writes frames of:  0xA5 0x5A  + 16-byte EvRec (little-endian)
+
+    uint32 t    millis()
+    uint8  id   event id (see EventIds.h of the sketch that produced it)
+    uint8  a
+    uint16 b
+    uint32 c
+    uint32 d
+
+Anything between frames (ordinary Serial.print text) is passed through as-is,
+so a capture of a mixed serial stream decodes into one readable log.
+
+Examples:
+    # live, from the server's USB serial (needs pyserial)
+    python3 tools/evlog_decode.py --ids TREX_TrexServer/EventIds.h --port /dev/ttyACM0
+
+    # from a raw capture file
+    python3 tools/evlog_decode.py --ids TREX_Loot/EventIds.h capture.bin
+"""
+
+from __future__ import annotations
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+from typing import BinaryIO, Dict, Iterator, Tuple
+
+SYNC = b"\xA5\x5A"
+REC = struct.Struct("<IBBHII")          # must match EvRec in EventLog.h
+FRAME_LEN = len(SYNC) + REC.size
+
+EVT_RE = re.compile(r'^\s*EVT\(\s*(\d+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def load_ids(path: Path) -> Dict[int, Tuple[str, str]]:
+    """Parse EVT(id, NAME, "fmt") lines from an EventIds.h."""
+    ids: Dict[int, Tuple[str, str]] = {}
+    for line in path.read_text(encoding="utf-8").splitlines():
+        m = EVT_RE.match(line)
+        if not m:
+            continue
+        fmt = bytes(m.group(3), "utf-8").decode("unicode_escape")
+        ids[int(m.group(1))] = (m.group(2), fmt)
+    if not ids:
+        raise SystemExit(f"no EVT(...) entries found in {path}")
+    return ids
+
+
+def render(ids: Dict[int, Tuple[str, str]], rec: bytes, with_time: bool) -> str:
+    t, ev, a, b, c, d = REC.unpack(rec)
+    entry = ids.get(ev)
+    if entry is None:
+        text = f"[EVLOG] unknown id={ev} args={a},{b},{c},{d}"
+    else:
+        _, fmt = entry
+        nargs = len(re.findall(r"%[-+ #0-9.]*l?[udxX]", fmt))
+        # Python's % ignores the C 'l' length modifier, so %lu works as-is.
+        text = fmt % (a, b, c, d)[:nargs]
+    return f"{t:8d} {text}" if with_time else text
+
+
+def decode(stream: BinaryIO, ids: Dict[int, Tuple[str, str]], with_time: bool,
+           live: bool = False) -> Iterator[str]:
+    buf = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if live:
+                continue        # serial read timed out; keep waiting
+            break
+        buf += chunk
+        while True:
+            i = buf.find(SYNC)
+            if i < 0:
+                # keep a possible half sync byte at the end
+                keep = 1 if buf.endswith(SYNC[:1]) else 0
+                text, buf = buf[: len(buf) - keep], buf[len(buf) - keep:]
+                if text:
+                    yield text.decode("utf-8", "replace")
+                break
+            if i > 0:
+                yield buf[:i].decode("utf-8", "replace")
+                buf = buf[i:]
+            if len(buf) < FRAME_LEN:
+                break
+            yield render(ids, buf[len(SYNC):FRAME_LEN], with_time) + "\n"
+            buf = buf[FRAME_LEN:]
+    if buf:
+        yield buf.decode("utf-8", "replace")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--ids", required=True, type=Path, help="EventIds.h of the sketch that produced the log")
+    ap.add_argument("--port", help="read live from this serial port instead of a file")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--time", action="store_true", help="prefix decoded events with their millis() stamp")
+    ap.add_argument("capture", nargs="?", help="raw capture file (default: stdin)")
+    args = ap.parse_args()
+
+    ids = load_ids(args.ids)
+
+    if args.port:
+        import serial  # pyserial; only needed for live decoding
+
+        stream: BinaryIO = serial.Serial(args.port, args.baud, timeout=0.2)
+    elif args.capture:
+        stream = open(args.capture, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    try:
+        for piece in decode(stream, ids, args.time, live=bool(args.port)):
+            sys.stdout.write(piece)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
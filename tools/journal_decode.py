@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Turn a server input journal (/journal.bin, see TREX_TrexServer/Journal.h)
+into a readable timeline.
+
+Get the journal off the server either as the raw file, or through
+maintenance telnet with `journal`, which prints it as "J <hex>" lines:
+
+    python3 tools/journal_decode.py journal.bin
+    python3 tools/journal_decode.py --hex telnet_capture.txt
+
+Output is one line per record, stamped with millis() and the offset from
+the game start, e.g.
+
+    123456 +   4.210s RX   type=14 src=3 len=20  0e...
+    123890 +   4.644s PIR  input=0 triggered
+    130001 +  10.755s CMD  serial "TEST R2"
+    130950 +  11.704s TX   window=10 frames=14 hash=5f2a09c1
+
+TX records hash what the server sent in each second of the
+game; host/tools/trex_replay compares them against a replay.
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+from typing import Iterator, Tuple
+
+FILE_HDR = struct.Struct("<4sHHIII")    # JournalFileHeader
+REC_HDR = struct.Struct("<IBB")         # t, kind, len
+
+# Byte offsets of MsgHeader.type / .srcStationId inside a frame; keep in sync
+# with MsgHeader in the TrexProtocol library.
+MSG_TYPE_OFS = 1
+MSG_SRC_OFS = 2
+
+KINDS = {1: "START", 2: "RX", 3: "PIR", 4: "CMD", 5: "END", 6: "TX"}
+CMD_SOURCES = {ord("S"): "serial", ord("T"): "telnet"}
+
+
+def read_journal(path: Path, is_hex: bool) -> bytes:
+    if not is_hex:
+        return path.read_bytes()
+    out = bytearray()
+    for line in path.read_text(encoding="utf-8", errors="replace").splitlines():
+        line = line.strip()
+        if line.startswith("J "):
+            out += bytes.fromhex(line[2:].strip())
+    return bytes(out)
+
+
+def records(blob: bytes) -> Iterator[Tuple[int, int, bytes]]:
+    pos = 0
+    while pos + REC_HDR.size <= len(blob):
+        t, kind, n = REC_HDR.unpack_from(blob, pos)
+        pos += REC_HDR.size
+        if pos + n > len(blob):
+            print(f"# truncated record at offset {pos - REC_HDR.size}", file=sys.stderr)
+            return
+        yield t, kind, blob[pos:pos + n]
+        pos += n
+
+
+def describe(kind: int, data: bytes) -> str:
+    if kind == 1 and len(data) >= 4:
+        seed = struct.unpack_from("<I", data)[0]
+        return f"seed={seed} stations={data[4]}" if len(data) >= 5 else f"seed={seed}"
+    if kind == 2 and len(data) > MSG_SRC_OFS:
+        return (f"type={data[MSG_TYPE_OFS]} src={data[MSG_SRC_OFS]} "
+                f"len={len(data)}  {data.hex()}")
+    if kind == 3 and len(data) >= 2:
+        return f"input={data[0]} {'triggered' if data[1] else 'released'}"
+    if kind == 4 and data:
+        src = CMD_SOURCES.get(data[0], chr(data[0]))
+        return f'{src} "{data[1:].decode("utf-8", "replace")}"'
+    if kind == 5 and len(data) >= 2:
+        return f"reason={data[0]} blameSid={data[1]}"
+    if kind == 6 and len(data) >= 8:
+        window, frames, h = struct.unpack_from("<HHI", data)
+        return f"window={window} frames={frames} hash={h:08x}"
+    return data.hex()
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--hex", action="store_true", help='input is a telnet capture of "J <hex>" lines')
+    ap.add_argument("--kind", action="append", choices=[k.lower() for k in KINDS.values()],
+                    help="only show these record kinds (repeatable)")
+    ap.add_argument("journal", type=Path)
+    args = ap.parse_args()
+
+    blob = read_journal(args.journal, args.hex)
+    if len(blob) < FILE_HDR.size:
+        raise SystemExit("journal too short")
+    magic, version, proto, seed, nbytes, dropped = FILE_HDR.unpack_from(blob)
+    if magic != b"TRJ1":
+        raise SystemExit(f"not a journal (magic={magic!r})")
+    print(f"# journal v{version} proto={proto} seed={seed} bytes={nbytes} dropped={dropped}")
+    if dropped:
+        print("# WARNING: records were dropped (RAM buffer full); the tail of the game is missing")
+
+    body = blob[FILE_HDR.size:FILE_HDR.size + nbytes]
+    want = {k.upper() for k in args.kind} if args.kind else None
+    t0 = None
+    for t, kind, data in records(body):
+        name = KINDS.get(kind, f"K{kind}")
+        if t0 is None:
+            t0 = t
+        if want and name not in want:
+            continue
+        rel = ((t - t0) & 0xFFFFFFFF) / 1000.0
+        print(f"{t:10d} +{rel:8.3f}s {name:<5} {describe(kind, data)}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())